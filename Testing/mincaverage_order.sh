@@ -0,0 +1,150 @@
+#! /bin/sh
+#
+# Test the -median, -percentile and -trimmed_mean options of mincaverage
+# against the sorted values of the input files, for few files and for
+# more files than are kept open at once, with values left out because
+# they are invalid or below -ignore_below.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+ifile=0
+while [ $ifile -lt 20 ]; do
+   make_volume f$ifile.mnc `expr 20 + $ifile` 'int(rand()*256)'
+   minctoraw -double -normalize f$ifile.mnc | od -An -v -tf8 | \
+      tr -s ' ' '\n' | sed '/^$/d' > f$ifile.txt
+   ifile=`expr $ifile + 1`
+done
+
+# check_order <output file> <input text files> <percentile> <fraction>
+#             [<largest value left out>]
+#
+# Check an output file against the percentile (from 0 to 100) of the
+# values of the input files at each voxel, or, if the percentile is
+# negative, against their mean without the given fraction at each end.
+# Values no larger than the last argument are left out, and voxels with
+# no values left should be 0.
+check_order () {
+   output=$1
+   inputs=$2
+   minctoraw -double -normalize $output | od -An -v -tf8 | \
+      tr -s ' ' '\n' | sed '/^$/d' > $output.txt
+   paste $output.txt $inputs | awk -v p=$3 -v t=$4 -v lo=${5:--1} '
+      {
+         n = 0;
+         for (i=2; i <= NF; i++) {
+            x = $i;
+            if (x <= lo) continue;
+            for (j=n; (j >= 1) && (v[j] > x); j--) v[j+1] = v[j];
+            v[j+1] = x;
+            n++;
+         }
+         if (n == 0) {
+            want = 0;
+         }
+         else if (p >= 0) {
+            pos = p / 100 * (n - 1);
+            k = int(pos);
+            f = pos - k;
+            want = v[k+1];
+            if ((f > 0) && (k < n-1)) want = (1 - f) * v[k+1] + f * v[k+2];
+         }
+         else {
+            ntrim = int(t * n);
+            sum = 0;
+            for (i=ntrim+1; i <= n-ntrim; i++) sum += v[i];
+            want = sum / (n - 2 * ntrim);
+         }
+         diff = $1 - want;
+         if (diff < 0) diff = -diff;
+         if (!(diff <= 1e-9 * (1 + ((want < 0) ? -want : want)))) bad++;
+      }
+      END { exit (bad > 0) || (NR == 0) }'
+}
+
+for nfiles in 3 4 20; do
+   files=""
+   texts=""
+   ifile=0
+   while [ $ifile -lt $nfiles ]; do
+      files="$files f$ifile.mnc"
+      texts="$texts f$ifile.txt"
+      ifile=`expr $ifile + 1`
+   done
+
+   for options in "" "-max_buffer_size_in_kb 1"; do
+      while read percentile fraction statistic; do
+         mincaverage -quiet -clobber -double -nonormalize $options \
+            $statistic $files out.mnc
+         check_order out.mnc "$texts" $percentile $fraction || \
+            fail "$options $statistic of $nfiles files"
+      done <<'EOF'
+50 0 -median
+0 0 -percentile 0
+100 0 -percentile 100
+25 0 -percentile 25
+30 0 -percentile 30
+90 0 -percentile 90
+-1 0.2 -trimmed_mean 0.2
+-1 0.45 -trimmed_mean 0.45
+EOF
+   done
+done
+
+# Files whose values below 64 are invalid, with the values they were made
+# from (the same random numbers, all valid)
+ifile=0
+while [ $ifile -lt 20 ]; do
+   make_volume g$ifile.mnc `expr 60 + $ifile` 'int(rand()*256)' 64
+   make_volume all.mnc `expr 60 + $ifile` 'int(rand()*256)'
+   raw_values all.mnc
+   mv all.mnc.txt g$ifile.txt
+   ifile=`expr $ifile + 1`
+done
+
+for nfiles in 5 20; do
+   ffiles=""
+   ftexts=""
+   gfiles=""
+   gtexts=""
+   ifile=0
+   while [ $ifile -lt $nfiles ]; do
+      ffiles="$ffiles f$ifile.mnc"
+      ftexts="$ftexts f$ifile.txt"
+      gfiles="$gfiles g$ifile.mnc"
+      gtexts="$gtexts g$ifile.txt"
+      ifile=`expr $ifile + 1`
+   done
+
+   # <files> <texts> <-ignore_below value or none> <largest value left out>
+   while read group ignore lo; do
+      if [ $group = f ]; then
+         files=$ffiles; texts=$ftexts
+      else
+         files=$gfiles; texts=$gtexts
+      fi
+      if [ $ignore = none ]; then
+         ignore=""
+      else
+         ignore="-ignore_below $ignore"
+      fi
+      for options in "" "-max_buffer_size_in_kb 1"; do
+         for statistic in "50 0 -median" "25 0 -percentile 25" \
+                          "-1 0.2 -trimmed_mean 0.2"; do
+            set -- $statistic
+            mincaverage -quiet -clobber -double -nonormalize $options \
+               $ignore $3 $4 $files out.mnc
+            check_order out.mnc "$texts" $1 $2 $lo || \
+               fail "$options $ignore $3 $4 of $nfiles files ($group)"
+         done
+      done
+   done <<'EOF'
+g none 63.5
+g 100 100
+f 100 100
+g 250 250
+EOF
+done
+
+exit 0
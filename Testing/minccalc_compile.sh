@@ -0,0 +1,63 @@
+#! /bin/sh
+#
+# Test that minccalc gives the same results when it compiles an expression
+# as when it evaluates the expression tree, including for voxels with
+# invalid data, with invalid values propagated or ignored.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+make_volume a.mnc 1 'int(rand()*256)'
+make_volume b.mnc 2 'int(rand()*256)'
+make_volume c.mnc 3 'int(rand()*4)'
+
+# A file with invalid data below 64, so that tests of if statements and
+# arguments of accumulations are invalid at some voxels
+make_volume d.mnc 4 'int(rand()*256)' 64
+
+for options in "" "-eval_width 1" "-eval_width 9" "-ignore_nan" \
+               "-ignore_nan -eval_width 1" "-ignore_nan -eval_width 9"; do
+   while read expression; do
+      minccalc -quiet -clobber -double $options -compile \
+         -expression "$expression" a.mnc b.mnc c.mnc d.mnc compiled.mnc
+      minccalc -quiet -clobber -double $options -nocompile \
+         -expression "$expression" a.mnc b.mnc c.mnc d.mnc tree.mnc
+      same_values compiled.mnc tree.mnc "$options $expression"
+   done <<'EOF'
+A[0] + A[1]*2 - A[2]/3
+A[0] / A[2] + A[1] / (A[2] - 1)
+isnan(A[0] / A[2]) ? -1 : A[0] / A[2]
+A[2] > 1 ? A[0] : NaN
+r = A[0] / (A[1] + 1); A[2] * exp(-r)
+let a = A[0] - A[1], b = A[2] in a*a + b
+sqrt(A[0]) + log(A[1] + 1) + sin(A[2]) * cos(A[0]) + atan(A[1])
+clamp(A[0], 50, 200) + segment(A[1], 10, 100) + abs(A[0] - A[1])
+max(A[0], A[1]) - min(A[1], A[2])
+A[0] < A[1] && A[1] < A[2] || !(A[0] == A[2])
+sum(A) + avg(A) + prod(A) + len(A)
+sum({ i in [0:len(A)) | A[i] * (i + 1) })
+total = 0; for {i in [0:len(A))} total = total + A[i]*i; total
+s = 0; s2 = 0; for {i in [0:3)} { s = s + A[i]; s2 = s2 + A[i]^2 }; sqrt((s2 - s^2/3)/2)
+if (A[0] > 128) A[1] else A[2]
+if (A[0] > 128) r = A[1] else r = A[2]; r * 2
+if (A[0] > 64) { if (A[1] > 128) A[0] else A[1] } else A[2]
+if (A[0] > 64) { if (A[1] > 128) r = 1 else r = 2 } else r = 3; r + A[2]
+if (A[2] > 0) { x = A[0]; if (A[1] > 100) x = x + A[1] } else x = -1; x
+V = [A[0], A[1]]; V[0] - V[1]
+A[3] + A[0]
+isnan(A[3]) ? -1 : A[3] * 2
+if (A[3] > 128) A[0] else A[1]
+r = -1; if (A[3] > 128) r = A[0] else r = A[1]; r + A[3]
+r = 0; if (A[3] > 100) { if (A[0] > 128) r = 1 else r = 2 } else r = 3; r
+if (A[0] > 128) { if (A[3] > 100) A[1] else A[2] } else A[3]
+r = 0; if (A[3] > 128) r = A[0]; r
+if (A[1] > 64) { x = A[3]; if (x > 128) x = x - A[0] } else x = -1; x
+sum(A) + avg(A) + prod(A)
+max(A) - min(A) + max(A[3], A[0]) - min(A[2], A[3])
+s = 0; for {i in [0:len(A))} s = s + A[i]; s
+A[3] / A[2] + A[3] / (A[2] - 1)
+EOF
+done
+
+exit 0
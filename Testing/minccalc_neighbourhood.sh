@@ -0,0 +1,119 @@
+#! /bin/sh
+#
+# Test the neighbourhood values A[s](dz,dy,dx) and mean3x3x3 of minccalc
+# against awk, with buffers smaller than a slice and larger than one, so
+# that halos come from the buffer before and from the files, and with
+# offsets past the edges, where the nearest voxel on the edge is used.
+# Also check that invalid neighbours stay invalid and that offsets
+# minccalc cannot use are rejected.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# shifted <values> <dz> <dy> <dx>
+#
+# Write the values of a volume, one per line in the order of the voxels,
+# at an offset from each voxel, using the nearest voxel on the edge
+# outside of the volume.
+shifted () {
+   awk -v nz=$nz -v ny=$ny -v nx=$nx -v dz=$2 -v dy=$3 -v dx=$4 '
+      function clamp(i, n) { return (i < 0) ? 0 : (i >= n) ? n - 1 : i }
+      { v[NR - 1] = $1 }
+      END {
+         for (z=0; z < nz; z++) for (y=0; y < ny; y++) {
+            row = (clamp(z + dz, nz)*ny + clamp(y + dy, ny)) * nx;
+            for (x=0; x < nx; x++) print v[row + clamp(x + dx, nx)];
+         }
+      }' $1
+}
+
+# expect_values <file> <expected values> <description>
+expect_values () {
+   raw_values $1
+   paste $1.txt $2 | awk '
+      { if (($1 - $2 > 1e-9) || ($2 - $1 > 1e-9)) bad++ }
+      END { exit (bad > 0) || (NR == 0) }' || fail "$3"
+}
+
+# 2760 voxels in slices of 460: a buffer of 1 KB holds a few rows and
+# one of 8 KB a couple of slices
+nz=6
+ny=20
+nx=23
+
+make_volume r.mnc 6 'int(rand()*256)'
+make_volume s.mnc 7 'int(rand()*256)'
+
+# A volume with invalid data below 64
+make_volume v.mnc 8 'int(rand()*256)' 64
+
+raw_values r.mnc
+raw_values s.mnc
+raw_values v.mnc
+
+# The mean over the 3x3x3 neighbourhood of r
+i=0
+while [ $i -lt 27 ]; do
+   shifted r.mnc.txt `expr $i / 9 - 1` `expr $i / 3 % 3 - 1` \
+      `expr $i % 3 - 1` > neighbour$i.txt
+   i=`expr $i + 1`
+done
+paste neighbour*.txt | \
+   awk '{ sum = 0; for (i=1; i <= NF; i++) sum += $i; print sum / 27 }' \
+   > mean.txt
+
+for options in "" "-max_buffer_size_in_kb 1" "-max_buffer_size_in_kb 8" \
+               "-max_buffer_size_in_kb 1 -nocompile" \
+               "-max_buffer_size_in_kb 8 -eval_width 5 -threads 3"; do
+
+   # Offsets along each dimension, within the volume and past its edges
+   for offset in "0 0 0" "1 0 0" "-1 0 0" "0 2 0" "0 0 -3" \
+                 "-2 3 1" "4 -5 6" "-9 21 -24"; do
+      set -- $offset
+      minccalc -quiet -clobber -double $options \
+         -expression "A[0]($1,$2,$3)" r.mnc s.mnc out.mnc
+      shifted r.mnc.txt $1 $2 $3 > expected.txt
+      expect_values out.mnc expected.txt "$options A[0]($1,$2,$3)"
+   done
+
+   # Each file has its own offsets, and the voxel itself is A[i]
+   minccalc -quiet -clobber -double $options \
+      -expression 'A[0](1,0,-1) * 1000 + A[1](0,-2,1) - A[1]' \
+      r.mnc s.mnc out.mnc
+   shifted r.mnc.txt 1 0 -1 > r_shifted.txt
+   shifted s.mnc.txt 0 -2 1 > s_shifted.txt
+   paste r_shifted.txt s_shifted.txt s.mnc.txt | \
+      awk '{ print $1 * 1000 + $2 - $3 }' > expected.txt
+   expect_values out.mnc expected.txt "$options offsets of two files"
+
+   minccalc -quiet -clobber -double $options \
+      -expression 'mean3x3x3(A[0])' r.mnc out.mnc
+   expect_values out.mnc mean.txt "$options mean3x3x3"
+
+   # Neighbours with invalid data are invalid
+   minccalc -quiet -clobber -double $options \
+      -expression 'isnan(A[0](0,1,-1))' v.mnc out.mnc
+   shifted v.mnc.txt 0 1 -1 | awk '{ print ($1 < 64) }' > expected.txt
+   expect_values out.mnc expected.txt "$options invalid neighbours"
+done
+
+# Offsets that are not whole numbers, means of other than an element of
+# A, files of other dimensions and offsets along a dimension that the
+# file does not have are rejected
+nx=8
+make_volume narrow.mnc 9 'int(rand()*256)'
+mincreshape -quiet -clobber -dimrange zspace=2,0 r.mnc slice.mnc
+while read files expression; do
+   if minccalc -quiet -clobber -double -expression "$expression" \
+      `echo $files | tr , ' '` bad.mnc 2> /dev/null; then
+      fail "$expression of $files was accepted"
+   fi
+done <<'EOF'
+r.mnc A[0](0.5,0,0)
+r.mnc mean3x3x3(A[0] + 1)
+r.mnc,narrow.mnc A[0](0,0,1) + A[1]
+slice.mnc A[0](1,0,0)
+EOF
+
+exit 0
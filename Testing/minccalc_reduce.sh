@@ -0,0 +1,173 @@
+#! /bin/sh
+#
+# Test the global reductions of minccalc (gsum, gmean, gmin, gmax and
+# gcount) against awk: with and without masks, with invalid values and
+# masks, with no voxels, nested in one another and mixed with values of
+# each voxel, over several buffers and threads. Also check that the
+# results do not depend on the number of threads, and that arguments
+# using symbols set outside of the reduction, and symbols set in the
+# arguments but used outside of them, are rejected.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# expect_constant <file> <value> <description>
+#
+# Check that a file has the same real value everywhere, to within
+# rounding.
+expect_constant () {
+   raw_values $1
+   awk -v value=$2 '
+      {
+         diff = $1 - value;
+         if (diff < 0) diff = -diff;
+         size = (value < 0) ? -value : value;
+         if (!(diff <= 1e-9 * (1 + size))) bad++;
+      }
+      END { exit (bad > 0) || (NR == 0) }' $1.txt || fail "$3"
+}
+
+# 990 voxels, which split unevenly into buffers of 1 KB, blocks of 5 or 7
+# voxels and ranges of blocks for 3 threads
+nz=9
+ny=10
+nx=11
+
+make_volume a.mnc 7 'int(rand()*256)'
+make_volume b.mnc 8 'int(rand()*256)'
+
+# A volume with invalid data below 64
+make_volume v.mnc 9 'int(rand()*256)' 64
+
+raw_values a.mnc
+raw_values b.mnc
+raw_values v.mnc
+paste a.mnc.txt b.mnc.txt v.mnc.txt > abv.txt
+
+# The reductions of a (all of it, and where b is above 100) and of the
+# valid values of v
+eval `awk '
+   function add(name, value) {
+      count[name]++;
+      sum[name] += value;
+      if ((count[name] == 1) || (value < min[name])) min[name] = value;
+      if ((count[name] == 1) || (value > max[name])) max[name] = value;
+   }
+   {
+      a[NR] = $1;
+      add("all", $1);
+      if ($2 > 100) add("masked", $1);
+      if ($3 >= 64) { add("valid", $3); add("a_valid", $1) }
+   }
+   END {
+      mean = sum["all"] / count["all"];
+      for (i=1; i <= NR; i++) squares += (a[i] - mean)^2;
+      printf "squares=%.17g\n", squares;
+      for (name in count) {
+         printf "%s_sum=%.17g %s_count=%d %s_mean=%.17g\n", name, sum[name],
+            name, count[name], name, sum[name] / count[name];
+         printf "%s_min=%.17g %s_max=%.17g\n",
+            name, min[name], name, max[name];
+      }
+   }' abv.txt`
+awk -v mean=$masked_mean '{ print $1 - mean }' abv.txt > centred.txt
+
+for options in "" "-nocompile" "-max_buffer_size_in_kb 1 -eval_width 7" \
+               "-threads 3 -eval_width 5 -max_buffer_size_in_kb 1"; do
+
+   while read expected expression; do
+      minccalc -quiet -clobber -double $options -expression "$expression" \
+         a.mnc b.mnc v.mnc out.mnc
+      expect_constant out.mnc $expected "$options $expression"
+   done <<EOF
+$all_sum gsum(A[0])
+$all_count gcount(A[0])
+$masked_sum gsum(A[0], A[1] > 100)
+$masked_count gcount(A[0], A[1] > 100)
+$masked_mean gmean(A[0], A[1] > 100)
+$masked_min gmin(A[0], A[1] > 100)
+$masked_max gmax(A[0], A[1] > 100)
+$valid_sum gsum(A[2])
+$valid_count gcount(A[2])
+$valid_mean gmean(A[2])
+$valid_min gmin(A[2])
+$valid_max gmax(A[2])
+$a_valid_sum gsum(A[0], A[2])
+$masked_mean gsum(A[1] > 100 ? A[0] : NaN) / gcount(A[0], A[1] > 100)
+$squares gsum((A[0] - gmean(A[0]))^2)
+EOF
+
+   # A reduction used with the value of each voxel
+   minccalc -quiet -clobber -double $options \
+      -expression 'A[0] - gmean(A[0], A[1] > 100)' a.mnc b.mnc out.mnc
+   raw_values out.mnc
+   paste out.mnc.txt centred.txt | awk '
+      { if (($1 - $2 > 1e-9) || ($2 - $1 > 1e-9)) bad++ }
+      END { exit (bad > 0) || (NR == 0) }' || \
+      fail "$options gmean used with each voxel"
+
+   # Reductions of no voxels
+   minccalc -quiet -clobber -double $options -expression "
+      gsum(A[0], A[1] > 1000) == 0 && gcount(A[0], A[1] > 1000) == 0 &&
+      isnan(gmean(A[0], A[1] > 1000)) && isnan(gmin(A[0], A[1] > 1000)) &&
+      isnan(gmax(A[0], A[1] > 1000))" a.mnc b.mnc ok.mnc
+   all_true ok.mnc "$options reductions of no voxels"
+
+   # Reductions set as output symbols
+   minccalc -quiet -clobber -double $options \
+      -expression 'm = gmean(A[0], A[1] > 100); d = A[0] - m' \
+      -outfile m m.mnc -outfile d d.mnc a.mnc b.mnc
+   expect_constant m.mnc $masked_mean "$options -outfile of gmean"
+   close_values d.mnc out.mnc "$options -outfile of the centred values"
+done
+
+# Blocks are added in the same order for any number of threads, so sums
+# of values that do not add exactly are the same
+minccalc -quiet -clobber -double -eval_width 5 -max_buffer_size_in_kb 1 \
+   -expression 'gsum(A[0] / 7) + gmean(A[0] / 3, A[1] > 100)' \
+   a.mnc b.mnc one.mnc
+for nthreads in 2 3 7; do
+   minccalc -quiet -clobber -double -eval_width 5 -max_buffer_size_in_kb 1 \
+      -threads $nthreads \
+      -expression 'gsum(A[0] / 7) + gmean(A[0] / 3, A[1] > 100)' \
+      a.mnc b.mnc threads.mnc
+   same_values one.mnc threads.mnc "reductions with -threads $nthreads"
+done
+
+# Symbols set outside of a reduction cannot be used in it
+for expression in "x = 2; gmean(A[0] * x)" "m = gmean(A[0] * m)" \
+                  "gsum(A[0], A[1] > x); x = 1"; do
+   if minccalc -quiet -clobber -double -expression "$expression" \
+      a.mnc b.mnc bad.mnc 2> /dev/null; then
+      fail "$expression was accepted"
+   fi
+done
+if minccalc -quiet -clobber -double -expression "s = A[0]; t = gmean(s)" \
+   -outfile t bad.mnc a.mnc b.mnc 2> /dev/null; then
+   fail "gmean of a symbol set outside of it was accepted with -outfile"
+fi
+
+# Symbols set inside a reduction cannot be used outside of it
+for options in "" "-nocompile"; do
+   for expression in "gsum(t = A[0]) + t" "gmean({ t = A[0]; t }) * t" \
+                     "gmax(A[0], { t = A[1] > 100; t }); t"; do
+      if minccalc -quiet -clobber -double $options \
+         -expression "$expression" a.mnc b.mnc bad.mnc 2> /dev/null; then
+         fail "$options $expression was accepted"
+      fi
+   done
+   if minccalc -quiet -clobber -double $options \
+      -expression "s = gsum(t = A[0])" -outfile s s.mnc -outfile t bad.mnc \
+      a.mnc b.mnc 2> /dev/null; then
+      fail "$options a symbol set inside gsum was accepted with -outfile"
+   fi
+done
+
+# Symbols set inside a reduction before they are used can be
+minccalc -quiet -clobber -double \
+   -expression 'gsum({ t = A[0] + 1; t * t }) == gsum((A[0] + 1)^2)' \
+   a.mnc b.mnc ok.mnc
+all_true ok.mnc "a symbol set inside a reduction"
+
+exit 0
@@ -0,0 +1,108 @@
+#! /bin/sh
+#
+# Test minccalc -threads: the values, against awk, when the buffers split
+# unevenly into ranges of blocks and when there are more threads than
+# blocks, the single thread (and its warning) for expressions that carry
+# a symbol from one block to the next, and the evaluation of ranges whose
+# thread cannot be started.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# expect_values <file> <expected values> <description>
+expect_values () {
+   raw_values $1
+   paste $1.txt $2 | awk '
+      { if (($1 - $2 > 1e-9) || ($2 - $1 > 1e-9)) bad++ }
+      END { exit (bad > 0) || (NR == 0) }' || fail "$3"
+}
+
+# 990 voxels, so that neither the buffers of 1 KB nor the blocks of 3 or
+# 4 voxels split evenly between 2, 3 or 7 threads
+nz=9
+ny=10
+nx=11
+
+make_volume a.mnc 4 'int(rand()*256)'
+make_volume b.mnc 5 'int(rand()*256)'
+
+# A mask that restarts the running count below at the first voxel and
+# then every 17 voxels
+make_volume reset.mnc 0 '((z*ny + y)*nx + x) % 17 == 0'
+
+raw_values a.mnc
+raw_values b.mnc
+raw_values reset.mnc
+paste a.mnc.txt b.mnc.txt reset.mnc.txt > abr.txt
+
+awk '{ print $1 * 2 + $2 / 3 }' abr.txt > linear.txt
+awk '{ r = $1 - $2; print (r > 0) ? r : -r }' abr.txt > absdiff.txt
+awk 'NR == FNR { if ($2 > 100) { sum += $1; count++ }; next }
+     { print $1 - sum / count }' abr.txt abr.txt > centred.txt
+awk '{ n = ($3 > 0) ? 0 : n + 1; print n * $1 }' abr.txt > count.txt
+
+for options in "-eval_width 4" "-eval_width 3 -max_buffer_size_in_kb 1" \
+               "-eval_width 4 -max_buffer_size_in_kb 1 -nocompile" \
+               "-eval_width 200 -max_buffer_size_in_kb 1"; do
+   for nthreads in 2 3 7; do
+      while read expected expression; do
+         minccalc -quiet -clobber -double $options -threads $nthreads \
+            -expression "$expression" a.mnc b.mnc out.mnc 2> warn.txt
+         expect_values out.mnc $expected \
+            "$options -threads $nthreads $expression"
+         if [ -s warn.txt ]; then
+            fail "$options -threads $nthreads $expression gave a warning"
+         fi
+      done <<'EOF'
+linear.txt A[0] * 2 + A[1] / 3
+absdiff.txt r = A[0] - A[1]; if (r > 0) r else -r
+centred.txt A[0] - gmean(A[0], A[1] > 100)
+EOF
+   done
+done
+
+# A running count keeps n from one voxel to the next, so with blocks of
+# one voxel it needs the voxels in file order, on one thread
+for options in "" "-max_buffer_size_in_kb 1" "-nocompile"; do
+   minccalc -quiet -clobber -double -eval_width 1 $options -threads 3 \
+      -expression 'if (A[2] > 0) n = 0 else n = n + 1; n * A[0]' \
+      a.mnc b.mnc reset.mnc out.mnc 2> warn.txt
+   expect_values out.mnc count.txt "$options running count"
+   grep "Symbol n may be used before it is set: using one thread" \
+      warn.txt > /dev/null || fail "$options running count gave no warning"
+done
+
+# Symbols set in only one part of an if are carried, including output
+# symbols, but not those set before being used
+while read symbol expression; do
+   minccalc -quiet -clobber -double -threads 3 -expression "$expression" \
+      -outfile s s.mnc a.mnc b.mnc 2> warn.txt
+   if [ "$symbol" = "-" ]; then
+      if [ -s warn.txt ]; then fail "$expression gave a warning"; fi
+   else
+      grep "Symbol $symbol may be used" warn.txt > /dev/null || \
+         fail "$expression gave no warning for $symbol"
+   fi
+done <<'EOF'
+s if (A[0] > 128) s = A[0]
+r if (A[0] > 128) r = A[1]; s = r
+- r = A[1]; if (A[0] > 128) r = A[0]; s = r
+- s = (let t = A[0] * 2 in t + A[1])
+t s = 0; for {i in [0:len(A))} t = A[i]; s = t
+EOF
+
+# Ranges whose thread cannot be started are evaluated by the main thread
+if (ulimit -s 1000000 && ulimit -v 400000) 2> /dev/null; then
+   (ulimit -s 1000000; ulimit -v 400000;
+    minccalc -quiet -clobber -double -eval_width 4 -max_buffer_size_in_kb 1 \
+       -threads 3 -expression 'A[0] * 2 + A[1] / 3' a.mnc b.mnc out.mnc)
+   expect_values out.mnc linear.txt "threads that cannot be started"
+fi
+
+if minccalc -quiet -clobber -threads 0 -expression 'A[0]' \
+   a.mnc bad.mnc 2> /dev/null; then
+   fail "-threads 0 was accepted"
+fi
+
+exit 0
@@ -0,0 +1,88 @@
+#! /bin/sh
+#
+# Test that mincmath gives the same results with several threads as with
+# one for cumulative operations on files, and that the threaded results
+# are right. The volumes hold more values than three threads get whole
+# chunks of, so that the threads get uneven shares, and five threads
+# leave one thread without a chunk.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# generated_values <seed> <expression>
+#
+# Write the byte values that make_volume writes for a seed and
+# expression, one per line, in the order of the voxels.
+generated_values () {
+   awk -v seed=$1 -v nz=$nz -v ny=$ny -v nx=$nx 'BEGIN {
+      srand(seed);
+      for (z=0; z < nz; z++) for (y=0; y < ny; y++) for (x=0; x < nx; x++)
+         print ('"$2"') % 256;
+   }'
+}
+
+# expect_values <file> <expected values> <description>
+expect_values () {
+   raw_values $1
+   paste $1.txt $2 | awk '
+      { if (($1 - $2 > 1e-9) || ($2 - $1 > 1e-9)) bad++ }
+      END { exit (bad > 0) || (NR == 0) }' || fail "$3"
+}
+
+# 990 values: 3 whole chunks of 256 and part of a fourth
+nz=9
+ny=10
+nx=11
+
+make_volume a.mnc 9 'int(rand()*256)'
+make_volume b.mnc 10 'int(rand()*256)'
+make_volume c.mnc 11 'int(rand()*256)'
+
+# A file with invalid data, to be propagated or ignored
+make_volume d.mnc 12 'int(rand()*256)' 64
+
+for options in "" "-ignore_nan" "-max_buffer_size_in_kb 1" \
+               "-max_buffer_size_in_kb 4"; do
+   for operation in -add -mult -maximum -minimum -count_valid; do
+      mincmath -quiet -clobber -double $options $operation \
+         a.mnc b.mnc c.mnc d.mnc one.mnc
+      for nthreads in 3 5; do
+         mincmath -quiet -clobber -double $options $operation \
+            -threads $nthreads a.mnc b.mnc c.mnc d.mnc threads.mnc
+         same_values one.mnc threads.mnc \
+            "$options $operation -threads $nthreads"
+      done
+   done
+   for operation in -sub -div; do
+      mincmath -quiet -clobber -double $options $operation \
+         a.mnc d.mnc one.mnc
+      mincmath -quiet -clobber -double $options $operation -threads 3 \
+         a.mnc d.mnc threads.mnc
+      same_values one.mnc threads.mnc "$options $operation"
+   done
+done
+
+# The threaded results against values worked out here
+generated_values 9 'int(rand()*256)' > a.txt
+generated_values 10 'int(rand()*256)' > b.txt
+generated_values 11 'int(rand()*256)' > c.txt
+generated_values 12 'int(rand()*256)' > d.txt
+
+paste a.txt b.txt c.txt | awk '{ print $1 + $2 + $3 }' > sum.txt
+paste a.txt b.txt c.txt | awk '{
+   m = $1; if ($2 > m) m = $2; if ($3 > m) m = $3; print m }' > max.txt
+awk '{ print ($1 >= 64) ? 4 : 3 }' d.txt > count.txt
+
+for options in "-threads 3" "-threads 3 -max_buffer_size_in_kb 1"; do
+   mincmath -quiet -clobber -double $options -add a.mnc b.mnc c.mnc sum.mnc
+   expect_values sum.mnc sum.txt "$options -add"
+   mincmath -quiet -clobber -double $options -maximum a.mnc b.mnc c.mnc \
+      max.mnc
+   expect_values max.mnc max.txt "$options -maximum"
+   mincmath -quiet -clobber -double $options -count_valid \
+      a.mnc b.mnc c.mnc d.mnc count.mnc
+   expect_values count.mnc count.txt "$options -count_valid"
+done
+
+exit 0
@@ -0,0 +1,79 @@
+#! /bin/sh
+#
+# Test that the byte output of mincresample -analytic_range, written in
+# one pass with a range worked out from the input, matches the output
+# rescaled to the range of the resampled values in a second pass.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# Random data with the whole input range, so that nearest neighbour
+# output of the whole volume has the range worked out for it
+make_volume a.mnc 37 \
+   '(z+y+x == 0) ? 0 : ((z+y+x == nz+ny+nx-3) ? 255 : int(rand()*256))'
+
+cat > rotate.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.96592583 -0.25881905 0 0.7
+ 0.25881905 0.96592583 0 -0.4
+ 0 0 1 0.3;
+EOG
+
+# image_range <file>
+#
+# Print the lowest image-min and highest image-max of a file.
+image_range () {
+   min=`mincinfo -varvalues image-min $1 | sort -g | head -1`
+   max=`mincinfo -varvalues image-max $1 | sort -g | tail -1`
+   echo $min $max
+}
+
+# within_steps <analytic file> <two-pass file> <description>
+#
+# Check that the range of the analytic output holds that of the two-pass
+# output and that their values differ by no more than half of a voxel
+# step of each.
+within_steps () {
+   set -- $1 $2 "$3" `image_range $1` `image_range $2`
+   awk -v amin=$4 -v amax=$5 -v min=$6 -v max=$7 'BEGIN {
+      exit !((amin <= min + 1e-9) && (amax >= max - 1e-9)) }' || \
+      fail "$3: range $4 $5 does not hold $6 $7"
+   raw_values $1
+   raw_values $2
+   paste $1.txt $2.txt | awk -v tol=`echo $4 $5 $6 $7 | \
+      awk '{ print (($2 - $1) + ($4 - $3)) / 255 / 2 + 1e-9 }'` '
+      {
+         diff = $1 - $2;
+         if (diff < 0) diff = -diff;
+         if (diff > tol) bad++;
+      }
+      END { exit (bad > 0) || (NR == 0) }' || fail "$3: $1 and $2 differ"
+}
+
+# Nearest neighbour without a transformation copies every value, so both
+# ways give the same range and so the same output
+mincresample -quiet -clobber -like a.mnc -nearest_neighbour \
+   a.mnc two_pass.mnc
+mincresample -quiet -clobber -like a.mnc -nearest_neighbour \
+   -analytic_range a.mnc analytic.mnc
+same_values two_pass.mnc analytic.mnc "-nearest_neighbour"
+
+for interpolant in -nearest_neighbour -trilinear -tricubic "-sinc -width 2"
+do
+   options="-transformation rotate.xfm $interpolant"
+   mincresample -quiet -clobber -like a.mnc $options a.mnc two_pass.mnc
+   mincresample -quiet -clobber -like a.mnc $options -analytic_range \
+      a.mnc analytic.mnc
+   within_steps analytic.mnc two_pass.mnc "$options"
+
+   # The slices are written once, in order, whatever the threads
+   mincresample -quiet -clobber -like a.mnc $options -analytic_range \
+      -threads 3 a.mnc threads.mnc
+   same_values analytic.mnc threads.mnc "$options -threads 3"
+done
+
+exit 0
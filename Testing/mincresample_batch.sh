@@ -0,0 +1,75 @@
+#! /bin/sh
+#
+# Test that mincresample -batch gives the same files as separate runs,
+# for jobs that use the default transformation, jobs that give their own
+# and jobs that share a transformation file, with inputs of different
+# sizes so that buffers must be reallocated between jobs.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+nz=9
+ny=10
+nx=11
+make_volume a.mnc 41 'int(rand()*256)'
+make_volume c.mnc 43 'int(rand()*256)'
+
+# A smaller input to follow a larger one
+nz=5
+ny=7
+nx=6
+make_volume b.mnc 42 'int(rand()*256)'
+
+cat > rotate.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.96592583 -0.25881905 0 0.7
+ 0.25881905 0.96592583 0 -0.4
+ 0 0 1 0.3;
+EOG
+cat > shift.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 1 0 0 1.5
+ 0 1 0 -0.5
+ 0 0 1 0.25;
+EOG
+make_grid_xfm grid 44
+
+cat > jobs.txt <<EOG
+# input   output       transformation
+a.mnc     batch_a.mnc
+
+b.mnc     batch_b.mnc  grid.xfm   # a grid after the default
+c.mnc     batch_c.mnc  shift.xfm
+a.mnc     batch_d.mnc  grid.xfm
+c.mnc     batch_e.mnc
+EOG
+
+for options in "-trilinear" "-tricubic -threads 3" "-sinc -double"; do
+   rm -f batch_?.mnc
+   mincresample -quiet -clobber -like a.mnc -transformation rotate.xfm \
+      $options -batch jobs.txt
+   for job in "a rotate" "b grid" "c shift" "d grid" "e rotate"; do
+      set $job
+      input=`grep "batch_$1.mnc" jobs.txt | awk '{print $1}'`
+      mincresample -quiet -clobber -like a.mnc -transformation $2.xfm \
+         $options $input single.mnc
+      same_values single.mnc batch_$1.mnc "-batch job $1 $options"
+   done
+done
+
+# The job list can also be read from standard input
+rm -f batch_?.mnc
+mincresample -quiet -clobber -like a.mnc -transformation rotate.xfm \
+   -batch - < jobs.txt
+mincresample -quiet -clobber -like a.mnc -transformation grid.xfm \
+   b.mnc single.mnc
+same_values single.mnc batch_b.mnc "-batch -"
+
+exit 0
@@ -0,0 +1,58 @@
+#! /bin/sh
+#
+# Test that mincresample gives the same output when it reads the
+# coordinates of a grid transformation from a cache file as when it
+# writes them, and that a cache file written for another transformation,
+# or before the grid file of the transformation changed, is not used.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+make_volume a.mnc 30 'int(rand()*256)'
+
+# differ <file1> <file2> <description>
+differ () {
+   minctoraw -double -normalize $1 > $1.raw
+   minctoraw -double -normalize $2 > $2.raw
+   if cmp -s $1.raw $2.raw; then fail "$3: $1 and $2 are the same"; fi
+}
+
+make_grid_xfm grid1 31
+make_grid_xfm grid2 32
+
+for options in "" "-transform_lattice 2" "-double -tricubic"; do
+   rm -f first.cache second.cache
+
+   # Written and then read
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid1.xfm -coord_cache_file first.cache a.mnc written.mnc
+   test -s first.cache || fail "$options: no cache file written"
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid1.xfm -coord_cache_file first.cache a.mnc read.mnc
+   same_values written.mnc read.mnc "$options cache file read"
+
+   # Not read for another transformation
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid2.xfm -coord_cache_file second.cache a.mnc other.mnc
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid2.xfm -coord_cache_file first.cache a.mnc stale.mnc
+   differ written.mnc other.mnc "$options other transformation"
+   same_values other.mnc stale.mnc "$options other transformation cache"
+
+   # Not read after the contents of the grid file changed
+   rm -f second.cache
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid1.xfm -coord_cache_file first.cache a.mnc written.mnc
+   cp grid1_grid.mnc saved.mnc
+   cp grid2_grid.mnc grid1_grid.mnc
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid1.xfm -coord_cache_file second.cache a.mnc new.mnc
+   mincresample -quiet -clobber $options -like a.mnc \
+      -transformation grid1.xfm -coord_cache_file first.cache a.mnc stale.mnc
+   cp saved.mnc grid1_grid.mnc
+   differ written.mnc new.mnc "$options changed grid"
+   same_values new.mnc stale.mnc "$options changed grid cache"
+done
+
+exit 0
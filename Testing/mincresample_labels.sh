@@ -0,0 +1,78 @@
+#! /bin/sh
+#
+# Test that mincresample -labels copies label voxel values exactly: with
+# the identity transformation every voxel is unchanged, and with a
+# rotation every voxel is one of the input labels (or the fill value) and
+# matches nearest-neighbour resampling. The short volume has a real range
+# that does not map voxel values onto whole numbers, so that any
+# conversion through real values would show.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# voxels <file>
+#
+# Write the voxel values of a file, one per line, to <file>.vox.
+voxels () {
+   minctoraw -double -nonormalize $1 | od -An -v -tf8 | \
+      tr -s ' ' '\n' | sed '/^$/d' > $1.vox
+}
+
+nz=9
+ny=10
+nx=11
+
+# Six labels, including 0 for the fill value
+make_volume bytes.mnc 51 'int(rand()*6)*40'
+minctoraw -byte -unsigned -nonormalize bytes.mnc | \
+   rawtominc -clobber -byte -unsigned -range 0 255 -real_range 0 255 \
+      -oshort -osigned -orange 0 30000 -noscan_range shorts.mnc $nz $ny $nx
+
+cat > rotate.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.96592583 -0.25881905 0 0.7
+ 0.25881905 0.96592583 0 -0.4
+ 0 0 1 0.3;
+EOG
+
+for input in bytes.mnc shorts.mnc; do
+
+   # The identity copies every voxel
+   mincresample -quiet -clobber -labels $input copy.mnc
+   voxels $input
+   voxels copy.mnc
+   cmp -s $input.vox copy.mnc.vox || \
+      fail "-labels changed the voxels of $input"
+
+   # A rotation only gives input labels and agrees with nearest neighbour
+   mincresample -quiet -clobber -like $input -transformation rotate.xfm \
+      -labels $input rotated.mnc
+   voxels rotated.mnc
+   sort -u $input.vox > labels.txt
+   awk 'NR == FNR { label[$1] = 1; next }
+        !($1 in label) { bad++ }
+        END { exit (bad > 0) }' labels.txt rotated.mnc.vox || \
+      fail "-labels made new label values from $input"
+   mincresample -quiet -clobber -like $input -transformation rotate.xfm \
+      -nearest_neighbour -keep_real_range $input nearest.mnc
+   same_values nearest.mnc rotated.mnc "-labels and -nearest_neighbour of $input"
+
+   # Threads give the same voxels
+   mincresample -quiet -clobber -like $input -transformation rotate.xfm \
+      -labels -threads 3 $input threads.mnc
+   voxels threads.mnc
+   cmp -s rotated.mnc.vox threads.mnc.vox || \
+      fail "-labels -threads 3 differs for $input"
+done
+
+# The output type cannot be changed
+if mincresample -quiet -clobber -labels -short bytes.mnc bad.mnc \
+      2> /dev/null; then
+   fail "-labels accepted a change of type"
+fi
+
+exit 0
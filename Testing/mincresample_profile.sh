@@ -0,0 +1,92 @@
+#! /bin/sh
+#
+# Test the -profile report of mincresample: that it is valid JSON, that it
+# lists each of the six timed stages, that the bytes read and written are
+# counted, and that nothing is printed without -profile.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+nz=9
+ny=10
+nx=11
+
+make_volume a.mnc 41 'int(rand()*256)'
+
+cat > rotate.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.96592583 -0.25881905 0 0.7
+ 0.25881905 0.96592583 0 -0.4
+ 0 0 1 0.3;
+EOG
+
+# stage <report> <name> <field>
+#
+# Print a field of a stage of a report.
+stage () {
+   awk -v name="\"$2\"" -v field="\"$3\":" '
+      $0 ~ "\"name\": " name {
+         for (i=1; i < NF; i++) {
+            if ($i == field) {
+               value = $(i+1);
+               sub(/[,}]+$/, "", value);
+               print value;
+            }
+         }
+      }' $1
+}
+
+for options in "" "-threads 3" "-max_buffer_size_in_kb 1"; do
+   mincresample -quiet -clobber -like a.mnc -transformation rotate.xfm \
+      $options -profile a.mnc out.mnc > report.json
+
+   # The report parses as JSON, when there is a parser to try
+   if command -v python3 > /dev/null 2>&1; then
+      python3 -c 'import json, sys; json.load(open(sys.argv[1]))' \
+         report.json || fail "$options: the report is not valid JSON"
+   fi
+
+   # Each stage is listed once
+   for name in transform_load load_volume transform_slice interpolate \
+               write renormalize; do
+      count=`grep -c "\"name\": \"$name\"" report.json || true`
+      if [ "$count" != 1 ]; then
+         fail "$options: stage $name is listed $count times"
+      fi
+   done
+   count=`grep -c '"name": ' report.json || true`
+   if [ "$count" != 6 ]; then
+      fail "$options: the report lists $count stages"
+   fi
+
+   # The input is read and each output slice of bytes is written once
+   bytes=`stage report.json load_volume bytes`
+   if [ -z "$bytes" ] || [ "$bytes" -le 0 ]; then
+      fail "$options: load_volume counted $bytes bytes"
+   fi
+   bytes=`stage report.json write bytes`
+   if [ "$bytes" != `expr $nz \* $ny \* $nx` ]; then
+      fail "$options: write counted $bytes bytes"
+   fi
+   calls=`stage report.json write calls`
+   if [ "$calls" != $nz ]; then
+      fail "$options: write was called $calls times"
+   fi
+   calls=`stage report.json transform_load calls`
+   if [ "$calls" != 1 ]; then
+      fail "$options: transform_load was called $calls times"
+   fi
+done
+
+# Without -profile nothing is printed
+mincresample -quiet -clobber -like a.mnc -transformation rotate.xfm \
+   a.mnc out.mnc > report.txt
+if [ -s report.txt ]; then
+   fail "output without -profile"
+fi
+
+exit 0
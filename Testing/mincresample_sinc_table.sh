@@ -0,0 +1,100 @@
+#! /bin/sh
+#
+# Test that mincresample -sinc -sinc_table gives the same output as -sinc
+# (with exactly evaluated weights) to within the accuracy of the table,
+# for an oblique transformation, which takes the full sum at each point,
+# and for output rows that follow each of the input axes, which take the
+# separable sums along rows.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# within <file1> <file2> <tolerance> <description>
+#
+# Check that the real values of two files differ by at most a tolerance.
+within () {
+   raw_values $1
+   raw_values $2
+   paste $1.txt $2.txt | awk -v tolerance=$3 '
+      {
+         diff = $1 - $2;
+         if (diff < 0) diff = -diff;
+         if (!(diff <= tolerance)) bad++;
+      }
+      END { exit (bad > 0) || (NR == 0) }' || fail "$4: $1 and $2 differ"
+}
+
+nz=16
+ny=16
+nx=16
+
+make_volume a.mnc 42 'int(rand()*256)'
+
+# Shifts by fractions of a voxel, with output rows along the input x, y
+# and z axes, and a rotation by 20 degrees about the diagonal
+cat > along_x.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 1 0 0 0.3
+ 0 1 0 0.4
+ 0 0 1 0.25;
+EOG
+cat > along_y.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0 -1 0 15.3
+ 1 0 0 0.4
+ 0 0 1 0.25;
+EOG
+cat > along_z.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0 0 1 0.3
+ 0 1 0 0.4
+ -1 0 0 15.25;
+EOG
+cat > oblique.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.95979508 -0.17736296 0.21756788 0.1
+ 0.21756788 0.95979508 -0.17736296 0.2
+ -0.17736296 0.21756788 0.95979508 0.3;
+EOG
+
+# Table weights are interpolated linearly between 1024 offsets per voxel,
+# which puts each weight within about 4e-7 of its exact value and, for
+# data from 0 to 255, the interpolated values within about 2e-4
+tolerance=1e-3
+
+for transformation in along_x along_y along_z oblique; do
+   for window in "" "-width 2" "-width 7 -hamming"; do
+      options="-transformation $transformation.xfm -sinc $window -double"
+      mincresample -quiet -clobber -like a.mnc $options a.mnc exact.mnc
+      mincresample -quiet -clobber -like a.mnc $options -sinc_table \
+         a.mnc table.mnc
+      within exact.mnc table.mnc $tolerance "$options -sinc_table"
+
+      # The table gives the same values with threads
+      mincresample -quiet -clobber -like a.mnc $options -sinc_table \
+         -threads 3 a.mnc threads.mnc
+      same_values table.mnc threads.mnc "$options -sinc_table -threads 3"
+   done
+done
+
+# -nosinc_table goes back to exact weights
+mincresample -quiet -clobber -like a.mnc -transformation oblique.xfm \
+   -sinc -double -sinc_table -nosinc_table a.mnc table.mnc
+mincresample -quiet -clobber -like a.mnc -transformation oblique.xfm \
+   -sinc -double a.mnc exact.mnc
+same_values exact.mnc table.mnc "-nosinc_table"
+
+exit 0
@@ -0,0 +1,64 @@
+#! /bin/sh
+#
+# Test that mincresample gives the same output when it reads the input in
+# slabs, with a buffer much smaller than the input volume, as when it
+# reads the whole volume.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# An input volume of 3840 bytes, with slices of 320 bytes, so that a
+# buffer of 1kb holds the input for only a few output slices
+nz=12
+ny=16
+nx=20
+
+make_volume a.mnc 35 'int(rand()*256)'
+
+# Rotations within the slices and across them, and a shift along the
+# slices that maps some of them completely outside of the volume
+cat > rotate.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.96592583 -0.25881905 0 0.7
+ 0.25881905 0.96592583 0 -0.4
+ 0 0 1 0.3;
+EOG
+cat > tilt.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 1 0 0 0.2
+ 0 0.93969262 -0.34202014 1.5
+ 0 0.34202014 0.93969262 -2.1;
+EOG
+cat > shift.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 1 0 0 0
+ 0 1 0 0
+ 0 0 1 7.5;
+EOG
+make_grid_xfm grid 36
+
+for transformation in rotate.xfm tilt.xfm shift.xfm grid.xfm; do
+   for interpolant in -nearest_neighbour -trilinear -tricubic \
+                      "-sinc -width 2"; do
+      options="-transformation $transformation $interpolant"
+      mincresample -quiet -clobber -like a.mnc $options a.mnc whole.mnc
+      for buffer in "-max_buffer_size_in_kb 1" \
+                    "-max_buffer_size_in_kb 2 -threads 3"; do
+         mincresample -quiet -clobber -like a.mnc $options $buffer \
+            a.mnc slabs.mnc
+         same_values whole.mnc slabs.mnc "$options $buffer"
+      done
+   done
+done
+
+exit 0
@@ -0,0 +1,45 @@
+#! /bin/sh
+#
+# Test that mincresample gives the same output with several threads as
+# with one, for each interpolant, for linear and grid transformations and
+# for output that is rescaled after all of the slices are computed.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# Slices that do not divide evenly between the threads
+nz=9
+ny=10
+nx=11
+
+make_volume a.mnc 33 'int(rand()*256)'
+
+cat > rotate.xfm <<EOG
+MNI Transform File
+
+Transform_Type = Linear;
+Linear_Transform =
+ 0.96592583 -0.25881905 0 0.7
+ 0.25881905 0.96592583 0 -0.4
+ 0 0 1 0.3;
+EOG
+make_grid_xfm grid 34
+
+for transformation in "" "-transformation rotate.xfm" \
+                      "-transformation grid.xfm" \
+                      "-transformation grid.xfm -transform_lattice 3"; do
+   for interpolant in -nearest_neighbour -trilinear -tricubic -sinc; do
+      for type in "" "-double"; do
+         options="$transformation $interpolant $type"
+         mincresample -quiet -clobber -like a.mnc $options a.mnc one.mnc
+         for nthreads in 2 4; do
+            mincresample -quiet -clobber -like a.mnc $options \
+               -threads $nthreads a.mnc threads.mnc
+            same_values one.mnc threads.mnc "$options -threads $nthreads"
+         done
+      done
+   done
+done
+
+exit 0
@@ -0,0 +1,69 @@
+#! /bin/sh
+#
+# Test that mincreshape gives the same files with several threads as
+# with one: for reordered, flipped and cut-down dimensions, ranges that
+# go outside the input, conversions that scan the image range, and
+# chunks small enough that a copy has several sets of them. Threads that
+# cannot be started leave their chunks to the main thread, which is
+# checked by running with too little address space for a thread stack.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# same_voxels <file1> <file2> <description>
+#
+# Check that two files have exactly the same voxel values.
+same_voxels () {
+   minctoraw -nonormalize $1 > $1.vox
+   minctoraw -nonormalize $2 > $2.vox
+   cmp -s $1.vox $2.vox || fail "$3: voxels of $1 and $2 differ"
+}
+
+nz=9
+ny=10
+nx=11
+make_volume a.mnc 71 'int(rand()*256)'
+
+# Values below 64 are invalid
+make_volume v.mnc 72 'int(rand()*256)' 64
+
+for input in a.mnc v.mnc; do
+   while read options; do
+      for chunk in "" "-max_chunk_size_in_kb 1"; do
+         mincreshape -quiet -clobber $options $chunk $input one.mnc
+         for nthreads in 2 3 5; do
+            mincreshape -quiet -clobber $options $chunk \
+               -threads $nthreads $input threads.mnc
+            same_values one.mnc threads.mnc \
+               "$input $options $chunk -threads $nthreads"
+            same_voxels one.mnc threads.mnc \
+               "$input $options $chunk -threads $nthreads"
+         done
+      done
+   done <<'EOG'
+-dimorder xspace,zspace,yspace
+-sagittal
+-coronal
+-xdirection -zdirection
+-dimrange yspace=-2,14 -dimrange xspace=9,-6
+-short -scan_range
+-float -dimorder yspace,xspace,zspace
+-short -normalize -coronal
+EOG
+done
+
+# With a stack limit larger than the address space left, no thread can
+# get a stack, so pthread_create fails and the main thread does the work
+if (ulimit -s 1000000 && ulimit -v 400000) 2> /dev/null; then
+   for options in "-dimorder xspace,zspace,yspace" "-short -scan_range"; do
+      mincreshape -quiet -clobber $options -max_chunk_size_in_kb 1 \
+         a.mnc one.mnc
+      (ulimit -s 1000000; ulimit -v 400000;
+       mincreshape -quiet -clobber $options -max_chunk_size_in_kb 1 \
+          -threads 3 a.mnc threads.mnc)
+      same_voxels one.mnc threads.mnc "$options without threads"
+   done
+fi
+
+exit 0
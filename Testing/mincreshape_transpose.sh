@@ -0,0 +1,53 @@
+#! /bin/sh
+#
+# Test that mincreshape -dimorder writes each voxel where it belongs, for
+# values of 1, 2, 4 and 8 bytes, with and without a flip and with chunks
+# of several sizes. The transposed dimensions are longer than a tile of
+# the in-memory transpose and not a multiple of it. The result is checked
+# voxel by voxel against a copy in the input order.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+# check_transpose <copy> <transposed> <flip> <description>
+#
+# Check that the transposed file, in xspace, zspace, yspace order, has
+# the values of the copy, in zspace, yspace, xspace order, with yspace
+# flipped if <flip> is 1.
+check_transpose () {
+   raw_values $1
+   raw_values $2
+   awk -v nz=$nz -v ny=$ny -v nx=$nx -v flip=$3 '
+      NR == FNR { v[NR-1] = $1; next }
+      {
+         i = FNR - 1;
+         y = i % ny;
+         z = int(i / ny) % nz;
+         x = int(i / (ny * nz));
+         if (flip) y = ny - 1 - y;
+         if ($1 != v[(z * ny + y) * nx + x]) bad++;
+      }
+      END { exit (bad > 0) || (FNR != nz * ny * nx) }' $1.txt $2.txt || \
+      fail "$4"
+}
+
+nz=3
+ny=34
+nx=37
+make_volume a.mnc 81 'int(rand()*256)'
+
+for type in -byte -short -int -float -double; do
+   for chunk in "" "-max_chunk_size_in_kb 4"; do
+      mincreshape -quiet -clobber $type $chunk a.mnc copy.mnc
+      mincreshape -quiet -clobber $type $chunk \
+         -dimorder xspace,zspace,yspace a.mnc transposed.mnc
+      check_transpose copy.mnc transposed.mnc 0 "$type $chunk -dimorder"
+      mincreshape -quiet -clobber $type $chunk \
+         -dimorder xspace,zspace,yspace -ydirection a.mnc flipped.mnc
+      check_transpose copy.mnc flipped.mnc 1 \
+         "$type $chunk -dimorder -ydirection"
+   done
+done
+
+exit 0
@@ -0,0 +1,117 @@
+#! /bin/sh
+#
+# Test that reductions split up with -partial and combined with -merge
+# give the results of a single run, for mincaverage and mincmath, and
+# that partial states written by either program can be merged by the
+# other.
+
+set -e
+
+. `dirname $0`/test_functions.sh
+
+make_volume a.mnc 12 'int(rand()*256)'
+make_volume b.mnc 13 'int(rand()*256)'
+make_volume c.mnc 14 'int(rand()*256)'
+make_volume d.mnc 15 'int(rand()*256)'
+make_volume e.mnc 16 'int(rand()*256)'
+
+# A file with invalid data, to be ignored
+make_volume nan.mnc 17 'int(rand()*256)' 64
+
+# mincaverage, with and without weights
+for weights in "" "1,2,0.5,3,1.5"; do
+   if [ -n "$weights" ]; then
+      all_weights="-weights $weights"
+      first_weights="-weights `echo $weights | cut -d, -f1-2`"
+      last_weights="-weights `echo $weights | cut -d, -f3-`"
+   else
+      all_weights=""
+      first_weights=""
+      last_weights=""
+   fi
+
+   mincaverage -quiet -clobber -double -nonormalize $all_weights \
+      -sdfile sd.mnc a.mnc b.mnc c.mnc d.mnc e.mnc avg.mnc
+
+   # Two parts, merged directly and through a merged partial state
+   mincaverage -quiet -clobber -nonormalize $first_weights -partial \
+      a.mnc b.mnc first.mnc
+   mincaverage -quiet -clobber -nonormalize $last_weights -partial \
+      c.mnc d.mnc e.mnc last.mnc
+   mincaverage -quiet -clobber -double -merge -sdfile sd2.mnc \
+      first.mnc last.mnc avg2.mnc
+   close_values avg2.mnc avg.mnc "mincaverage $all_weights merged average"
+   close_values sd2.mnc sd.mnc "mincaverage $all_weights merged sd"
+   mincaverage -quiet -clobber -merge -partial last.mnc first.mnc both.mnc
+   mincaverage -quiet -clobber -double -merge -sdfile sd3.mnc \
+      both.mnc avg3.mnc
+   close_values avg3.mnc avg.mnc "mincaverage $all_weights average of merge"
+   close_values sd3.mnc sd.mnc "mincaverage $all_weights sd of merge"
+
+   # A single part gives exactly the results of a single run
+   mincaverage -quiet -clobber -nonormalize $all_weights -partial \
+      a.mnc b.mnc c.mnc d.mnc e.mnc one.mnc
+   mincaverage -quiet -clobber -double -merge -sdfile sd1.mnc \
+      one.mnc avg1.mnc
+   same_values avg1.mnc avg.mnc "mincaverage $all_weights one part average"
+   same_values sd1.mnc sd.mnc "mincaverage $all_weights one part sd"
+done
+
+# mincmath, with and without invalid data
+for files in "a.mnc b.mnc c.mnc d.mnc e.mnc" "a.mnc b.mnc nan.mnc d.mnc e.mnc"
+do
+   set -- $files
+   first="$1 $2"
+   last="$3 $4 $5"
+   mincmath -quiet -clobber -ignore_nan -partial $first first.mnc
+   mincmath -quiet -clobber -ignore_nan -partial $last last.mnc
+   mincmath -quiet -clobber -ignore_nan -partial $files one.mnc
+   for operation in -add -maximum -minimum -count_valid; do
+      mincmath -quiet -clobber -double -ignore_nan $operation $files out.mnc
+      mincmath -quiet -clobber -double -ignore_nan -merge $operation \
+         first.mnc last.mnc out2.mnc
+      close_values out2.mnc out.mnc "mincmath $operation of $files"
+      mincmath -quiet -clobber -double -ignore_nan -merge $operation \
+         one.mnc out1.mnc
+      same_values out1.mnc out.mnc "mincmath $operation of one part"
+   done
+done
+
+# Partial states of one program merged by the other
+mincmath -quiet -clobber -partial a.mnc b.mnc first.mnc
+mincaverage -quiet -clobber -nonormalize -partial c.mnc d.mnc e.mnc last.mnc
+mincaverage -quiet -clobber -double -nonormalize \
+   a.mnc b.mnc c.mnc d.mnc e.mnc avg.mnc
+mincaverage -quiet -clobber -double -merge first.mnc last.mnc avg2.mnc
+close_values avg2.mnc avg.mnc "mincaverage merge of mincmath states"
+mincmath -quiet -clobber -double -add a.mnc b.mnc c.mnc d.mnc e.mnc sum.mnc
+mincmath -quiet -clobber -double -merge -add first.mnc last.mnc sum2.mnc
+close_values sum2.mnc sum.mnc "mincmath merge of mincaverage states"
+
+# weight_of <file>
+#
+# Print the total weight kept in a file of partial states.
+weight_of () {
+   mincinfo -attvalue image:partial_state_weight $1 | awk '{ print $1 + 0 }'
+}
+
+# Averaging along a dimension gives each value along it a weight, so the
+# total weight counts the slices of every file and -min_weight_fraction
+# after a merge matches a single run
+mincaverage -quiet -clobber -nonormalize -avgdim zspace -partial \
+   nan.mnc a.mnc slabs.mnc
+[ "`weight_of slabs.mnc`" = `expr 2 \* $nz` ] || \
+   fail "mincaverage -avgdim -partial weight"
+mincaverage -quiet -clobber -nonormalize -avgdim zspace -partial \
+   nan.mnc slab.mnc
+mincaverage -quiet -clobber -double -nonormalize -avgdim zspace \
+   -min_weight_fraction 0.7 nan.mnc avg.mnc
+mincaverage -quiet -clobber -double -merge -min_weight_fraction 0.7 \
+   slab.mnc avg2.mnc
+same_values avg2.mnc avg.mnc "mincaverage -avgdim -min_weight_fraction merge"
+mincmath -quiet -clobber -dimension zspace -partial nan.mnc a.mnc \
+   slabs.mnc
+[ "`weight_of slabs.mnc`" = `expr 2 \* $nz` ] || \
+   fail "mincmath -dimension -partial weight"
+
+exit 0
@@ -0,0 +1,114 @@
+#! /bin/sh
+#
+# Shell functions for the regression tests of the minc programs. Each
+# test is run as
+#
+#    sh <test>.sh <directory of the programs>
+#
+# and sources this file, which puts the programs on the path and moves to
+# a scratch directory that is removed when the test exits.
+
+progs=`cd ${1:-..} && pwd`
+PATH=${progs}:${PATH}
+export PATH
+
+work=${TMPDIR:-/tmp}/minctest.$$
+rm -rf ${work}
+mkdir ${work}
+trap 'cd /; rm -rf ${work}' 0
+cd ${work}
+
+# Dimensions of the test volumes (slowest varying first), chosen so that
+# no dimension or slice fills a whole block of voxels
+nz=5
+ny=6
+nx=7
+
+# make_volume <file> <seed> <expression> [<valid minimum>]
+#
+# Write a byte volume whose value at each voxel is the awk expression,
+# which can use the voxel indices z, y and x and rand() (seeded with the
+# given seed). The real values are the byte values. With a valid
+# minimum, voxels below it are outside of the valid range and so are
+# read as invalid data.
+make_volume () {
+   bytes=`awk -v seed=$2 -v nz=$nz -v ny=$ny -v nx=$nx 'BEGIN {
+      srand(seed);
+      for (z=0; z < nz; z++) for (y=0; y < ny; y++) for (x=0; x < nx; x++)
+         printf "\\\\%03o", ('"$3"') % 256;
+   }'`
+   vmin=${4:-0}
+   printf "$bytes" | rawtominc -clobber -byte -unsigned -range $vmin 255 \
+      -real_range $vmin 255 $1 $nz $ny $nx
+}
+
+# make_grid_xfm <file> <seed>
+#
+# Write a grid transformation <file>.xfm, with its displacements of up
+# to 1mm at random on a 4 x 4 x 4 grid in <file>_grid.mnc that covers
+# the test volumes.
+make_grid_xfm () {
+   bytes=`awk -v seed=$2 'BEGIN {
+      srand(seed);
+      for (i=0; i < 4*4*4*3; i++) printf "\\\\%03o", int(rand()*256);
+   }'`
+   step=`echo $nz $ny $nx | awk '{
+      n = $1; if ($2 > n) n = $2; if ($3 > n) n = $3; print int(n/3) + 1 }'`
+   printf "$bytes" | rawtominc -clobber -vector 3 -byte -unsigned \
+      -range 0 255 -real_range -1 1 -xstart -1 -ystart -1 -zstart -1 \
+      -xstep $step -ystep $step -zstep $step $1_grid.mnc 4 4 4
+   cat > $1.xfm <<EOF
+MNI Transform File
+
+Transform_Type = Grid_Transform;
+Displacement_Volume = $1_grid.mnc;
+EOF
+}
+
+# raw_values <file>
+#
+# Write the real values of a file, one per line, to <file>.txt.
+raw_values () {
+   minctoraw -double -normalize $1 | od -An -v -tf8 | \
+      tr -s ' ' '\n' | sed '/^$/d' > $1.txt
+}
+
+# fail <message>
+fail () {
+   echo "FAILED: $*" >&2
+   exit 1
+}
+
+# same_values <file1> <file2> <description>
+#
+# Check that two files have exactly the same real values.
+same_values () {
+   minctoraw -double -normalize $1 > $1.raw
+   minctoraw -double -normalize $2 > $2.raw
+   cmp -s $1.raw $2.raw || fail "$3: $1 and $2 differ"
+}
+
+# all_true <file> <description>
+#
+# Check that a file written by minccalc from a test is 1 everywhere.
+all_true () {
+   minctoraw -double -normalize $1 | od -An -v -tf8 | \
+      awk '{ for (i=1; i <= NF; i++) if ($i != 1) bad++ }
+           END { exit (bad > 0) || (NR == 0) }' || fail "$2"
+}
+
+# close_values <file1> <file2> <description>
+#
+# Check that two files have the same real values to within rounding.
+close_values () {
+   raw_values $1
+   raw_values $2
+   paste $1.txt $2.txt | awk '
+      {
+         diff = $1 - $2;
+         if (diff < 0) diff = -diff;
+         size = ($2 < 0) ? -$2 : $2;
+         if (($1 != $2) && !(diff <= 1e-9 * (1 + size))) bad++;
+      }
+      END { exit (bad > 0) || (NR == 0) }' || fail "$3: $1 and $2 differ"
+}
@@ -0,0 +1,246 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : fused_files.c
+@DESCRIPTION: Routines to read the input files of mincaverage and mincmath
+              that voxel_loop does not read, a buffer of the first file
+              at a time, so that all of the files can be combined in one
+              pass through the first.
+@METHOD     : The files must have the dimensions of the first file, so
+              that the part of each one to read is the one that
+              voxel_loop gives for the first. They are read as voxel_loop
+              reads its input files.
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1995 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <minc.h>
+#include <fused_files.h>
+#include <loop_icv.h>
+
+#ifndef TRUE
+#  define TRUE 1
+#  define FALSE 0
+#endif
+
+/* Largest number of files kept open. With more files, the others are
+   opened for each buffer, as voxel_loop does, since the number of icvs
+   is limited. */
+#define FUSED_MAX_OPEN 16
+
+/* Relative difference of dimension step or start for files to be taken as
+   having different sampling */
+#define SAMPLING_TOLERANCE 1.0e-5
+
+static void open_fused_file(Fused_Files *fused, int ifile);
+static void close_fused_file(Fused_Files *fused, int ifile);
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : open_fused_files
+@INPUT      : num_files - number of input files
+              files - names of the input files
+              check_sampling - TRUE if the files must have the same 
+                 dimension sampling
+@OUTPUT     : fused - files kept open
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to check that the input files have the same
+              dimensions as the first file, so that the part of each file
+              in a buffer of the first file can be read with
+              read_fused_file. Up to FUSED_MAX_OPEN of the files after
+              the first are kept open; the rest are opened for each read.
+              Exits if the dimensions differ.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : open_fused_file
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void open_fused_files(Fused_Files *fused, int num_files, char *files[],
+                      int check_sampling)
+{
+   int ifile, idim, ndims, first_ndims, imgid, varid, old_ncopts;
+   int dim[MAX_VAR_DIMS];
+   long size, first_size[MAX_VAR_DIMS];
+   char name[MAX_NC_NAME], (*first_name)[MAX_NC_NAME];
+   double step, start, first_step[MAX_VAR_DIMS], first_start[MAX_VAR_DIMS];
+   int mincid;
+
+   fused->num_files = num_files;
+   fused->files = files;
+   fused->num_open = (num_files - 1 < FUSED_MAX_OPEN) ? 
+      num_files - 1 : FUSED_MAX_OPEN;
+   fused->mincids = malloc(sizeof(int) * num_files);
+   fused->icvids = malloc(sizeof(int) * num_files);
+   first_name = malloc(sizeof(*first_name) * MAX_VAR_DIMS);
+
+   first_ndims = 0;
+   for (ifile=0; ifile < num_files; ifile++) {
+      mincid = miopen(files[ifile], NC_NOWRITE);
+      imgid = ncvarid(mincid, MIimage);
+      (void) ncvarinq(mincid, imgid, NULL, NULL, &ndims, dim, NULL);
+      if (ifile == 0) {
+         first_ndims = ndims;
+      }
+      else if (ndims != first_ndims) {
+         (void) fprintf(stderr, 
+                        "File %s does not have the dimensions of %s\n",
+                        files[ifile], files[0]);
+         exit(EXIT_FAILURE);
+      }
+
+      for (idim=0; idim < ndims; idim++) {
+         (void) ncdiminq(mincid, dim[idim], name, &size);
+
+         /* Get the sampling, if the dimension has any */
+         step = 1.0;
+         start = 0.0;
+         old_ncopts = ncopts;
+         ncopts = 0;
+         varid = ncvarid(mincid, name);
+         if (varid != MI_ERROR) {
+            (void) miattget1(mincid, varid, MIstep, NC_DOUBLE, &step);
+            (void) miattget1(mincid, varid, MIstart, NC_DOUBLE, &start);
+         }
+         ncopts = old_ncopts;
+
+         if (ifile == 0) {
+            (void) strcpy(first_name[idim], name);
+            first_size[idim] = size;
+            first_step[idim] = step;
+            first_start[idim] = start;
+         }
+         else if ((strcmp(name, first_name[idim]) != 0) || 
+                  (size != first_size[idim])) {
+            (void) fprintf(stderr, 
+                           "File %s does not have the dimensions of %s\n",
+                           files[ifile], files[0]);
+            exit(EXIT_FAILURE);
+         }
+         else if (check_sampling &&
+                  ((fabs(step - first_step[idim]) > 
+                    SAMPLING_TOLERANCE * fabs(first_step[idim])) ||
+                   (fabs(start - first_start[idim]) > 
+                    SAMPLING_TOLERANCE * fabs(first_step[idim])))) {
+            (void) fprintf(stderr, 
+                           "File %s does not have the sampling of %s\n",
+                           files[ifile], files[0]);
+            exit(EXIT_FAILURE);
+         }
+      }
+      (void) miclose(mincid);
+
+      if ((ifile > 0) && (ifile <= fused->num_open))
+         open_fused_file(fused, ifile);
+   }
+
+   free(first_name);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : close_fused_files
+@INPUT      : fused - files kept open
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to close the files opened by open_fused_files.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : close_fused_file
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void close_fused_files(Fused_Files *fused)
+{
+   int ifile;
+
+   for (ifile=1; ifile <= fused->num_open; ifile++)
+      close_fused_file(fused, ifile);
+   free(fused->mincids);
+   free(fused->icvids);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : read_fused_file
+@INPUT      : fused - input files
+              ifile - file to read (not the first one)
+              start, count - part of the image to read
+@OUTPUT     : buffer - values read
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to read part of an input file, opening it first if
+              it is not kept open.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : open_fused_file, close_fused_file
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void read_fused_file(Fused_Files *fused, int ifile,
+                     long start[], long count[], double *buffer)
+{
+   int keep_open = (ifile <= fused->num_open);
+
+   if (!keep_open) open_fused_file(fused, ifile);
+   (void) miicv_get(fused->icvids[ifile], start, count, buffer);
+   if (!keep_open) close_fused_file(fused, ifile);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : open_fused_file
+@INPUT      : fused - names of the input files
+              ifile - file to open
+@OUTPUT     : fused - file id and icv
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to open an input file for reading real values as
+              voxel_loop does: doubles with invalid values set to
+              -DBL_MAX.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : create_loop_icv
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void open_fused_file(Fused_Files *fused, int ifile)
+{
+   int mincid, icvid;
+
+   mincid = miopen(fused->files[ifile], NC_NOWRITE);
+   icvid = create_loop_icv(mincid);
+   fused->mincids[ifile] = mincid;
+   fused->icvids[ifile] = icvid;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : close_fused_file
+@INPUT      : fused - file id and icv
+              ifile - file to close
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to close an input file opened by open_fused_file.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void close_fused_file(Fused_Files *fused, int ifile)
+{
+   (void) miicv_free(fused->icvids[ifile]);
+   (void) miclose(fused->mincids[ifile]);
+}
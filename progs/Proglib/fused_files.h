@@ -0,0 +1,35 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : fused_files.h
+@DESCRIPTION: Header file for fused_files.c
+@METHOD     :
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1995 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+/* Input files read alongside the first one, for the part of each file
+   in a voxel_loop buffer of the first file */
+typedef struct {
+   int num_files;
+   char **files;
+   int num_open;             /* Number of files after the first that 
+                                are kept open */
+   int *mincids;
+   int *icvids;
+} Fused_Files;
+
+void open_fused_files(Fused_Files *fused, int num_files, char *files[],
+                      int check_sampling);
+void close_fused_files(Fused_Files *fused);
+void read_fused_file(Fused_Files *fused, int ifile,
+                     long start[], long count[], double *buffer);
@@ -0,0 +1,63 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : loop_icv.c
+@DESCRIPTION: Routine to read the image of a file outside of voxel_loop
+              the way voxel_loop reads its input files, for programs
+              that read parts of their input files themselves.
+@METHOD     :
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1995 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <float.h>
+#include <minc.h>
+#include <loop_icv.h>
+
+#ifndef TRUE
+#  define TRUE 1
+#  define FALSE 0
+#endif
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_loop_icv
+@INPUT      : mincid - id of an open file
+@OUTPUT     : (none)
+@RETURNS    : Id of an icv attached to the image of the file
+@DESCRIPTION: Creates an icv that reads the image as voxel_loop does:
+              normalized real values as doubles, without converting
+              vectors to scalars, and with values outside of the valid
+              range set to LOOP_ICV_INVALID_DATA.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+int create_loop_icv(int mincid)
+{
+   int icvid;
+
+   icvid = miicv_create();
+   (void) miicv_setint(icvid, MI_ICV_TYPE, NC_DOUBLE);
+   (void) miicv_setint(icvid, MI_ICV_DO_NORM, TRUE);
+   (void) miicv_setint(icvid, MI_ICV_DO_SCALAR, FALSE);
+   (void) miicv_setint(icvid, MI_ICV_DO_FILLVALUE, TRUE);
+   (void) miicv_setdbl(icvid, MI_ICV_FILLVALUE, LOOP_ICV_INVALID_DATA);
+   (void) miicv_attach(icvid, mincid, ncvarid(mincid, MIimage));
+
+   return icvid;
+}
@@ -0,0 +1,23 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : loop_icv.h
+@DESCRIPTION: Header file for loop_icv.c
+@METHOD     :
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1995 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+/* Value given to data that is not valid, as voxel_loop gives it */
+#define LOOP_ICV_INVALID_DATA (-DBL_MAX)
+
+int create_loop_icv(int mincid);
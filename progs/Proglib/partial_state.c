@@ -0,0 +1,279 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : partial_state.c
+@DESCRIPTION: Routines to accumulate and merge the partial states written
+              by mincaverage and mincmath with -partial, so that a
+              reduction over many files can be done on separate sets of
+              files and the results combined (with -merge) in any order.
+@METHOD     : Each state holds the number of values, the sum of their
+              weights, their weighted sum, their weighted sum of squared
+              differences from the mean (updated for each value with
+              Welford's method, as generalized to weights by West), their
+              minimum and maximum, and the number of values left out.
+              Two states are merged with the formula of Chan, Golub and
+              LeVeque for the sums of squared differences.
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1995 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <float.h>
+#include <minc.h>
+#include <partial_state.h>
+
+#ifndef TRUE
+#  define TRUE 1
+#  define FALSE 0
+#endif
+
+/* Value of data that is not valid */
+#define INVALID_DATA -DBL_MAX
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_partial_states
+@INPUT      : num_voxels - number of voxels
+@OUTPUT     : states - PARTIAL_STATE_LENGTH values for each voxel
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to set partial states to those of no values.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void start_partial_states(long num_voxels, double states[])
+{
+   long ivalue;
+
+   for (ivalue=0; ivalue < num_voxels * PARTIAL_STATE_LENGTH; ivalue++) {
+      states[ivalue] = 0.0;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : add_partial_value
+@INPUT      : state - partial state of a voxel
+              value - value to add (-DBL_MAX if it is left out)
+              weight - weight of the value
+@OUTPUT     : state - updated partial state
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to add a value to the partial state of a voxel.
+@METHOD     : 
+@GLOBALS    :
+@CALLS      : add_partial_sums
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void add_partial_value(double state[], double value, double weight)
+{
+   if (value == INVALID_DATA) {
+      state[PARTIAL_INVALID] += 1.0;
+      return;
+   }
+
+   add_partial_sums(&state[PARTIAL_WEIGHT], &state[PARTIAL_SUM],
+                    &state[PARTIAL_M2], value, weight);
+
+   if (state[PARTIAL_COUNT] <= 0.0) {
+      state[PARTIAL_MIN] = value;
+      state[PARTIAL_MAX] = value;
+   }
+   else {
+      if (value < state[PARTIAL_MIN]) state[PARTIAL_MIN] = value;
+      if (value > state[PARTIAL_MAX]) state[PARTIAL_MAX] = value;
+   }
+   state[PARTIAL_COUNT] += 1.0;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : add_partial_sums
+@INPUT      : sum_weight, sum, m2 - sum of the weights, weighted sum and
+                 weighted sum of squared differences from the mean of 
+                 the values so far
+              value - valid value to add
+              weight - weight of the value
+@OUTPUT     : sum_weight, sum, m2 - updated sums
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to add a value to the PARTIAL_WEIGHT, PARTIAL_SUM
+              and PARTIAL_M2 parts of a partial state only, for callers
+              (mincaverage -sdfile) that keep nothing else.
+@METHOD     : The sum of squared differences is updated with the
+              difference of the value from the mean before and after
+              adding it. The first value is taken as the mean before it,
+              so that it adds nothing, whatever the rounding of the new
+              mean.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void add_partial_sums(double *sum_weight, double *sum, double *m2,
+                      double value, double weight)
+{
+   double old_weight, new_weight, new_sum, mean;
+
+   old_weight = *sum_weight;
+   new_weight = old_weight + weight;
+   mean = (old_weight != 0.0) ? *sum / old_weight : value;
+   new_sum = *sum + weight * value;
+   if (new_weight != 0.0)
+      *m2 += weight * (value - mean) * (value - new_sum / new_weight);
+   *sum_weight = new_weight;
+   *sum = new_sum;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : merge_partial_states
+@INPUT      : num_voxels - number of voxels
+              states - partial states
+              parts - partial states to merge into them
+@OUTPUT     : states - merged partial states
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to merge two sets of partial states, giving those
+              of all of the values of both.
+@METHOD     : The sums of squared differences from the two means are
+              added, with the squared difference of the means times the
+              product of the weights over their sum. Merging with the
+              state of no values copies the other state.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void merge_partial_states(long num_voxels, double states[],
+                          double parts[])
+{
+   long ivox;
+   double *state, *part;
+   double weight_a, weight_b, weight, delta, m2;
+
+   for (ivox=0; ivox < num_voxels; ivox++) {
+      state = &states[ivox * PARTIAL_STATE_LENGTH];
+      part = &parts[ivox * PARTIAL_STATE_LENGTH];
+      state[PARTIAL_INVALID] += part[PARTIAL_INVALID];
+      if (part[PARTIAL_COUNT] <= 0.0) continue;
+
+      if (state[PARTIAL_COUNT] <= 0.0) {
+         state[PARTIAL_COUNT] = part[PARTIAL_COUNT];
+         state[PARTIAL_WEIGHT] = part[PARTIAL_WEIGHT];
+         state[PARTIAL_SUM] = part[PARTIAL_SUM];
+         state[PARTIAL_M2] = part[PARTIAL_M2];
+         state[PARTIAL_MIN] = part[PARTIAL_MIN];
+         state[PARTIAL_MAX] = part[PARTIAL_MAX];
+         continue;
+      }
+
+      weight_a = state[PARTIAL_WEIGHT];
+      weight_b = part[PARTIAL_WEIGHT];
+      weight = weight_a + weight_b;
+      m2 = state[PARTIAL_M2] + part[PARTIAL_M2];
+      if ((weight_a != 0.0) && (weight_b != 0.0) && (weight != 0.0)) {
+         delta = part[PARTIAL_SUM] / weight_b -
+            state[PARTIAL_SUM] / weight_a;
+         m2 += delta * delta * (weight_a * (weight_b / weight));
+      }
+      state[PARTIAL_COUNT] += part[PARTIAL_COUNT];
+      state[PARTIAL_WEIGHT] = weight;
+      state[PARTIAL_SUM] += part[PARTIAL_SUM];
+      state[PARTIAL_M2] = m2;
+      if (part[PARTIAL_MIN] < state[PARTIAL_MIN])
+         state[PARTIAL_MIN] = part[PARTIAL_MIN];
+      if (part[PARTIAL_MAX] > state[PARTIAL_MAX])
+         state[PARTIAL_MAX] = part[PARTIAL_MAX];
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : put_partial_state_weight
+@INPUT      : filename - name of a partial-state file that was written
+              total_weight - total weight of the input files
+@OUTPUT     : (none)
+@RETURNS    : MI_NOERROR, or MI_ERROR if the file could not be changed
+@DESCRIPTION: Routine to mark a file as holding partial states, giving
+              the total weight of the files that went into them.
+@METHOD     : The file is opened again once voxel_loop has written it.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+int put_partial_state_weight(char *filename, double total_weight)
+{
+   int mincid, imgid, status, old_ncopts;
+
+   old_ncopts = ncopts; ncopts = 0;
+   status = MI_ERROR;
+   mincid = miopen(filename, NC_WRITE);
+   if (mincid != MI_ERROR) {
+      imgid = ncvarid(mincid, MIimage);
+      if ((imgid != MI_ERROR) && (ncredef(mincid) != MI_ERROR) &&
+          (ncattput(mincid, imgid, PARTIAL_STATE_ATTRIBUTE, NC_DOUBLE,
+                    1, (void *) &total_weight) != MI_ERROR)) {
+         status = MI_NOERROR;
+      }
+      if (miclose(mincid) == MI_ERROR) status = MI_ERROR;
+   }
+   ncopts = old_ncopts;
+
+   return status;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_partial_state_weight
+@INPUT      : filename - name of a minc file
+@OUTPUT     : total_weight - total weight of the files that went into
+                 the partial states
+@RETURNS    : TRUE if the file holds partial states, FALSE otherwise
+@DESCRIPTION: Routine to check that a file holds partial states and to
+              get the total weight of the files that went into them.
+@METHOD     : The last image dimension must be the vector dimension,
+              with one value for each part of the state.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+int get_partial_state_weight(char *filename, double *total_weight)
+{
+   int mincid, imgid, found, old_ncopts;
+   int ndims, dim[MAX_VAR_DIMS];
+   char dimname[MAX_NC_NAME];
+   long vector_length;
+
+   old_ncopts = ncopts; ncopts = 0;
+   found = FALSE;
+   mincid = miopen(filename, NC_NOWRITE);
+   if (mincid != MI_ERROR) {
+      imgid = ncvarid(mincid, MIimage);
+      if ((imgid != MI_ERROR) &&
+          (ncvarinq(mincid, imgid, NULL, NULL, &ndims, dim, NULL) 
+           != MI_ERROR) && (ndims > 1) &&
+          (ncdiminq(mincid, dim[ndims-1], dimname, &vector_length)
+           != MI_ERROR)) {
+         found = (strcmp(dimname, MIvector_dimension) == 0) &&
+            (vector_length == PARTIAL_STATE_LENGTH) &&
+            (miattget1(mincid, imgid, PARTIAL_STATE_ATTRIBUTE, NC_DOUBLE,
+                       (void *) total_weight) != MI_ERROR);
+      }
+      (void) miclose(mincid);
+   }
+   ncopts = old_ncopts;
+
+   return found;
+}
@@ -0,0 +1,46 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : partial_state.h
+@DESCRIPTION: Header file for partial_state.c
+@METHOD     :
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1995 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+/* A partial state holds what is needed at each voxel to combine the
+   values of a set of files with those of another set: it is a vector of
+   PARTIAL_STATE_LENGTH values, stored along the vector dimension of a
+   partial-state file. */
+#define PARTIAL_STATE_LENGTH 7
+
+#define PARTIAL_COUNT   0    /* Number of values */
+#define PARTIAL_WEIGHT  1    /* Sum of their weights */
+#define PARTIAL_SUM     2    /* Weighted sum of the values */
+#define PARTIAL_M2      3    /* Weighted sum of squared differences
+                                from their mean */
+#define PARTIAL_MIN     4    /* Minimum value (0 if there are none) */
+#define PARTIAL_MAX     5    /* Maximum value (0 if there are none) */
+#define PARTIAL_INVALID 6    /* Number of values that were left out */
+
+/* Attribute of the image variable of partial-state files, giving the
+   total weight of the input files that went into it */
+#define PARTIAL_STATE_ATTRIBUTE "partial_state_weight"
+
+void start_partial_states(long num_voxels, double states[]);
+void add_partial_value(double state[], double value, double weight);
+void add_partial_sums(double *sum_weight, double *sum, double *m2,
+                      double value, double weight);
+void merge_partial_states(long num_voxels, double states[],
+                          double parts[]);
+int put_partial_state_weight(char *filename, double total_weight);
+int get_partial_state_weight(char *filename, double *total_weight);
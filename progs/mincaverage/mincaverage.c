@@ -105,6 +105,8 @@
 #include <ParseArgv.h>
 #include <time_stamp.h>
 #include <voxel_loop.h>
+#include <partial_state.h>
+#include <fused_files.h>
 
 /* Constants */
 
@@ -119,6 +121,17 @@
 
 #define DEFAULT_BOOLEAN -1
 
+/* Value for options that are not given */
+#define UNSET_VALUE -DBL_MAX
+
+/* Number of values in the transposition buffer of do_order_statistic */
+#define ORDER_TILE_VALUES 32768
+
+/* Statistics computed at each voxel */
+typedef enum {
+   MEAN_STAT = 0, MEDIAN_STAT, TRIMMED_MEAN_STAT, PERCENTILE_STAT
+} Statistic;
+
 /* Double_Array structure */
 typedef struct {
    int numvalues;
@@ -138,6 +151,17 @@ typedef struct {
    int num_weights;
    double *weights;
    double weight_thresh;
+   Statistic statistic;
+   double percentile;        /* For PERCENTILE_STAT */
+   double trim_fraction;     /* For TRIMMED_MEAN_STAT */
+   Fused_Files fused;        /* Input files read by do_order_statistic */
+   double **file_data;       /* Values of each file for a buffer */
+   long file_data_alloc;
+   double *tile;             /* Values of a few voxels for all files */
+   int partial;              /* Write partial states */
+   int merge;                /* Merge partial states */
+   double *states;           /* Partial states of a buffer */
+   long states_alloc;
 } Average_Data;
 
 typedef struct {
@@ -168,7 +192,41 @@ static void finish_average(void *caller_data, long num_voxels,
                           int output_num_buffers, int output_vector_length,
                           double *output_data[],
                           Loop_Info *loop_info);
+static double input_weight(Average_Data *average_data, 
+                           Loop_Info *loop_info);
+static void partial_average(void *caller_data, long num_voxels, 
+                            int input_num_buffers, int input_vector_length,
+                            double *input_data[],
+                            int output_num_buffers, 
+                            int output_vector_length,
+                            double *output_data[],
+                            Loop_Info *loop_info);
+static void merge_average(void *caller_data, long num_voxels, 
+                          int input_num_buffers, int input_vector_length,
+                          double *input_data[],
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[],
+                          Loop_Info *loop_info);
+static void start_partial(void *caller_data, long num_voxels, 
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[],
+                          Loop_Info *loop_info);
+static void finish_partial(void *caller_data, long num_voxels, 
+                           int output_num_buffers, int output_vector_length,
+                           double *output_data[],
+                           Loop_Info *loop_info);
 static int get_double_list(char *dst, char *key, char *nextarg);
+static void do_order_statistic(void *caller_data, long num_voxels, 
+                               int input_num_buffers, 
+                               int input_vector_length,
+                               double *input_data[],
+                               int output_num_buffers, 
+                               int output_vector_length,
+                               double *output_data[],
+                               Loop_Info *loop_info);
+static double order_statistic(Average_Data *average_data, 
+                              int nvalues, double *values);
+static double select_value(double *values, int nvalues, int k);
 
 /* Argument variables */
 static int clobber = FALSE;
@@ -198,6 +256,11 @@ static double weight_thresh_fraction = 0.0;
 static Double_Array weights = {0, NULL};
 static int width_weighted = FALSE;
 static char *filelist = NULL;
+static int median = FALSE;
+static double trim_fraction = UNSET_VALUE;
+static double percentile = UNSET_VALUE;
+static int partial = FALSE;
+static int merge = FALSE;
 #if MINC2
 static int minc2_format = FALSE;
 #endif /* MINC2 */
@@ -286,6 +349,16 @@ ArgvInfo argTable[] = {
        "Minimum cumulative weight needed for calculating the average or sd." },
    {"-min_weight_fraction", ARGV_FLOAT, (char *) 1, (char *) &weight_thresh_fraction,
        "Same as -min_weight, but specified as a fraction of the sum of the input weights (or the number of input volumes, if no weight is specified)." },
+   {"-median", ARGV_CONSTANT, (char *) TRUE, (char *) &median,
+       "Compute the median instead of the average."},
+   {"-trimmed_mean", ARGV_FLOAT, (char *) 1, (char *) &trim_fraction,
+       "Compute the mean without this fraction of the values at each end."},
+   {"-percentile", ARGV_FLOAT, (char *) 1, (char *) &percentile,
+       "Compute this percentile (0 to 100) instead of the average."},
+   {"-partial", ARGV_CONSTANT, (char *) TRUE, (char *) &partial,
+       "Write the partial state of the average, to be merged later."},
+   {"-merge", ARGV_CONSTANT, (char *) TRUE, (char *) &merge,
+       "Merge input files written with -partial."},
    {NULL, ARGV_END, NULL, NULL, NULL}
 };
 
@@ -300,9 +373,11 @@ int main(int argc, char *argv[])
    Average_Data average_data;
    Loop_Options *loop_options;
    double *vol_mean, vol_total, nvols, global_mean, total_weight;
+   double file_weight;
+   VoxelFunction average_function;
    int ifile, iweight;
    int weights_specified;
-   int first_mincid, dimid, varid, dim[MAX_VAR_DIMS];
+   int first_mincid, mincid, dimid, varid, dim[MAX_VAR_DIMS];
    int ndims;
    long start, count;
    int old_ncopts;
@@ -366,6 +441,73 @@ int main(int argc, char *argv[])
    /* Are we averaging over a dimension? */
    average_data.averaging_over_dimension = (averaging_dimension != NULL);
 
+   /* Check for order statistics */
+   if ((median != 0) + (trim_fraction != UNSET_VALUE) + 
+       (percentile != UNSET_VALUE) > 1) {
+      (void) fprintf(stderr, 
+         "%s: Specify only one of -median, -trimmed_mean or -percentile.\n",
+                     argv[0]);
+      exit(EXIT_FAILURE);
+   }
+   average_data.statistic = MEAN_STAT;
+   if (median) {
+      average_data.statistic = MEDIAN_STAT;
+   }
+   else if (trim_fraction != UNSET_VALUE) {
+      if ((trim_fraction < 0.0) || (trim_fraction >= 0.5)) {
+         (void) fprintf(stderr, 
+            "%s: The -trimmed_mean fraction must be from 0 to below 0.5.\n",
+                        argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      average_data.statistic = TRIMMED_MEAN_STAT;
+      average_data.trim_fraction = trim_fraction;
+   }
+   else if (percentile != UNSET_VALUE) {
+      if ((percentile < 0.0) || (percentile > 100.0)) {
+         (void) fprintf(stderr, 
+            "%s: The -percentile must be from 0 to 100.\n", argv[0]);
+         exit(EXIT_FAILURE);
+      }
+      average_data.statistic = PERCENTILE_STAT;
+      average_data.percentile = percentile;
+   }
+   if ((average_data.statistic != MEAN_STAT) &&
+       ((sdfile != NULL) || (weightfile != NULL) || 
+        (weights.numvalues > 0) || width_weighted ||
+        (averaging_dimension != NULL))) {
+      (void) fprintf(stderr, 
+         "%s: Do not use -sdfile, -weightfile, -weights, -width_weighted\n"
+         "or -avgdim with -median, -trimmed_mean or -percentile.\n",
+                     argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Check for partial states */
+   if ((partial || merge) && (average_data.statistic != MEAN_STAT)) {
+      (void) fprintf(stderr, 
+         "%s: Do not use -partial or -merge with -median, -trimmed_mean\n"
+         "or -percentile.\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+   if (partial && 
+       ((sdfile != NULL) || (weightfile != NULL) || (normalize == TRUE) ||
+        (weight_thresh > 0.0) || (weight_thresh_fraction > 0.0))) {
+      (void) fprintf(stderr, 
+         "%s: Do not use -sdfile, -weightfile, -normalize, -min_weight\n"
+         "or -min_weight_fraction with -partial.\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+   if (merge && 
+       ((normalize == TRUE) || binarize || (ignore_below != -DBL_MAX) ||
+        (ignore_above != DBL_MAX) || (weights.numvalues > 0) || 
+        width_weighted || (averaging_dimension != NULL))) {
+      (void) fprintf(stderr, 
+         "%s: Do not use -normalize, -binarize, -ignore_below, -ignore_above,\n"
+         "-weights, -width_weighted or -avgdim with -merge.\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
    /* Check for weights and width-weighting */
    weights_specified = weights.numvalues > 0;
    if (weights_specified && width_weighted) {
@@ -487,8 +629,34 @@ int main(int argc, char *argv[])
       }
    }
 
-   /* If we don't have weights, each input will get a weight of 1 */
-   if (average_data.num_weights == 0)
+   /* If we don't have weights, each input will get a weight of 1, or
+      with -avgdim each value along the dimension of each input. Files
+      of partial states have the total weight of the files that went 
+      into them. */
+   if (merge) {
+      total_weight = 0.0;
+      for (ifile=0; ifile < nfiles; ifile++) {
+         if (!get_partial_state_weight(infiles[ifile], &file_weight)) {
+            (void) fprintf(stderr, 
+               "%s: File %s was not written with -partial.\n",
+                           argv[0], infiles[ifile]);
+            exit(EXIT_FAILURE);
+         }
+         total_weight += file_weight;
+      }
+   }
+   else if ((average_data.num_weights == 0) && 
+            (averaging_dimension != NULL)) {
+      total_weight = 0.0;
+      for (ifile=0; ifile < nfiles; ifile++) {
+         mincid = miopen(infiles[ifile], NC_NOWRITE);
+         dimid = ncdimid(mincid, averaging_dimension);
+         (void) ncdiminq(mincid, dimid, NULL, &count);
+         (void) miclose(mincid);
+         total_weight += count;
+      }
+   }
+   else if (average_data.num_weights == 0)
        total_weight = nfiles;
 
    /* Check the cumulative weight thresholding */
@@ -619,9 +787,60 @@ int main(int argc, char *argv[])
       }
    }
 
+   /* Do order statistics. All of the files are read for each buffer of
+      the first file, so voxel_loop's buffers are made small enough for 
+      the buffers of all of the files to fit in the maximum size. */
+   if (average_data.statistic != MEAN_STAT) {
+      open_fused_files(&average_data.fused, nfiles, infiles, 
+                       check_dimensions);
+      if (verbose && (average_data.fused.num_open < nfiles - 1)) {
+         (void) fprintf(stderr, 
+            "%s: %d input files are opened again for each buffer; a larger\n"
+            "-max_buffer_size_in_kb gives fewer buffers.\n", 
+                        argv[0], nfiles - 1 - average_data.fused.num_open);
+      }
+      average_data.file_data = malloc(sizeof(double *) * nfiles);
+      for (ifile=0; ifile < nfiles; ifile++) {
+         average_data.file_data[ifile] = NULL;
+      }
+      average_data.file_data_alloc = 0;
+      average_data.tile = malloc(sizeof(double) * 
+                                 ((nfiles < ORDER_TILE_VALUES) ? 
+                                  ORDER_TILE_VALUES : nfiles));
+      loop_options = create_loop_options();
+      set_loop_verbose(loop_options, verbose);
+      set_loop_clobber(loop_options, clobber);
+#if MINC2
+      set_loop_v2format(loop_options, minc2_format);
+#endif /* MINC2 */
+      set_loop_datatype(loop_options, datatype, is_signed, 
+                        valid_range[0], valid_range[1]);
+      set_loop_copy_all_header(loop_options, copy_all_header);
+      set_loop_buffer_size(loop_options, 
+                           (long) 1024 * max_buffer_size_in_kb * 2 / 
+                           (nfiles + 1));
+      set_loop_check_dim_info(loop_options, check_dimensions);
+      voxel_loop(1, infiles, 1, outfiles, arg_string, loop_options,
+                 do_order_statistic, (void *) &average_data);
+      free_loop_options(loop_options);
+      close_fused_files(&average_data.fused);
+      for (ifile=1; ifile < nfiles; ifile++) {
+         if (average_data.file_data[ifile] != NULL)
+            free(average_data.file_data[ifile]);
+      }
+      free(average_data.file_data);
+      free(average_data.tile);
+      free(average_data.norm_factor);
+      exit(EXIT_SUCCESS);
+   }
+
    /* Do averaging */
    average_data.need_sd = (sdfile != NULL);
    average_data.need_weight = (weightfile != NULL);
+   average_data.partial = partial;
+   average_data.merge = merge;
+   average_data.states = NULL;
+   average_data.states_alloc = 0;
    loop_options = create_loop_options();
    if (first_mincid != MI_ERROR) {
       set_loop_first_input_mincid(loop_options, first_mincid);
@@ -629,20 +848,48 @@ int main(int argc, char *argv[])
    }
    set_loop_verbose(loop_options, verbose);
    set_loop_clobber(loop_options, clobber);
-   set_loop_datatype(loop_options, datatype, is_signed, 
-                     valid_range[0], valid_range[1]);
-   set_loop_accumulate(loop_options, TRUE, 1, start_average, finish_average);
+   if (partial) {
+      set_loop_datatype(loop_options, NC_DOUBLE, TRUE, 0.0, 0.0);
+   }
+   else {
+      set_loop_datatype(loop_options, datatype, is_signed, 
+                        valid_range[0], valid_range[1]);
+   }
+
+   /* Partial states are accumulated in average_data, since the output
+      buffers of a merge have only one value for each voxel */
+   if (partial || merge) {
+      set_loop_accumulate(loop_options, TRUE, 0, 
+                          start_partial, finish_partial);
+      set_loop_output_vector_size(loop_options, 
+                                  partial ? PARTIAL_STATE_LENGTH : 1);
+      average_function = merge ? merge_average : partial_average;
+   }
+   else {
+      set_loop_accumulate(loop_options, TRUE, 1, 
+                          start_average, finish_average);
+      average_function = do_average;
+   }
    set_loop_copy_all_header(loop_options, copy_all_header);
    set_loop_dimension(loop_options, averaging_dimension);
    set_loop_buffer_size(loop_options, (long) 1024 * max_buffer_size_in_kb);
    set_loop_check_dim_info(loop_options, check_dimensions);
    voxel_loop(nfiles, infiles, nout, outfiles, arg_string, loop_options,
-              do_average, (void *) &average_data);
+              average_function, (void *) &average_data);
    free_loop_options(loop_options);
 
+   /* Mark the file of partial states */
+   if (partial && 
+       (put_partial_state_weight(outfiles[0], total_weight) == MI_ERROR)) {
+      (void) fprintf(stderr, "%s: Error marking %s as partial states.\n",
+                     argv[0], outfiles[0]);
+      exit(EXIT_FAILURE);
+   }
+
    /* Free stuff */
    free(average_data.weights);
    free(average_data.norm_factor);
+   free(average_data.states);
 
    exit(EXIT_SUCCESS);
 }
@@ -783,11 +1030,16 @@ static void find_mincfile_range(int mincid, double *minimum, double *maximum)
 @RETURNS    : (nothing)
 @DESCRIPTION: Routine to loop through an array of voxels and perform averaging
               of across volumes.
-@METHOD     : 
+@METHOD     : The buffers hold the sums of the weights and of the weighted
+              values. With an sd file, a third buffer holds the weighted
+              sum of squared differences from the mean, and each value is
+              added with add_partial_sums, as add_partial_value does for
+              -partial, so that the results are the same as those of
+              -partial and -merge.
 @GLOBALS    : 
-@CALLS      : 
+@CALLS      : add_partial_sums
 @CREATED    : April 25, 1995 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - sd from the sums of partial states
 ---------------------------------------------------------------------------- */
 static void do_average(void *caller_data, long num_voxels, 
                        int input_num_buffers, int input_vector_length,
@@ -800,7 +1052,6 @@ static void do_average(void *caller_data, long num_voxels,
    Average_Data *average_data;
    long ivox;
    double value;
-   int curfile, curindex;
    int num_out;
    double norm_factor, binmin, binmax, weight, ignore_below, ignore_above;
    int binarize;
@@ -820,28 +1071,9 @@ static void do_average(void *caller_data, long num_voxels,
    }
 
    /* Get the normalization factor and binarization range */
-   curfile = get_info_current_file(loop_info);
-   curindex = get_info_current_index(loop_info);
-   norm_factor = average_data->norm_factor[curfile];
-   if ((average_data->num_weights <= 0) || (average_data->weights == NULL)) {
-      weight = 1.0;
-   }
-   else {
-      if (average_data->averaging_over_dimension) {
-         if (curindex >= average_data->num_weights) {
-            (void) fprintf(stderr, "Internal error in index!\n");
-            exit(EXIT_FAILURE);
-         }
-         weight = average_data->weights[curindex];
-      }
-      else {
-         if (curfile >= average_data->num_weights) {
-            (void) fprintf(stderr, "Internal error in file number!\n");
-            exit(EXIT_FAILURE);
-         }
-         weight = average_data->weights[curfile];
-      }
-   }
+   norm_factor = 
+      average_data->norm_factor[get_info_current_file(loop_info)];
+   weight = input_weight(average_data, loop_info);
    binarize = average_data->binarize;
    binmin = average_data->binrange[0];
    binmax = average_data->binrange[1];
@@ -856,10 +1088,14 @@ static void do_average(void *caller_data, long num_voxels,
       }
       if (value != -DBL_MAX && value > ignore_below && value < ignore_above ) {
          value *= norm_factor;
-         output_data[0][ivox] += weight;
-         output_data[1][ivox] += value * weight;
-         if (average_data->need_sd)
-            output_data[2][ivox] += value * value * weight;
+         if (average_data->need_sd) {
+            add_partial_sums(&output_data[0][ivox], &output_data[1][ivox],
+                             &output_data[2][ivox], value, weight);
+         }
+         else {
+            output_data[0][ivox] += weight;
+            output_data[1][ivox] += value * weight;
+         }
       }
    }
 
@@ -918,11 +1154,11 @@ static void start_average(void *caller_data, long num_voxels,
 @OUTPUT     : Standard for voxel loop
 @RETURNS    : (nothing)
 @DESCRIPTION: Finish routine for averaging.
-@METHOD     : 
+@METHOD     : See do_average for what the buffers hold.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : April 25, 1995 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - sd from the sums of partial states
 ---------------------------------------------------------------------------- */
 static void finish_average(void *caller_data, long num_voxels, 
                           int output_num_buffers, int output_vector_length,
@@ -933,7 +1169,7 @@ static void finish_average(void *caller_data, long num_voxels,
    Average_Data *average_data;
    long ivox;
    int num_out, i_weight;
-   double sum0, sum1, sum2, value;
+   double sum0, sum1, m2, value;
 
    /* Get pointer to window info */
    average_data = (Average_Data *) caller_data;
@@ -958,9 +1194,9 @@ static void finish_average(void *caller_data, long num_voxels,
       if (sum0 > 0.0 && sum0 >= average_data->weight_thresh) {
          output_data[0][ivox] = sum1 / sum0;
          if (average_data->need_sd) {
-            sum2 = output_data[2][ivox];
+            m2 = output_data[2][ivox];
             if (sum0 > 1.0) {
-               value = (sum2 - sum1*sum1 / sum0) / (sum0 - 1.0);
+               value = m2 / (sum0 - 1.0);
                if (value > 0.0)
                   value = sqrt(value);
                else
@@ -986,6 +1222,266 @@ static void finish_average(void *caller_data, long num_voxels,
    return;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : input_weight
+@INPUT      : average_data - averaging information
+              loop_info - voxel_loop information
+@OUTPUT     : (none)
+@RETURNS    : Weight of the values being accumulated
+@DESCRIPTION: Routine to get the weight of the current input file, or of
+              the current index of the averaging dimension.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : April 25, 1995 (Peter Neelin)
+@MODIFIED   : October 16, 2026 - moved out of do_average
+---------------------------------------------------------------------------- */
+static double input_weight(Average_Data *average_data, 
+                           Loop_Info *loop_info)
+{
+   int curfile, curindex;
+
+   if ((average_data->num_weights <= 0) || (average_data->weights == NULL)) {
+      return 1.0;
+   }
+
+   curfile = get_info_current_file(loop_info);
+   curindex = get_info_current_index(loop_info);
+   if (average_data->averaging_over_dimension) {
+      if (curindex >= average_data->num_weights) {
+         (void) fprintf(stderr, "Internal error in index!\n");
+         exit(EXIT_FAILURE);
+      }
+      return average_data->weights[curindex];
+   }
+   else {
+      if (curfile >= average_data->num_weights) {
+         (void) fprintf(stderr, "Internal error in file number!\n");
+         exit(EXIT_FAILURE);
+      }
+      return average_data->weights[curfile];
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : partial_average
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to add the values of an input file to the partial
+              states of the average (-partial).
+@METHOD     : Values are binarized, left out and normalized as in 
+              do_average. Values that are left out are counted as such.
+@GLOBALS    : 
+@CALLS      : add_partial_value
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void partial_average(void *caller_data, long num_voxels, 
+                            int input_num_buffers, int input_vector_length,
+                            double *input_data[],
+                            int output_num_buffers, 
+                            int output_vector_length,
+                            double *output_data[],
+                            Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Average_Data *average_data;
+   long ivox;
+   double value, *states;
+   double norm_factor, binmin, binmax, weight, ignore_below, ignore_above;
+   int binarize;
+
+   /* Get pointer to window info */
+   average_data = (Average_Data *) caller_data;
+
+   /* Check arguments */
+   if (input_vector_length != 1) {
+      (void) fprintf(stderr, "Input files must be scalar for -partial.\n");
+      exit(EXIT_FAILURE);
+   }
+   if ((input_num_buffers != 1) || (output_num_buffers != 1)) {
+      (void) fprintf(stderr, "Bad arguments to partial_average!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Get the normalization factor and binarization range */
+   norm_factor = 
+      average_data->norm_factor[get_info_current_file(loop_info)];
+   weight = input_weight(average_data, loop_info);
+   binarize = average_data->binarize;
+   binmin = average_data->binrange[0];
+   binmax = average_data->binrange[1];
+   ignore_below = average_data->ignore_below;
+   ignore_above = average_data->ignore_above;
+
+   /* Loop through the voxels */
+   states = average_data->states;
+   for (ivox=0; ivox < num_voxels; ivox++) {
+      value = input_data[0][ivox];
+      if (binarize) {
+         value = ( ((value >= binmin) && (value <= binmax)) ? 1.0 : 0.0 );
+      }
+      if (value != -DBL_MAX && value > ignore_below && value < ignore_above )
+         value *= norm_factor;
+      else
+         value = -DBL_MAX;
+      add_partial_value(&states[ivox * PARTIAL_STATE_LENGTH], value, weight);
+   }
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : merge_average
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to merge the partial states of an input file 
+              (-merge).
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : merge_partial_states
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void merge_average(void *caller_data, long num_voxels, 
+                          int input_num_buffers, int input_vector_length,
+                          double *input_data[],
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[],
+                          Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Average_Data *average_data;
+
+   /* Get pointer to window info */
+   average_data = (Average_Data *) caller_data;
+
+   /* Check arguments */
+   if ((input_num_buffers != 1) || 
+       (input_vector_length != PARTIAL_STATE_LENGTH)) {
+      (void) fprintf(stderr, "Bad arguments to merge_average!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   merge_partial_states(num_voxels, average_data->states, input_data[0]);
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_partial
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Start routine for -partial and -merge.
+@METHOD     : The partial states are kept in average_data, which is made
+              big enough for the buffer.
+@GLOBALS    : 
+@CALLS      : start_partial_states
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void start_partial(void *caller_data, long num_voxels, 
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[],
+                          Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Average_Data *average_data;
+   long nvalues;
+
+   /* Get pointer to window info */
+   average_data = (Average_Data *) caller_data;
+
+   /* Get space for the states */
+   nvalues = num_voxels * PARTIAL_STATE_LENGTH;
+   if (nvalues > average_data->states_alloc) {
+      free(average_data->states);
+      average_data->states = malloc(sizeof(*average_data->states) * nvalues);
+      if (average_data->states == NULL) {
+         (void) fprintf(stderr, "Out of memory for partial states.\n");
+         exit(EXIT_FAILURE);
+      }
+      average_data->states_alloc = nvalues;
+   }
+
+   start_partial_states(num_voxels, average_data->states);
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : finish_partial
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Finish routine for -partial and -merge.
+@METHOD     : With -partial, the states are copied to the output. 
+              Otherwise, the mean, sd and weight are computed from them as
+              in finish_average.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void finish_partial(void *caller_data, long num_voxels, 
+                           int output_num_buffers, int output_vector_length,
+                           double *output_data[],
+                           Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Average_Data *average_data;
+   long ivox, ivalue;
+   int num_out, i_weight;
+   double *state, weight, mean, sd;
+
+   /* Get pointer to window info */
+   average_data = (Average_Data *) caller_data;
+
+   /* Check arguments */
+   num_out = 1 + 
+       ( average_data->need_sd != 0 ) + 
+       ( average_data->need_weight != 0 );
+   if ((output_num_buffers != num_out) ||
+       (output_vector_length != 
+        (average_data->partial ? PARTIAL_STATE_LENGTH : 1))) {
+      (void) fprintf(stderr, "Bad arguments to finish_partial!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Copy the partial states */
+   if (average_data->partial) {
+      for (ivalue=0; ivalue < num_voxels * PARTIAL_STATE_LENGTH; ivalue++) {
+         output_data[0][ivalue] = average_data->states[ivalue];
+      }
+      return;
+   }
+
+   /* Loop through the voxels */
+   i_weight = 1 + ( average_data->need_sd != 0 );
+   for (ivox=0; ivox < num_voxels; ivox++) {
+      state = &average_data->states[ivox * PARTIAL_STATE_LENGTH];
+      weight = state[PARTIAL_WEIGHT];
+      mean = sd = 0.0;
+      if (weight > 0.0 && weight >= average_data->weight_thresh) {
+         mean = state[PARTIAL_SUM] / weight;
+         if (weight > 1.0) {
+            sd = state[PARTIAL_M2] / (weight - 1.0);
+            sd = (sd > 0.0) ? sqrt(sd) : 0.0;
+         }
+      }
+      output_data[0][ivox] = mean;
+      if (average_data->need_sd)
+         output_data[1][ivox] = sd;
+      if (average_data->need_weight)
+         output_data[i_weight][ivox] = weight;
+   }
+
+   return;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : get_double_list
 @INPUT      : dst - client data passed by ParseArgv
@@ -1075,3 +1571,229 @@ static int get_double_list(char *dst, char *key, char *nextarg)
 
    return TRUE;
 }
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : do_order_statistic
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine computing a median, trimmed mean or percentile
+              across the files for a buffer of the first file.
+@METHOD     : The same part of each of the other files is read into a 
+              buffer of its own. A few voxels at a time, the values of all
+              of the files are then copied into a tile with the values of
+              each voxel together, leaving out the values that would not
+              be averaged, and the statistic is found by selection in the 
+              tile.
+@GLOBALS    : 
+@CALLS      : order_statistic
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void do_order_statistic(void *caller_data, long num_voxels, 
+                               int input_num_buffers, 
+                               int input_vector_length,
+                               double *input_data[],
+                               int output_num_buffers, 
+                               int output_vector_length,
+                               double *output_data[],
+                               Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Average_Data *average_data;
+   long nvalues, ivox, tile_start;
+   long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+   int ifile, nfiles, ntile, itile, num_valid;
+   double value, *values, *file_values;
+   double norm_factor, binmin, binmax, ignore_below, ignore_above;
+   int binarize;
+
+   /* Get pointer to window info */
+   average_data = (Average_Data *) caller_data;
+
+   /* Check arguments */
+   if ((input_num_buffers != 1) || (output_num_buffers != 1) || 
+       (output_vector_length != input_vector_length)) {
+      (void) fprintf(stderr, "Bad arguments to do_order_statistic!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Read the same part of the other files */
+   nfiles = average_data->fused.num_files;
+   nvalues = num_voxels * input_vector_length;
+   if (nvalues > average_data->file_data_alloc) {
+      for (ifile=1; ifile < nfiles; ifile++) {
+         if (average_data->file_data[ifile] != NULL)
+            free(average_data->file_data[ifile]);
+         average_data->file_data[ifile] = malloc(sizeof(double) * nvalues);
+         if (average_data->file_data[ifile] == NULL) {
+            (void) fprintf(stderr, "Out of memory for file buffers.\n");
+            exit(EXIT_FAILURE);
+         }
+      }
+      average_data->file_data_alloc = nvalues;
+   }
+   average_data->file_data[0] = input_data[0];
+   get_info_shape(loop_info, MAX_VAR_DIMS, start, count);
+   for (ifile=1; ifile < nfiles; ifile++) {
+      read_fused_file(&average_data->fused, ifile, start, count,
+                      average_data->file_data[ifile]);
+   }
+
+   binarize = average_data->binarize;
+   binmin = average_data->binrange[0];
+   binmax = average_data->binrange[1];
+   ignore_below = average_data->ignore_below;
+   ignore_above = average_data->ignore_above;
+
+   /* Loop through the voxels, a tile at a time */
+   ntile = ORDER_TILE_VALUES / nfiles;
+   if (ntile < 1) ntile = 1;
+   for (tile_start=0; tile_start < nvalues; tile_start += ntile) {
+      if (ntile > nvalues - tile_start) ntile = (int) (nvalues - tile_start);
+
+      /* Copy the values into the tile, marking those that are not used
+         as invalid */
+      for (ifile=0; ifile < nfiles; ifile++) {
+         file_values = &average_data->file_data[ifile][tile_start];
+         norm_factor = average_data->norm_factor[ifile];
+         for (itile=0; itile < ntile; itile++) {
+            value = file_values[itile];
+            if (binarize) {
+               value = ( ((value >= binmin) && (value <= binmax)) ? 
+                         1.0 : 0.0 );
+            }
+            if (value != -DBL_MAX && value > ignore_below && 
+                value < ignore_above)
+               value *= norm_factor;
+            else
+               value = -DBL_MAX;
+            average_data->tile[itile * nfiles + ifile] = value;
+         }
+      }
+
+      /* Get the statistic of the valid values of each voxel */
+      for (itile=0; itile < ntile; itile++) {
+         values = &average_data->tile[itile * nfiles];
+         num_valid = 0;
+         for (ifile=0; ifile < nfiles; ifile++) {
+            if (values[ifile] != -DBL_MAX)
+               values[num_valid++] = values[ifile];
+         }
+         ivox = tile_start + itile;
+         if ((num_valid > 0) && (num_valid >= average_data->weight_thresh))
+            output_data[0][ivox] = 
+               order_statistic(average_data, num_valid, values);
+         else
+            output_data[0][ivox] = 0.0;
+      }
+   }
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : order_statistic
+@INPUT      : average_data - statistic to compute
+              nvalues - number of values
+              values - values of a voxel
+@OUTPUT     : values - values reordered
+@RETURNS    : Median, trimmed mean or percentile of the values
+@DESCRIPTION: Computes an order statistic of the values of a voxel. 
+              Percentiles are interpolated linearly between the two 
+              nearest values, so the median of an even number of values
+              is the mean of the two middle ones. The trimmed mean leaves
+              out the given fraction of the values, rounded down, at each
+              end.
+@METHOD     : The values are only partly ordered, by select_value.
+@GLOBALS    : 
+@CALLS      : select_value
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static double order_statistic(Average_Data *average_data, 
+                              int nvalues, double *values)
+{
+   double position, fraction, low, high, sum;
+   int k, ntrim, ivalue;
+
+   if (average_data->statistic == TRIMMED_MEAN_STAT) {
+      ntrim = (int) (average_data->trim_fraction * nvalues);
+      if (ntrim > 0) {
+         (void) select_value(values, nvalues, ntrim);
+         (void) select_value(&values[ntrim], nvalues - ntrim, 
+                             nvalues - 2 * ntrim - 1);
+      }
+      sum = 0.0;
+      for (ivalue=ntrim; ivalue < nvalues - ntrim; ivalue++)
+         sum += values[ivalue];
+      return sum / (nvalues - 2 * ntrim);
+   }
+
+   /* Get the position of the percentile among the sorted values */
+   if (average_data->statistic == MEDIAN_STAT)
+      position = 0.5 * (nvalues - 1);
+   else
+      position = average_data->percentile / 100.0 * (nvalues - 1);
+   k = (int) position;
+   if (k > nvalues - 1) k = nvalues - 1;
+   fraction = position - k;
+
+   /* Select the value below it, and the smallest value above that is the 
+      one after it */
+   low = select_value(values, nvalues, k);
+   if ((fraction <= 0.0) || (k >= nvalues - 1))
+      return low;
+   high = values[k+1];
+   for (ivalue=k+2; ivalue < nvalues; ivalue++) {
+      if (values[ivalue] < high) high = values[ivalue];
+   }
+   return (1.0 - fraction) * low + fraction * high;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : select_value
+@INPUT      : values - values to select from
+              nvalues - number of values
+              k - index of the value in sorted order
+@OUTPUT     : values - values reordered
+@RETURNS    : The k'th smallest value
+@DESCRIPTION: Finds the k'th smallest value (counting from 0) without 
+              sorting. The values are reordered so that the ones before 
+              index k are no bigger than it and the ones after are no 
+              smaller.
+@METHOD     : Wirth's selection algorithm, partitioning around the value
+              at index k until the part holding index k has one value.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static double select_value(double *values, int nvalues, int k)
+{
+   int left, right, i, j;
+   double pivot, temp;
+
+   left = 0;
+   right = nvalues - 1;
+   while (left < right) {
+      pivot = values[k];
+      i = left;
+      j = right;
+      do {
+         while (values[i] < pivot) i++;
+         while (pivot < values[j]) j--;
+         if (i <= j) {
+            temp = values[i];
+            values[i] = values[j];
+            values[j] = temp;
+            i++;
+            j--;
+         }
+      } while (i <= j);
+      if (j < k) left = i;
+      if (k < i) right = j;
+   }
+
+   return values[k];
+}
@@ -0,0 +1,1252 @@
+/* Bytecode compiler and interpreter for minccalc expressions.
+
+   The expression tree is compiled once into a flat list of instructions
+   working on registers, where each register holds eval_width values.
+   Each instruction loops over all of the values of a block, so that the
+   cost of walking the tree, allocating temporaries and dispatching on
+   node types is paid once per block rather than once per node per block.
+
+   The compiled program gives the same results as eval_scalar:
+     - Elementwise operations are done on all values of a block; masks
+       (eval_flags) only matter for stores into the symbol table and
+       for index checks, and these honour them as eval_scalar does.
+     - if-else is compiled into forward jumps, so that a consequent is
+       skipped when no voxel needs it, and mask slots that are set at
+       run time as eval_scalar sets eval_flags. An if-else with an else
+       part inside another if is not compiled, since eval_scalar lets
+       voxels masked by the enclosing if take its else part.
+     - Reading a symbol reads its register when the value is used, which
+       matches eval_scalar sharing the symbol's scalar by reference.
+   Constants are folded, repeated elementwise operations on the same
+   operands are computed once and for loops and vector generators over
+   vectors of known length are unrolled. Anything that the compiler
+   does not handle (vector symbols other than A, vector if-else, ranges
+   with varying ends, else parts of nested ifs, programs of more than
+   MAX_INSTRUCTIONS instructions) makes compile_program return NULL, in
+   which case the tree is evaluated with eval_scalar as before.
+
+   Copyright David Leonard and Andrew Janke, 2000. All rights reserved. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include "node.h"
+
+#ifndef TRUE
+#  define TRUE 1
+#endif
+
+#ifndef FALSE
+#  define FALSE 0
+#endif
+
+#define INVALID_VALUE -DBL_MAX
+
+/* Limits on the size of a compiled program (loops are unrolled) */
+#define MAX_INSTRUCTIONS 100000
+#define MAX_RANGE_LENGTH 100000
+
+/* Opcodes other than elementwise operations, which use enum nodetype */
+enum opcode {
+   OP_STORE = 1000,       /* Store into symbol register under mask */
+   OP_CHECKDEF,           /* Check that a symbol has been set */
+   OP_COPY,               /* Copy a register */
+   OP_GATHER,             /* Index into a vector with a varying index */
+   OP_SHIFT,              /* Neighbourhood value of an input file */
+   OP_SUM,
+   OP_PROD,
+   OP_AVG,
+   OP_MAX,
+   OP_MIN,
+   OP_IMAX,
+   OP_IMIN,
+   OP_IF,                 /* Test and set masks, jump if all false */
+   OP_ELSE,               /* Set else masks, jump if all true */
+   OP_ENDIF               /* Merge the two consequents */
+};
+
+typedef struct {
+   int op;
+   int dst;               /* Destination register */
+   int arg[3];            /* Operand registers */
+   int nlist;             /* Number of registers in list */
+   int list;              /* Offset of register list in program */
+   int slot;              /* Symbol or if-else number */
+   int mask;              /* Mask slot for stores and checks (-1: none) */
+   int target;            /* Jump target */
+   node_t node;           /* Node for error messages */
+} instr_t;
+
+/* Run-time state of an if-else */
+typedef struct {
+   int *flags;            /* Voxels taking the then branch */
+   int *isnan_flags;      /* Voxels with an invalid test */
+   int *else_flags;       /* Voxels taking the else branch */
+   int all_true, all_false;
+} if_state_t;
+
+struct program {
+   int ninstr;
+   instr_t *instr;
+   int *list;
+   int nregs;
+   double **reg;          /* Values of each register */
+   int nsyms;
+   ident_t *sym_ident;
+   int *sym_defined;      /* TRUE once a symbol has been stored */
+   int nifs;
+   if_state_t *ifs;
+   int **masks;           /* Current mask of then (2*i) and else (2*i+1)
+                             consequent of each if-else (NULL: all) */
+   int result;            /* Register holding value of expression */
+   double *pool;          /* Space for temporary registers */
+   double *data;          /* Space for constants and symbols */
+};
+
+/* Compile-time information about registers */
+enum regkind {REG_TEMP, REG_CONST, REG_SYM, REG_INPUT};
+
+typedef struct {
+   enum regkind kind;
+   double value;          /* Value of constant */
+   int sym;               /* Symbol number */
+   double *alias;         /* Existing values (inputs and symbols already
+                             in the symbol table) */
+   int version;           /* Incremented by stores */
+   int last_use;          /* Last instruction using temporary */
+} reginfo_t;
+
+typedef struct {
+   ident_t ident;
+   int reg;
+   int known;             /* TRUE if value is a known constant */
+   double value;
+   int surely_defined;    /* TRUE if stored unconditionally */
+} csym_t;
+
+/* Entry in table of computed elementwise operations */
+#define CSE_HASH_SIZE 1024
+typedef struct {
+   int op;
+   int arg[3];
+   int version[3];
+   int dst;
+   int next;
+} cse_t;
+
+typedef struct {
+   program_t p;
+   sym_t sym;
+   int failed;
+   int nregs, maxregs;
+   reginfo_t *regs;
+   int maxinstr;
+   int nlist, maxlist;
+   int nsyms, maxsyms;
+   csym_t *syms;
+   int ncse, maxcse;
+   cse_t *cse;
+   int cse_head[CSE_HASH_SIZE];
+   int mask;              /* Current mask slot (-1: none) */
+   instr_t overflow;      /* Instruction returned by emit once the
+                             program is too long (never run) */
+} compiler_t;
+
+extern double value_for_illegal_operations;
+extern int propagate_nan;
+
+static int comp_scalar(compiler_t *c, node_t n);
+static int comp_vector(compiler_t *c, node_t n, int **regs);
+
+/* Apply an elementwise operation to a single set of values, as
+   eval_scalar does */
+static double apply_op(int type, double vals[], int numargs)
+{
+   double *args[3], result;
+   int iarg;
+
+   for (iarg=0; iarg < 3; iarg++) {
+      args[iarg] = (iarg < numargs) ? &vals[iarg] : NULL;
+   }
+   eval_kernel(type, 1, args, &result);
+   return result;
+}
+
+/* Add a register */
+static int new_reg(compiler_t *c, enum regkind kind)
+{
+   reginfo_t *r;
+
+   if (c->nregs >= c->maxregs) {
+      c->maxregs = (c->maxregs == 0) ? 64 : 2 * c->maxregs;
+      c->regs = realloc(c->regs, c->maxregs * sizeof(c->regs[0]));
+   }
+   r = &c->regs[c->nregs];
+   r->kind = kind;
+   r->value = 0.0;
+   r->sym = -1;
+   r->alias = NULL;
+   r->version = 0;
+   r->last_use = -1;
+   return c->nregs++;
+}
+
+/* Get the register for a constant, sharing registers between equal
+   constants */
+static int const_reg(compiler_t *c, double value)
+{
+   int ireg;
+
+   for (ireg=0; ireg < c->nregs; ireg++) {
+      if ((c->regs[ireg].kind == REG_CONST) &&
+          (memcmp(&c->regs[ireg].value, &value, sizeof(value)) == 0))
+         return ireg;
+   }
+   ireg = new_reg(c, REG_CONST);
+   c->regs[ireg].value = value;
+   return ireg;
+}
+
+/* Check whether a register holds a known constant at this point */
+static int known_value(compiler_t *c, int reg, double *value)
+{
+   reginfo_t *r = &c->regs[reg];
+
+   if (r->kind == REG_CONST) {
+      *value = r->value;
+      return TRUE;
+   }
+   if ((r->kind == REG_SYM) && c->syms[r->sym].known) {
+      *value = c->syms[r->sym].value;
+      return TRUE;
+   }
+   return FALSE;
+}
+
+/* Add an instruction */
+static instr_t *emit(compiler_t *c, int op, node_t n)
+{
+   program_t p = c->p;
+   instr_t *ip;
+
+   /* Once the program is too long, stop adding to it: the compilation
+      has failed, so whatever the caller fills in is thrown away */
+   if (p->ninstr >= MAX_INSTRUCTIONS) {
+      c->failed = TRUE;
+      ip = &c->overflow;
+   }
+   else {
+      if (p->ninstr >= c->maxinstr) {
+         c->maxinstr = (c->maxinstr == 0) ? 64 : 2 * c->maxinstr;
+         p->instr = realloc(p->instr, c->maxinstr * sizeof(p->instr[0]));
+      }
+      ip = &p->instr[p->ninstr++];
+   }
+   ip->op = op;
+   ip->dst = -1;
+   ip->arg[0] = ip->arg[1] = ip->arg[2] = -1;
+   ip->nlist = 0;
+   ip->list = 0;
+   ip->slot = -1;
+   ip->mask = c->mask;
+   ip->target = -1;
+   ip->node = n;
+   return ip;
+}
+
+/* Note the use of a register by the last instruction */
+static void use_reg(compiler_t *c, int reg)
+{
+   if ((reg >= 0) && (c->regs[reg].kind == REG_TEMP))
+      c->regs[reg].last_use = c->p->ninstr - 1;
+}
+
+/* Save a list of registers for the last instruction */
+static void set_list(compiler_t *c, instr_t *ip, int nregs, int regs[])
+{
+   program_t p = c->p;
+   int i;
+
+   if (c->nlist + nregs > c->maxlist) {
+      c->maxlist = 2 * (c->nlist + nregs) + 64;
+      p->list = realloc(p->list, c->maxlist * sizeof(p->list[0]));
+   }
+   ip->list = c->nlist;
+   ip->nlist = nregs;
+   for (i=0; i < nregs; i++) {
+      p->list[c->nlist++] = regs[i];
+      use_reg(c, regs[i]);
+   }
+}
+
+/* Look for an elementwise operation that has already been computed */
+static int cse_hash(int op, int arg[])
+{
+   unsigned int h;
+
+   h = (unsigned int) op;
+   h = h * 31u + (unsigned int) (arg[0] + 1);
+   h = h * 31u + (unsigned int) (arg[1] + 1);
+   h = h * 31u + (unsigned int) (arg[2] + 1);
+   return (int) (h % CSE_HASH_SIZE);
+}
+
+static int cse_lookup(compiler_t *c, int op, int arg[])
+{
+   int i, iarg, match;
+   cse_t *e;
+
+   for (i = c->cse_head[cse_hash(op, arg)]; i >= 0; i = e->next) {
+      e = &c->cse[i];
+      if (e->op != op) continue;
+      match = TRUE;
+      for (iarg=0; iarg < 3; iarg++) {
+         if ((e->arg[iarg] != arg[iarg]) || ((arg[iarg] >= 0) &&
+             (e->version[iarg] != c->regs[arg[iarg]].version)))
+            match = FALSE;
+      }
+      if (match) return e->dst;
+   }
+   return -1;
+}
+
+static void cse_insert(compiler_t *c, int op, int arg[], int dst)
+{
+   int h, iarg;
+   cse_t *e;
+
+   if (c->ncse >= c->maxcse) {
+      c->maxcse = (c->maxcse == 0) ? 256 : 2 * c->maxcse;
+      c->cse = realloc(c->cse, c->maxcse * sizeof(c->cse[0]));
+   }
+   h = cse_hash(op, arg);
+   e = &c->cse[c->ncse];
+   e->op = op;
+   for (iarg=0; iarg < 3; iarg++) {
+      e->arg[iarg] = arg[iarg];
+      e->version[iarg] = (arg[iarg] >= 0) ? c->regs[arg[iarg]].version : 0;
+   }
+   e->dst = dst;
+   e->next = c->cse_head[h];
+   c->cse_head[h] = c->ncse++;
+}
+
+/* Forget operations computed since a mark (at the end of a consequent,
+   which may not have been run) */
+static void cse_forget(compiler_t *c, int mark)
+{
+   cse_t *e;
+
+   while (c->ncse > mark) {
+      e = &c->cse[--c->ncse];
+      c->cse_head[cse_hash(e->op, e->arg)] = e->next;
+   }
+}
+
+/* Emit an elementwise operation, folding constants and reusing earlier
+   results */
+static int emit_op(compiler_t *c, node_t n, int numargs, int args[])
+{
+   int arg[3], iarg, allconst, dst;
+   double vals[3];
+   instr_t *ip;
+
+   allconst = TRUE;
+   for (iarg=0; iarg < 3; iarg++) {
+      arg[iarg] = -1;
+      if (iarg >= numargs) continue;
+      if (known_value(c, args[iarg], &vals[iarg]))
+         arg[iarg] = const_reg(c, vals[iarg]);
+      else {
+         arg[iarg] = args[iarg];
+         allconst = FALSE;
+      }
+   }
+   if (allconst)
+      return const_reg(c, apply_op(n->type, vals, numargs));
+
+   dst = cse_lookup(c, n->type, arg);
+   if (dst >= 0) {
+      c->regs[dst].last_use = c->p->ninstr;
+      return dst;
+   }
+
+   dst = new_reg(c, REG_TEMP);
+   ip = emit(c, n->type, n);
+   ip->dst = dst;
+   for (iarg=0; iarg < numargs; iarg++) {
+      ip->arg[iarg] = arg[iarg];
+      use_reg(c, arg[iarg]);
+   }
+   cse_insert(c, n->type, arg, dst);
+   return dst;
+}
+
+/* Get the symbol entry for an identifier, creating it if needed */
+static int get_sym(compiler_t *c, ident_t ident)
+{
+   program_t p = c->p;
+   csym_t *s;
+   scalar_t existing;
+   int isym;
+
+   for (isym=0; isym < c->nsyms; isym++) {
+      if (c->syms[isym].ident == ident) return isym;
+   }
+   if (c->nsyms >= c->maxsyms) {
+      c->maxsyms = (c->maxsyms == 0) ? 16 : 2 * c->maxsyms;
+      c->syms = realloc(c->syms, c->maxsyms * sizeof(c->syms[0]));
+      p->sym_ident = realloc(p->sym_ident, c->maxsyms * sizeof(ident_t));
+   }
+   isym = c->nsyms++;
+   s = &c->syms[isym];
+   s->ident = ident;
+   s->reg = new_reg(c, REG_SYM);
+   s->known = FALSE;
+   s->surely_defined = FALSE;
+   c->regs[s->reg].sym = isym;
+   p->sym_ident[isym] = ident;
+
+   /* Symbols already in the table (output symbols) share its values */
+   existing = sym_find_scalar(ident, c->sym);
+   if (existing != NULL) {
+      c->regs[s->reg].alias = existing->vals;
+      s->surely_defined = TRUE;
+   }
+
+   return isym;
+}
+
+/* Store a register into a symbol */
+static void emit_store(compiler_t *c, node_t n, ident_t ident, int reg)
+{
+   int isym;
+   csym_t *s;
+   instr_t *ip;
+   double value;
+
+   isym = get_sym(c, ident);
+   s = &c->syms[isym];
+   if (reg != s->reg) {
+      ip = emit(c, OP_STORE, n);
+      ip->dst = s->reg;
+      ip->arg[0] = reg;
+      ip->slot = isym;
+      use_reg(c, reg);
+   }
+   c->regs[s->reg].version++;
+
+   /* Keep track of constant values of symbols set outside of if-else */
+   if ((c->mask < 0) && known_value(c, reg, &value)) {
+      s->known = TRUE;
+      s->value = value;
+   }
+   else {
+      s->known = FALSE;
+   }
+   if (c->mask < 0) s->surely_defined = TRUE;
+}
+
+/* Compile a reduction over a vector */
+static int comp_reduce(compiler_t *c, node_t n, int op)
+{
+   int *regs, len, dst;
+   instr_t *ip;
+
+   len = comp_vector(c, n->expr[0], &regs);
+   if (c->failed) return 0;
+   if (op < 0) {
+      free(regs);
+      return const_reg(c, (double) len);
+   }
+   dst = new_reg(c, REG_TEMP);
+   ip = emit(c, op, n);
+   ip->dst = dst;
+   set_list(c, ip, len, regs);
+   free(regs);
+   return dst;
+}
+
+/* Compile indexing into a vector */
+static int comp_index(compiler_t *c, node_t n)
+{
+   int *regs, len, ireg, idx, dst;
+   double value;
+   instr_t *ip;
+
+   len = comp_vector(c, n->expr[0], &regs);
+   if (c->failed) return 0;
+   ireg = comp_scalar(c, n->expr[1]);
+   if (c->failed) {
+      free(regs);
+      return 0;
+   }
+
+   /* Constant index in range - take the element, copying it if it is a
+      symbol that could change */
+   if (known_value(c, ireg, &value) && (fabs(value) < (double) INT_MAX)) {
+      idx = SCALAR_ROUND(value);
+      if ((idx >= 0) && (idx < len)) {
+         dst = regs[idx];
+         free(regs);
+         if (c->regs[dst].kind == REG_SYM) {
+            ireg = dst;
+            dst = new_reg(c, REG_TEMP);
+            ip = emit(c, OP_COPY, n);
+            ip->dst = dst;
+            ip->arg[0] = ireg;
+            use_reg(c, ireg);
+         }
+         return dst;
+      }
+   }
+
+   /* Otherwise look it up for each voxel */
+   dst = new_reg(c, REG_TEMP);
+   ip = emit(c, OP_GATHER, n);
+   ip->dst = dst;
+   ip->arg[0] = ireg;
+   use_reg(c, ireg);
+   set_list(c, ip, len, regs);
+   free(regs);
+   return dst;
+}
+
+/* Compile an if-else */
+static int comp_ifelse(compiler_t *c, node_t n)
+{
+   program_t p = c->p;
+   int cond, then_reg, else_reg, islot, outer_mask, mark, dst;
+   int if_instr, else_instr;
+   instr_t *ip;
+
+   /* eval_scalar evaluates the else part of an if-else inside another
+      if for the voxels that fail the test, whether or not they are in
+      the enclosing if's mask - leave that to eval_scalar */
+   if ((n->numargs > 2) && (c->mask >= 0)) {
+      c->failed = TRUE;
+      return 0;
+   }
+
+   cond = comp_scalar(c, n->expr[0]);
+   if (c->failed) return 0;
+
+   islot = p->nifs++;
+   outer_mask = c->mask;
+
+   ip = emit(c, OP_IF, n);
+   ip->arg[0] = cond;
+   ip->slot = islot;
+   use_reg(c, cond);
+   if_instr = p->ninstr - 1;
+
+   /* Then part */
+   mark = c->ncse;
+   c->mask = 2 * islot;
+   then_reg = comp_scalar(c, n->expr[1]);
+   cse_forget(c, mark);
+   if (c->failed) return 0;
+
+   /* Else part */
+   else_reg = -1;
+   if (n->numargs > 2) {
+      c->mask = outer_mask;
+      ip = emit(c, OP_ELSE, n);
+      ip->slot = islot;
+      else_instr = p->ninstr - 1;
+      p->instr[if_instr].target = else_instr;
+      c->mask = 2 * islot + 1;
+      else_reg = comp_scalar(c, n->expr[2]);
+      cse_forget(c, mark);
+      if (c->failed) return 0;
+      p->instr[else_instr].target = p->ninstr;
+   }
+   else {
+      p->instr[if_instr].target = p->ninstr;
+   }
+   c->mask = outer_mask;
+
+   /* eval_scalar merges into the value of the then part (or else part),
+      so it changes a symbol that is given as a consequent - leave that
+      to eval_scalar */
+   if (((then_reg >= 0) && (c->regs[then_reg].kind == REG_SYM)) ||
+       ((else_reg >= 0) && (c->regs[else_reg].kind == REG_SYM))) {
+      c->failed = TRUE;
+      return 0;
+   }
+
+   /* Merge */
+   dst = new_reg(c, REG_TEMP);
+   ip = emit(c, OP_ENDIF, n);
+   ip->dst = dst;
+   ip->arg[0] = then_reg;
+   ip->arg[1] = else_reg;
+   ip->slot = islot;
+   use_reg(c, then_reg);
+   use_reg(c, else_reg);
+   return dst;
+}
+
+/* Compile the body of a for loop or vector generator once for each
+   element of the vector */
+static int comp_unrolled(compiler_t *c, node_t n, int **regs)
+{
+   int *els, len, iel;
+
+   if (!ident_is_scalar(n->ident)) {
+      c->failed = TRUE;
+      return 0;
+   }
+   len = comp_vector(c, n->expr[0], &els);
+   if (c->failed) return 0;
+   if (regs != NULL)
+      *regs = malloc((len > 0 ? len : 1) * sizeof(int));
+   for (iel=0; iel < len; iel++) {
+      emit_store(c, n, n->ident, els[iel]);
+      if (regs != NULL)
+         (*regs)[iel] = comp_scalar(c, n->expr[1]);
+      else
+         (void) comp_scalar(c, n->expr[1]);
+      if (c->failed) break;
+   }
+   free(els);
+   return len;
+}
+
+/* Compile an expression in a scalar context, returning its register */
+static int comp_scalar(compiler_t *c, node_t n)
+{
+   int args[3], iarg, *regs, len, reg, isym, dst;
+   instr_t *ip;
+
+   if (c->failed) return 0;
+   if (!node_is_scalar(n)) {
+      c->failed = TRUE;
+      return 0;
+   }
+
+   if (n->flags & ALLARGS_SCALAR) {
+      if (n->numargs > 3) {
+         c->failed = TRUE;
+         return 0;
+      }
+      for (iarg=0; iarg < n->numargs; iarg++) {
+         args[iarg] = comp_scalar(c, n->expr[iarg]);
+      }
+      if (c->failed) return 0;
+      return emit_op(c, n, n->numargs, args);
+   }
+
+   switch (n->type) {
+   case NODETYPE_EXPRLIST:
+      if (node_is_scalar(n->expr[0])) {
+         (void) comp_scalar(c, n->expr[0]);
+      }
+      else {
+         len = comp_vector(c, n->expr[0], &regs);
+         if (!c->failed) free(regs);
+      }
+      return comp_scalar(c, n->expr[1]);
+
+   case NODETYPE_INDEX:
+      return comp_index(c, n);
+
+   case NODETYPE_SHIFT:
+      reg = comp_scalar(c, n->expr[0]);
+      if (c->failed) return 0;
+      isym = get_sym(c, slab_centre_ident());
+      dst = new_reg(c, REG_TEMP);
+      ip = emit(c, OP_SHIFT, n);
+      ip->dst = dst;
+      ip->arg[0] = reg;
+      ip->arg[1] = c->syms[isym].reg;
+      use_reg(c, reg);
+      return dst;
+
+   case NODETYPE_SUM:  return comp_reduce(c, n, OP_SUM);
+   case NODETYPE_PROD: return comp_reduce(c, n, OP_PROD);
+   case NODETYPE_AVG:  return comp_reduce(c, n, OP_AVG);
+   case NODETYPE_LEN:  return comp_reduce(c, n, -1);
+   case NODETYPE_MAX:  return comp_reduce(c, n, OP_MAX);
+   case NODETYPE_MIN:  return comp_reduce(c, n, OP_MIN);
+   case NODETYPE_IMAX: return comp_reduce(c, n, OP_IMAX);
+   case NODETYPE_IMIN: return comp_reduce(c, n, OP_IMIN);
+
+   case NODETYPE_FOR:
+      len = comp_unrolled(c, n, NULL);
+      if (c->failed) return 0;
+      return const_reg(c, (double) len);
+
+   case NODETYPE_IDENT:
+      isym = get_sym(c, n->ident);
+      if (!c->syms[isym].surely_defined) {
+         ip = emit(c, OP_CHECKDEF, n);
+         ip->slot = isym;
+      }
+      return c->syms[isym].reg;
+
+   case NODETYPE_REAL:
+      return const_reg(c, n->real);
+
+   case NODETYPE_ASSIGN:
+      reg = comp_scalar(c, n->expr[0]);
+      if (c->failed) return 0;
+      emit_store(c, n, n->ident, reg);
+      return reg;
+
+   case NODETYPE_LET:
+      if (!ident_is_scalar(n->ident)) {
+         c->failed = TRUE;
+         return 0;
+      }
+      reg = comp_scalar(c, n->expr[0]);
+      if (c->failed) return 0;
+      emit_store(c, n, n->ident, reg);
+      return comp_scalar(c, n->expr[1]);
+
+   case NODETYPE_IFELSE:
+      return comp_ifelse(c, n);
+
+   default:
+      c->failed = TRUE;
+      return 0;
+   }
+}
+
+/* Compile an expression in a vector context, returning the number of
+   elements and their registers (to be freed by the caller) */
+static int comp_vector(compiler_t *c, node_t n, int **regs)
+{
+   int *els, len, ireg, i;
+   vector_t v;
+   double start, stop;
+
+   *regs = NULL;
+   if (c->failed) return 0;
+
+   /* A scalar is a vector of one element, as in eval_vector */
+   if (node_is_scalar(n)) {
+      ireg = comp_scalar(c, n);
+      if (c->failed) return 0;
+      *regs = malloc(sizeof(int));
+      (*regs)[0] = ireg;
+      return 1;
+   }
+
+   switch (n->type) {
+   case NODETYPE_EXPRLIST:
+      if (node_is_scalar(n->expr[0])) {
+         (void) comp_scalar(c, n->expr[0]);
+      }
+      else {
+         len = comp_vector(c, n->expr[0], &els);
+         if (!c->failed) free(els);
+      }
+      return comp_vector(c, n->expr[1], regs);
+
+   case NODETYPE_VEC1:
+      ireg = comp_scalar(c, n->expr[0]);
+      if (c->failed) return 0;
+      *regs = malloc(sizeof(int));
+      (*regs)[0] = ireg;
+      return 1;
+
+   case NODETYPE_VEC2:
+      len = comp_vector(c, n->expr[0], &els);
+      if (c->failed) return 0;
+      ireg = comp_scalar(c, n->expr[1]);
+      if (c->failed) {
+         free(els);
+         return 0;
+      }
+      els = realloc(els, (len + 1) * sizeof(int));
+      els[len++] = ireg;
+      *regs = els;
+      return len;
+
+   case NODETYPE_GEN:
+      len = comp_unrolled(c, n, regs);
+      if (c->failed && (*regs != NULL)) {
+         free(*regs);
+         *regs = NULL;
+      }
+      return len;
+
+   case NODETYPE_RANGE:
+      /* Only ranges with constant ends that are not symbols (gen_range
+         rounds the values of its ends in place) */
+      ireg = comp_scalar(c, n->expr[0]);
+      i = comp_scalar(c, n->expr[1]);
+      if (c->failed || (c->regs[ireg].kind == REG_SYM) ||
+          (c->regs[i].kind == REG_SYM) || !known_value(c, ireg, &start) ||
+          !known_value(c, i, &stop) ||
+          (fabs(start) > MAX_RANGE_LENGTH) ||
+          (fabs(stop) > MAX_RANGE_LENGTH)) {
+         c->failed = TRUE;
+         return 0;
+      }
+      start = SCALAR_ROUND(start);
+      stop = SCALAR_ROUND(stop);
+      if (!(n->flags & RANGE_EXACT_LOWER)) start++;
+      if (!(n->flags & RANGE_EXACT_UPPER)) stop--;
+      len = (int) (stop - start);
+      len++;
+      if (len < 0) len = 0;
+      *regs = malloc((len > 0 ? len : 1) * sizeof(int));
+      for (i=0; i < len; i++) {
+         (*regs)[i] = const_reg(c, start + i);
+      }
+      return len;
+
+   case NODETYPE_IDENT:
+      /* Only vectors that are already in the symbol table and are never
+         assigned (the input vector A) */
+      v = sym_find_vector(n->ident, c->sym);
+      if (v == NULL) {
+         c->failed = TRUE;
+         return 0;
+      }
+      *regs = malloc((v->len > 0 ? v->len : 1) * sizeof(int));
+      for (i=0; i < v->len; i++) {
+         for (ireg=0; ireg < c->nregs; ireg++) {
+            if ((c->regs[ireg].kind == REG_INPUT) &&
+                (c->regs[ireg].alias == v->el[i]->vals)) break;
+         }
+         if (ireg >= c->nregs) {
+            ireg = new_reg(c, REG_INPUT);
+            c->regs[ireg].alias = v->el[i]->vals;
+         }
+         (*regs)[i] = ireg;
+      }
+      return v->len;
+
+   default:
+      c->failed = TRUE;
+      return 0;
+   }
+}
+
+/* Check whether a tree assigns to a vector symbol, which the compiled
+   program cannot do */
+static int assigns_vector(node_t n)
+{
+   int iarg;
+
+   if (n == NULL) return FALSE;
+   if (((n->type == NODETYPE_ASSIGN) || (n->type == NODETYPE_LET)) &&
+       !ident_is_scalar(n->ident))
+      return TRUE;
+   for (iarg=0; iarg < n->numargs && iarg < 3; iarg++) {
+      if (assigns_vector(n->expr[iarg])) return TRUE;
+   }
+   return FALSE;
+}
+
+/* Give each temporary register space in the pool, sharing space between
+   registers that are not needed at the same time. Jumps only go forward,
+   so a register is needed from the instruction that sets it to its
+   last use. */
+static int allocate_pool(compiler_t *c, int *slot)
+{
+   program_t p = c->p;
+   int *free_slots, nfree, nslots, pc, ireg, iarg, i;
+   int *dying, ndying;
+   instr_t *ip;
+
+   free_slots = malloc((c->nregs + 1) * sizeof(int));
+   dying = malloc((c->nregs + 1) * sizeof(int));
+   nfree = 0;
+   nslots = 0;
+   for (ireg=0; ireg < c->nregs; ireg++) slot[ireg] = -1;
+
+   for (pc=0; pc < p->ninstr; pc++) {
+      ip = &p->instr[pc];
+
+      /* Find temporaries last used here */
+      ndying = 0;
+      for (iarg=0; iarg < 3; iarg++) {
+         ireg = ip->arg[iarg];
+         if ((ireg >= 0) && (c->regs[ireg].kind == REG_TEMP) &&
+             (c->regs[ireg].last_use == pc) && (slot[ireg] >= 0))
+            dying[ndying++] = ireg;
+      }
+      for (i=0; i < ip->nlist; i++) {
+         ireg = p->list[ip->list + i];
+         if ((c->regs[ireg].kind == REG_TEMP) &&
+             (c->regs[ireg].last_use == pc) && (slot[ireg] >= 0))
+            dying[ndying++] = ireg;
+      }
+
+      /* Release their space (operations work value by value, so the
+         result can go in the space of an operand) */
+      for (i=0; i < ndying; i++) {
+         ireg = dying[i];
+         if (slot[ireg] >= 0) {
+            free_slots[nfree++] = slot[ireg];
+            slot[ireg] = -2 - slot[ireg];
+         }
+      }
+
+      /* Get space for the result */
+      ireg = ip->dst;
+      if ((ireg >= 0) && (c->regs[ireg].kind == REG_TEMP) &&
+          (slot[ireg] == -1)) {
+         slot[ireg] = (nfree > 0) ? free_slots[--nfree] : nslots++;
+         if (c->regs[ireg].last_use < pc) {
+            free_slots[nfree++] = slot[ireg];
+         }
+      }
+   }
+
+   /* Registers that were released keep the space they had */
+   for (ireg=0; ireg < c->nregs; ireg++) {
+      if (slot[ireg] < -1) slot[ireg] = -2 - slot[ireg];
+   }
+
+   free(free_slots);
+   free(dying);
+   return nslots;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : compile_program
+@INPUT      : root - expression tree
+              sym - symbol table holding the input vector and the output
+                 symbols
+              width - largest number of voxels evaluated at once
+@OUTPUT     : (none)
+@RETURNS    : Compiled program, or NULL if the expression cannot be
+              compiled (it must then be evaluated with eval_scalar)
+@DESCRIPTION: Compiles an expression tree into a program for run_program.
+@METHOD     :
+@GLOBALS    : value_for_illegal_operations (used for constant folding)
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+program_t compile_program(node_t root, sym_t sym, int width)
+{
+   compiler_t compiler, *c;
+   program_t p;
+   int *slot, nslots, ireg, nconst, i;
+   double *data;
+
+   if ((root == NULL) || !node_is_scalar(root) || assigns_vector(root))
+      return NULL;
+
+   c = &compiler;
+   (void) memset(c, 0, sizeof(*c));
+   for (i=0; i < CSE_HASH_SIZE; i++) c->cse_head[i] = -1;
+   c->sym = sym;
+   c->mask = -1;
+   p = c->p = calloc(1, sizeof(*p));
+
+   /* Compile */
+   p->result = comp_scalar(c, root);
+   if (c->failed) {
+      p->nsyms = c->nsyms;
+      free(c->regs);
+      free(c->syms);
+      free(c->cse);
+      free_program(p);
+      return NULL;
+   }
+   if (c->regs[p->result].kind == REG_TEMP)
+      c->regs[p->result].last_use = p->ninstr;
+
+   /* Lay out the registers */
+   slot = malloc((c->nregs + 1) * sizeof(int));
+   nslots = allocate_pool(c, slot);
+   p->pool = malloc(((size_t) nslots * width + 1) * sizeof(double));
+   nconst = 0;
+   for (ireg=0; ireg < c->nregs; ireg++) {
+      if ((c->regs[ireg].kind == REG_CONST) ||
+          ((c->regs[ireg].kind == REG_SYM) && (c->regs[ireg].alias == NULL)))
+         nconst++;
+   }
+   p->data = calloc((size_t) nconst * width + 1, sizeof(double));
+   p->nregs = c->nregs;
+   p->reg = malloc((c->nregs + 1) * sizeof(double *));
+   data = p->data;
+   for (ireg=0; ireg < c->nregs; ireg++) {
+      switch (c->regs[ireg].kind) {
+      case REG_TEMP:
+         p->reg[ireg] = &p->pool[(size_t) (slot[ireg] >= 0 ? slot[ireg] : 0)
+                                 * width];
+         break;
+      case REG_CONST:
+         p->reg[ireg] = data;
+         for (i=0; i < width; i++) data[i] = c->regs[ireg].value;
+         data += width;
+         break;
+      case REG_SYM:
+      case REG_INPUT:
+         if (c->regs[ireg].alias != NULL) {
+            p->reg[ireg] = c->regs[ireg].alias;
+         }
+         else {
+            p->reg[ireg] = data;
+            data += width;
+         }
+         break;
+      }
+   }
+   free(slot);
+
+   /* Symbols and if-else state */
+   p->nsyms = c->nsyms;
+   p->sym_defined = malloc((c->nsyms + 1) * sizeof(int));
+   for (i=0; i < c->nsyms; i++) {
+      p->sym_defined[i] = (c->regs[c->syms[i].reg].alias != NULL);
+   }
+   p->ifs = malloc((p->nifs + 1) * sizeof(p->ifs[0]));
+   p->masks = malloc((2 * p->nifs + 1) * sizeof(p->masks[0]));
+   for (i=0; i < p->nifs; i++) {
+      p->ifs[i].flags = malloc(width * sizeof(int));
+      p->ifs[i].isnan_flags = malloc(width * sizeof(int));
+      p->ifs[i].else_flags = malloc(width * sizeof(int));
+      p->masks[2*i] = p->masks[2*i+1] = NULL;
+   }
+
+   free(c->regs);
+   free(c->syms);
+   free(c->cse);
+   return p;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : free_program
+@INPUT      : p - compiled program
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Frees a program from compile_program.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void free_program(program_t p)
+{
+   int i;
+
+   if (p == NULL) return;
+   if (p->ifs != NULL) {
+      for (i=0; i < p->nifs; i++) {
+         free(p->ifs[i].flags);
+         free(p->ifs[i].isnan_flags);
+         free(p->ifs[i].else_flags);
+      }
+   }
+   free(p->instr);
+   free(p->list);
+   free(p->reg);
+   free(p->sym_ident);
+   free(p->sym_defined);
+   free(p->ifs);
+   free(p->masks);
+   free(p->pool);
+   free(p->data);
+   free(p);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : run_program
+@INPUT      : p - compiled program
+              width - number of voxels to evaluate (no more than the
+                 width given to compile_program)
+@OUTPUT     : (none)
+@RETURNS    : Pointer to values of expression (valid until next call)
+@DESCRIPTION: Evaluates a compiled expression for a block of voxels. The
+              input vector must already hold the voxel values.
+@METHOD     :
+@GLOBALS    : value_for_illegal_operations, propagate_nan
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+double *run_program(program_t p, int width)
+{
+   int pc, ivalue, i, idx, *mask, *list, all_true, all_false;
+   int found_invalid, found_valid;
+   double **reg, *args[3], *a, *b, *d, *vals, x, z, value, max, index;
+   long offset;
+   instr_t *ip;
+   if_state_t *is;
+   double illegal = value_for_illegal_operations;
+
+   reg = p->reg;
+   for (pc=0; pc < p->ninstr; pc++) {
+      ip = &p->instr[pc];
+      d = (ip->dst >= 0) ? reg[ip->dst] : NULL;
+      mask = (ip->mask >= 0) ? p->masks[ip->mask] : NULL;
+
+      switch (ip->op) {
+      case OP_STORE:
+         a = reg[ip->arg[0]];
+         for (ivalue=0; ivalue < width; ivalue++) {
+            if (mask != NULL && !mask[ivalue]) continue;
+            d[ivalue] = a[ivalue];
+         }
+         p->sym_defined[ip->slot] = TRUE;
+         break;
+
+      case OP_CHECKDEF:
+         if (!p->sym_defined[ip->slot]) {
+            (void) fprintf(stderr, "%s undefined\n",
+                           ident_str(p->sym_ident[ip->slot]));
+            exit(1);
+         }
+         break;
+
+      case OP_COPY:
+         a = reg[ip->arg[0]];
+         for (ivalue=0; ivalue < width; ivalue++) d[ivalue] = a[ivalue];
+         break;
+
+      case OP_GATHER:
+         a = reg[ip->arg[0]];
+         list = &p->list[ip->list];
+         for (ivalue=0; ivalue < width; ivalue++) {
+            idx = SCALAR_ROUND(a[ivalue]);
+            if (idx < 0 || idx >= ip->nlist) {
+               if (mask != NULL && !mask[ivalue]) continue;
+               show_error(ip->node->pos, "index out of bounds");
+            }
+            d[ivalue] = reg[list[idx]][ivalue];
+         }
+         break;
+
+      case OP_SHIFT:
+         a = reg[ip->arg[0]];
+         b = reg[ip->arg[1]];
+         offset = slab_offset(ip->node->offset);
+         for (ivalue=0; ivalue < width; ivalue++) {
+            vals = slab_values(SCALAR_ROUND(a[ivalue]));
+            if (vals == NULL) {
+               if (mask != NULL && !mask[ivalue]) continue;
+               show_error(ip->node->pos, "index out of bounds");
+            }
+            d[ivalue] = vals[(long) b[ivalue] + offset];
+         }
+         break;
+
+      case OP_SUM:
+      case OP_AVG:
+      case OP_PROD:
+         list = &p->list[ip->list];
+         for (ivalue=0; ivalue < width; ivalue++) {
+            value = (ip->op == OP_PROD) ? 1.0 : 0.0;
+            found_invalid = found_valid = FALSE;
+            for (i=0; i < ip->nlist; i++) {
+               x = reg[list[i]][ivalue];
+               if (x == INVALID_VALUE)
+                  found_invalid = TRUE;
+               else {
+                  if (ip->op == OP_PROD) value *= x;
+                  else value += x;
+                  found_valid = TRUE;
+               }
+            }
+            if ((found_invalid && propagate_nan) || !found_valid)
+               value = illegal;
+            if ((ip->op == OP_AVG) && (value != INVALID_VALUE))
+               value /= (double) ip->nlist;
+            d[ivalue] = value;
+         }
+         break;
+
+      case OP_MAX:
+      case OP_MIN:
+      case OP_IMAX:
+      case OP_IMIN:
+         list = &p->list[ip->list];
+         z = ((ip->op == OP_MAX) || (ip->op == OP_IMAX)) ? 1.0 : -1.0;
+         index = 0.0;
+         for (ivalue=0; ivalue < width; ivalue++) {
+            max = INVALID_VALUE;
+            for (i=0; i < ip->nlist; i++) {
+               x = reg[list[i]][ivalue];
+               if (x != INVALID_VALUE) {
+                  if (max == INVALID_VALUE || (z*(x-max) > 0.0)) {
+                     max = x;
+                     index = (double) i;
+                  }
+               }
+            }
+            d[ivalue] = ((ip->op == OP_MAX) || (ip->op == OP_MIN)) ?
+               max : index;
+         }
+         break;
+
+      case OP_IF:
+         a = reg[ip->arg[0]];
+         is = &p->ifs[ip->slot];
+         all_true = all_false = TRUE;
+         for (ivalue=0; ivalue < width; ivalue++) {
+            is->isnan_flags[ivalue] = (a[ivalue] == INVALID_VALUE);
+            is->flags[ivalue] = ((mask == NULL) ? 1 : mask[ivalue]) &&
+               (a[ivalue] != 0.0) && !is->isnan_flags[ivalue];
+            if (is->flags[ivalue])
+               all_false = FALSE;
+            else
+               all_true = FALSE;
+         }
+         is->all_true = all_true;
+         is->all_false = all_false;
+         p->masks[2*ip->slot] = (all_true || all_false) ? NULL : is->flags;
+         if (all_false) pc = ip->target - 1;
+         break;
+
+      case OP_ELSE:
+         is = &p->ifs[ip->slot];
+         if (is->all_true) {
+            pc = ip->target - 1;
+            break;
+         }
+         if (is->all_false) {
+            p->masks[2*ip->slot+1] = NULL;
+         }
+         else {
+            for (ivalue=0; ivalue < width; ivalue++)
+               is->else_flags[ivalue] = ((mask == NULL) ? 1 : mask[ivalue])
+                  && !is->flags[ivalue] && !is->isnan_flags[ivalue];
+            p->masks[2*ip->slot+1] = is->else_flags;
+         }
+         break;
+
+      case OP_ENDIF:
+         is = &p->ifs[ip->slot];
+         a = is->all_false ? NULL : reg[ip->arg[0]];
+         b = ((ip->arg[1] >= 0) && !is->all_true) ? reg[ip->arg[1]] : NULL;
+         for (ivalue=0; ivalue < width; ivalue++) {
+            if (is->isnan_flags[ivalue])
+               d[ivalue] = illegal;
+            else if (!is->all_true && !is->all_false)
+               d[ivalue] = is->flags[ivalue] ? a[ivalue] :
+                  ((b != NULL) ? b[ivalue] : 0.0);
+            else if (a != NULL)
+               d[ivalue] = a[ivalue];
+            else if (b != NULL)
+               d[ivalue] = b[ivalue];
+            else
+               d[ivalue] = 0.0;
+         }
+         break;
+
+      default:
+         /* Elementwise operation */
+         for (i=0; i < 3; i++) {
+            args[i] = (ip->arg[i] >= 0) ? reg[ip->arg[i]] : NULL;
+         }
+         eval_kernel(ip->op, width, args, d);
+         break;
+
+      }
+   }
+
+   return reg[p->result];
+}
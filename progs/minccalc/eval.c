@@ -18,6 +18,7 @@
 #define INVALID_VALUE -DBL_MAX
 
 scalar_t   eval_index(int, int *, node_t, vector_t, scalar_t);
+scalar_t   eval_shift(int, int *, node_t, scalar_t, scalar_t);
 scalar_t   eval_sum(int, int *, node_t, vector_t);
 scalar_t   eval_prod(int, int *, node_t, vector_t);
 scalar_t   eval_max(int, int *, node_t, vector_t, double, int);
@@ -72,9 +73,9 @@ scalar_t eval_scalar(int width, int *eval_flags, node_t n, sym_t sym){
    vector_t v;
    scalar_t s, s2, result;
    scalar_t args[3];
-   double vals[3];
+   double *argvals[3];
    int *eval_flags2, *isnan_flags;
-   int found_invalid, all_true, all_false;
+   int all_true, all_false;
    int iarg, ivalue;
 
    /* Check that node is of correct type */
@@ -106,143 +107,23 @@ scalar_t eval_scalar(int width, int *eval_flags, node_t n, sym_t sym){
          result = new_scalar(width);
       }
 
-      /* Loop over all values in scalar */
-      for (ivalue=0; ivalue < width; ivalue++) {
-
-         /* Check the eval flag */
-         if (eval_flags != NULL && !eval_flags[ivalue]) continue;
-
-         /* Get the values, checking for invalid values. */
-         found_invalid = FALSE;
-         for (iarg=0; iarg < n->numargs; iarg++) {
-            vals[iarg] = args[iarg]->vals[ivalue];
-            if (vals[iarg] == INVALID_VALUE) {
-               found_invalid = TRUE;
-            }
-         }
-
-         /* Debug */
-         if (debug) {
+      /* Debug */
+      if (debug) {
+         for (ivalue=0; ivalue < width; ivalue++) {
+            if (eval_flags != NULL && !eval_flags[ivalue]) continue;
             (void) fprintf(stderr, "scalar %s:", node_name(n));
             for (iarg=0; iarg < n->numargs; iarg++)
-               (void) fprintf(stderr, " %g", vals[iarg]);
+               (void) fprintf(stderr, " %g", args[iarg]->vals[ivalue]);
             (void) fprintf(stderr, "\n");
          }
+      }
 
-         /* Check for an invalid value. If we are testing for them, 
-            return 1.0, otherwise return an invalid value. */
-         if (found_invalid) {
-            result->vals[ivalue] = 
-               ( (n->type == NODETYPE_ISNAN) ? 1.0 : INVALID_VALUE );
-            continue;
-         }
-
-         /* Do the operation */
-         switch (n->type) {
-         case NODETYPE_ADD:
-            result->vals[ivalue] = vals[0] + vals[1]; break;
-   
-         case NODETYPE_SUB:
-            result->vals[ivalue] = vals[0] - vals[1]; break;
-      
-         case NODETYPE_MUL:
-            result->vals[ivalue] = vals[0] * vals[1]; break;
-      
-         case NODETYPE_DIV:
-            if (vals[1] == 0.0)
-               result->vals[ivalue] = value_for_illegal_operations;
-            else
-               result->vals[ivalue] = vals[0] / vals[1];
-            break;
-
-         case NODETYPE_LT:
-            result->vals[ivalue] = vals[0] < vals[1]; break;
-   
-         case NODETYPE_LE:
-            result->vals[ivalue] = vals[0] <= vals[1]; break;
-   
-         case NODETYPE_GT:
-            result->vals[ivalue] = vals[0] > vals[1]; break;
-   
-         case NODETYPE_GE:
-            result->vals[ivalue] = vals[0] >= vals[1]; break;
-   
-         case NODETYPE_EQ:
-            result->vals[ivalue] = vals[0] == vals[1]; break;
-   
-         case NODETYPE_NE:
-            result->vals[ivalue] = vals[0] != vals[1]; break;
-   
-         case NODETYPE_NOT:
-            result->vals[ivalue] = (vals[0] == 0.0); break;
-   
-         case NODETYPE_AND:
-            result->vals[ivalue] = (vals[0] != 0.0) && (vals[1] != 0.0); 
-            break;
-   
-         case NODETYPE_OR:
-            result->vals[ivalue] = (vals[0] != 0.0) || (vals[1] != 0.0);
-            break;
-   
-         case NODETYPE_ISNAN:
-            /* We only get here if the value is valid */
-            result->vals[ivalue] = 0.0; break;
-   
-         case NODETYPE_POW:
-            result->vals[ivalue] = pow(vals[0], vals[1]); break;
-   
-         case NODETYPE_SQRT:
-            if (vals[0] < 0.0)
-               result->vals[ivalue] = value_for_illegal_operations;
-            else 
-               result->vals[ivalue] = sqrt(vals[0]);
-            break;
-   
-         case NODETYPE_ABS:
-            result->vals[ivalue] = fabs(vals[0]); break;
-   
-         case NODETYPE_EXP:
-            result->vals[ivalue] = exp(vals[0]); break;
-   
-         case NODETYPE_LOG:
-            if (vals[0] <= 0.0)
-               result->vals[ivalue] = value_for_illegal_operations;
-            else
-               result->vals[ivalue] = log(vals[0]);
-            break;
-   
-         case NODETYPE_SIN:
-            result->vals[ivalue] = sin(vals[0]); break;
-   
-         case NODETYPE_COS:
-            result->vals[ivalue] = cos(vals[0]); break;
-         
-         case NODETYPE_TAN:
-            result->vals[ivalue] = tan(vals[0]); break;
-   
-         case NODETYPE_ASIN:
-            result->vals[ivalue] = asin(vals[0]); break;
-   
-         case NODETYPE_ACOS:
-            result->vals[ivalue] = acos(vals[0]); break;
-         
-         case NODETYPE_ATAN:
-            result->vals[ivalue] = atan(vals[0]); break;
-   
-         case NODETYPE_CLAMP:
-            if (vals[0] < vals[1]) result->vals[ivalue] = vals[1];
-            else if (vals[0] > vals[2]) result->vals[ivalue] = vals[2];
-            else result->vals[ivalue] = vals[0];
-            break;
-   
-         case NODETYPE_SEGMENT:
-            result->vals[ivalue] = 
-               ( (vals[0] >= vals[1] && vals[0] <= vals[2]) ? 1.0 : 0.0);
-            break;
-   
-         }  /* switch on type */
-
-      }   /* Loop over values of scalar */
+      /* Do the operation on all values at once, checking for invalid
+         values. Values not in eval_flags are computed but never used. */
+      for (iarg=0; iarg < 3; iarg++) {
+         argvals[iarg] = (iarg < n->numargs) ? args[iarg]->vals : NULL;
+      }
+      eval_kernel(n->type, width, argvals, result->vals);
 
       /* Free the intermediate results */
       for (iarg=0; iarg < n->numargs; iarg++) {
@@ -277,6 +158,13 @@ scalar_t eval_scalar(int width, int *eval_flags, node_t n, sym_t sym){
       scalar_free(s);
       return result;
       
+   case NODETYPE_SHIFT:
+      s = eval_scalar(width, eval_flags, n->expr[0], sym);
+      s2 = sym_lookup_scalar(slab_centre_ident(), sym);
+      result = eval_shift(width, eval_flags, n, s, s2);
+      scalar_free(s);
+      return result;
+
    case NODETYPE_SUM:
       v = eval_vector(width, eval_flags, n->expr[0], sym);
       s = eval_sum(width, eval_flags, n, v);
@@ -485,6 +373,29 @@ scalar_t eval_index(int width, int *eval_flags,
    return s;
 }
 
+/* Get the value of an input file at an offset from each voxel */
+scalar_t eval_shift(int width, int *eval_flags, 
+                    node_t n, scalar_t i, scalar_t centre){
+   scalar_t s;
+   double *vals;
+   long offset;
+   int ivalue;
+
+   s = new_scalar(width);
+   offset = slab_offset(n->offset);
+   for (ivalue=0; ivalue < width; ivalue++) {
+      if (eval_flags != NULL && !eval_flags[ivalue]) continue;
+      vals = slab_values(SCALAR_ROUND(i->vals[ivalue]));
+      if (vals == NULL)
+         eval_error(n, "index out of bounds");
+      s->vals[ivalue] = vals[(long) centre->vals[ivalue] + offset];
+      if (debug) (void) fprintf(stderr, "Shift (%d,%d,%d) = %g\n", 
+                                n->offset[0], n->offset[1], n->offset[2],
+                                s->vals[ivalue]);
+   }
+   return s;
+}
+
 /* Perform a sum over the arguments */
 scalar_t eval_sum(int width, int *eval_flags, node_t n, vector_t v)
 {
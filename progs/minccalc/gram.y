@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 #include <limits.h>
 #include <float.h>
 #include "node.h"
@@ -10,6 +11,9 @@
 
 /* Avoid problems with conflicting declarations */
 void yyerror(const char *msg);
+static node_t new_shift_node(node_t vector, node_t index, int pos,
+                             double offset0, double offset1, double offset2);
+static node_t new_reduce_node(int type, int pos, node_t values, node_t mask);
 %}
 
 %union{
@@ -23,17 +27,19 @@ ident_t  ident;
 %token      IN TO IDENT REAL AVG PROD SUM LET NEG LEN MAX MIN IMAX IMIN
 %token      ISNAN SQRT ABS EXP LOG SIN COS TAN ASIN ACOS ATAN CLAMP SEGMENT
 %token      LT LE GT GE EQ NE NOT AND OR
-%token      IF ELSE FOR
+%token      IF ELSE FOR MEAN3
+%token      GSUM GMEAN GMIN GMAX GCOUNT
 
 %type<ident>   IDENT 
 %type<real>    REAL
-%type<pos>     IN TO AVG SUM PROD LET NEG LEN IF ELSE FOR
+%type<pos>     IN TO AVG SUM PROD LET NEG LEN IF ELSE FOR MEAN3
 %type<pos>     ISNAN SQRT ABS MAX MIN IMAX IMIN EXP LOG SIN COS TAN ASIN ACOS ATAN
-%type<pos>     CLAMP SEGMENT
+%type<pos>     CLAMP SEGMENT GSUM GMEAN GMIN GMAX GCOUNT
 %type<pos>     NOT LT LE GT GE EQ NE AND OR
 %type<pos>     '+' '-' '*' '/' '(' ')' '[' ']' '.' '=' '^' '{' '}' ',' '|' ';'
 %type<pos>     ':' '?'
 %type<node>    exprlist expr letexpr vector
+%type<real>    offset
 
 %right   '='
 %right   LET
@@ -238,6 +244,39 @@ expr   :   '(' expr ')'
         $$->expr[0] = $1;
         $$->expr[1] = $3; }
 
+   |   expr '[' expr ']' '(' offset ',' offset ',' offset ')'
+      { $$ = new_shift_node($1, $3, $5, $6, $8, $10); }
+
+   |   MEAN3 '(' expr ')'
+      { int i;
+        node_t shift, list;
+        if ($3->type != NODETYPE_INDEX) {
+           yyerror("mean3x3x3 needs an element of A");
+        }
+        $$ = new_scalar_node(1);
+        $$->pos = $1;
+        $$->type = NODETYPE_AVG;
+        $$->expr[0] = NULL;
+        for (i=0; i < 27; i++) {
+           shift = new_shift_node($3->expr[0], $3->expr[1], $1,
+                                  (double) (i / 9 - 1),
+                                  (double) (i / 3 % 3 - 1),
+                                  (double) (i % 3 - 1));
+           if ($$->expr[0] == NULL) {
+              $$->expr[0] = new_vector_node(1);
+              $$->expr[0]->type = NODETYPE_VEC1;
+              $$->expr[0]->expr[0] = shift;
+           }
+           else {
+              list = new_vector_node(2);
+              list->type = NODETYPE_VEC2;
+              list->expr[0] = $$->expr[0];
+              list->expr[1] = shift;
+              $$->expr[0] = list;
+           }
+           $$->expr[0]->pos = $1;
+        } }
+
    |   IDENT '=' expr
       { $$ = new_node(1, node_is_scalar($3));
         $$->type = NODETYPE_ASSIGN;
@@ -398,6 +437,36 @@ expr   :   '(' expr ')'
         $$->expr[1] = $5;
         $$->expr[2] = $7; }
 
+   |   GSUM '(' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GSUM, $1, $3, NULL); }
+
+   |   GSUM '(' expr ',' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GSUM, $1, $3, $5); }
+
+   |   GMEAN '(' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GMEAN, $1, $3, NULL); }
+
+   |   GMEAN '(' expr ',' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GMEAN, $1, $3, $5); }
+
+   |   GMIN '(' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GMIN, $1, $3, NULL); }
+
+   |   GMIN '(' expr ',' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GMIN, $1, $3, $5); }
+
+   |   GMAX '(' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GMAX, $1, $3, NULL); }
+
+   |   GMAX '(' expr ',' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GMAX, $1, $3, $5); }
+
+   |   GCOUNT '(' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GCOUNT, $1, $3, NULL); }
+
+   |   GCOUNT '(' expr ',' expr ')'
+      { $$ = new_reduce_node(NODETYPE_GCOUNT, $1, $3, $5); }
+
    |   expr '?' expr ':' expr
       { $$ = new_node(3, node_is_scalar($3));
         $$->pos = $2;
@@ -466,6 +535,14 @@ letexpr   :   IDENT '=' expr ',' letexpr
         $$->expr[1] = $5; }
    ;
 
+offset   :   REAL
+      { $$ = $1; }
+   |   '+' REAL
+      { $$ = $2; }
+   |   '-' REAL
+      { $$ = -$2; }
+   ;
+
 vector   :   expr
       { $$ = new_vector_node(1);
         $$->pos = $1->pos;
@@ -483,6 +560,53 @@ vector   :   expr
 
 node_t root;
 
+/* Make a node for the value of an element of A at an offset from each
+   voxel. Offsets must be whole numbers of voxels. */
+static node_t new_shift_node(node_t vector, node_t index, int pos,
+                             double offset0, double offset1, double offset2)
+{
+   node_t n;
+   double offset[3];
+   int k;
+
+   if ((vector->type != NODETYPE_IDENT) ||
+       (strcmp(ident_str(vector->ident), "A") != 0)) {
+      yyerror("neighbourhood values are only available for A");
+   }
+   n = new_scalar_node(1);
+   n->type = NODETYPE_SHIFT;
+   n->pos = pos;
+   n->expr[0] = index;
+   offset[0] = offset0;
+   offset[1] = offset1;
+   offset[2] = offset2;
+   for (k=0; k < 3; k++) {
+      if ((offset[k] > (double) INT_MAX) || (offset[k] < (double) -INT_MAX) ||
+          (offset[k] != (double) (int) offset[k])) {
+         yyerror("neighbourhood offsets must be whole numbers");
+      }
+      n->offset[k] = (int) offset[k];
+   }
+   return n;
+}
+
+/* Make a node for a reduction of an expression over the voxels of the
+   image where the mask (if any) is true */
+static node_t new_reduce_node(int type, int pos, node_t values, node_t mask)
+{
+   node_t n;
+
+   if (!node_is_scalar(values) || ((mask != NULL) && !node_is_scalar(mask))) {
+      yyerror("global reductions need scalar arguments");
+   }
+   n = new_scalar_node((mask == NULL) ? 1 : 2);
+   n->type = type;
+   n->pos = pos;
+   n->expr[0] = values;
+   n->expr[1] = mask;
+   return n;
+}
+
 void
 yyerror(msg)
    const char *msg;
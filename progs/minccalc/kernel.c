@@ -0,0 +1,186 @@
+/* Elementwise operations of minccalc on blocks of values.
+
+   Each operation has its own loop, with no branches other than selects,
+   so that the compiler can vectorize it. Invalid arguments are found by
+   comparing the whole block against INVALID_VALUE and the result is
+   replaced where any argument is invalid, rather than testing each value
+   before doing the operation. Operations are done on every value, since
+   they have no side effects; the values that are not wanted are never
+   used. Functions from libm (pow, exp, log and the trigonometric
+   functions) are still called one value at a time, so that results do
+   not depend on the vector math library.
+
+   Copyright David Leonard and Andrew Janke, 2000. All rights reserved. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "node.h"
+
+#define INVALID_VALUE -DBL_MAX
+
+extern double value_for_illegal_operations;
+
+/* Loops for each number of arguments, done in chunks. The operation is
+   first done whether or not the arguments are valid, and the result is
+   then selected, which leaves no branches in either loop. The result may
+   be the same array as an argument. */
+#define KERNEL_CHUNK 256
+
+#define CHUNK_LOOP(nargs, expr, select) \
+   for (start=0; start < width; start += KERNEL_CHUNK) { \
+      nvalues = (width - start < KERNEL_CHUNK) ? width - start : KERNEL_CHUNK; \
+      for (ivalue=0; ivalue < nvalues; ivalue++) { \
+         x = a[start+ivalue]; \
+         if (nargs > 1) y = b[start+ivalue]; \
+         if (nargs > 2) z = c[start+ivalue]; \
+         value[ivalue] = (expr); \
+      } \
+      for (ivalue=0; ivalue < nvalues; ivalue++) { \
+         invalid = (a[start+ivalue] == INVALID_VALUE); \
+         if (nargs > 1) invalid |= (b[start+ivalue] == INVALID_VALUE); \
+         if (nargs > 2) invalid |= (c[start+ivalue] == INVALID_VALUE); \
+         result[start+ivalue] = invalid ? INVALID_VALUE : (select); \
+      } \
+   } \
+   break
+
+#define UNARY_KERNEL(expr) CHUNK_LOOP(1, expr, value[ivalue])
+#define BINARY_KERNEL(expr) CHUNK_LOOP(2, expr, value[ivalue])
+#define TERNARY_KERNEL(expr) CHUNK_LOOP(3, expr, value[ivalue])
+
+/* Loops for library functions, which are only called for valid values */
+#define UNARY_CALL(expr) \
+   for (ivalue=0; ivalue < width; ivalue++) { \
+      x = a[ivalue]; \
+      result[ivalue] = (x == INVALID_VALUE) ? INVALID_VALUE : (expr); \
+   } \
+   break
+
+#define BINARY_CALL(expr) \
+   for (ivalue=0; ivalue < width; ivalue++) { \
+      x = a[ivalue]; \
+      y = b[ivalue]; \
+      result[ivalue] = ((x == INVALID_VALUE) || (y == INVALID_VALUE)) ? \
+         INVALID_VALUE : (expr); \
+   } \
+   break
+
+/* Square root of a block. Negative values give the illegal value. */
+static void sqrt_kernel(int width, double *a, double *result,
+                        double illegal)
+{
+   int ivalue;
+   double x;
+
+   ivalue = 0;
+#ifdef __SSE2__
+   /* sqrt is exact to the last bit, so the SSE2 instruction gives the
+      same values as the library call */
+   {
+      __m128d vx, vroot, vinvalid, vnegative, vinvalid_value, villegal;
+
+      vinvalid_value = _mm_set1_pd(INVALID_VALUE);
+      villegal = _mm_set1_pd(illegal);
+      for (; ivalue + 2 <= width; ivalue += 2) {
+         vx = _mm_loadu_pd(&a[ivalue]);
+         vinvalid = _mm_cmpeq_pd(vx, vinvalid_value);
+         vnegative = _mm_cmplt_pd(vx, _mm_setzero_pd());
+         vroot = _mm_sqrt_pd(_mm_andnot_pd(vnegative, vx));
+         vroot = _mm_or_pd(_mm_and_pd(vnegative, villegal),
+                           _mm_andnot_pd(vnegative, vroot));
+         vroot = _mm_or_pd(_mm_and_pd(vinvalid, vinvalid_value),
+                           _mm_andnot_pd(vinvalid, vroot));
+         _mm_storeu_pd(&result[ivalue], vroot);
+      }
+   }
+#endif
+   for (; ivalue < width; ivalue++) {
+      x = a[ivalue];
+      result[ivalue] = (x == INVALID_VALUE) ? INVALID_VALUE :
+         ((x < 0.0) ? illegal : sqrt(x));
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : eval_kernel
+@INPUT      : type - node type of an operation with all arguments scalar
+                 (ALLARGS_SCALAR)
+              width - number of values
+              args - values of each argument
+@OUTPUT     : result - values of operation (may be one of args)
+@RETURNS    : (nothing)
+@DESCRIPTION: Does an elementwise operation on a block of values. Where
+              any argument is invalid the result is invalid, except for
+              isnan, which gives 1.
+@METHOD     :
+@GLOBALS    : value_for_illegal_operations
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void eval_kernel(int type, int width, double *args[], double *result)
+{
+   int start, nvalues, ivalue, invalid;
+   double *a, *b, *c, x, y, z, value[KERNEL_CHUNK];
+   double illegal = value_for_illegal_operations;
+
+   a = args[0];
+   b = args[1];
+   c = args[2];
+
+   switch (type) {
+   case NODETYPE_ADD: BINARY_KERNEL(x + y);
+   case NODETYPE_SUB: BINARY_KERNEL(x - y);
+   case NODETYPE_MUL: BINARY_KERNEL(x * y);
+   case NODETYPE_DIV:
+      /* Divide zeros by one (adding zero to other values leaves them
+         as they are) and then select the illegal value */
+      CHUNK_LOOP(2, x / (y + (double) (y == 0.0)),
+                 (b[start+ivalue] == 0.0) ? illegal : value[ivalue]);
+   case NODETYPE_LT:  BINARY_KERNEL((x < y) ? 1.0 : 0.0);
+   case NODETYPE_LE:  BINARY_KERNEL((x <= y) ? 1.0 : 0.0);
+   case NODETYPE_GT:  BINARY_KERNEL((x > y) ? 1.0 : 0.0);
+   case NODETYPE_GE:  BINARY_KERNEL((x >= y) ? 1.0 : 0.0);
+   case NODETYPE_EQ:  BINARY_KERNEL((x == y) ? 1.0 : 0.0);
+   case NODETYPE_NE:  BINARY_KERNEL((x != y) ? 1.0 : 0.0);
+   case NODETYPE_AND:
+      BINARY_KERNEL(((x != 0.0) & (y != 0.0)) ? 1.0 : 0.0);
+   case NODETYPE_OR:
+      BINARY_KERNEL(((x != 0.0) | (y != 0.0)) ? 1.0 : 0.0);
+   case NODETYPE_NOT: UNARY_KERNEL((x == 0.0) ? 1.0 : 0.0);
+   case NODETYPE_ABS: UNARY_KERNEL(fabs(x));
+   case NODETYPE_CLAMP:
+      TERNARY_KERNEL((x < y) ? y : ((x > z) ? z : x));
+   case NODETYPE_SEGMENT:
+      TERNARY_KERNEL(((x >= y) & (x <= z)) ? 1.0 : 0.0);
+
+   case NODETYPE_POW: BINARY_CALL(pow(x, y));
+   case NODETYPE_EXP: UNARY_CALL(exp(x));
+   case NODETYPE_LOG: UNARY_CALL((x <= 0.0) ? illegal : log(x));
+   case NODETYPE_SIN: UNARY_CALL(sin(x));
+   case NODETYPE_COS: UNARY_CALL(cos(x));
+   case NODETYPE_TAN: UNARY_CALL(tan(x));
+   case NODETYPE_ASIN: UNARY_CALL(asin(x));
+   case NODETYPE_ACOS: UNARY_CALL(acos(x));
+   case NODETYPE_ATAN: UNARY_CALL(atan(x));
+
+   case NODETYPE_SQRT:
+      sqrt_kernel(width, a, result, illegal);
+      break;
+
+   case NODETYPE_ISNAN:
+      for (ivalue=0; ivalue < width; ivalue++)
+         result[ivalue] = (a[ivalue] == INVALID_VALUE) ? 1.0 : 0.0;
+      break;
+
+   default:
+      (void) fprintf(stderr, "Internal error: no kernel for node type %d\n",
+                     type);
+      exit(1);
+   }
+}
@@ -117,6 +117,9 @@ Mon May 21 01:01:01 EST 2000 - Original version "imgcalc" by David Leonard
 #include <float.h>
 #include <limits.h>
 #include <math.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include <ParseArgv.h>
 #include <voxel_loop.h>
 #include <time_stamp.h>
@@ -137,7 +140,48 @@ Mon May 21 01:01:01 EST 2000 - Original version "imgcalc" by David Leonard
 #define DEFAULT_DBL DBL_MAX
 #define DEFAULT_BOOL -1
 
+/* Default number of voxels evaluated at once. Each value of an expression
+   takes 8 kbytes, so that the input values and temporaries of an
+   expression over a few dozen files stay in the second level cache,
+   while the cost of walking the expression is spread over many voxels. */
+#define DEFAULT_EVAL_WIDTH 1024
+
+/* Evaluation state for a range of voxels. Each thread has its own
+   symbol table (with its own input vector and output symbols), compiled
+   program and pool of scalars, so that threads share only the
+   expression tree. */
+typedef struct {
+   pool_t pool;
+   sym_t sym;
+   vector_t A;
+   scalar_t *output_values;
+   scalar_t centre;           /* Position of values in the slab */
+   program_t program;
+   program_t *reduce_programs;  /* Arguments of the reductions of a pass */
+   long start;                /* Range of values to evaluate */
+   long end;
+   int input_num_buffers;
+   double **input_data;
+   int num_output;
+   double **output_data;
+} Calc_Worker;
+
 /* Function prototypes */
+static const char *find_carried_symbol(node_t n);
+static void setup_worker(Calc_Worker *worker, int nfiles);
+static void free_worker(Calc_Worker *worker);
+static program_t compile_worker(Calc_Worker *worker, node_t n);
+static void run_workers(long total_values, void *(*evaluate)(void *));
+static void load_block(Calc_Worker *worker, long ivox, long nvox);
+static double *evaluate_block(Calc_Worker *worker, program_t program, 
+                              node_t n, int width, scalar_t *scalar);
+static void *evaluate_range(void *arg);
+static void *reduce_range(void *arg);
+static void do_reduce(void *caller_data, long num_voxels, 
+                      int input_num_buffers, 
+                      int input_vector_length, double *input_data[],
+                      int output_num_buffers, int output_vector_length,
+                      double *output_data[], Loop_Info *loop_info);
 static void do_math(void *caller_data, long num_voxels, 
                     int input_num_buffers, 
                     int input_vector_length, double *input_data[],
@@ -168,7 +212,14 @@ static nc_type datatype = MI_ORIGINAL_TYPE;
 static char *filelist = NULL;
 static char *expr_file = NULL;
 char *expression = NULL;
-static int eval_width = 200;
+static int eval_width = DEFAULT_EVAL_WIDTH;
+static int compile_expression = TRUE;
+static int nthreads = 1;
+static int stencil = FALSE;
+static int nreduce = 0;                  /* Reductions of the current pass */
+static accum_t *reduce_totals = NULL;
+static accum_t *reduce_partials = NULL;  /* Each block of a buffer */
+static long reduce_partials_alloc = 0;
 #if MINC2
 static int minc2_format = FALSE;
 #endif /* MINC2 */
@@ -249,13 +300,17 @@ ArgvInfo argTable[] = {
           "Symbol to save in an output file (2 args)."}, 
    {"-eval_width",  ARGV_INT,  (char*)1,    (char*) &eval_width,
           "Number of voxels to evaluate simultaneously."}, 
+   {"-compile", ARGV_CONSTANT, (char *) TRUE, (char *) &compile_expression,
+       "Compile the expression before evaluating it (default)."},
+   {"-nocompile", ARGV_CONSTANT, (char *) FALSE, (char *) &compile_expression,
+       "Evaluate the expression tree directly."},
+   {"-threads", ARGV_INT, (char *) 1, (char *) &nthreads,
+       "Number of threads evaluating the expression (default 1)."},
    {NULL, ARGV_END, NULL, NULL, NULL}
 };
 
 extern int yydebug;
-sym_t      rootsym;
-vector_t   A;
-scalar_t   *Output_values;
+static Calc_Worker *workers;
 
 /* Main program */
 int main(int argc, char *argv[]){
@@ -264,9 +319,8 @@ int main(int argc, char *argv[]){
    char *arg_string;
    Loop_Options *loop_options;
    char *pname;
-   int i;
-   ident_t ident;
-   scalar_t scalar;
+   const char *carried_symbol;
+   int i, j, radius[3];
 
    /* Save time stamp and args */
    arg_string = time_stamp(argc, argv);
@@ -352,42 +406,41 @@ int main(int argc, char *argv[]){
    
    /* Optimize the expression tree */
    root = optimize(root);
-   
-   /* Setup the input vector from the input files */
-   A = new_vector();
-   for (i=0; i<nfiles; i++) {
-      if (debug) fprintf(stderr,"Getting file[%d] %s\n", i, argv[i+1]);
-      scalar = new_scalar(eval_width);
-      vector_append(A, scalar);
-      scalar_free(scalar);
+
+   /* Symbols set in the arguments of global reductions are only set in
+      the passes of the reductions, so they cannot be used elsewhere */
+   reduce_check(root);
+   for (i=0; i < Output_list_size; i++) {
+      reduce_check_output(Output_list[i].symbol);
    }
-      
-   /* Construct initial symbol table from the A vector. Since setting
-      a symbol makes a copy, we have to get a handle to that copy. */
-   rootsym = sym_enter_scope(NULL);
-   ident = new_ident("A");
-   sym_set_vector(eval_width, NULL, A, ident, rootsym);
-   vector_free(A);
-   A = sym_lookup_vector(ident, rootsym);
-   if (A==NULL) {
-      (void) fprintf(stderr, "Error initializing symbol table\n");
+
+   /* Neighbourhood values need the input files to be read around each
+      buffer */
+   for (i=0; i < 3; i++) radius[i] = 0;
+   stencil = stencil_radius(root, radius);
+   if (stencil) {
+      slab_open(nfiles, infiles, radius);
+   }
+   
+   /* Check the number of threads. Debugging output is only readable
+      from one thread. */
+   if (nthreads < 1) {
+      (void) fprintf(stderr, "Illegal number of threads (%d)\n", nthreads);
       exit(EXIT_FAILURE);
    }
-   vector_incr_ref(A);
+#ifndef HAVE_PTHREAD
+   nthreads = 1;
+#endif
+   if (debug) nthreads = 1;
 
-   /* Add output symbols to the table */
-   if (Output_list == NULL) {
-      Output_values = NULL;
-   }
-   else {
-      Output_values = malloc(Output_list_size * sizeof(*Output_values));
-      for (i=0; i < Output_list_size; i++) {
-         ident = ident_lookup(Output_list[i].symbol);
-         scalar = new_scalar(eval_width);
-         sym_set_scalar(eval_width, NULL, scalar, ident, rootsym);
-         scalar_free(scalar);
-         Output_values[i] = sym_lookup_scalar(ident, rootsym);
-      }
+   /* A symbol that keeps its value from one block to the next would get
+      it from another block with more than one thread */
+   if ((nthreads > 1) && 
+       ((carried_symbol = find_carried_symbol(root)) != NULL)) {
+      (void) fprintf(stderr, 
+         "Symbol %s may be used before it is set: using one thread\n",
+                     carried_symbol);
+      nthreads = 1;
    }
 
    /* Set default copy_all_header according to number of input files */
@@ -401,7 +454,13 @@ int main(int argc, char *argv[]){
          value_for_illegal_operations = 0.0;
    }
 
-   /* Do math */
+   /* Set up the symbol table of each thread */
+   workers = malloc(nthreads * sizeof(*workers));
+   for (i=0; i < nthreads; i++) {
+      setup_worker(&workers[i], nfiles);
+   }
+
+   /* Set up the looping */
    loop_options = create_loop_options();
    set_loop_verbose(loop_options, verbose);
    set_loop_clobber(loop_options, clobber);
@@ -418,32 +477,234 @@ int main(int argc, char *argv[]){
       }
    
    set_loop_check_dim_info(loop_options, check_dim_info);
+
+   /* Get the global reductions, with a pass through the input files for
+      each level of nesting */
+   while ((nreduce = reduce_find(root)) > 0) {
+      reduce_totals = malloc(nreduce * sizeof(*reduce_totals));
+      for (j=0; j < nreduce; j++) {
+         reduce_init(&reduce_totals[j]);
+      }
+      for (i=0; i < nthreads; i++) {
+         workers[i].reduce_programs = 
+            malloc(2 * nreduce * sizeof(*workers[i].reduce_programs));
+         for (j=0; j < 2 * nreduce; j++) {
+            workers[i].reduce_programs[j] = 
+               compile_worker(&workers[i], reduce_arg(j / 2, j % 2));
+         }
+      }
+      voxel_loop(nfiles, infiles, 0, NULL, NULL, loop_options,
+                 do_reduce, NULL);
+      reduce_finish(reduce_totals);
+      for (i=0; i < nthreads; i++) {
+         for (j=0; j < 2 * nreduce; j++) {
+            free_program(workers[i].reduce_programs[j]);
+         }
+         free(workers[i].reduce_programs);
+         workers[i].reduce_programs = NULL;
+      }
+      free(reduce_totals);
+   }
+   if (reduce_partials != NULL) free(reduce_partials);
+
+   /* Compile the expression, now that the reductions are constants */
+   for (i=0; i < nthreads; i++) {
+      workers[i].program = compile_worker(&workers[i], root);
+   }
+
+   /* Do math */
    voxel_loop(nfiles, infiles, nout, outfiles, arg_string, loop_options,
               do_math, NULL);
    free_loop_options(loop_options);
 
    
    /* Clean up */
-   vector_free(A);
-   sym_leave_scope(rootsym);
+   for (i=0; i < nthreads; i++) {
+      free_worker(&workers[i]);
+   }
+   free(workers);
+   if (stencil) slab_close();
    if (expr_file != NULL) free(expression);
    free(outfiles);
    if (Output_list != NULL) free(Output_list);
-   if (Output_values != NULL) free(Output_values);
    exit(EXIT_SUCCESS);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : find_carried_symbol
+@INPUT      : n - expression
+@OUTPUT     : (none)
+@RETURNS    : Name of a symbol, or NULL if there is none
+@DESCRIPTION: Finds a symbol whose value in a block may be the one it was
+              left with by the block before: one that the expression may
+              use before setting it, or an output symbol that it may not
+              set. Such an expression must be evaluated with one thread,
+              in file order, since with more the block before is not the
+              same one.
+@METHOD     : 
+@GLOBALS    : Output_list
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static const char *find_carried_symbol(node_t n)
+{
+   int iout;
+   ident_t ident;
+
+   ident = sym_find_unset(n);
+   if (ident >= 0) return ident_str(ident);
+   if (Output_list != NULL) {
+      for (iout=0; iout < Output_list_size; iout++) {
+         ident = ident_lookup(Output_list[iout].symbol);
+         if ((ident < 0) || !sym_surely_set(ident))
+            return Output_list[iout].symbol;
+      }
+   }
+   return NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : setup_worker
+@INPUT      : nfiles - number of input files
+@OUTPUT     : worker - evaluation state to set up
+@RETURNS    : (nothing)
+@DESCRIPTION: Makes the pool of scalars of the worker and builds a symbol
+              table holding the input vector A and the output symbols.
+@METHOD     : 
+@GLOBALS    : root, eval_width, Output_list
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void setup_worker(Calc_Worker *worker, int nfiles)
+{
+   int i;
+   ident_t ident;
+   scalar_t scalar;
+   vector_t A;
+
+   /* Everything the worker makes comes from its pool */
+   worker->pool = new_pool();
+   pool_use(worker->pool);
+
+   /* Setup the input vector from the input files */
+   A = new_vector();
+   for (i=0; i<nfiles; i++) {
+      scalar = new_scalar(eval_width);
+      vector_append(A, scalar);
+      scalar_free(scalar);
+   }
+      
+   /* Construct initial symbol table from the A vector. Since setting
+      a symbol makes a copy, we have to get a handle to that copy. */
+   worker->sym = sym_enter_scope(NULL);
+   ident = new_ident("A");
+   sym_set_vector(eval_width, NULL, A, ident, worker->sym);
+   vector_free(A);
+   worker->A = sym_lookup_vector(ident, worker->sym);
+   if (worker->A == NULL) {
+      (void) fprintf(stderr, "Error initializing symbol table\n");
+      exit(EXIT_FAILURE);
+   }
+   vector_incr_ref(worker->A);
+
+   /* Add output symbols to the table */
+   if (Output_list == NULL) {
+      worker->output_values = NULL;
+   }
+   else {
+      worker->output_values = 
+         malloc(Output_list_size * sizeof(*worker->output_values));
+      for (i=0; i < Output_list_size; i++) {
+         ident = ident_lookup(Output_list[i].symbol);
+         scalar = new_scalar(eval_width);
+         sym_set_scalar(eval_width, NULL, scalar, ident, worker->sym);
+         scalar_free(scalar);
+         worker->output_values[i] = sym_lookup_scalar(ident, worker->sym);
+      }
+   }
+
+   /* Add the position of each value in the slab for neighbourhood
+      values */
+   worker->centre = NULL;
+   if (stencil) {
+      scalar = new_scalar(eval_width);
+      sym_set_scalar(eval_width, NULL, scalar, slab_centre_ident(),
+                     worker->sym);
+      scalar_free(scalar);
+      worker->centre = sym_lookup_scalar(slab_centre_ident(), worker->sym);
+   }
+
+   worker->program = NULL;
+   worker->reduce_programs = NULL;
+
+   pool_use(NULL);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : free_worker
+@INPUT      : worker - evaluation state
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Frees what setup_worker allocated.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void free_worker(Calc_Worker *worker)
+{
+   free_program(worker->program);
+   vector_free(worker->A);
+   sym_leave_scope(worker->sym);
+   if (worker->output_values != NULL) free(worker->output_values);
+   free_pool(worker->pool);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : compile_worker
+@INPUT      : worker - evaluation state
+              n - expression to compile, or NULL
+@OUTPUT     : (none)
+@RETURNS    : Compiled program, or NULL if the tree is to be evaluated
+@DESCRIPTION: Compiles an expression against the symbol table of a worker.
+              The expression tree is used if it cannot be compiled or 
+              debugging output of the evaluation is wanted.
+@METHOD     : 
+@GLOBALS    : compile_expression, debug, eval_width
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static program_t compile_worker(Calc_Worker *worker, node_t n)
+{
+   program_t program;
+
+   if ((n == NULL) || !compile_expression || debug) return NULL;
+
+   pool_use(worker->pool);
+   program = compile_program(n, worker->sym, eval_width);
+   pool_use(NULL);
+
+   return program;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : do_math
 @INPUT      : Standard for voxel loop
 @OUTPUT     : Standard for voxel loop
 @RETURNS    : (nothing)
 @DESCRIPTION: Routine doing math operations.
-@METHOD     : 
-@GLOBALS    : Output_values, A
+@METHOD     : The buffer is split into ranges of whole blocks of 
+              eval_width values, one for each thread. Blocks hold the
+              same values as when there is a single thread.
+@GLOBALS    : workers, nthreads
 @CALLS      : 
 @CREATED    : April 25, 1995 (Peter Neelin)
 @MODIFIED   : Thu Dec 21 17:08:40 EST 2000 (Andrew Janke - a.janke@gmail.com)
+@MODIFIED   : October 16, 2026 - split buffer between threads
 ---------------------------------------------------------------------------- */
 static void do_math(void *caller_data, long num_voxels, 
                     int input_num_buffers, int input_vector_length,
@@ -451,10 +712,10 @@ static void do_math(void *caller_data, long num_voxels,
                     int output_num_buffers, int output_vector_length,
                     double *output_data[],
                     Loop_Info *loop_info){
-   long ivox, ibuff, ivalue, nvox;
-   scalar_t scalar, *output_scalars;
-   int num_output, iout;
    long total_values;  /* Total # of values to process in this call */
+   int iworker;
+   Calc_Worker *worker;
+   long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
 
    /* Check arguments */
    if ((output_num_buffers < 1) || 
@@ -465,20 +726,247 @@ static void do_math(void *caller_data, long num_voxels,
 
    total_values = num_voxels * input_vector_length;
 
+   /* Get the neighbourhood of the buffer */
+   if (stencil) {
+      get_info_shape(loop_info, MAX_VAR_DIMS, start, count);
+      slab_load(start, count, input_data);
+   }
+
+   /* Give the buffers to each thread */
+   for (iworker=0; iworker < nthreads; iworker++) {
+      worker = &workers[iworker];
+      worker->input_num_buffers = input_num_buffers;
+      worker->input_data = input_data;
+      worker->num_output = (worker->output_values == NULL) ? 
+         1 : Output_list_size;
+      worker->output_data = output_data;
+   }
+
+   run_workers(total_values, evaluate_range);
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : do_reduce
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine adding the values of a buffer to the global 
+              reductions of a pass.
+@METHOD     : Each block of eval_width values is accumulated on its own
+              by the thread that evaluates it, and the blocks are then
+              added to the totals in order, so that the totals do not 
+              depend on the number of threads.
+@GLOBALS    : nreduce, reduce_totals, reduce_partials
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void do_reduce(void *caller_data, long num_voxels, 
+                      int input_num_buffers, int input_vector_length,
+                      double *input_data[],
+                      int output_num_buffers, int output_vector_length,
+                      double *output_data[],
+                      Loop_Info *loop_info){
+   long total_values, nblocks, iblock;
+   int iworker, ireduce;
+   long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+
+   total_values = num_voxels * input_vector_length;
+
+   /* Get the neighbourhood of the buffer */
+   if (stencil) {
+      get_info_shape(loop_info, MAX_VAR_DIMS, start, count);
+      slab_load(start, count, input_data);
+   }
+
+   /* Get space for the blocks */
+   nblocks = (total_values + eval_width - 1) / eval_width;
+   if (nblocks * nreduce > reduce_partials_alloc) {
+      if (reduce_partials != NULL) free(reduce_partials);
+      reduce_partials_alloc = nblocks * nreduce;
+      reduce_partials = 
+         malloc(reduce_partials_alloc * sizeof(*reduce_partials));
+   }
+
+   /* Give the buffers to each thread */
+   for (iworker=0; iworker < nthreads; iworker++) {
+      workers[iworker].input_num_buffers = input_num_buffers;
+      workers[iworker].input_data = input_data;
+   }
+
+   run_workers(total_values, reduce_range);
+
+   /* Add up the blocks */
+   for (iblock=0; iblock < nblocks; iblock++) {
+      for (ireduce=0; ireduce < nreduce; ireduce++) {
+         reduce_merge(&reduce_totals[ireduce], 
+                      &reduce_partials[iblock * nreduce + ireduce]);
+      }
+   }
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : run_workers
+@INPUT      : total_values - number of values in the buffers
+              evaluate - function evaluating the range of a worker
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Splits the buffers into ranges of whole blocks of 
+              eval_width values, one for each thread, and evaluates them.
+@METHOD     : 
+@GLOBALS    : workers, nthreads, eval_width
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void run_workers(long total_values, void *(*evaluate)(void *))
+{
+   long nblocks, end;
+   int nworkers, iworker;
+   Calc_Worker *worker;
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+   int *started;
+#endif
+
+   /* Give each thread a range of blocks */
+   nblocks = (total_values + eval_width - 1) / eval_width;
+   nworkers = (nblocks < nthreads) ? (int) nblocks : nthreads;
+   if (nworkers < 1) nworkers = 1;
+   for (iworker=0; iworker < nworkers; iworker++) {
+      worker = &workers[iworker];
+      worker->start = (nblocks * iworker / nworkers) * eval_width;
+      end = (nblocks * (iworker+1) / nworkers) * eval_width;
+      worker->end = (end < total_values) ? end : total_values;
+   }
+
+   /* Evaluate the ranges */
+#ifdef HAVE_PTHREAD
+   if (nworkers > 1) {
+      threads = malloc(sizeof(pthread_t) * nworkers);
+      started = malloc(sizeof(int) * nworkers);
+      for (iworker=1; iworker < nworkers; iworker++) {
+         started[iworker] = (pthread_create(&threads[iworker], NULL, 
+                                            evaluate, 
+                                            &workers[iworker]) == 0);
+      }
+      (void) evaluate(&workers[0]);
+      for (iworker=1; iworker < nworkers; iworker++) {
+         if (started[iworker])
+            (void) pthread_join(threads[iworker], NULL);
+         else
+            (void) evaluate(&workers[iworker]);
+      }
+      free(threads);
+      free(started);
+      return;
+   }
+#endif /* HAVE_PTHREAD */
+
+   (void) evaluate(&workers[0]);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : load_block
+@INPUT      : worker - evaluation state
+              ivox - index of the first value of the block in the buffers
+              nvox - number of values
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Sets the symbols of a worker for a block of values: the
+              input vector A and the positions of the values in the slab.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void load_block(Calc_Worker *worker, long ivox, long nvox)
+{
+   long ibuff, ivalue;
+
+   /* Copy the data into the A vector */
+   for (ivalue=0; ivalue < nvox; ivalue++) {
+      for (ibuff=0; ibuff < worker->input_num_buffers; ibuff++){
+         worker->A->el[ibuff]->vals[ivalue] = 
+            worker->input_data[ibuff][ivox+ivalue];
+      }
+   }
+
+   /* Find the values in the slab */
+   if (worker->centre != NULL) {
+      slab_centres(ivox, (int) nvox, worker->centre->vals);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_block
+@INPUT      : worker - evaluation state
+              program - compiled expression, or NULL
+              n - expression
+              width - number of values
+@OUTPUT     : scalar - scalar to free once the values are used, or NULL
+@RETURNS    : Values of the expression
+@DESCRIPTION: Evaluates an expression for the block loaded into a worker,
+              with its program if it was compiled.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static double *evaluate_block(Calc_Worker *worker, program_t program, 
+                              node_t n, int width, scalar_t *scalar)
+{
+   if (program != NULL) {
+      *scalar = NULL;
+      return run_program(program, width);
+   }
+   *scalar = eval_scalar(width, NULL, n, worker->sym);
+   return (*scalar)->vals;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : evaluate_range
+@INPUT      : arg - pointer to Calc_Worker giving the range of values and
+                 the buffers
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Evaluates the expression for a range of values of the 
+              voxel_loop buffers, eval_width values at a time, using
+              the symbol table of the worker. Can be run as a thread.
+@METHOD     : 
+@GLOBALS    : root, eval_width, debug
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *evaluate_range(void *arg)
+{
+   Calc_Worker *worker = (Calc_Worker *) arg;
+   long ivox, ivalue, nvox;
+   scalar_t scalar;
+   double *result, *output_vals;
+   int iout;
+
+   /* Temporaries of the expression are taken from and given back to the
+      pool of the worker, so that once the first block has been done
+      no more memory is allocated */
+   pool_use(worker->pool);
+
    /* Loop through the voxels */
-   for (ivox=0; ivox < total_values; ivox+=eval_width) {
+   for (ivox=worker->start; ivox < worker->end; ivox+=eval_width) {
 
       /* Figure out how many voxels to work on at once */
       nvox = eval_width;
-      if (ivox + nvox > total_values) 
-          nvox = total_values - ivox;
+      if (ivox + nvox > worker->end) 
+          nvox = worker->end - ivox;
       
-      /* Copy the data into the A vector */
-      for (ivalue=0; ivalue < nvox; ivalue++) {
-         for (ibuff=0; ibuff < input_num_buffers; ibuff++){
-            A->el[ibuff]->vals[ivalue] = input_data[ibuff][ivox+ivalue];
-         }
-      }
+      load_block(worker, ivox, nvox);
 
       /* Some debugging */
       if (debug) {
@@ -486,37 +974,93 @@ static void do_math(void *caller_data, long num_voxels,
       }
 
       /* Evaluate the expression */
-      scalar = eval_scalar((int) nvox, NULL, root, rootsym);
-
-      /* Get the list of scalar values to write out */
-      if (Output_values == NULL) {
-         num_output = 1;
-         output_scalars = &scalar;
-      }
-      else {
-         num_output = Output_list_size;
-         output_scalars = Output_values;
-      }
+      result = evaluate_block(worker, worker->program, root, (int) nvox,
+                              &scalar);
 
       /* Copy the scalar values into the right buffers */
-      for (iout=0; iout < num_output; iout++) {
+      for (iout=0; iout < worker->num_output; iout++) {
+         output_vals = (worker->output_values == NULL) ? 
+            result : worker->output_values[iout]->vals;
          for (ivalue=0; ivalue < nvox; ivalue++) {
-            output_data[iout][ivox+ivalue] = 
-               output_scalars[iout]->vals[ivalue];
+            worker->output_data[iout][ivox+ivalue] = output_vals[ivalue];
          }
       }
 
       /* Free things up */
-      scalar_free(scalar);
+      if (scalar != NULL) scalar_free(scalar);
 
       if (debug) {
-         (void) printf("Voxel result = %g\n", output_data[0][ivox]);
+         (void) printf("Voxel result = %g\n", worker->output_data[0][ivox]);
       }
          
 
    }
 
-   return;
+   pool_use(NULL);
+
+   return NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_range
+@INPUT      : arg - pointer to Calc_Worker giving the range of values and
+                 the buffers
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Accumulates the arguments of the reductions of a pass for
+              each block of a range of values of the voxel_loop buffers.
+              Can be run as a thread.
+@METHOD     : 
+@GLOBALS    : nreduce, reduce_partials, eval_width
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *reduce_range(void *arg)
+{
+   Calc_Worker *worker = (Calc_Worker *) arg;
+   long ivox, nvox;
+   int ireduce;
+   scalar_t scalar, mask_scalar;
+   double *values, *mask;
+   node_t mask_node;
+   accum_t *accum;
+
+   pool_use(worker->pool);
+
+   for (ivox=worker->start; ivox < worker->end; ivox+=eval_width) {
+
+      nvox = eval_width;
+      if (ivox + nvox > worker->end) 
+          nvox = worker->end - ivox;
+
+      load_block(worker, ivox, nvox);
+
+      /* Accumulate the block on its own */
+      accum = &reduce_partials[(ivox / eval_width) * nreduce];
+      for (ireduce=0; ireduce < nreduce; ireduce++) {
+         values = evaluate_block(worker, 
+                                 worker->reduce_programs[2*ireduce],
+                                 reduce_arg(ireduce, 0), (int) nvox,
+                                 &scalar);
+         mask = NULL;
+         mask_scalar = NULL;
+         mask_node = reduce_arg(ireduce, 1);
+         if (mask_node != NULL) {
+            mask = evaluate_block(worker, 
+                                  worker->reduce_programs[2*ireduce+1],
+                                  mask_node, (int) nvox, &mask_scalar);
+         }
+         reduce_init(&accum[ireduce]);
+         reduce_values(&accum[ireduce], (int) nvox, values, mask);
+         if (scalar != NULL) scalar_free(scalar);
+         if (mask_scalar != NULL) scalar_free(mask_scalar);
+      }
+   }
+
+   pool_use(NULL);
+
+   return NULL;
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -52,6 +52,12 @@ nodenames[] = {
         { NODETYPE_ASSIGN,   "assign" },
         { NODETYPE_IFELSE,   "ifelse" },
         { NODETYPE_FOR,      "for" },
+        { NODETYPE_SHIFT,    "shift" },
+        { NODETYPE_GSUM,     "gsum" },
+        { NODETYPE_GMEAN,    "gmean" },
+        { NODETYPE_GMIN,     "gmin" },
+        { NODETYPE_GMAX,     "gmax" },
+        { NODETYPE_GCOUNT,   "gcount" },
         { (enum nodetype) 0, NULL }
 };
 
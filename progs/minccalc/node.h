@@ -10,6 +10,7 @@ typedef struct node    *node_t;
 typedef struct scalar  *scalar_t;
 typedef struct vector  *vector_t;
 typedef struct sym     *sym_t;
+typedef struct pool    *pool_t;
 
 #define SCALAR_ROUND(s)   (floor(s + 0.5))
 
@@ -17,6 +18,8 @@ struct scalar {
    int      width;
    double   *vals;
    int      refcnt;
+   pool_t   pool;
+   scalar_t next_free;
 };
 
 struct vector {
@@ -24,6 +27,8 @@ struct vector {
    scalar_t *el;
    int      maxlen;
    int      refcnt;
+   pool_t   pool;
+   vector_t next_free;
 };
 
 enum nodetype {
@@ -73,7 +78,13 @@ enum nodetype {
    NODETYPE_EXPRLIST,
    NODETYPE_ASSIGN,
    NODETYPE_IFELSE,
-   NODETYPE_FOR
+   NODETYPE_FOR,
+   NODETYPE_SHIFT,
+   NODETYPE_GSUM,
+   NODETYPE_GMEAN,
+   NODETYPE_GMIN,
+   NODETYPE_GMAX,
+   NODETYPE_GCOUNT
 };
 
 #define RANGE_EXACT_UPPER   1
@@ -81,6 +92,14 @@ enum nodetype {
 #define ALLARGS_SCALAR      4
 #define NODE_IS_SCALAR      8
 
+/* Accumulator of a global reduction */
+typedef struct {
+   double sum;
+   double count;
+   double min;
+   double max;
+} accum_t;
+
 struct node {
    enum nodetype type;
    node_t expr[3];
@@ -89,6 +108,7 @@ struct node {
    double real;
    int   pos;
    int   numargs;
+   int   offset[3];     /* Neighbourhood offset of NODETYPE_SHIFT */
 };
 
 ident_t       new_ident(const char *);
@@ -112,6 +132,15 @@ scalar_t    new_scalar(int);
 void        scalar_free(scalar_t);
 void        scalar_incr_ref(scalar_t);
 
+pool_t      new_pool(void);
+void        free_pool(pool_t);
+void        pool_use(pool_t);
+pool_t      pool_current(void);
+scalar_t    pool_get_scalar(pool_t, int);
+void        pool_put_scalar(scalar_t);
+vector_t    pool_get_vector(pool_t);
+void        pool_put_vector(vector_t);
+
 sym_t sym_enter_scope(sym_t sym);
 void sym_leave_scope(sym_t sym);
 void sym_declare_ident(ident_t id, sym_t sym);
@@ -119,12 +148,41 @@ void sym_set_scalar(int, int *, scalar_t, ident_t, sym_t);
 void sym_set_vector(int, int *, vector_t, ident_t, sym_t);
 scalar_t sym_lookup_scalar(ident_t id, sym_t sym);
 vector_t sym_lookup_vector(ident_t id, sym_t sym);
+scalar_t sym_find_scalar(ident_t id, sym_t sym);
+vector_t sym_find_vector(ident_t id, sym_t sym);
+ident_t sym_find_unset(node_t n);
+int sym_surely_set(ident_t id);
 
 void       lex_init(const char *);
 void       lex_finalize(void);
 
 scalar_t   eval_scalar(int, int *, node_t, sym_t);
 void       show_error(int, const char *);
+void       eval_kernel(int, int, double *[], double *);
+
+int        stencil_radius(node_t, int [3]);
+void       slab_open(int, char *[], int [3]);
+void       slab_close(void);
+void       slab_load(long [], long [], double *[]);
+void       slab_centres(long, int, double *);
+long       slab_offset(int [3]);
+double     *slab_values(int);
+ident_t    slab_centre_ident(void);
+
+void       reduce_check(node_t);
+void       reduce_check_output(char *);
+int        reduce_find(node_t);
+node_t     reduce_arg(int, int);
+void       reduce_init(accum_t *);
+void       reduce_values(accum_t *, int, double *, double *);
+void       reduce_merge(accum_t *, accum_t *);
+void       reduce_finish(accum_t []);
+
+typedef struct program *program_t;
+
+program_t  compile_program(node_t, sym_t, int);
+double     *run_program(program_t, int);
+void       free_program(program_t);
 
 int      yyparse(void);
 int      yylex(void);
@@ -0,0 +1,165 @@
+/* Free lists of scalars and vectors for minccalc.
+
+   Evaluating an expression makes and frees a scalar for nearly every node
+   of the tree on every block of voxels. A pool keeps the scalars (with
+   their values) and vectors (with their element arrays) that are freed,
+   so that later blocks reuse them instead of calling malloc and free.
+   Scalars are kept by width, since the width of a block only changes for
+   the last block of a buffer.
+
+   Each thread evaluates with its own pool, which it makes current with
+   pool_use. Scalars and vectors made while a pool is current go back to
+   that pool when they are freed; those made with no current pool are
+   freed as before.
+
+   Copyright David Leonard and Andrew Janke, 2000. All rights reserved. */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#include "node.h"
+
+/* Free scalars of one width */
+typedef struct bucket {
+   int width;
+   scalar_t free_scalars;
+   struct bucket *next;
+} bucket_t;
+
+struct pool {
+   bucket_t *buckets;
+   vector_t free_vectors;
+};
+
+/* Current pool of each thread */
+#ifdef HAVE_PTHREAD
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+
+static void make_pool_key(void)
+{
+   (void) pthread_key_create(&pool_key, NULL);
+}
+#else
+static pool_t current_pool = NULL;
+#endif
+
+pool_t new_pool(void)
+{
+   pool_t pool;
+
+   pool = malloc(sizeof *pool);
+   pool->buckets = NULL;
+   pool->free_vectors = NULL;
+   return pool;
+}
+
+void free_pool(pool_t pool)
+{
+   bucket_t *bucket;
+   scalar_t s;
+   vector_t v;
+
+   if (pool == NULL) return;
+   if (pool_current() == pool) pool_use(NULL);
+   while (pool->buckets != NULL) {
+      bucket = pool->buckets;
+      while (bucket->free_scalars != NULL) {
+         s = bucket->free_scalars;
+         bucket->free_scalars = s->next_free;
+         free(s->vals);
+         free(s);
+      }
+      pool->buckets = bucket->next;
+      free(bucket);
+   }
+   while (pool->free_vectors != NULL) {
+      v = pool->free_vectors;
+      pool->free_vectors = v->next_free;
+      free(v->el);
+      free(v);
+   }
+   free(pool);
+}
+
+void pool_use(pool_t pool)
+{
+#ifdef HAVE_PTHREAD
+   (void) pthread_once(&pool_key_once, make_pool_key);
+   (void) pthread_setspecific(pool_key, pool);
+#else
+   current_pool = pool;
+#endif
+}
+
+pool_t pool_current(void)
+{
+#ifdef HAVE_PTHREAD
+   (void) pthread_once(&pool_key_once, make_pool_key);
+   return (pool_t) pthread_getspecific(pool_key);
+#else
+   return current_pool;
+#endif
+}
+
+/* Find the bucket for a width, adding it if asked */
+static bucket_t *find_bucket(pool_t pool, int width, int add)
+{
+   bucket_t *bucket;
+
+   for (bucket=pool->buckets; bucket != NULL; bucket=bucket->next) {
+      if (bucket->width == width) return bucket;
+   }
+   if (!add) return NULL;
+   bucket = malloc(sizeof *bucket);
+   bucket->width = width;
+   bucket->free_scalars = NULL;
+   bucket->next = pool->buckets;
+   pool->buckets = bucket;
+   return bucket;
+}
+
+scalar_t pool_get_scalar(pool_t pool, int width)
+{
+   bucket_t *bucket;
+   scalar_t s;
+
+   bucket = find_bucket(pool, width, 0);
+   if ((bucket == NULL) || (bucket->free_scalars == NULL)) return NULL;
+   s = bucket->free_scalars;
+   bucket->free_scalars = s->next_free;
+   s->next_free = NULL;
+   return s;
+}
+
+void pool_put_scalar(scalar_t s)
+{
+   bucket_t *bucket;
+
+   bucket = find_bucket(s->pool, s->width, 1);
+   s->next_free = bucket->free_scalars;
+   bucket->free_scalars = s;
+}
+
+vector_t pool_get_vector(pool_t pool)
+{
+   vector_t v;
+
+   v = pool->free_vectors;
+   if (v == NULL) return NULL;
+   pool->free_vectors = v->next_free;
+   v->next_free = NULL;
+   return v;
+}
+
+void pool_put_vector(vector_t v)
+{
+   v->next_free = v->pool->free_vectors;
+   v->pool->free_vectors = v;
+}
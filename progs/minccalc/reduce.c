@@ -0,0 +1,423 @@
+/* Global reductions of minccalc.
+
+   An expression such as gmean(A[0], A[1] > 0.5) has one value for the
+   whole image: the mean of A[0] over the voxels where A[1] > 0.5. Before
+   the expression is evaluated voxel by voxel, the arguments of the
+   reductions are evaluated over the whole image in a pass of their own,
+   which only reads the input files. Each reduction node is then turned
+   into a constant holding its result, so that the voxel by voxel
+   evaluation (and the compiled program) just uses the cached value.
+
+   A reduction inside the argument of another needs its own pass first,
+   so each pass does the reductions that have no others inside them,
+   until none are left.
+
+   Values are accumulated for each block of eval_width values by the
+   thread that evaluates it, and the blocks are then added up in order,
+   so that results do not depend on the number of threads. Invalid
+   values, and values where the mask is invalid or zero, are left out.
+
+   Copyright David Leonard and Andrew Janke, 2000. All rights reserved. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include "node.h"
+
+#define INVALID_VALUE -DBL_MAX
+
+#ifndef TRUE
+#  define TRUE 1
+#endif
+
+#ifndef FALSE
+#  define FALSE 0
+#endif
+
+extern int debug;
+
+/* Reductions of the current pass */
+static node_t *reductions = NULL;
+static int nreductions = 0;
+static int reductions_alloc = 0;
+
+/* Check whether a node is a global reduction */
+static int is_reduction(node_t n)
+{
+   switch (n->type) {
+   case NODETYPE_GSUM:
+   case NODETYPE_GMEAN:
+   case NODETYPE_GMIN:
+   case NODETYPE_GMAX:
+   case NODETYPE_GCOUNT:
+      return TRUE;
+   default:
+      return FALSE;
+   }
+}
+
+/* Check that the arguments of a reduction use no symbols set elsewhere
+   in the expression, since they are evaluated over the whole image
+   before it */
+static void check_arguments(node_t n)
+{
+   int iarg;
+   ident_t ident;
+   char msg[256];
+
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      ident = sym_find_unset(n->expr[iarg]);
+      if (ident >= 0) {
+         (void) sprintf(msg, 
+                        "%.64s cannot be used in %s: it is not set in it",
+                        ident_str(ident), node_name(n));
+         show_error(n->pos, msg);
+      }
+   }
+}
+
+/* Symbols set in the arguments of reductions, with the outermost
+   reduction that sets each one */
+static ident_t *reduction_idents = NULL;
+static node_t *reduction_setters = NULL;
+static int nreduction_idents = 0;
+static int reduction_idents_alloc = 0;
+
+/* Find the reduction whose arguments set a symbol, or NULL if none do */
+static node_t find_setter(ident_t ident)
+{
+   int iident;
+
+   for (iident=0; iident < nreduction_idents; iident++) {
+      if (reduction_idents[iident] == ident)
+         return reduction_setters[iident];
+   }
+   return NULL;
+}
+
+/* Add the symbols set in a tree to those set by a reduction */
+static void add_set_symbols(node_t n, node_t reduction)
+{
+   int iarg;
+
+   if (n == NULL) return;
+   switch (n->type) {
+   case NODETYPE_ASSIGN:
+   case NODETYPE_LET:
+   case NODETYPE_FOR:
+   case NODETYPE_GEN:
+      if (find_setter(n->ident) == NULL) {
+         if (nreduction_idents >= reduction_idents_alloc) {
+            reduction_idents_alloc += 10;
+            reduction_idents = 
+               realloc(reduction_idents, reduction_idents_alloc * 
+                       sizeof(*reduction_idents));
+            reduction_setters = 
+               realloc(reduction_setters, reduction_idents_alloc * 
+                       sizeof(*reduction_setters));
+         }
+         reduction_idents[nreduction_idents] = n->ident;
+         reduction_setters[nreduction_idents] = reduction;
+         nreduction_idents++;
+      }
+      break;
+   default:
+      break;
+   }
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      add_set_symbols(n->expr[iarg], reduction);
+   }
+}
+
+/* Find the symbols set in the arguments of the outermost reductions of
+   a tree */
+static void find_set_symbols(node_t n)
+{
+   int iarg;
+
+   if (n == NULL) return;
+   if (is_reduction(n)) {
+      add_set_symbols(n, n);
+      return;
+   }
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      find_set_symbols(n->expr[iarg]);
+   }
+}
+
+/* Report a symbol used outside of the reduction that sets it */
+static void show_set_symbol(ident_t ident, node_t reduction)
+{
+   char msg[256];
+
+   (void) sprintf(msg, "%.64s cannot be used outside of %s: it is set in it",
+                  ident_str(ident), node_name(reduction));
+   show_error(reduction->pos, msg);
+}
+
+/* Check that symbols used outside of reductions are not set in them */
+static void check_used_symbols(node_t n)
+{
+   int iarg;
+   node_t reduction;
+
+   if ((n == NULL) || is_reduction(n)) return;
+   if (n->type == NODETYPE_IDENT) {
+      reduction = find_setter(n->ident);
+      if (reduction != NULL) show_set_symbol(n->ident, reduction);
+   }
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      check_used_symbols(n->expr[iarg]);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_check
+@INPUT      : root - expression tree
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Exits with an error if a symbol set in the arguments of a
+              reduction is used outside of them. The arguments are only
+              evaluated in the passes of the reductions, so outside of
+              them such a symbol would hold whatever the last block of
+              the pass left in it.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reduce_check(node_t root)
+{
+   nreduction_idents = 0;
+   find_set_symbols(root);
+   check_used_symbols(root);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_check_output
+@INPUT      : symbol - name of an output symbol
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Exits with an error if the expression last given to
+              reduce_check sets an output symbol in the arguments of a
+              reduction, since it is then never set for the output.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reduce_check_output(char *symbol)
+{
+   ident_t ident;
+   node_t reduction;
+
+   ident = ident_lookup(symbol);
+   if (ident < 0) return;
+   reduction = find_setter(ident);
+   if (reduction != NULL) show_set_symbol(ident, reduction);
+}
+
+/* Add the innermost reductions of a tree to the list, returning TRUE if
+   there are any reductions in the tree */
+static int add_reductions(node_t n)
+{
+   int iarg, found;
+
+   if (n == NULL) return FALSE;
+   found = FALSE;
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      if (add_reductions(n->expr[iarg])) found = TRUE;
+   }
+   if (!is_reduction(n)) return found;
+   if (!found) {
+      check_arguments(n);
+      if (nreductions >= reductions_alloc) {
+         reductions_alloc += 10;
+         reductions = realloc(reductions,
+                              reductions_alloc * sizeof(*reductions));
+      }
+      reductions[nreductions++] = n;
+   }
+   return TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_find
+@INPUT      : root - expression tree
+@OUTPUT     : (none)
+@RETURNS    : Number of reductions to do in the next pass
+@DESCRIPTION: Finds the global reductions that have no other reductions
+              in their arguments. Exits with an error if their arguments
+              use symbols other than A that are not set in them.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+int reduce_find(node_t root)
+{
+   nreductions = 0;
+   (void) add_reductions(root);
+   return nreductions;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_arg
+@INPUT      : ireduce - reduction of the pass
+              iarg - 0 for the values or 1 for the mask
+@OUTPUT     : (none)
+@RETURNS    : Argument, or NULL if there is no mask
+@DESCRIPTION: Gets an argument of a reduction, to be evaluated over the
+              image.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+node_t reduce_arg(int ireduce, int iarg)
+{
+   if (iarg >= reductions[ireduce]->numargs) return NULL;
+   return reductions[ireduce]->expr[iarg];
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_init
+@INPUT      : (none)
+@OUTPUT     : accum - accumulator
+@RETURNS    : (nothing)
+@DESCRIPTION: Empties an accumulator.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reduce_init(accum_t *accum)
+{
+   accum->sum = 0.0;
+   accum->count = 0.0;
+   accum->min = DBL_MAX;
+   accum->max = -DBL_MAX;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_values
+@INPUT      : accum - accumulator
+              width - number of values
+              values - values to add
+              mask - mask of values to add, or NULL for all of them
+@OUTPUT     : accum - accumulator
+@RETURNS    : (nothing)
+@DESCRIPTION: Adds a block of values to an accumulator.
+@METHOD     : Values that are not used are replaced by values that do not
+              change the accumulator, so that the loop has no branches.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reduce_values(accum_t *accum, int width, double *values, double *mask)
+{
+   int ivalue, use;
+   double x, sum, count, min, max;
+
+   sum = accum->sum;
+   count = accum->count;
+   min = accum->min;
+   max = accum->max;
+   for (ivalue=0; ivalue < width; ivalue++) {
+      x = values[ivalue];
+      use = (x != INVALID_VALUE);
+      if (mask != NULL)
+         use &= (mask[ivalue] != INVALID_VALUE) & (mask[ivalue] != 0.0);
+      sum += use ? x : 0.0;
+      count += use ? 1.0 : 0.0;
+      min = (use && (x < min)) ? x : min;
+      max = (use && (x > max)) ? x : max;
+   }
+   accum->sum = sum;
+   accum->count = count;
+   accum->min = min;
+   accum->max = max;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_merge
+@INPUT      : total - accumulator
+              part - accumulator to add to it
+@OUTPUT     : total - accumulator
+@RETURNS    : (nothing)
+@DESCRIPTION: Adds one accumulator to another.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reduce_merge(accum_t *total, accum_t *part)
+{
+   total->sum += part->sum;
+   total->count += part->count;
+   if (part->min < total->min) total->min = part->min;
+   if (part->max > total->max) total->max = part->max;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reduce_finish
+@INPUT      : totals - accumulator of each reduction over the image
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Replaces the reductions of the pass by their results.
+              Reductions other than gsum and gcount of no values are
+              invalid.
+@METHOD     :
+@GLOBALS    : debug
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reduce_finish(accum_t totals[])
+{
+   int ireduce, iarg;
+   node_t n;
+   accum_t *accum;
+   double value;
+
+   for (ireduce=0; ireduce < nreductions; ireduce++) {
+      n = reductions[ireduce];
+      accum = &totals[ireduce];
+      switch (n->type) {
+      case NODETYPE_GSUM:
+         value = accum->sum;
+         break;
+      case NODETYPE_GCOUNT:
+         value = accum->count;
+         break;
+      case NODETYPE_GMEAN:
+         value = (accum->count > 0.0) ?
+            accum->sum / accum->count : INVALID_VALUE;
+         break;
+      case NODETYPE_GMIN:
+         value = (accum->count > 0.0) ? accum->min : INVALID_VALUE;
+         break;
+      case NODETYPE_GMAX:
+      default:
+         value = (accum->count > 0.0) ? accum->max : INVALID_VALUE;
+         break;
+      }
+      if (debug) {
+         (void) fprintf(stderr, "Global %s = %.15g\n", node_name(n), value);
+      }
+
+      /* The arguments are not freed, since the programs that evaluated
+         them point into them */
+      n->type = NODETYPE_REAL;
+      n->real = value;
+      n->numargs = 0;
+      for (iarg=0; iarg < 3; iarg++) n->expr[iarg] = NULL;
+   }
+}
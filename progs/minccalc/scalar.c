@@ -8,10 +8,18 @@
 
 scalar_t new_scalar(int width){
    scalar_t s;
+   pool_t pool;
 
-   s = malloc(sizeof *s);
-   s->width = width;
-   s->vals = malloc(width * sizeof(s->vals[0]));
+   /* Reuse a scalar from the pool of this thread if there is one */
+   pool = pool_current();
+   s = (pool != NULL) ? pool_get_scalar(pool, width) : NULL;
+   if (s == NULL) {
+      s = malloc(sizeof *s);
+      s->width = width;
+      s->vals = malloc(width * sizeof(s->vals[0]));
+      s->pool = pool;
+      s->next_free = NULL;
+   }
    s->refcnt = 1;
    return s;
 }
@@ -26,6 +34,10 @@ void scalar_free(scalar_t s){
       exit(1);
    }
    if (--s->refcnt == 0) {
+      if (s->pool != NULL) {
+         pool_put_scalar(s);
+         return;
+      }
       free(s->vals);
       s->vals = NULL;
       free(s);
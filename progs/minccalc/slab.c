@@ -0,0 +1,530 @@
+/* Slab buffers for the neighbourhood operators of minccalc.
+
+   An expression such as A[0](-1,0,0) needs the values of an input file
+   around each voxel, while voxel_loop only hands minccalc the hyperslab
+   being worked on. For each buffer of voxel_loop, the hyperslab is
+   copied into a larger block (the slab) that has a halo of the largest
+   offset of the expression on each side of the spatial dimensions. The
+   halo is taken from the slab of the previous buffer where it overlaps
+   (the slices just before this buffer, since voxel_loop goes through the
+   file in order) and only the rest is read from the input files. Outside
+   of the volume the halo repeats the nearest voxel on the edge.
+
+   Offsets are given along the last three spatial dimensions of the
+   image, slowest varying first, so that for a zspace, yspace, xspace
+   file A[0](1,0,0) is the value of the next slice. A vector dimension
+   and any other dimensions have no halo.
+
+   The slab is filled by the main thread before the buffer is evaluated
+   and is only read during evaluation, so threads can share it. Each
+   voxel finds its own value in the slab from its position, held in the
+   symbol "#centre" of its symbol table, which cannot be typed in an
+   expression.
+
+   Copyright David Leonard and Andrew Janke, 2000. All rights reserved. */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <minc.h>
+#include <loop_icv.h>
+#include "node.h"
+
+#ifndef TRUE
+#  define TRUE 1
+#endif
+
+#ifndef FALSE
+#  define FALSE 0
+#endif
+
+/* A hyperslab of the image */
+typedef struct {
+   long start[MAX_VAR_DIMS];
+   long count[MAX_VAR_DIMS];
+} box_t;
+
+static int slab_nfiles = 0;
+static int slab_ndims = 0;
+static int *mincids = NULL;
+static int *icvids = NULL;
+static long dim_size[MAX_VAR_DIMS];       /* Size of each dimension */
+static long pad[MAX_VAR_DIMS];            /* Halo on each side */
+static int spatial_dim[3];                /* Dimensions of offsets */
+
+static box_t chunk;                       /* Hyperslab of the buffer */
+static box_t slab, prev_slab;             /* Slab and that of the last
+                                             buffer */
+static int have_prev_slab = FALSE;
+static long stride[MAX_VAR_DIMS];         /* Steps through the slab */
+static double **values = NULL;            /* Slab of each file */
+static double **prev_values = NULL;
+static long values_alloc = 0;
+static double *read_buffer = NULL;
+static long read_alloc = 0;
+static ident_t centre_ident = -1;
+
+static long box_size(box_t *box);
+static int box_contains(box_t *outer, box_t *inner);
+static void copy_box(double *src, box_t *src_box,
+                     double *dst, box_t *dst_box, box_t *region);
+static void fill_region(box_t *region);
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : stencil_radius
+@INPUT      : n - expression tree
+@OUTPUT     : radius - largest absolute offset of each spatial dimension,
+                 which must be set to zero by the caller
+@RETURNS    : TRUE if the expression uses neighbourhood values
+@DESCRIPTION: Finds how much of a halo the expression needs.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+int stencil_radius(node_t n, int radius[3])
+{
+   int iarg, k, found;
+
+   if (n == NULL) return FALSE;
+   found = FALSE;
+   if (n->type == NODETYPE_SHIFT) {
+      found = TRUE;
+      for (k=0; k < 3; k++) {
+         if (abs(n->offset[k]) > radius[k])
+            radius[k] = abs(n->offset[k]);
+      }
+   }
+   for (iarg=0; iarg < n->numargs; iarg++) {
+      if (stencil_radius(n->expr[iarg], radius)) found = TRUE;
+   }
+   return found;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_open
+@INPUT      : nfiles - number of input files
+              files - names of input files
+              radius - halo needed along each spatial dimension
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Opens the input files for reading halos and works out the
+              dimensions that offsets refer to.
+@METHOD     : Values are read as voxel_loop reads them: real values, with
+              invalid values set to -DBL_MAX.
+@GLOBALS    :
+@CALLS      : create_loop_icv
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void slab_open(int nfiles, char *files[], int radius[3])
+{
+   int ifile, idim, ndims, dim[MAX_VAR_DIMS], imgid, k;
+   long size;
+   char name[MAX_NC_NAME];
+
+   centre_ident = new_ident("#centre");
+   slab_nfiles = nfiles;
+   mincids = malloc(nfiles * sizeof(*mincids));
+   icvids = malloc(nfiles * sizeof(*icvids));
+   values = malloc(nfiles * sizeof(*values));
+   prev_values = malloc(nfiles * sizeof(*prev_values));
+
+   for (ifile=0; ifile < nfiles; ifile++) {
+      mincids[ifile] = miopen(files[ifile], NC_NOWRITE);
+      imgid = ncvarid(mincids[ifile], MIimage);
+      (void) ncvarinq(mincids[ifile], imgid, NULL, NULL, &ndims, dim, NULL);
+
+      /* Get the dimensions of the first file, and check the others
+         against them */
+      if (ifile == 0) {
+         slab_ndims = ndims;
+      }
+      else if (ndims != slab_ndims) {
+         (void) fprintf(stderr, "Input files must have the same dimensions "
+                        "for neighbourhood values\n");
+         exit(EXIT_FAILURE);
+      }
+      for (idim=0; idim < ndims; idim++) {
+         (void) ncdiminq(mincids[ifile], dim[idim], name, &size);
+         if (ifile == 0) {
+            dim_size[idim] = size;
+            pad[idim] = 0;
+         }
+         else if (size != dim_size[idim]) {
+            (void) fprintf(stderr, "Input files must have the same "
+                           "dimensions for neighbourhood values\n");
+            exit(EXIT_FAILURE);
+         }
+      }
+
+      /* Find the spatial dimensions - the last three, skipping a vector
+         dimension */
+      if (ifile == 0) {
+         idim = ndims - 1;
+         if (idim >= 0) {
+            (void) ncdiminq(mincids[ifile], dim[idim], name, NULL);
+            if (strcmp(name, MIvector_dimension) == 0) idim--;
+         }
+         for (k=2; k >= 0; k--) {
+            spatial_dim[k] = (idim >= 0) ? idim-- : -1;
+            if (radius[k] > 0) {
+               if (spatial_dim[k] < 0) {
+                  (void) fprintf(stderr, "Neighbourhood offsets have more "
+                                 "dimensions than the image\n");
+                  exit(EXIT_FAILURE);
+               }
+               pad[spatial_dim[k]] = radius[k];
+            }
+         }
+      }
+
+      /* Read real values as voxel_loop does */
+      icvids[ifile] = create_loop_icv(mincids[ifile]);
+
+      values[ifile] = NULL;
+      prev_values[ifile] = NULL;
+   }
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_close
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Closes the input files and frees the slabs.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void slab_close(void)
+{
+   int ifile;
+
+   for (ifile=0; ifile < slab_nfiles; ifile++) {
+      (void) miicv_free(icvids[ifile]);
+      (void) miclose(mincids[ifile]);
+      if (values[ifile] != NULL) free(values[ifile]);
+      if (prev_values[ifile] != NULL) free(prev_values[ifile]);
+   }
+   if (slab_nfiles > 0) {
+      free(mincids);
+      free(icvids);
+      free(values);
+      free(prev_values);
+   }
+   if (read_buffer != NULL) free(read_buffer);
+   slab_nfiles = 0;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_load
+@INPUT      : start - start of the voxel_loop buffer in the image
+              count - size of the voxel_loop buffer
+              input_data - values of the buffer for each input file
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Fills the slab of each input file for a buffer.
+@METHOD     : The part of the slab that is inside the volume is split into
+              the buffer itself and, for each dimension, the blocks before
+              and after it. The buffer is copied from input_data, and
+              each other block is copied from the previous slab if that
+              holds it or read from the files otherwise. The part outside
+              the volume is then set from the nearest voxel inside.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void slab_load(long start[], long count[], double *input_data[])
+{
+   int ifile, idim, jdim, clamped;
+   long size, index[MAX_VAR_DIMS], ivalue, isource, coord;
+   box_t inside, region;
+   double **swap;
+
+   /* The slab that was filled last becomes the previous one */
+   swap = prev_values;
+   prev_values = values;
+   values = swap;
+   have_prev_slab = (prev_values[0] != NULL);
+   prev_slab = slab;
+
+   /* Get the slab for this buffer, and the part of it inside the
+      volume */
+   for (idim=0; idim < slab_ndims; idim++) {
+      chunk.start[idim] = start[idim];
+      chunk.count[idim] = count[idim];
+      slab.start[idim] = start[idim] - pad[idim];
+      slab.count[idim] = count[idim] + 2 * pad[idim];
+      inside.start[idim] = (slab.start[idim] < 0) ? 0 : slab.start[idim];
+      inside.count[idim] =
+         ((slab.start[idim] + slab.count[idim] > dim_size[idim]) ?
+          dim_size[idim] : slab.start[idim] + slab.count[idim]) -
+         inside.start[idim];
+   }
+   stride[slab_ndims-1] = 1;
+   for (idim=slab_ndims-2; idim >= 0; idim--)
+      stride[idim] = stride[idim+1] * slab.count[idim+1];
+
+   /* Make sure that the slabs are big enough. Both are reallocated so
+      that the previous one is never used after a change of size. */
+   size = box_size(&slab);
+   if (size > values_alloc) {
+      for (ifile=0; ifile < slab_nfiles; ifile++) {
+         if (values[ifile] != NULL) free(values[ifile]);
+         if (prev_values[ifile] != NULL) free(prev_values[ifile]);
+         values[ifile] = malloc(size * sizeof(double));
+         prev_values[ifile] = malloc(size * sizeof(double));
+      }
+      values_alloc = size;
+      have_prev_slab = FALSE;
+   }
+
+   /* Copy the buffer */
+   for (ifile=0; ifile < slab_nfiles; ifile++) {
+      copy_box(input_data[ifile], &chunk, values[ifile], &slab, &chunk);
+   }
+
+   /* Get the blocks before and after the buffer along each dimension */
+   for (idim=0; idim < slab_ndims; idim++) {
+      for (jdim=0; jdim < slab_ndims; jdim++) {
+         region.start[jdim] = (jdim < idim) ?
+            chunk.start[jdim] : inside.start[jdim];
+         region.count[jdim] = (jdim < idim) ?
+            chunk.count[jdim] : inside.count[jdim];
+      }
+      region.start[idim] = inside.start[idim];
+      region.count[idim] = chunk.start[idim] - inside.start[idim];
+      fill_region(&region);
+      region.start[idim] = chunk.start[idim] + chunk.count[idim];
+      region.count[idim] = inside.start[idim] + inside.count[idim] -
+         region.start[idim];
+      fill_region(&region);
+   }
+
+   /* Repeat the edges of the volume into the rest of the slab */
+   if (box_size(&inside) == size) return;
+   for (idim=0; idim < slab_ndims; idim++) index[idim] = 0;
+   for (ivalue=0; ivalue < size; ivalue++) {
+      clamped = FALSE;
+      isource = 0;
+      for (idim=0; idim < slab_ndims; idim++) {
+         coord = slab.start[idim] + index[idim];
+         if (coord < 0) {
+            coord = 0;
+            clamped = TRUE;
+         }
+         else if (coord >= dim_size[idim]) {
+            coord = dim_size[idim] - 1;
+            clamped = TRUE;
+         }
+         isource += (coord - slab.start[idim]) * stride[idim];
+      }
+      if (clamped) {
+         for (ifile=0; ifile < slab_nfiles; ifile++)
+            values[ifile][ivalue] = values[ifile][isource];
+      }
+      for (idim=slab_ndims-1; idim >= 0; idim--) {
+         if (++index[idim] < slab.count[idim]) break;
+         index[idim] = 0;
+      }
+   }
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_centres
+@INPUT      : first - index of first value in the voxel_loop buffer
+              width - number of values
+@OUTPUT     : centres - position in the slab of each value
+@RETURNS    : (nothing)
+@DESCRIPTION: Finds where values of the buffer are in the slab, as stored
+              in the "#centre" symbol.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void slab_centres(long first, int width, double *centres)
+{
+   long index[MAX_VAR_DIMS], position;
+   int idim, ivalue;
+
+   /* Get the index in the buffer of the first value */
+   for (idim=slab_ndims-1; idim >= 0; idim--) {
+      index[idim] = first % chunk.count[idim];
+      first /= chunk.count[idim];
+   }
+
+   for (ivalue=0; ivalue < width; ivalue++) {
+      position = 0;
+      for (idim=0; idim < slab_ndims; idim++)
+         position += (index[idim] + pad[idim]) * stride[idim];
+      centres[ivalue] = (double) position;
+      for (idim=slab_ndims-1; idim >= 0; idim--) {
+         if (++index[idim] < chunk.count[idim]) break;
+         index[idim] = 0;
+      }
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_offset
+@INPUT      : offset - offset along each spatial dimension
+@OUTPUT     : (none)
+@RETURNS    : Distance between values in the slab
+@DESCRIPTION: Converts an offset in voxels to one in the slab.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+long slab_offset(int offset[3])
+{
+   long distance;
+   int k;
+
+   distance = 0;
+   for (k=0; k < 3; k++) {
+      if (spatial_dim[k] >= 0)
+         distance += offset[k] * stride[spatial_dim[k]];
+   }
+   return distance;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_values
+@INPUT      : ifile - input file
+@OUTPUT     : (none)
+@RETURNS    : Slab of the file, or NULL if there is no such file
+@DESCRIPTION: Gets the slab for the current buffer of an input file.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+double *slab_values(int ifile)
+{
+   if ((ifile < 0) || (ifile >= slab_nfiles)) return NULL;
+   return values[ifile];
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : slab_centre_ident
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : Identifier of the "#centre" symbol
+@DESCRIPTION: Gets the symbol holding the position in the slab of each
+              value, as set by slab_centres.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+ident_t slab_centre_ident(void)
+{
+   return centre_ident;
+}
+
+/* Number of values in a box */
+static long box_size(box_t *box)
+{
+   long size;
+   int idim;
+
+   size = 1;
+   for (idim=0; idim < slab_ndims; idim++)
+      size *= box->count[idim];
+   return size;
+}
+
+/* Check whether one box holds another */
+static int box_contains(box_t *outer, box_t *inner)
+{
+   int idim;
+
+   for (idim=0; idim < slab_ndims; idim++) {
+      if ((inner->start[idim] < outer->start[idim]) ||
+          (inner->start[idim] + inner->count[idim] >
+           outer->start[idim] + outer->count[idim]))
+         return FALSE;
+   }
+   return TRUE;
+}
+
+/* Copy a region from one box of values to another, one row of the
+   last dimension at a time */
+static void copy_box(double *src, box_t *src_box,
+                     double *dst, box_t *dst_box, box_t *region)
+{
+   long index[MAX_VAR_DIMS], src_offset, dst_offset, src_step, dst_step;
+   long nrows;
+   int idim, last;
+
+   last = slab_ndims - 1;
+   nrows = box_size(region) / region->count[last];
+   for (idim=0; idim < slab_ndims; idim++) index[idim] = 0;
+   while (nrows-- > 0) {
+      src_offset = 0;
+      dst_offset = 0;
+      src_step = 1;
+      dst_step = 1;
+      for (idim=last; idim >= 0; idim--) {
+         src_offset += (region->start[idim] + index[idim] -
+                        src_box->start[idim]) * src_step;
+         dst_offset += (region->start[idim] + index[idim] -
+                        dst_box->start[idim]) * dst_step;
+         src_step *= src_box->count[idim];
+         dst_step *= dst_box->count[idim];
+      }
+      (void) memcpy(&dst[dst_offset], &src[src_offset],
+                    region->count[last] * sizeof(double));
+      for (idim=last-1; idim >= 0; idim--) {
+         if (++index[idim] < region->count[idim]) break;
+         index[idim] = 0;
+      }
+   }
+}
+
+/* Fill a region of the slab that lies in the volume, from the previous
+   slab if it holds it or from the files */
+static void fill_region(box_t *region)
+{
+   int ifile;
+   long size;
+
+   size = box_size(region);
+   if (size <= 0) return;
+
+   if (have_prev_slab && box_contains(&prev_slab, region)) {
+      for (ifile=0; ifile < slab_nfiles; ifile++)
+         copy_box(prev_values[ifile], &prev_slab,
+                  values[ifile], &slab, region);
+      return;
+   }
+
+   if (size > read_alloc) {
+      if (read_buffer != NULL) free(read_buffer);
+      read_buffer = malloc(size * sizeof(double));
+      read_alloc = size;
+   }
+   for (ifile=0; ifile < slab_nfiles; ifile++) {
+      (void) miicv_get(icvids[ifile], region->start, region->count,
+                       read_buffer);
+      copy_box(read_buffer, region, values[ifile], &slab, region);
+   }
+}
@@ -4,6 +4,14 @@
 #include <stdlib.h>
 #include "node.h"
 
+#ifndef TRUE
+#  define TRUE 1
+#endif
+
+#ifndef FALSE
+#  define FALSE 0
+#endif
+
 #define NEW_SCOPE (-1)
 
 typedef enum {SYM_UNKNOWN, SYM_SCALAR, SYM_VECTOR} sym_type_t;
@@ -189,3 +197,134 @@ vector_t sym_lookup_vector(ident_t id, sym_t sym){
    return s->vector;
 }
 
+
+/* Look up a symbol without complaining if it is not there or is not a
+   scalar - returns NULL in that case */
+scalar_t sym_find_scalar(ident_t id, sym_t sym){
+   sym_t s = sym_lookup(id, sym);
+   if (!s || s->type != SYM_SCALAR)
+      return NULL;
+   return s->scalar;
+}
+
+/* Same for vectors */
+vector_t sym_find_vector(ident_t id, sym_t sym){
+   sym_t s = sym_lookup(id, sym);
+   if (!s || s->type != SYM_VECTOR)
+      return NULL;
+   return s->vector;
+}
+
+/* Symbols surely set so far, while walking an expression in the order in
+   which it is evaluated */
+static ident_t *set_idents = NULL;
+static int nset_idents = 0;
+static int set_idents_alloc = 0;
+
+/* Add a symbol to those surely set */
+static void add_set_ident(ident_t ident)
+{
+   if (nset_idents >= set_idents_alloc) {
+      set_idents_alloc += 10;
+      set_idents = realloc(set_idents,
+                           set_idents_alloc * sizeof(*set_idents));
+   }
+   set_idents[nset_idents++] = ident;
+}
+
+/* Find a symbol other than A that a tree may use before setting it,
+   returning -1 if there is none */
+static ident_t find_unset(node_t n, ident_t input_ident)
+{
+   int iarg, nsaved;
+   ident_t ident;
+
+   if (n == NULL) return -1;
+   ident = -1;
+   switch (n->type) {
+   case NODETYPE_IDENT:
+      if ((n->ident != input_ident) && !sym_surely_set(n->ident))
+         ident = n->ident;
+      break;
+   case NODETYPE_ASSIGN:
+      ident = find_unset(n->expr[0], input_ident);
+      add_set_ident(n->ident);
+      break;
+   case NODETYPE_LET:
+      ident = find_unset(n->expr[0], input_ident);
+      add_set_ident(n->ident);
+      if (ident < 0) ident = find_unset(n->expr[1], input_ident);
+      break;
+   case NODETYPE_IFELSE:
+      ident = find_unset(n->expr[0], input_ident);
+      nsaved = nset_idents;
+      for (iarg=1; (ident < 0) && (iarg < n->numargs); iarg++) {
+         ident = find_unset(n->expr[iarg], input_ident);
+         nset_idents = nsaved;
+      }
+      break;
+   case NODETYPE_FOR:
+   case NODETYPE_GEN:
+      ident = find_unset(n->expr[0], input_ident);
+      nsaved = nset_idents;
+      add_set_ident(n->ident);
+      if (ident < 0) ident = find_unset(n->expr[1], input_ident);
+      nset_idents = nsaved;
+      break;
+   default:
+      for (iarg=0; (ident < 0) && (iarg < n->numargs); iarg++) {
+         ident = find_unset(n->expr[iarg], input_ident);
+      }
+      break;
+   }
+   return ident;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : sym_find_unset
+@INPUT      : n - expression
+@OUTPUT     : (none)
+@RETURNS    : Identifier of a symbol, or -1 if there is none
+@DESCRIPTION: Finds a symbol other than A that an expression may use
+              before setting it, so that its value would be left from
+              an earlier evaluation. Symbols set in the parts of an if or
+              in the body of a loop are only surely set within them,
+              since the parts are not evaluated for every value (neither
+              is, where the test is invalid) and a loop may have no
+              iterations.
+@METHOD     : The tree is walked in the order in which it is evaluated,
+              keeping the symbols that are surely set so far for
+              sym_surely_set.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+ident_t sym_find_unset(node_t n)
+{
+   nset_idents = 0;
+   return find_unset(n, new_ident("A"));
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : sym_surely_set
+@INPUT      : id - identifier of a symbol
+@OUTPUT     : (none)
+@RETURNS    : TRUE if the symbol is surely set
+@DESCRIPTION: Checks whether the expression last given to sym_find_unset
+              surely sets a symbol.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+int sym_surely_set(ident_t id)
+{
+   int iset;
+
+   for (iset=0; iset < nset_idents; iset++) {
+      if (set_idents[iset] == id) return TRUE;
+   }
+   return FALSE;
+}
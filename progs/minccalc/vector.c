@@ -8,10 +8,19 @@
 
 vector_t new_vector(){
    vector_t v;
-
-   v = malloc(sizeof *v);
-   v->maxlen = INIT_SIZE;
-   v->el = malloc(INIT_SIZE * sizeof v->el[0]);
+   pool_t pool;
+
+   /* Reuse a vector (and its array of elements) from the pool of this
+      thread if there is one */
+   pool = pool_current();
+   v = (pool != NULL) ? pool_get_vector(pool) : NULL;
+   if (v == NULL) {
+      v = malloc(sizeof *v);
+      v->maxlen = INIT_SIZE;
+      v->el = malloc(INIT_SIZE * sizeof v->el[0]);
+      v->pool = pool;
+      v->next_free = NULL;
+   }
    v->len = 0;
    v->refcnt = 1;
    return v;
@@ -41,6 +50,10 @@ void vector_free(vector_t v){
       for (i=0; i < v->len; i++) {
          scalar_free(v->el[i]);
       }
+      if (v->pool != NULL) {
+         pool_put_vector(v);
+         return;
+      }
       free(v->el);
       v->el = NULL;
       free(v);
@@ -119,10 +119,15 @@
 #include <float.h>
 #include <limits.h>
 #include <math.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include <minc.h>
 #include <ParseArgv.h>
 #include <time_stamp.h>
 #include <voxel_loop.h>
+#include <partial_state.h>
+#include <fused_files.h>
 
 /* Constants */
 
@@ -196,8 +201,106 @@ typedef struct {
    double constants[2];
    int propagate_nan;
    double illegal_value;
+   int nthreads;             /* Threads accumulating in fused_math */
+   Fused_Files fused;        /* Input files read by fused_math */
+   double *file_data[2];     /* Buffers for reading ahead */
+   long file_data_alloc;
+   int partial;              /* Write partial states */
+   double *states;           /* Partial states of a buffer */
+   long states_alloc;
 } Math_Data;
 
+/* Loops for do_math, done in chunks of the buffers. The operation is
+   first done on every value, whether or not it is valid, and the
+   result is then selected where values are invalid or the operation is
+   illegal, so that neither loop has branches and both can be vectorized.
+   The second operand comes from the second buffer or, with one buffer,
+   from an array holding the constant. Floating-point exceptions are not
+   trapped, so doing an operation on values that are not wanted is
+   harmless. */
+#define MATH_CHUNK 256
+
+#define MATH_LOOP(expr, select) \
+   for (start=0; start < nvalues; start += MATH_CHUNK) { \
+      nchunk = (nvalues - start < MATH_CHUNK) ? \
+         (int) (nvalues - start) : MATH_CHUNK; \
+      in1 = &input_data[0][start]; \
+      in2 = (input_num_buffers == 2) ? &input_data[1][start] : second; \
+      out = &output_data[0][start]; \
+      for (ivalue=0; ivalue < nchunk; ivalue++) { \
+         x = in1[ivalue]; \
+         y = in2[ivalue]; \
+         out[ivalue] = (expr); \
+      } \
+      for (ivalue=0; ivalue < nchunk; ivalue++) { \
+         x = in1[ivalue]; \
+         y = in2[ivalue]; \
+         result = out[ivalue]; \
+         out[ivalue] = ((x == INVALID_DATA) | (y == INVALID_DATA)) ? \
+            INVALID_DATA : (select); \
+      } \
+   } \
+   break
+
+#define SIMPLE_LOOP(expr) MATH_LOOP(expr, result)
+
+/* Loop for isnan and nisnan, which are the only operations with a
+   valid result for invalid values */
+#define NAN_LOOP(invalid_result, valid_result) \
+   for (start=0; start < nvalues; start += MATH_CHUNK) { \
+      nchunk = (nvalues - start < MATH_CHUNK) ? \
+         (int) (nvalues - start) : MATH_CHUNK; \
+      in1 = &input_data[0][start]; \
+      in2 = (input_num_buffers == 2) ? &input_data[1][start] : second; \
+      out = &output_data[0][start]; \
+      for (ivalue=0; ivalue < nchunk; ivalue++) { \
+         out[ivalue] = \
+            ((in1[ivalue] == INVALID_DATA) | (in2[ivalue] == INVALID_DATA)) ? \
+            (invalid_result) : (valid_result); \
+      } \
+   } \
+   break
+
+/* Loop for accumulate_values. As in MATH_LOOP, the operation is done on
+   every value and the result is then selected: invalid new values either
+   make the output invalid or are ignored, the first valid value is
+   copied and outputs that are already invalid are left alone. */
+#define ACCUM_LOOP(expr) \
+   for (ivalue=0; ivalue < nvalues; ivalue++) { \
+      x = output[ivalue]; \
+      y = input[ivalue]; \
+      result = (expr); \
+      output[ivalue] = (y == INVALID_DATA) ? \
+         (propagate_nan ? INVALID_DATA : x) : \
+         ((x == UNINITIALIZED_DATA) ? y : \
+          ((x == INVALID_DATA) ? x : result)); \
+   } \
+   break
+
+#ifdef HAVE_PTHREAD
+
+/* State shared by fused_math and its threads. Each thread goes through
+   the files in order, waiting until a file has been read, and the file
+   after next is only read into a buffer once all of the threads are done
+   with the file that was in it. */
+typedef struct {
+   pthread_mutex_t mutex;
+   pthread_cond_t cond;
+   int files_read;           /* Files with data in the buffers */
+   int buffer_done[2];       /* Threads done with the file in a buffer */
+} Fused_Sync;
+
+/* Range of values accumulated by one thread */
+typedef struct {
+   Math_Data *math_data;
+   Fused_Sync *sync;
+   double *first_data;       /* Values of the first file */
+   double *output;
+   long start, end;
+} Fused_Job;
+
+#endif /* HAVE_PTHREAD */
+
 /* Function prototypes */
 static void do_math(void *caller_data, long num_voxels, 
                     int input_num_buffers, int input_vector_length,
@@ -219,6 +322,40 @@ static void end_math(void *caller_data, long num_voxels,
                      int output_num_buffers, int output_vector_length,
                      double *output_data[],
                      Loop_Info *loop_info);
+static void start_values(Operation operation, long nvalues, double *output);
+static void accumulate_values(Operation operation, int propagate_nan,
+                              long nvalues, double *input, double *output);
+static void finish_values(double illegal_value, long nvalues, 
+                          double *output);
+static void partial_math(void *caller_data, long num_voxels, 
+                         int input_num_buffers, int input_vector_length,
+                         double *input_data[],
+                         int output_num_buffers, int output_vector_length,
+                         double *output_data[],
+                         Loop_Info *loop_info);
+static void merge_math(void *caller_data, long num_voxels, 
+                       int input_num_buffers, int input_vector_length,
+                       double *input_data[],
+                       int output_num_buffers, int output_vector_length,
+                       double *output_data[],
+                       Loop_Info *loop_info);
+static void start_partial(void *caller_data, long num_voxels, 
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[],
+                          Loop_Info *loop_info);
+static void finish_partial(void *caller_data, long num_voxels, 
+                           int output_num_buffers, int output_vector_length,
+                           double *output_data[],
+                           Loop_Info *loop_info);
+#ifdef HAVE_PTHREAD
+static void fused_math(void *caller_data, long num_voxels, 
+                       int input_num_buffers, int input_vector_length,
+                       double *input_data[],
+                       int output_num_buffers, int output_vector_length,
+                       double *output_data[],
+                       Loop_Info *loop_info);
+static void *fused_job(void *arg);
+#endif /* HAVE_PTHREAD */
 
 /* Argument variables */
 static int clobber = FALSE;
@@ -238,6 +375,9 @@ static int use_nan_for_illegal_values = TRUE;
 static double value_for_illegal_operations = DEFAULT_DBL;
 static int check_dim_info = TRUE;
 static char *filelist = NULL;
+static int nthreads = 1;
+static int partial = FALSE;
+static int merge = FALSE;
 #if MINC2
 static int minc2_format = FALSE;
 #endif /* MINC2 */
@@ -312,6 +452,12 @@ static ArgvInfo argTable[] = {
    {"-illegal_value", ARGV_FLOAT, (char *) 1, 
        (char *) &value_for_illegal_operations,
        "Value to write out when an illegal operation is done."},
+   {"-threads", ARGV_INT, (char *) 1, (char *) &nthreads,
+       "Number of threads for cumulative operations on files (default 1)."},
+   {"-partial", ARGV_CONSTANT, (char *) TRUE, (char *) &partial,
+       "Write the partial state of a cumulative operation, to be merged later."},
+   {"-merge", ARGV_CONSTANT, (char *) TRUE, (char *) &merge,
+       "Merge input files written with -partial."},
    {NULL, ARGV_HELP, (char *) NULL, (char *) NULL, 
        "Options for specifying constants:"},
    {"-constant", ARGV_FLOAT, (char *) 1, (char *) &constant,
@@ -401,6 +547,10 @@ int main(int argc, char *argv[])
    int num_constants;
    Num_Operands num_operands;
    VoxelFunction math_function;
+   long buffer_size;
+   int num_loop_files, ifile, mincid, dimid;
+   long dimlength;
+   double total_weight, file_weight;
 
    /* Save time stamp and args */
    arg_string = time_stamp(argc, argv);
@@ -465,6 +615,8 @@ int main(int argc, char *argv[])
    else
       num_constants = 0;
    num_operands = OperandTable[operation][num_constants];
+   if (partial && (operation == UNSPECIFIED_OP) && (num_constants == 0))
+      num_operands = NARY_NUMOP;
    if (num_operands == ILLEGAL_NUMOP) {
       (void) fprintf(stderr, "%s: Operation and constants do not match.\n",
                      pname);
@@ -490,6 +642,60 @@ int main(int argc, char *argv[])
       exit(EXIT_FAILURE);
    }
 
+   /* Partial states only give sums, extrema and counts */
+   if ((partial || merge) && 
+       ((num_operands != NARY_NUMOP) || (num_constants != 0) ||
+        ((operation != UNSPECIFIED_OP) && (operation != ADD_OP) &&
+         (operation != MAX_OP) && (operation != MIN_OP) && 
+         (operation != COUNT_OP)))) {
+      (void) fprintf(stderr, 
+         "%s: Use -partial and -merge only with -add, -maximum, -minimum\n"
+         "or -count_valid of files.\n", pname);
+      exit(EXIT_FAILURE);
+   }
+   if (merge && (loop_dimension != NULL)) {
+      (void) fprintf(stderr, "%s: Do not use -dimension with -merge.\n",
+                     pname);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Get the total weight of the files that went into partial states:
+      one for each input file, or with -dimension one for each value 
+      along the dimension of each input file */
+   total_weight = nfiles;
+   if (partial && (loop_dimension != NULL)) {
+      total_weight = 0.0;
+      for (ifile=0; ifile < nfiles; ifile++) {
+         mincid = miopen(infiles[ifile], NC_NOWRITE);
+         dimid = ncdimid(mincid, loop_dimension);
+         (void) ncdiminq(mincid, dimid, NULL, &dimlength);
+         (void) miclose(mincid);
+         total_weight += dimlength;
+      }
+   }
+   else if (merge) {
+      total_weight = 0.0;
+      for (ifile=0; ifile < nfiles; ifile++) {
+         if (!get_partial_state_weight(infiles[ifile], &file_weight)) {
+            (void) fprintf(stderr, 
+               "%s: File %s was not written with -partial.\n",
+                           pname, infiles[ifile]);
+            exit(EXIT_FAILURE);
+         }
+         total_weight += file_weight;
+      }
+   }
+
+   /* Check the number of threads */
+   if (nthreads < 1) {
+      (void) fprintf(stderr, "%s: Illegal number of threads (%d)\n",
+                     pname, nthreads);
+      exit(EXIT_FAILURE);
+   }
+#ifndef HAVE_PTHREAD
+   nthreads = 1;
+#endif
+
    /* Set default copy_all_header according to number of input files */
    if (copy_all_header == DEFAULT_BOOL)
       copy_all_header = (nfiles == 1);
@@ -514,6 +720,12 @@ int main(int argc, char *argv[])
       math_data.illegal_value = INVALID_DATA;
    else
       math_data.illegal_value = 0.0;
+   math_data.nthreads = nthreads;
+   math_data.file_data[0] = math_data.file_data[1] = NULL;
+   math_data.file_data_alloc = 0;
+   math_data.partial = partial;
+   math_data.states = NULL;
+   math_data.states_alloc = 0;
 
    /* Do math */
    loop_options = create_loop_options();
@@ -522,22 +734,68 @@ int main(int argc, char *argv[])
 #if MINC2
    set_loop_v2format(loop_options, minc2_format);
 #endif /* MINC2 */
-   set_loop_datatype(loop_options, datatype, is_signed, 
-                     valid_range[0], valid_range[1]);
-   if (num_operands == NARY_NUMOP) {
+   if (partial) {
+      set_loop_datatype(loop_options, NC_DOUBLE, TRUE, 0.0, 0.0);
+   }
+   else {
+      set_loop_datatype(loop_options, datatype, is_signed, 
+                        valid_range[0], valid_range[1]);
+   }
+   buffer_size = (long) 1024 * max_buffer_size_in_kb;
+   num_loop_files = nfiles;
+   if (partial || merge) {
+      math_function = merge ? merge_math : partial_math;
+      set_loop_accumulate(loop_options, TRUE, 0, 
+                          start_partial, finish_partial);
+      set_loop_output_vector_size(loop_options, 
+                                  partial ? PARTIAL_STATE_LENGTH : 1);
+   }
+   else if (num_operands == NARY_NUMOP) {
       math_function = accum_math;
       set_loop_accumulate(loop_options, TRUE, 0, start_math, end_math);
    }
    else {
       math_function = do_math;
    }
+
+   /* With threads, a cumulative operation on files is done on each buffer
+      of the first file at once, reading the other files in fused_math.
+      Its two buffers are as big as voxel_loop's, so voxel_loop gets half
+      of the memory. */
+#ifdef HAVE_PTHREAD
+   if ((math_function == accum_math) && (loop_dimension == NULL) &&
+       (nfiles > 1) && (nthreads > 1)) {
+      math_function = fused_math;
+      set_loop_accumulate(loop_options, FALSE, 0, NULL, NULL);
+      buffer_size /= 2;
+      num_loop_files = 1;
+      open_fused_files(&math_data.fused, nfiles, infiles, check_dim_info);
+   }
+#endif /* HAVE_PTHREAD */
+
    set_loop_copy_all_header(loop_options, copy_all_header);
    set_loop_dimension(loop_options, loop_dimension);
-   set_loop_buffer_size(loop_options, (long) 1024 * max_buffer_size_in_kb);
+   set_loop_buffer_size(loop_options, buffer_size);
    set_loop_check_dim_info(loop_options, check_dim_info);
-   voxel_loop(nfiles, infiles, nout, outfiles, arg_string, loop_options,
-              math_function, (void *) &math_data);
+   voxel_loop(num_loop_files, infiles, nout, outfiles, arg_string, 
+              loop_options, math_function, (void *) &math_data);
    free_loop_options(loop_options);
+#ifdef HAVE_PTHREAD
+   if (math_function == fused_math) {
+      close_fused_files(&math_data.fused);
+      if (math_data.file_data[0] != NULL) free(math_data.file_data[0]);
+      if (math_data.file_data[1] != NULL) free(math_data.file_data[1]);
+   }
+#endif /* HAVE_PTHREAD */
+   free(math_data.states);
+
+   /* Mark the file of partial states */
+   if (partial && 
+       (put_partial_state_weight(outfiles[0], total_weight) == MI_ERROR)) {
+      (void) fprintf(stderr, "%s: Error marking %s as partial states.\n",
+                     pname, outfiles[0]);
+      exit(EXIT_FAILURE);
+   }
 
    exit(EXIT_SUCCESS);
 }
@@ -548,11 +806,13 @@ int main(int argc, char *argv[])
 @OUTPUT     : Standard for voxel loop
 @RETURNS    : (nothing)
 @DESCRIPTION: Routine doing math operations.
-@METHOD     : 
+@METHOD     : The operation is chosen once per buffer, and each operation
+              has its own loop (see MATH_LOOP). With one input buffer,
+              the second operand is the first constant.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : April 25, 1995 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - one loop for each operation
 ---------------------------------------------------------------------------- */
 static void do_math(void *caller_data, long num_voxels, 
                     int input_num_buffers, int input_vector_length,
@@ -563,12 +823,14 @@ static void do_math(void *caller_data, long num_voxels,
      /* ARGSUSED */
 {
    Math_Data *math_data;
-   long ivox;
-   double value1, value2;
+   long nvalues, start;
+   int nchunk, ivalue;
+   double *in1, *in2, *out;
+   double x, y, result, second[MATH_CHUNK];
    double illegal_value;
    Operation operation;
    int num_constants, iconst;
-   double constants[2];
+   double constants[2], c0, c1;
 
    /* Get pointer to window info */
    math_data = (Math_Data *) caller_data;
@@ -594,138 +856,79 @@ static void do_math(void *caller_data, long num_voxels,
          constants[iconst] = 0.0;
    }
    illegal_value = math_data->illegal_value;
+   c0 = constants[0];
+   c1 = constants[1];
 
    /* Set default second value */
-   value2 = constants[0];
+   for (ivalue=0; ivalue < MATH_CHUNK; ivalue++)
+      second[ivalue] = constants[0];
+
+   nvalues = num_voxels * input_vector_length;
 
    /* Loop through the voxels */
-   for (ivox=0; ivox < num_voxels*input_vector_length; ivox++) {
-      value1 = input_data[0][ivox];
-      if (input_num_buffers == 2) 
-         value2 = input_data[1][ivox];
-      if ((value1 == INVALID_DATA) || (value2 == INVALID_DATA)) {
-         switch(operation) {
-         case ISNAN_OP:
-            output_data[0][ivox] = 1.0;
-            break;
-         case NISNAN_OP:
-            output_data[0][ivox] = 0.0;
-            break;
-         default:
-            output_data[0][ivox] = INVALID_DATA;
-            break;
-         }
-      }
-      else {
-         switch (operation) {
-         case ADD_OP:
-            output_data[0][ivox] = value1 + value2; break;
-         case SUB_OP:
-            output_data[0][ivox] = value1 - value2; break;
-         case MULT_OP:
-            output_data[0][ivox] = value1 * value2; break;
-         case DIV_OP:
-            if (value2 != 0.0)
-               output_data[0][ivox] = value1 / value2;
-            else
-               output_data[0][ivox] = illegal_value;
-            break;
-         case INVERT_OP:
-            if (value1 == 0.0)
-               output_data[0][ivox] = illegal_value;
-            else
-               output_data[0][ivox] = value2 / value1;
-            break;
-         case SQRT_OP:
-            if (value1 < 0.0)
-               output_data[0][ivox] = illegal_value;
-            else
-               output_data[0][ivox] = sqrt(value1);
-            break;
-         case SQUARE_OP:
-            output_data[0][ivox] = value1 * value1; break;
-         case ABS_OP:
-            if (value1 < 0.0)
-               output_data[0][ivox] = -value1;
-            else
-               output_data[0][ivox] = value1;
-            break;
-         case EXP_OP:
-            output_data[0][ivox] = constants[1] * exp(value1 * constants[0]);
-            break;
-         case LOG_OP:
-            if ((value1 <= 0.0) || (constants[1] <= 0.0) || 
-                (constants[0] == 0.0))
-               output_data[0][ivox] = illegal_value;
-            else
-               output_data[0][ivox] = log(value1/constants[1])/constants[0];
-            break;
-         case SCALE_OP:
-            output_data[0][ivox] = value1 * constants[0] + constants[1]; break;
-         case CLAMP_OP:
-            if (value1 < constants[0])
-               value1 = constants[0];
-            else if (value1 > constants[1])
-               value1 = constants[1];
-            output_data[0][ivox] = value1;
-            break;
-         case SEGMENT_OP:
-            if ((value1 < constants[0]) || (value1 > constants[1]))
-               output_data[0][ivox] = 0.0;
-            else
-               output_data[0][ivox] = 1.0;
-            break;
-         case NSEGMENT_OP:
-            if ((value1 < constants[0]) || (value1 > constants[1]))
-               output_data[0][ivox] = 1.0;
-            else
-               output_data[0][ivox] = 0.0;
-            break;
-         case PERCENTDIFF_OP:
-            if ((value1 < constants[0]) || (value1 == 0.0))
-               output_data[0][ivox] = illegal_value;
-            else {
-               output_data[0][ivox] = 100.0 * (value1 - value2) / value1;
-            }
-            break;
-         case EQ_OP:
-            output_data[0][ivox] = (((rint(value1)-rint(value2)) == 0.0)
-                                    ? 1.0 : 0.0);
-            break;
-         case NE_OP:
-            output_data[0][ivox] = (((rint(value1)-rint(value2)) != 0.0)
-                                    ? 1.0 : 0.0);
-            break;
-         case GT_OP:
-            output_data[0][ivox] = value1 > value2; break;
-         case GE_OP:
-            output_data[0][ivox] = value1 >= value2; break;
-         case LT_OP:
-            output_data[0][ivox] = value1 < value2; break;
-         case LE_OP:
-            output_data[0][ivox] = value1 <= value2; break;
-         case AND_OP:
-            output_data[0][ivox] = 
-               (((rint(value1) != 0.0) && (rint(value2) != 0.0)) ? 1.0 : 0.0);
-            break;
-         case OR_OP:
-            output_data[0][ivox] = 
-               (((rint(value1) != 0.0) || (rint(value2) != 0.0)) ? 1.0 : 0.0);
-            break;
-         case NOT_OP:
-            output_data[0][ivox] = ((rint(value1) == 0.0) ? 1.0 : 0.0);
-            break;
-         case ISNAN_OP:
-            output_data[0][ivox] = 0.0;     /* To get here, value is not nan */
-            break;
-         case NISNAN_OP:
-            output_data[0][ivox] = 1.0;
-            break;
-         default:
-            (void) fprintf(stderr, "Bad op in do_math!\n");
-            exit(EXIT_FAILURE);
-         }
-      }
+   switch (operation) {
+   case ADD_OP:
+      SIMPLE_LOOP(x + y);
+   case SUB_OP:
+      SIMPLE_LOOP(x - y);
+   case MULT_OP:
+      SIMPLE_LOOP(x * y);
+   case DIV_OP:
+      /* Divide zeros by one and then select the illegal value */
+      MATH_LOOP(x / (y + (double) (y == 0.0)),
+                (y == 0.0) ? illegal_value : result);
+   case INVERT_OP:
+      MATH_LOOP(y / (x + (double) (x == 0.0)),
+                (x == 0.0) ? illegal_value : result);
+   case SQRT_OP:
+      MATH_LOOP(sqrt((x < 0.0) ? 0.0 : x),
+                (x < 0.0) ? illegal_value : result);
+   case SQUARE_OP:
+      SIMPLE_LOOP(x * x);
+   case ABS_OP:
+      SIMPLE_LOOP((x < 0.0) ? -x : x);
+   case EXP_OP:
+      SIMPLE_LOOP(c1 * exp(x * c0));
+   case LOG_OP:
+      MATH_LOOP(log(x / c1) / c0,
+                ((x <= 0.0) | (c1 <= 0.0) | (c0 == 0.0)) ? 
+                illegal_value : result);
+   case SCALE_OP:
+      SIMPLE_LOOP(x * c0 + c1);
+   case CLAMP_OP:
+      SIMPLE_LOOP((x < c0) ? c0 : ((x > c1) ? c1 : x));
+   case SEGMENT_OP:
+      SIMPLE_LOOP(((x < c0) | (x > c1)) ? 0.0 : 1.0);
+   case NSEGMENT_OP:
+      SIMPLE_LOOP(((x < c0) | (x > c1)) ? 1.0 : 0.0);
+   case PERCENTDIFF_OP:
+      MATH_LOOP(100.0 * (x - y) / (x + (double) (x == 0.0)),
+                ((x < c0) | (x == 0.0)) ? illegal_value : result);
+   case EQ_OP:
+      SIMPLE_LOOP(((rint(x) - rint(y)) == 0.0) ? 1.0 : 0.0);
+   case NE_OP:
+      SIMPLE_LOOP(((rint(x) - rint(y)) != 0.0) ? 1.0 : 0.0);
+   case GT_OP:
+      SIMPLE_LOOP((x > y) ? 1.0 : 0.0);
+   case GE_OP:
+      SIMPLE_LOOP((x >= y) ? 1.0 : 0.0);
+   case LT_OP:
+      SIMPLE_LOOP((x < y) ? 1.0 : 0.0);
+   case LE_OP:
+      SIMPLE_LOOP((x <= y) ? 1.0 : 0.0);
+   case AND_OP:
+      SIMPLE_LOOP(((rint(x) != 0.0) & (rint(y) != 0.0)) ? 1.0 : 0.0);
+   case OR_OP:
+      SIMPLE_LOOP(((rint(x) != 0.0) | (rint(y) != 0.0)) ? 1.0 : 0.0);
+   case NOT_OP:
+      SIMPLE_LOOP((rint(x) == 0.0) ? 1.0 : 0.0);
+   case ISNAN_OP:
+      NAN_LOOP(1.0, 0.0);
+   case NISNAN_OP:
+      NAN_LOOP(0.0, 1.0);
+   default:
+      (void) fprintf(stderr, "Bad op in do_math!\n");
+      exit(EXIT_FAILURE);
    }
 
    return;
@@ -739,9 +942,9 @@ static void do_math(void *caller_data, long num_voxels,
 @DESCRIPTION: Routine for doing accumulation math operations.
 @METHOD     : 
 @GLOBALS    : 
-@CALLS      : 
+@CALLS      : accumulate_values
 @CREATED    : April 25, 1995 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - loops moved to accumulate_values
 ---------------------------------------------------------------------------- */
 static void accum_math(void *caller_data, long num_voxels, 
                        int input_num_buffers, int input_vector_length,
@@ -752,10 +955,6 @@ static void accum_math(void *caller_data, long num_voxels,
      /* ARGSUSED */
 {
    Math_Data *math_data;
-   long ivox;
-   double value, oldvalue;
-   Operation operation;
-   int propagate_nan;
 
    /* Get pointer to window info */
    math_data = (Math_Data *) caller_data;
@@ -767,65 +966,9 @@ static void accum_math(void *caller_data, long num_voxels,
       exit(EXIT_FAILURE);
    }
 
-   /* Get info */
-   operation = math_data->operation;
-   propagate_nan = math_data->propagate_nan;
-
-   /* Loop through the voxels */
-   for (ivox=0; ivox < num_voxels*input_vector_length; ivox++) {
-
-      /* Get previous value and the next value */
-      oldvalue = output_data[0][ivox];
-      value = input_data[0][ivox];
-
-      /* If the new data is invalid, then either mark the output as invalid
-         or ignore it */
-      if (value == INVALID_DATA) {
-         if (propagate_nan) {
-            output_data[0][ivox] = INVALID_DATA;
-         }
-      }
-
-      /* If we haven't set anything yet, then just copy the new value */
-      else if (oldvalue == UNINITIALIZED_DATA) {
-         output_data[0][ivox] = input_data[0][ivox];
-      }
-
-      /* Do the operation if the old data and the new data are valid */
-      else if (oldvalue != INVALID_DATA) {
-         switch (operation) {
-         case ADD_OP:
-            output_data[0][ivox] = oldvalue + value;
-            break;
-         case MULT_OP:
-            output_data[0][ivox] = oldvalue * value;
-            break;
-         case AND_OP:
-            output_data[0][ivox] = 
-               (((oldvalue != 0.0) && (rint(value) != 0.0)) ? 1.0 : 0.0);
-            break;
-         case OR_OP:
-            output_data[0][ivox] = 
-               (((oldvalue != 0.0) || (rint(value) != 0.0)) ? 1.0 : 0.0);
-            break;
-         case MAX_OP:
-            if (value > oldvalue)
-               output_data[0][ivox] = value;
-            break;
-         case MIN_OP:
-            if (value < oldvalue)
-               output_data[0][ivox] = value;
-            break;
-         case COUNT_OP:
-            output_data[0][ivox]++;
-            break;
-         default:
-            (void) fprintf(stderr, "Bad op in accum_math!\n");
-            exit(EXIT_FAILURE);
-         }
-      }
-
-   }              /* Loop over voxels */
+   accumulate_values(math_data->operation, math_data->propagate_nan,
+                     num_voxels * input_vector_length, 
+                     input_data[0], output_data[0]);
 
    return;
 }
@@ -838,9 +981,9 @@ static void accum_math(void *caller_data, long num_voxels,
 @DESCRIPTION: Start routine for math accumulation.
 @METHOD     : 
 @GLOBALS    : 
-@CALLS      : 
+@CALLS      : start_values
 @CREATED    : April 25, 1995 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - loop moved to start_values
 ---------------------------------------------------------------------------- */
 static void start_math(void *caller_data, long num_voxels, 
                        int output_num_buffers, int output_vector_length,
@@ -849,7 +992,6 @@ static void start_math(void *caller_data, long num_voxels,
      /* ARGSUSED */
 {
    Math_Data *math_data;
-   long ivox;
 
    /* Get pointer to window info */
    math_data = (Math_Data *) caller_data;
@@ -860,24 +1002,8 @@ static void start_math(void *caller_data, long num_voxels,
       exit(EXIT_FAILURE);
    }
 
-   /* Get info */
-   operation = math_data->operation;
-
-   /* Loop through the voxels, marking them all as uninitialized. We treat
-      COUNT_OP as a special case since it always has a value. This is 
-      especially important to prevent it from going through
-      the code in accum_math for handling the first valid voxel which
-      just assigns the first value. */
-   for (ivox=0; ivox < num_voxels*output_vector_length; ivox++) {
-      switch (operation) {
-      case COUNT_OP:
-         output_data[0][ivox] = 0.0;
-         break;
-      default:
-         output_data[0][ivox] = UNINITIALIZED_DATA;
-         break;
-      }
-   }
+   start_values(math_data->operation, num_voxels * output_vector_length,
+                output_data[0]);
 
    return;
 }
@@ -890,9 +1016,9 @@ static void start_math(void *caller_data, long num_voxels,
 @DESCRIPTION: Start routine for math accumulation.
 @METHOD     : 
 @GLOBALS    : 
-@CALLS      : 
+@CALLS      : finish_values
 @CREATED    : April 25, 1995 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - loop moved to finish_values
 ---------------------------------------------------------------------------- */
 static void end_math(void *caller_data, long num_voxels, 
                      int output_num_buffers, int output_vector_length,
@@ -901,9 +1027,6 @@ static void end_math(void *caller_data, long num_voxels,
      /* ARGSUSED */
 {
    Math_Data *math_data;
-   long ivox;
-   double value;
-   double illegal_value;
 
    /* Get pointer to window info */
    math_data = (Math_Data *) caller_data;
@@ -914,17 +1037,519 @@ static void end_math(void *caller_data, long num_voxels,
       exit(EXIT_FAILURE);
    }
 
-   /* Get info */
-   operation = math_data->operation;
+   finish_values(math_data->illegal_value, 
+                 num_voxels * output_vector_length, output_data[0]);
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_values
+@INPUT      : operation - cumulative operation
+              nvalues - number of values
+@OUTPUT     : output - values to accumulate into
+@RETURNS    : (nothing)
+@DESCRIPTION: Marks values as uninitialized before accumulating into them.
+@METHOD     : We treat COUNT_OP as a special case since it always has a 
+              value. This is especially important to prevent it from going 
+              through the code in accumulate_values for handling the first 
+              valid voxel which just assigns the first value.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void start_values(Operation operation, long nvalues, double *output)
+{
+   long ivalue;
+   double value;
+
+   value = (operation == COUNT_OP) ? 0.0 : UNINITIALIZED_DATA;
+   for (ivalue=0; ivalue < nvalues; ivalue++)
+      output[ivalue] = value;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : accumulate_values
+@INPUT      : operation - cumulative operation
+              propagate_nan - TRUE if invalid values make the output invalid
+              nvalues - number of values
+              input - values of the next file
+              output - values accumulated so far
+@OUTPUT     : output - values accumulated so far
+@RETURNS    : (nothing)
+@DESCRIPTION: Accumulates the values of a file.
+@METHOD     : The operation is chosen once, and each operation has its own
+              loop (see ACCUM_LOOP).
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void accumulate_values(Operation operation, int propagate_nan,
+                              long nvalues, double *input, double *output)
+{
+   long ivalue;
+   double x, y, result;
+
+   switch (operation) {
+   case ADD_OP:
+      ACCUM_LOOP(x + y);
+   case MULT_OP:
+      ACCUM_LOOP(x * y);
+   case AND_OP:
+      ACCUM_LOOP(((x != 0.0) & (rint(y) != 0.0)) ? 1.0 : 0.0);
+   case OR_OP:
+      ACCUM_LOOP(((x != 0.0) | (rint(y) != 0.0)) ? 1.0 : 0.0);
+   case MAX_OP:
+      ACCUM_LOOP((y > x) ? y : x);
+   case MIN_OP:
+      ACCUM_LOOP((y < x) ? y : x);
+   case COUNT_OP:
+      ACCUM_LOOP(x + 1.0);
+   default:
+      (void) fprintf(stderr, "Bad op in accum_math!\n");
+      exit(EXIT_FAILURE);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : finish_values
+@INPUT      : illegal_value - value for voxels with no result
+              nvalues - number of values
+              output - accumulated values
+@OUTPUT     : output - results
+@RETURNS    : (nothing)
+@DESCRIPTION: Replaces uninitialized and invalid accumulated values by the
+              illegal value.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void finish_values(double illegal_value, long nvalues, double *output)
+{
+   long ivalue;
+   double value;
+
+   for (ivalue=0; ivalue < nvalues; ivalue++) {
+      value = output[ivalue];
+      output[ivalue] = 
+         ((value == UNINITIALIZED_DATA) | (value == INVALID_DATA)) ?
+         illegal_value : value;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : partial_math
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to add the values of an input file to partial 
+              states (-partial).
+@METHOD     : Invalid values are counted, whether or not they are to be
+              propagated, so that this can be decided when merging.
+@GLOBALS    : 
+@CALLS      : add_partial_value
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void partial_math(void *caller_data, long num_voxels, 
+                         int input_num_buffers, int input_vector_length,
+                         double *input_data[],
+                         int output_num_buffers, int output_vector_length,
+                         double *output_data[],
+                         Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Math_Data *math_data;
+   long ivox;
+
+   /* Get pointer to window info */
+   math_data = (Math_Data *) caller_data;
+
+   /* Check arguments */
+   if (input_vector_length != 1) {
+      (void) fprintf(stderr, "Input files must be scalar for -partial.\n");
+      exit(EXIT_FAILURE);
+   }
+   if ((input_num_buffers != 1) || (output_num_buffers != 1)) {
+      (void) fprintf(stderr, "Bad arguments to partial_math!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   for (ivox=0; ivox < num_voxels; ivox++) {
+      add_partial_value(&math_data->states[ivox * PARTIAL_STATE_LENGTH],
+                        input_data[0][ivox], 1.0);
+   }
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : merge_math
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to merge the partial states of an input file 
+              (-merge).
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : merge_partial_states
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void merge_math(void *caller_data, long num_voxels, 
+                       int input_num_buffers, int input_vector_length,
+                       double *input_data[],
+                       int output_num_buffers, int output_vector_length,
+                       double *output_data[],
+                       Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Math_Data *math_data;
+
+   /* Get pointer to window info */
+   math_data = (Math_Data *) caller_data;
+
+   /* Check arguments */
+   if ((input_num_buffers != 1) || (output_num_buffers != 1) ||
+       (input_vector_length != PARTIAL_STATE_LENGTH)) {
+      (void) fprintf(stderr, "Bad arguments to merge_math!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   merge_partial_states(num_voxels, math_data->states, input_data[0]);
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_partial
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Start routine for -partial and -merge.
+@METHOD     : The partial states are kept in math_data, since the output
+              of a merge has only one value for each voxel.
+@GLOBALS    : 
+@CALLS      : start_partial_states
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void start_partial(void *caller_data, long num_voxels, 
+                          int output_num_buffers, int output_vector_length,
+                          double *output_data[],
+                          Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Math_Data *math_data;
+   long nvalues;
+
+   /* Get pointer to window info */
+   math_data = (Math_Data *) caller_data;
+
+   /* Get space for the states */
+   nvalues = num_voxels * PARTIAL_STATE_LENGTH;
+   if (nvalues > math_data->states_alloc) {
+      free(math_data->states);
+      math_data->states = malloc(sizeof(*math_data->states) * nvalues);
+      if (math_data->states == NULL) {
+         (void) fprintf(stderr, "Out of memory for partial states.\n");
+         exit(EXIT_FAILURE);
+      }
+      math_data->states_alloc = nvalues;
+   }
+
+   start_partial_states(num_voxels, math_data->states);
+
+   return;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : finish_partial
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Finish routine for -partial and -merge.
+@METHOD     : With -partial, the states are copied to the output. 
+              Otherwise, the result of the operation is taken from them,
+              with the illegal value where there are no valid values or,
+              when invalid values are propagated, where any value was
+              invalid.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void finish_partial(void *caller_data, long num_voxels, 
+                           int output_num_buffers, int output_vector_length,
+                           double *output_data[],
+                           Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Math_Data *math_data;
+   long ivox, ivalue;
+   int icomponent, propagate_nan;
+   double *state, illegal_value;
+
+   /* Get pointer to window info */
+   math_data = (Math_Data *) caller_data;
+
+   /* Check arguments */
+   if ((output_num_buffers != 1) ||
+       (output_vector_length != 
+        (math_data->partial ? PARTIAL_STATE_LENGTH : 1))) {
+      (void) fprintf(stderr, "Bad arguments to finish_partial!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Copy the partial states */
+   if (math_data->partial) {
+      for (ivalue=0; ivalue < num_voxels * PARTIAL_STATE_LENGTH; ivalue++) {
+         output_data[0][ivalue] = math_data->states[ivalue];
+      }
+      return;
+   }
+
+   /* Get the part of the state that is the result */
+   switch (math_data->operation) {
+   case ADD_OP:
+      icomponent = PARTIAL_SUM;
+      break;
+   case MAX_OP:
+      icomponent = PARTIAL_MAX;
+      break;
+   case MIN_OP:
+      icomponent = PARTIAL_MIN;
+      break;
+   case COUNT_OP:
+      icomponent = PARTIAL_COUNT;
+      break;
+   default:
+      (void) fprintf(stderr, "Bad op in finish_partial!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Loop through the voxels */
+   propagate_nan = math_data->propagate_nan;
    illegal_value = math_data->illegal_value;
+   for (ivox=0; ivox < num_voxels; ivox++) {
+      state = &math_data->states[ivox * PARTIAL_STATE_LENGTH];
+      output_data[0][ivox] = 
+         ((state[PARTIAL_COUNT] <= 0.0) | 
+          (propagate_nan & (state[PARTIAL_INVALID] > 0.0))) ?
+         illegal_value : state[icomponent];
+   }
+
+   return;
+}
+
+#ifdef HAVE_PTHREAD
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : fused_math
+@INPUT      : Standard for voxel loop
+@OUTPUT     : Standard for voxel loop
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine doing a cumulative operation on all of the files for
+              a buffer of the first file.
+@METHOD     : The buffer is split into ranges of values, one for each 
+              thread, and each thread accumulates the files in order into 
+              its range. Meanwhile, this thread reads the other files for
+              the same part of the image, one ahead of the slowest thread,
+              since the minc library can only be used from one thread at a
+              time. Values are accumulated in the same order as by 
+              accum_math, so results are the same.
+@GLOBALS    : 
+@CALLS      : read_fused_file, fused_job
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void fused_math(void *caller_data, long num_voxels, 
+                       int input_num_buffers, int input_vector_length,
+                       double *input_data[],
+                       int output_num_buffers, int output_vector_length,
+                       double *output_data[],
+                       Loop_Info *loop_info)
+     /* ARGSUSED */
+{
+   Math_Data *math_data;
+   long nvalues, nchunks;
+   long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+   int ifile, ijob, njobs, ibuff;
+   Fused_Sync sync;
+   Fused_Job *jobs;
+   pthread_t *threads;
+
+   /* Get pointer to window info */
+   math_data = (Math_Data *) caller_data;
+
+   /* Check arguments */
+   if ((input_num_buffers != 1) || (output_num_buffers != 1) || 
+       (output_vector_length != input_vector_length)) {
+      (void) fprintf(stderr, "Bad arguments to fused_math!\n");
+      exit(EXIT_FAILURE);
+   }
+
+   /* Get the part of the image in the buffer */
+   get_info_shape(loop_info, MAX_VAR_DIMS, start, count);
+
+   /* Get buffers for the other files */
+   nvalues = num_voxels * input_vector_length;
+   if (nvalues > math_data->file_data_alloc) {
+      for (ibuff=0; ibuff < 2; ibuff++) {
+         if (math_data->file_data[ibuff] != NULL)
+            free(math_data->file_data[ibuff]);
+         math_data->file_data[ibuff] = malloc(sizeof(double) * nvalues);
+         if (math_data->file_data[ibuff] == NULL) {
+            (void) fprintf(stderr, "Out of memory for file buffers.\n");
+            exit(EXIT_FAILURE);
+         }
+      }
+      math_data->file_data_alloc = nvalues;
+   }
+
+   /* Start the threads. They wait until their ranges are set, since
+      threads that cannot be started do not get one. */
+   (void) pthread_mutex_init(&sync.mutex, NULL);
+   (void) pthread_cond_init(&sync.cond, NULL);
+   sync.files_read = 0;
+   sync.buffer_done[0] = sync.buffer_done[1] = math_data->nthreads;
+   jobs = malloc(sizeof(*jobs) * math_data->nthreads);
+   threads = malloc(sizeof(*threads) * math_data->nthreads);
+   if ((jobs == NULL) || (threads == NULL)) {
+      (void) fprintf(stderr, "Out of memory for threads.\n");
+      exit(EXIT_FAILURE);
+   }
+   njobs = 0;
+   for (ijob=0; ijob < math_data->nthreads; ijob++) {
+      jobs[njobs].math_data = math_data;
+      jobs[njobs].sync = &sync;
+      jobs[njobs].first_data = input_data[0];
+      jobs[njobs].output = output_data[0];
+      if (pthread_create(&threads[njobs], NULL, fused_job, 
+                         &jobs[njobs]) == 0) {
+         njobs++;
+      }
+   }
+
+   /* Without threads, do the whole buffer here */
+   if (njobs == 0) {
+      start_values(math_data->operation, nvalues, output_data[0]);
+      for (ifile=0; ifile < math_data->fused.num_files; ifile++) {
+         if (ifile > 0) {
+            read_fused_file(&math_data->fused, ifile, start, count,
+                            math_data->file_data[0]);
+         }
+         accumulate_values(math_data->operation, math_data->propagate_nan,
+                           nvalues, (ifile == 0) ? 
+                           input_data[0] : math_data->file_data[0],
+                           output_data[0]);
+      }
+      finish_values(math_data->illegal_value, nvalues, output_data[0]);
+   }
+
+   else {
+
+      /* Give each thread a range of whole chunks */
+      nchunks = (nvalues + MATH_CHUNK - 1) / MATH_CHUNK;
+      (void) pthread_mutex_lock(&sync.mutex);
+      for (ijob=0; ijob < njobs; ijob++) {
+         jobs[ijob].start = (nchunks * ijob / njobs) * MATH_CHUNK;
+         jobs[ijob].end = (nchunks * (ijob+1) / njobs) * MATH_CHUNK;
+         if (jobs[ijob].end > nvalues) jobs[ijob].end = nvalues;
+      }
+      sync.files_read = 1;
+      sync.buffer_done[0] = sync.buffer_done[1] = njobs;
+      (void) pthread_cond_broadcast(&sync.cond);
 
-   /* Loop through the voxels, checking for uninitialized values */
-   for (ivox=0; ivox < num_voxels*output_vector_length; ivox++) {
-      value = output_data[0][ivox];
-      if ((value == UNINITIALIZED_DATA) || (value == INVALID_DATA)) {
-         output_data[0][ivox] = illegal_value;
+      /* Read the other files, waiting until the threads are done with the
+         file in the buffer before reading the next one into it */
+      for (ifile=1; ifile < math_data->fused.num_files; ifile++) {
+         ibuff = ifile % 2;
+         while (sync.buffer_done[ibuff] < njobs)
+            (void) pthread_cond_wait(&sync.cond, &sync.mutex);
+         sync.buffer_done[ibuff] = 0;
+         (void) pthread_mutex_unlock(&sync.mutex);
+         read_fused_file(&math_data->fused, ifile, start, count,
+                         math_data->file_data[ibuff]);
+         (void) pthread_mutex_lock(&sync.mutex);
+         sync.files_read = ifile + 1;
+         (void) pthread_cond_broadcast(&sync.cond);
       }
+      (void) pthread_mutex_unlock(&sync.mutex);
+
+      for (ijob=0; ijob < njobs; ijob++)
+         (void) pthread_join(threads[ijob], NULL);
    }
 
+   (void) pthread_cond_destroy(&sync.cond);
+   (void) pthread_mutex_destroy(&sync.mutex);
+   free(jobs);
+   free(threads);
+
    return;
 }
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : fused_job
+@INPUT      : arg - range of values (Fused_Job)
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Thread accumulating all of the files into a range of values
+              for fused_math.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : start_values, accumulate_values, finish_values
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void *fused_job(void *arg)
+{
+   Fused_Job *job;
+   Fused_Sync *sync;
+   Math_Data *math_data;
+   int ifile;
+   long nvalues;
+   double *input, *output;
+
+   job = (Fused_Job *) arg;
+   sync = job->sync;
+   math_data = job->math_data;
+
+   for (ifile=0; ifile < math_data->fused.num_files; ifile++) {
+
+      /* Wait for the file to be read */
+      (void) pthread_mutex_lock(&sync->mutex);
+      while (sync->files_read <= ifile)
+         (void) pthread_cond_wait(&sync->cond, &sync->mutex);
+      (void) pthread_mutex_unlock(&sync->mutex);
+
+      nvalues = job->end - job->start;
+      output = &job->output[job->start];
+      if (ifile == 0) {
+         start_values(math_data->operation, nvalues, output);
+         input = &job->first_data[job->start];
+      }
+      else {
+         input = &math_data->file_data[ifile % 2][job->start];
+      }
+      accumulate_values(math_data->operation, math_data->propagate_nan,
+                        nvalues, input, output);
+
+      /* Let fused_math know that we are done with the file */
+      (void) pthread_mutex_lock(&sync->mutex);
+      if (ifile > 0) sync->buffer_done[ifile % 2]++;
+      (void) pthread_cond_broadcast(&sync->cond);
+      (void) pthread_mutex_unlock(&sync->mutex);
+   }
+
+   finish_values(math_data->illegal_value, job->end - job->start,
+                 &job->output[job->start]);
+
+   return NULL;
+}
+
+#endif /* HAVE_PTHREAD */
@@ -0,0 +1,420 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : bench_interpolants.c
+@DESCRIPTION: Micro-benchmark for the mincresample interpolants. Fills a
+              synthetic volume of each specialized data type, interpolates
+              the same points, taken along the rows of an oblique slab of
+              output slices, with the single-point interpolants
+              (trilinear_interpolant, tricubic_interpolant,
+              windowed_sinc_interpolant) and with the row interpolants
+              (trilinear_interpolant_row, tricubic_interpolant_row,
+              windowed_sinc_interpolant_row), and reports the time per
+              point of each as well as the largest difference between
+              them. Sinc is also run on rows that follow the input
+              columns, rows and slices, which take the separable path,
+              and label lookup
+              (nearest_neighbour_label_row) is checked voxel for voxel
+              against nearest_neighbour_interpolant. Exits with a
+              failure status if any difference exceeds the documented
+              tolerance (see row_interpolants.c) or any label differs.
+@METHOD     : Usage: bench_interpolants [<size> [<npoints> [<nreps>]]]
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1993 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#include <math.h>
+#include <time.h>
+#include <minc.h>
+#include <volume_io.h>
+#include "mincresample.h"
+
+/* Largest relative difference allowed between the two paths */
+#define TOLERANCE 1.0e-12
+
+#define DEFAULT_SIZE    128
+#define DEFAULT_NPOINTS 4096
+#define DEFAULT_NREPS   64
+
+/* Angles (in radians) of the rotations of the oblique output slices */
+#define OBLIQUE_ANGLE_1 0.15
+#define OBLIQUE_ANGLE_2 0.10
+
+/* Offsets (in voxels) from the voxel centres of rows that follow an 
+   input axis, along the two other axes, and the start and step of the
+   rows along the axis (a slight zoom) */
+#define ALIGNED_OFFSET_1  0.37
+#define ALIGNED_OFFSET_2  0.41
+#define ALIGNED_START    -2.13
+#define ALIGNED_STEP      1.05
+
+/* Simple reproducible random numbers in [0,1) */
+static unsigned long random_state = 12345;
+static double random_fraction(void)
+{
+   random_state = random_state * 1103515245UL + 12345UL;
+   return (double) ((random_state >> 16) & 0x7fff) / 32768.0;
+}
+
+static double elapsed_seconds(clock_t start)
+{
+   return (double) (clock() - start) / (double) CLOCKS_PER_SEC;
+}
+
+/* Fill a volume of the given type with a smooth pattern plus noise */
+static void make_volume(Volume_Data *volume, nc_type datatype, int is_signed,
+                        int size)
+{
+   long ivox, nvox, islice;
+   double value, vmax;
+
+   volume->datatype = datatype;
+   volume->is_signed = is_signed;
+   volume->use_fill = TRUE;
+   volume->fillvalue = 0.0;
+   volume->voxel_fillvalue = 0.0;
+   volume->size[SLC_AXIS] = size;
+   volume->size[ROW_AXIS] = size;
+   volume->size[COL_AXIS] = size;
+   nvox = (long) size * size * size;
+   volume->data = malloc(nvox * nctypelen(datatype));
+   volume->scale = malloc(sizeof(double) * size);
+   volume->offset = malloc(sizeof(double) * size);
+
+   switch (datatype) {
+   case NC_BYTE:  vmax = 255.0; break;
+   case NC_SHORT: vmax = (is_signed ? 32767.0 : 65535.0); break;
+   default:       vmax = 1000.0; break;
+   }
+   volume->vrange[0] = 0.0;
+   volume->vrange[1] = vmax;
+
+   for (ivox=0; ivox < nvox; ivox++) {
+      value = vmax * (0.5 + 0.25 * sin(ivox * 0.001) +
+                      0.25 * random_fraction());
+      if (value > vmax) value = vmax;
+      switch (datatype) {
+      case NC_BYTE:
+         ((unsigned char *) volume->data)[ivox] = (unsigned char) value;
+         break;
+      case NC_SHORT:
+         if (is_signed)
+            ((short *) volume->data)[ivox] = (short) value;
+         else
+            ((unsigned short *) volume->data)[ivox] = (unsigned short) value;
+         break;
+      default:
+         ((float *) volume->data)[ivox] = (float) value;
+         break;
+      }
+   }
+
+   for (islice=0; islice < size; islice++) {
+      volume->scale[islice] = (datatype == NC_FLOAT) ? 1.0 :
+         (1.0 + islice * 0.01) / vmax;
+      volume->offset[islice] = (datatype == NC_FLOAT) ? 0.0 :
+         -0.5 + islice * 0.001;
+   }
+   volume->real_range[0] = 0.0;
+   volume->real_range[1] = 1.0;
+}
+
+/* Time one interpolant both ways, giving the row interpolant rows of
+   row_length points as mincresample does, and compare the results */
+static int compare_interpolants(char *name, Volume_Data *volume,
+                                Interpolating_Function interpolant,
+                                Row_Interpolating_Function row_interpolant,
+                                long npoints, Coord_Vector coords[],
+                                long row_length, int nreps)
+{
+   double *scalar_result, *row_result, diff, maxdiff;
+   double scalar_time, row_time;
+   int *scalar_inside, *row_inside;
+   long ipoint, istart, nrow;
+   int irep, mismatch;
+   clock_t start;
+
+   scalar_result = malloc(sizeof(double) * npoints);
+   row_result = malloc(sizeof(double) * npoints);
+   scalar_inside = malloc(sizeof(int) * npoints);
+   row_inside = malloc(sizeof(int) * npoints);
+
+   start = clock();
+   for (irep=0; irep < nreps; irep++) {
+      for (ipoint=0; ipoint < npoints; ipoint++) {
+         scalar_inside[ipoint] =
+            (*interpolant)(volume, coords[ipoint], &scalar_result[ipoint]);
+      }
+   }
+   scalar_time = elapsed_seconds(start);
+
+   start = clock();
+   for (irep=0; irep < nreps; irep++) {
+      for (istart=0; istart < npoints; istart += row_length) {
+         nrow = MIN(row_length, npoints - istart);
+         (*row_interpolant)(volume, nrow, &coords[istart],
+                            &row_result[istart], &row_inside[istart]);
+      }
+   }
+   row_time = elapsed_seconds(start);
+
+   maxdiff = 0.0;
+   mismatch = FALSE;
+   for (ipoint=0; ipoint < npoints; ipoint++) {
+      if (scalar_inside[ipoint] != row_inside[ipoint]) mismatch = TRUE;
+      diff = fabs(scalar_result[ipoint] - row_result[ipoint]) /
+         MAX(fabs(scalar_result[ipoint]), 1.0);
+      if (diff > maxdiff) maxdiff = diff;
+   }
+
+   (void) printf("%-28s scalar %8.2f ns/pt   row %8.2f ns/pt   "
+                 "speedup %5.2f   max rel diff %g%s\n",
+                 name,
+                 1.0e9 * scalar_time / ((double) npoints * nreps),
+                 1.0e9 * row_time / ((double) npoints * nreps),
+                 (row_time > 0.0) ? scalar_time / row_time : 0.0,
+                 maxdiff, mismatch ? "  (inside flags differ)" : "");
+
+   free(scalar_result);
+   free(row_result);
+   free(scalar_inside);
+   free(row_inside);
+
+   return (!mismatch && (maxdiff <= TOLERANCE));
+}
+
+/* Get a label voxel written by nearest_neighbour_label_row */
+static double label_voxel(Volume_Data *volume, void *values, long ipoint)
+{
+   switch (volume->datatype) {
+   case NC_BYTE:
+      return (double) ((unsigned char *) values)[ipoint];
+   case NC_SHORT:
+      if (volume->is_signed)
+         return (double) ((short *) values)[ipoint];
+      else
+         return (double) ((unsigned short *) values)[ipoint];
+   default:
+      return (double) ((float *) values)[ipoint];
+   }
+}
+
+/* Time label lookup both ways and check that the row routine copies
+   exactly the voxels that the single-point routine converts */
+static int compare_labels(char *name, Volume_Data *volume,
+                          long npoints, Coord_Vector coords[],
+                          long row_length, int nreps)
+{
+   double *scalar_result, *row_values, expected;
+   double scalar_time, row_time;
+   int *scalar_inside, *row_inside;
+   long ipoint, istart, nrow, islice, nbad;
+   int irep, size;
+   clock_t start;
+
+   size = nctypelen(volume->datatype);
+   scalar_result = malloc(sizeof(double) * npoints);
+   row_values = malloc(sizeof(double) * npoints);
+   scalar_inside = malloc(sizeof(int) * npoints);
+   row_inside = malloc(sizeof(int) * npoints);
+
+   start = clock();
+   for (irep=0; irep < nreps; irep++) {
+      for (ipoint=0; ipoint < npoints; ipoint++) {
+         scalar_inside[ipoint] =
+            nearest_neighbour_interpolant(volume, coords[ipoint],
+                                          &scalar_result[ipoint]);
+      }
+   }
+   scalar_time = elapsed_seconds(start);
+
+   start = clock();
+   for (irep=0; irep < nreps; irep++) {
+      for (istart=0; istart < npoints; istart += row_length) {
+         nrow = MIN(row_length, npoints - istart);
+         nearest_neighbour_label_row(volume, nrow, &coords[istart],
+                                     (char *) row_values + istart * size,
+                                     &row_inside[istart]);
+      }
+   }
+   row_time = elapsed_seconds(start);
+
+   /* Scale each copied voxel as the single-point routine does */
+   nbad = 0;
+   for (ipoint=0; ipoint < npoints; ipoint++) {
+      if (scalar_inside[ipoint] != row_inside[ipoint]) {
+         nbad++;
+         continue;
+      }
+      if (!row_inside[ipoint]) {
+         if (label_voxel(volume, row_values, ipoint) != 
+             volume->voxel_fillvalue) nbad++;
+         continue;
+      }
+      islice = VIO_ROUND(coords[ipoint][SLICE]);
+      expected = volume->scale[islice] * 
+         label_voxel(volume, row_values, ipoint) + volume->offset[islice];
+      if (expected != scalar_result[ipoint]) nbad++;
+   }
+
+   (void) printf("%-28s scalar %8.2f ns/pt   row %8.2f ns/pt   "
+                 "speedup %5.2f   labels differing %ld\n",
+                 name,
+                 1.0e9 * scalar_time / ((double) npoints * nreps),
+                 1.0e9 * row_time / ((double) npoints * nreps),
+                 (row_time > 0.0) ? scalar_time / row_time : 0.0,
+                 nbad);
+
+   free(scalar_result);
+   free(row_values);
+   free(scalar_inside);
+   free(row_inside);
+
+   return (nbad == 0);
+}
+
+int main(int argc, char *argv[])
+{
+   static struct {
+      char *name;
+      nc_type datatype;
+      int is_signed;
+   } types[] = {
+      {"byte",   NC_BYTE,  FALSE},
+      {"short",  NC_SHORT, TRUE},
+      {"ushort", NC_SHORT, FALSE},
+      {"float",  NC_FLOAT, TRUE},
+   };
+   int ntypes = sizeof(types) / sizeof(types[0]);
+   int size, nreps, itype, idim, ok;
+   long npoints, ipoint, iline, islice, irow, icol;
+   double ca, sa, cb, sb, centre;
+   double slice_step[VOL_NDIMS], row_step[VOL_NDIMS], column_step[VOL_NDIMS];
+   Coord_Vector *coords, *aligned[VOL_NDIMS];
+   Volume_Data volume;
+   char name[64];
+   static char *axis_names[VOL_NDIMS] = {"slices", "rows", "columns"};
+
+   size = (argc > 1) ? atoi(argv[1]) : DEFAULT_SIZE;
+   npoints = (argc > 2) ? atol(argv[2]) : DEFAULT_NPOINTS;
+   nreps = (argc > 3) ? atoi(argv[3]) : DEFAULT_NREPS;
+   if ((size < 1) || (npoints < 1) || (nreps < 1)) {
+      (void) fprintf(stderr,
+                     "Usage: %s [<size> [<npoints> [<nreps>]]]\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Points along the rows of oblique output slices, as mincresample
+      would produce for an output volume rotated about two axes of the
+      input. Each point is one column step on from the one before, the
+      rows start a quarter of the way into the middle slice and the ends
+      of the rows fall outside the volume. */
+   ca = cos(OBLIQUE_ANGLE_1); sa = sin(OBLIQUE_ANGLE_1);
+   cb = cos(OBLIQUE_ANGLE_2); sb = sin(OBLIQUE_ANGLE_2);
+   slice_step[SLC_AXIS] = cb;
+   slice_step[ROW_AXIS] = -sa * sb;
+   slice_step[COL_AXIS] = -ca * sb;
+   row_step[SLC_AXIS] = 0.0;
+   row_step[ROW_AXIS] = ca;
+   row_step[COL_AXIS] = -sa;
+   column_step[SLC_AXIS] = sb;
+   column_step[ROW_AXIS] = sa * cb;
+   column_step[COL_AXIS] = ca * cb;
+   centre = (size - 1) / 2.0;
+   coords = malloc(sizeof(Coord_Vector) * npoints);
+   for (ipoint=0; ipoint < npoints; ipoint++) {
+      icol = ipoint % size;
+      iline = ipoint / size + (long) size * (size / 2) + size / 4;
+      irow = iline % size;
+      islice = (iline / size) % size;
+      for (idim=0; idim < VOL_NDIMS; idim++) {
+         coords[ipoint][idim] = centre +
+            (islice - centre) * slice_step[idim] +
+            (irow - centre) * row_step[idim] +
+            (icol - centre) * column_step[idim];
+      }
+   }
+
+   /* Points along rows that follow each input axis, between voxel
+      centres on the other two axes, with a slight zoom along the row so
+      that both ends fall outside the volume */
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      aligned[idim] = malloc(sizeof(Coord_Vector) * npoints);
+      for (ipoint=0; ipoint < npoints; ipoint++) {
+         icol = ipoint % size;
+         iline = ipoint / size + (long) size * (size / 2) + size / 4;
+         aligned[idim][ipoint][(idim + 1) % VOL_NDIMS] =
+            (iline / size) % size + ALIGNED_OFFSET_1;
+         aligned[idim][ipoint][(idim + 2) % VOL_NDIMS] =
+            iline % size + ALIGNED_OFFSET_2;
+         aligned[idim][ipoint][idim] = ALIGNED_START + icol * ALIGNED_STEP;
+      }
+   }
+
+   ok = TRUE;
+   for (itype=0; itype < ntypes; itype++) {
+      make_volume(&volume, types[itype].datatype, types[itype].is_signed,
+                  size);
+
+      (void) sprintf(name, "trilinear (%s)", types[itype].name);
+      ok &= compare_interpolants(name, &volume, trilinear_interpolant,
+                                 trilinear_interpolant_row,
+                                 npoints, coords, size, nreps);
+
+      (void) sprintf(name, "tricubic (%s)", types[itype].name);
+      ok &= compare_interpolants(name, &volume, tricubic_interpolant,
+                                 tricubic_interpolant_row,
+                                 npoints, coords, size, nreps);
+
+      (void) sprintf(name, "sinc (%s)", types[itype].name);
+      ok &= compare_interpolants(name, &volume, windowed_sinc_interpolant,
+                                 windowed_sinc_interpolant_row,
+                                 npoints, coords, size, nreps);
+
+      for (idim=0; idim < VOL_NDIMS; idim++) {
+         (void) sprintf(name, "sinc along %s (%s)", axis_names[idim],
+                        types[itype].name);
+         ok &= compare_interpolants(name, &volume, 
+                                    windowed_sinc_interpolant,
+                                    windowed_sinc_interpolant_row,
+                                    npoints, aligned[idim], size, nreps);
+      }
+
+      (void) sprintf(name, "labels (%s)", types[itype].name);
+      ok &= compare_labels(name, &volume, npoints, coords, size, nreps);
+
+      free(volume.data);
+      free(volume.scale);
+      free(volume.offset);
+   }
+
+   free(coords);
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      free(aligned[idim]);
+   }
+
+   if (!ok) {
+      (void) fprintf(stderr, "Row interpolants differ from single-point "
+                     "interpolants by more than %g or copy different "
+                     "labels\n", TOLERANCE);
+      exit(EXIT_FAILURE);
+   }
+
+   exit(EXIT_SUCCESS);
+}
@@ -208,6 +208,7 @@
 #include <float.h>
 #include <limits.h>
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
 #include <minc.h>
 #include <ParseArgv.h>
@@ -225,10 +226,14 @@ int Specified_transform = FALSE;
 #define SAMPLING_ACTION_NOT_SET (-1)
 #endif
 
-static void get_arginfo(int argc, char *argv[],
-                        Program_Flags *program_flags,
-                        VVolume *in_vol, VVolume *out_vol,
-                        VIO_General_transform *transformation);
+static int get_arginfo(int argc, char *argv[], Arg_Data *parsed_args,
+                       Resample_Job **job_list);
+static int read_batch_file(char *filename, Transform_Info *default_transform,
+                           Resample_Job **job_list);
+static void setup_job(Arg_Data *parsed_args, Resample_Job *job,
+                      Program_Flags *program_flags,
+                      VVolume *in_vol, VVolume *out_vol,
+                      VIO_General_transform *transformation);
 static void check_imageminmax(File_Info *fp, Volume_Data *volume);
 static void get_file_info(char *filename, int initialized_volume_def,
                           Volume_Definition *volume_def,
@@ -264,6 +269,9 @@ static void irregular_inverse_transform_function(void *user_data,
                                                  VIO_Real *z_trans);
 static double get_default_range(char *what, nc_type datatype, int is_signed);
 static void finish_up(VVolume *in_vol, VVolume *out_vol);
+static unsigned long get_transform_checksum(Transform_Info *transform_info);
+static unsigned long add_grid_files_to_checksum(Transform_Info *transform_info,
+                                                unsigned long checksum);
 static int get_transformation(char *dst, char *key, char *nextArg);
 static int get_model_file(char *dst, char *key, char *nextArg);
 static int set_standard_sampling(char *dst, char *key, char *nextArg);
@@ -280,15 +288,49 @@ int main(int argc, char *argv[])
    VVolume *in_vol = &in_vol_struct, *out_vol = &out_vol_struct;
    VIO_General_transform transformation;
    Program_Flags program_flags;
+   Arg_Data args;
+   Resample_Job *jobs;
+   int njobs, ijob;
+   Profile_Timer run_timer;
+
+   /* Time the run, along with the transformation files read while the
+      arguments are parsed, and stop timing if -profile was not given */
+   profile_enable();
+   profile_start(&run_timer);
 
    /* Get argument information */
-   get_arginfo(argc, argv, &program_flags, in_vol, out_vol, &transformation);
+   njobs = get_arginfo(argc, argv, &args, &jobs);
+   if (!args.flags.profile) {
+      profile_disable();
+   }
+
+   /* Buffers are allocated by the first job and reused by the others */
+   (void) memset(in_vol, 0, sizeof(*in_vol));
+   (void) memset(out_vol, 0, sizeof(*out_vol));
 
-   /* Do the resampling */
-   resample_volumes(&program_flags, in_vol, out_vol, &transformation);
+   /* Loop over jobs */
+   for (ijob=0; ijob < njobs; ijob++) {
 
-   /* Finish up */
-   finish_up(in_vol, out_vol);
+      /* Set up the volumes and transformation */
+      setup_job(&args, &jobs[ijob], &program_flags, in_vol, out_vol,
+                &transformation);
+      if ((args.batch_file != NULL) && program_flags.verbose) {
+         (void) fprintf(stderr, "Resampling %s to %s\n",
+                        jobs[ijob].infile, jobs[ijob].outfile);
+      }
+
+      /* Do the resampling */
+      resample_volumes(&program_flags, in_vol, out_vol, &transformation);
+
+      /* Finish up */
+      finish_up(in_vol, out_vol);
+      delete_general_transform(&transformation);
+   }
+
+   /* Report the time spent in each stage */
+   if (args.flags.profile) {
+      profile_write(stdout, &run_timer, args.flags.nthreads, njobs);
+   }
 
    exit(EXIT_SUCCESS);
 }
@@ -297,24 +339,21 @@ int main(int argc, char *argv[])
 @NAME       : get_arginfo
 @INPUT      : argc - number of command-line arguments
               argv - command-line arguments
-@OUTPUT     : program_flags - data for program execution
-              in_vol - description of input volume.
-              out_vol - description of output volume.
-              transformation - description of world transformation
-@RETURNS    : (nothing)
+@OUTPUT     : parsed_args - options from the command line
+              job_list - list of input and output files and 
+                 transformations to process (allocated here)
+@RETURNS    : Number of jobs
 @DESCRIPTION: Routine to get information from arguments about input and 
-              output files and transfomation. Sets up all structures
-              completely (including allocating space for data).
+              output files and transfomation. The volumes for each job
+              are set up by setup_job.
 @METHOD     : 
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 8, 1993 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - split out setup_job for -batch
 ---------------------------------------------------------------------------- */
-static void get_arginfo(int argc, char *argv[],
-                        Program_Flags *program_flags,
-                        VVolume *in_vol, VVolume *out_vol, 
-                        VIO_General_transform *transformation)
+static int get_arginfo(int argc, char *argv[], Arg_Data *parsed_args,
+                       Resample_Job **job_list)
 {
    /* Argument parsing information */
 #ifdef TRANSFORM_CHANGE_KLUDGE
@@ -330,7 +369,7 @@ static void get_arginfo(int argc, char *argv[],
       {-DBL_MAX, -DBL_MAX},   /* Flag that range not set */
       FILL_DEFAULT,           /* Flag indicating that fillvalue not set */
       {NO_VALUE, NO_VALUE, NO_VALUE}, /* Flag indicating that origin not set */
-      {TRUE},                 /* Verbose */
+      {TRUE},                 /* Verbose (other flags are set below) */
       TRILINEAR,              /* use trilinear interpolation by default */
       {FALSE, NULL, NULL, 0, NULL}, /* Transformation info is empty at start.
                                  Transformation must be set before invoking
@@ -368,6 +407,16 @@ static void get_arginfo(int argc, char *argv[],
       {"-quiet", ARGV_CONSTANT, (char *) FALSE,
           (char *) &args.flags.verbose,
           "Do not print out any log messages.\n"},
+      {"-profile", ARGV_CONSTANT, (char *) TRUE,
+          (char *) &args.flags.profile,
+          "Print the time spent in each stage as JSON on stdout at exit."},
+      {"-batch", ARGV_STRING, (char *) 1, (char *) &args.batch_file,
+          "File of lines <infile> <outfile> [<xfm>] to resample (- for stdin)."},
+#ifdef HAVE_PTHREAD
+      {"-threads", ARGV_INT, (char *) 1,
+          (char *) &args.flags.nthreads,
+          "Number of threads used to compute output slices (default 1).\n"},
+#endif /* HAVE_PTHREAD */
       {"-transformation", ARGV_FUNC, (char *) get_transformation, 
           (char *) &args.transform_info,
           "File giving world transformation. (Default = identity)."},
@@ -377,6 +426,18 @@ static void get_arginfo(int argc, char *argv[],
       {"-noinvert_transformation", ARGV_CONSTANT, (char *) FALSE,
           (char *) &args.transform_info.invert_transform,
           "Do not invert the transformation (default).\n"},
+      {"-transform_lattice", ARGV_INT, (char *) 1,
+          (char *) &args.flags.transform_lattice,
+          "Evaluate non-linear transformations every n voxels (default 1)."},
+      {"-coord_cache", ARGV_CONSTANT, (char *) TRUE,
+          (char *) &args.flags.coord_cache,
+          "Reuse non-linearly transformed coordinates for every volume."},
+      {"-nocoord_cache", ARGV_CONSTANT, (char *) FALSE,
+          (char *) &args.flags.coord_cache,
+          "Transform coordinates again for each volume (default)."},
+      {"-coord_cache_file", ARGV_STRING, (char *) 1,
+          (char *) &args.flags.coord_cache_file,
+          "File for reusing transformed coordinates between runs."},
       {"-tfm_input_sampling", ARGV_CONSTANT, (char *) TRUE,
           (char *) &transform_input_sampling,
           "VIO_Transform the input sampling with the transform (default).\n"},
@@ -493,6 +554,15 @@ static void get_arginfo(int argc, char *argv[],
       {"-nokeep_real_range", ARGV_CONSTANT, (char *) FALSE, 
           (char *) &args.keep_real_range,
           "Do not keep the real scale of the data (default)"},
+      {"-max_buffer_size_in_kb", ARGV_LONG, (char *) 1,
+          (char *) &args.flags.max_buffer_size_in_kb,
+          "Maximum size of input buffer in kb (default 0 = whole volume)."},
+      {"-analytic_range", ARGV_CONSTANT, (char *) TRUE, 
+          (char *) &args.flags.analytic_range,
+          "Derive output range from input range and interpolant (one pass)"},
+      {"-noanalytic_range", ARGV_CONSTANT, (char *) FALSE, 
+          (char *) &args.flags.analytic_range,
+          "Rescale output slices to their actual range (default)"},
       {"-nofill", ARGV_FUNC, (char *) get_fillvalue, 
           (char *) &args.fillvalue,
           "Use value zero for points outside of input volume"},
@@ -512,6 +582,9 @@ static void get_arginfo(int argc, char *argv[],
           (char *) N_NEIGHBOUR, 
           (char *) &args.interpolant_type,
           "Do nearest neighbour interpolation"},
+      {"-labels", ARGV_CONSTANT, (char *) TRUE, 
+          (char *) &args.flags.labels,
+          "Resample a label volume, copying voxel values unchanged"},
       {"-sinc", ARGV_CONSTANT,
        (char *) WINDOWED_SINC,
        (char *) &args.interpolant_type,
@@ -528,41 +601,68 @@ static void get_arginfo(int argc, char *argv[],
        (char *) SINC_WINDOW_HAMMING,
        (char *) &sinc_window_type,
        "Set sinc window type to Hamming"},
+      {"-sinc_table", ARGV_CONSTANT, (char *) TRUE,
+       (char *) &sinc_use_table,
+       "Use a precomputed table of sinc weights"},
+      {"-nosinc_table", ARGV_CONSTANT, (char *) FALSE,
+       (char *) &sinc_use_table,
+       "Compute sinc weights exactly for every point (default)"},
       {NULL, ARGV_END, NULL, NULL, NULL}
    };
 
    /* Other variables */
-   int idim, index;
-   int out_vindex;              /* Volume indices (0, 1 or 2) */
-   int out_findex;              /* File indices (0 to ndims-1) */
-   long size, total_size;
-   char *infile, *outfile;
-   File_Info *fp;
-   char *tm_stamp, *pname;
-   Volume_Definition input_volume_def, transformed_volume_def;
-   VIO_General_transform input_transformation;
-   int cflags;
+   static VIO_General_transform input_transformation;
+   int idim, njobs;
+   char *pname;
 
    /* Initialize the transformation to identity */
    create_linear_transform(&input_transformation, NULL);
    args.transform_info.transformation = &input_transformation;
 
+   /* Set the default program flags: a single thread, an exact
+      transformation, the whole input volume in memory, renormalized
+      slices, no coordinate cache, no labels and no profile */
+   args.flags.nthreads = 1;
+   args.flags.transform_lattice = 1;
+   args.flags.max_buffer_size_in_kb = 0;
+   args.flags.analytic_range = FALSE;
+   args.flags.coord_cache = FALSE;
+   args.flags.coord_cache_file = NULL;
+   args.flags.transform_checksum = 0;
+   args.flags.labels = FALSE;
+   args.flags.profile = FALSE;
+
    /* Get the time stamp */
-   tm_stamp = time_stamp(argc, argv);
+   args.tm_stamp = time_stamp(argc, argv);
 
    /* Save the program name */
    pname=argv[0];
 
    /* Call ParseArgv */
-   if (ParseArgv(&argc, argv, argTable, 0) || (argc!=3)) {
+   if (ParseArgv(&argc, argv, argTable, 0) || 
+       (argc != ((args.batch_file == NULL) ? 3 : 1))) {
       (void) fprintf(stderr, 
                      "\nUsage: %s [<options>] <infile> <outfile>\n", pname);
+      (void) fprintf(stderr, 
+                     "       %s [<options>] -batch <jobfile>\n", pname);
       (void) fprintf(stderr,   
                      "       %s [-help]\n\n", pname);
       exit(EXIT_FAILURE);
    }
-   infile = argv[1];
-   outfile = argv[2];
+
+   /* Get the list of jobs. Jobs without their own transformation use
+      the one from the command line. */
+   if (args.batch_file == NULL) {
+      njobs = 1;
+      *job_list = malloc(sizeof(Resample_Job));
+      (*job_list)[0].infile = argv[1];
+      (*job_list)[0].outfile = argv[2];
+      (*job_list)[0].transform_info = &args.transform_info;
+   }
+   else {
+      njobs = read_batch_file(args.batch_file, &args.transform_info, 
+                              job_list);
+   }
 
 #ifdef TRANSFORM_CHANGE_KLUDGE
    if (Specified_transform && 
@@ -577,6 +677,197 @@ static void get_arginfo(int argc, char *argv[],
       transform_input_sampling = TRUE;
    }
 #endif
+   args.transform_input_sampling = transform_input_sampling;
+
+   /* Explicitly force output files to have regular spacing */
+   for (idim=0; idim < WORLD_NDIMS; idim++) {
+      if (args.volume_def.coords[idim] != NULL) {
+         free(args.volume_def.coords[idim]);
+         args.volume_def.coords[idim] = NULL;
+      }
+   }
+
+   /* Label volumes are resampled by nearest neighbour, keeping the 
+      input scale */
+   if (args.flags.labels) {
+      args.interpolant_type = N_NEIGHBOUR;
+      args.keep_real_range = TRUE;
+   }
+
+   /* Check the program flags */
+   if (args.flags.coord_cache_file != NULL) {
+      args.flags.coord_cache = TRUE;
+   }
+   if (args.flags.nthreads < 1) {
+      (void) fprintf(stderr, "Invalid number of threads %d\n", 
+                     args.flags.nthreads);
+      exit(EXIT_FAILURE);
+   }
+   if (args.flags.transform_lattice < 1) {
+      (void) fprintf(stderr, "Invalid transformation lattice spacing %d\n", 
+                     args.flags.transform_lattice);
+      exit(EXIT_FAILURE);
+   }
+
+   *parsed_args = args;
+
+   return njobs;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : read_batch_file
+@INPUT      : filename - name of file listing the jobs (- for stdin)
+              default_transform - transformation for jobs that do not
+                 give one
+@OUTPUT     : job_list - list of jobs (allocated here)
+@RETURNS    : Number of jobs
+@DESCRIPTION: Routine to read the job list for -batch. Each line gives an
+              input file, an output file and optionally a transformation
+              file. Blank lines and lines starting with # are ignored.
+              Each transformation file is read only once, however many 
+              jobs use it.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int read_batch_file(char *filename, Transform_Info *default_transform,
+                           Resample_Job **job_list)
+{
+   FILE *fp;
+   char line[BATCH_LINE_LENGTH];
+   char *field[3], *token;
+   int nfields, njobs, nalloc, ijob, lineno;
+   Resample_Job *jobs;
+   Transform_Info *transform_info;
+
+   /* Open the file */
+   if (strcmp(filename, "-") == 0) {
+      fp = stdin;
+   }
+   else if ((fp = fopen(filename, "r")) == NULL) {
+      (void) fprintf(stderr, "Error opening batch file %s.\n", filename);
+      exit(EXIT_FAILURE);
+   }
+
+   /* Loop over lines */
+   njobs = 0;
+   nalloc = 0;
+   jobs = NULL;
+   for (lineno=1; fgets(line, sizeof(line), fp) != NULL; lineno++) {
+
+      /* Split the line into fields, up to any comment */
+      nfields = 0;
+      for (token = strtok(line, BATCH_SEPARATORS);
+           (token != NULL) && (token[0] != '#');
+           token = strtok(NULL, BATCH_SEPARATORS)) {
+         if (nfields < 3) field[nfields] = token;
+         nfields++;
+      }
+      if (nfields == 0) continue;
+      if ((nfields < 2) || (nfields > 3)) {
+         (void) fprintf(stderr, "Error on line %d of batch file %s.\n",
+                        lineno, filename);
+         exit(EXIT_FAILURE);
+      }
+
+      /* Get space for the job */
+      if (njobs >= nalloc) {
+         nalloc += BATCH_JOB_INCREMENT;
+         jobs = realloc(jobs, sizeof(Resample_Job) * nalloc);
+      }
+      jobs[njobs].infile = strdup(field[0]);
+      jobs[njobs].outfile = strdup(field[1]);
+
+      /* Look for the transformation among those already read */
+      transform_info = default_transform;
+      if (nfields > 2) {
+         transform_info = NULL;
+         for (ijob=0; ijob < njobs; ijob++) {
+            if ((jobs[ijob].transform_info != default_transform) &&
+                (strcmp(jobs[ijob].transform_info->file_name, 
+                        field[2]) == 0)) {
+               transform_info = jobs[ijob].transform_info;
+               break;
+            }
+         }
+      }
+
+      /* Otherwise read it in */
+      if (transform_info == NULL) {
+         transform_info = malloc(sizeof(Transform_Info));
+         transform_info->invert_transform = 
+            default_transform->invert_transform;
+         transform_info->file_contents = NULL;
+         transform_info->transformation = 
+            malloc(sizeof(VIO_General_transform));
+         create_linear_transform(transform_info->transformation, NULL);
+         (void) get_transformation((char *) transform_info, "-batch",
+                                   strdup(field[2]));
+      }
+      jobs[njobs].transform_info = transform_info;
+
+      njobs++;
+   }
+
+   if (fp != stdin) {
+      (void) fclose(fp);
+   }
+
+   if (njobs == 0) {
+      (void) fprintf(stderr, "No jobs in batch file %s.\n", filename);
+      exit(EXIT_FAILURE);
+   }
+
+   *job_list = jobs;
+   return njobs;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : setup_job
+@INPUT      : parsed_args - options from the command line
+              job - input and output files and transformation
+              in_vol - volume buffers from the previous job (zeroed for
+                 the first job)
+              out_vol - slice buffers from the previous job (zeroed for
+                 the first job)
+@OUTPUT     : program_flags - data for program execution
+              in_vol - description of input volume.
+              out_vol - description of output volume.
+              transformation - description of world transformation
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to open the input file and create the output file
+              of a job. Sets up all structures completely (including 
+              allocating space for data). Buffers left from a previous
+              job are reused.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : February 8, 1993 (Peter Neelin)
+@MODIFIED   : October 16, 2026 - split out of get_arginfo
+---------------------------------------------------------------------------- */
+static void setup_job(Arg_Data *parsed_args, Resample_Job *job,
+                      Program_Flags *program_flags,
+                      VVolume *in_vol, VVolume *out_vol,
+                      VIO_General_transform *transformation)
+{
+   Arg_Data args;
+   int idim, index;
+   int out_vindex;              /* Volume indices (0, 1 or 2) */
+   int out_findex;              /* File indices (0 to ndims-1) */
+   int nthreads, ithread;
+   long size, total_size;
+   File_Info *fp;
+   Volume_Definition input_volume_def, transformed_volume_def;
+   int cflags;
+
+   /* Work on a copy of the arguments, since the unset values are filled
+      in from the input file */
+   args = *parsed_args;
+   args.transform_info.file_name = job->transform_info->file_name;
+   args.transform_info.file_contents = job->transform_info->file_contents;
+   args.transform_info.transformation = job->transform_info->transformation;
 
    /* Check for an inverted transform. This looks backwards because we 
       normally invert the transform. */
@@ -590,13 +881,12 @@ static void get_arginfo(int argc, char *argv[],
    }
    args.transform_info.transformation = transformation;
 
-   /* Get rid of the input transformation */
-   delete_general_transform(&input_transformation);
-
    /* Check input file for default argument information */
-   in_vol->file = malloc(sizeof(File_Info));
-   get_file_info(infile, FALSE, &input_volume_def, in_vol->file);
-   transform_volume_def((transform_input_sampling ? 
+   if (in_vol->file == NULL) {
+      in_vol->file = malloc(sizeof(File_Info));
+   }
+   get_file_info(job->infile, FALSE, &input_volume_def, in_vol->file);
+   transform_volume_def((args.transform_input_sampling ? 
                          &args.transform_info : NULL), 
                         &input_volume_def, 
                         &transformed_volume_def);
@@ -624,15 +914,22 @@ static void get_arginfo(int argc, char *argv[],
    }
 
    /* Save the voxel_to_world transformation information */
-   in_vol->voxel_to_world = malloc(sizeof(VIO_General_transform));
-   in_vol->world_to_voxel = malloc(sizeof(VIO_General_transform));
+   if (in_vol->voxel_to_world == NULL) {
+      in_vol->voxel_to_world = malloc(sizeof(VIO_General_transform));
+      in_vol->world_to_voxel = malloc(sizeof(VIO_General_transform));
+   }
    get_voxel_to_world_transf(&input_volume_def, in_vol->voxel_to_world);
    create_inverse_general_transform(in_vol->voxel_to_world,
                                     in_vol->world_to_voxel);
 
    /* Get input volume data information */
    in_vol->slice = NULL;
-   in_vol->volume = malloc(sizeof(Volume_Data));
+   if (in_vol->volume == NULL) {
+      in_vol->volume = malloc(sizeof(Volume_Data));
+      in_vol->volume->data = NULL;
+      in_vol->volume->scale = NULL;
+      in_vol->volume->offset = NULL;
+   }
    in_vol->volume->datatype = in_vol->file->datatype;
    in_vol->volume->is_signed = in_vol->file->is_signed;
    in_vol->volume->vrange[0] = in_vol->file->vrange[0];
@@ -647,29 +944,41 @@ static void get_arginfo(int argc, char *argv[],
    }
 
    /* set the function pointer defining the type of interpolation */
+   in_vol->volume->row_interpolant = NULL;
    switch (args.interpolant_type ) {
    case TRICUBIC:
      in_vol->volume->interpolant = tricubic_interpolant;
+     in_vol->volume->row_interpolant = tricubic_interpolant_row;
+     in_vol->volume->support = 2;
      break;
    case TRILINEAR:
      in_vol->volume->interpolant = trilinear_interpolant;
+     in_vol->volume->row_interpolant = trilinear_interpolant_row;
+     in_vol->volume->support = 1;
      break;
    case N_NEIGHBOUR:
      in_vol->volume->interpolant = nearest_neighbour_interpolant;
+     in_vol->volume->support = 1;
      break;
    case WINDOWED_SINC:
      in_vol->volume->interpolant = windowed_sinc_interpolant;
+     in_vol->volume->row_interpolant = windowed_sinc_interpolant_row;
+     in_vol->volume->support = sinc_half_width;
      if (sinc_half_width < SINC_HALF_WIDTH_MIN ||
          sinc_half_width > SINC_HALF_WIDTH_MAX) {
          fprintf(stderr, "Invalid sinc half-window size %d\n", 
                  sinc_half_width);
          exit(EXIT_FAILURE);
      }
+     if (sinc_use_table) {
+         init_sinc_table();
+     }
      break;
    default:
      (void) fprintf(stderr, "Error determining interpolation type\n");
      exit(EXIT_FAILURE);
    }
+   in_vol->volume->gain = get_interpolant_gain(args.interpolant_type);
 
    /* Check min/max variables */
    fp = in_vol->file;
@@ -679,38 +988,53 @@ static void get_arginfo(int argc, char *argv[],
       check_imageminmax(fp, in_vol->volume);
    }
 
-   /* Get space for volume data */
+   /* Get space for volume data (if the input is read in parts, space
+      is allocated as it is read) */
    total_size = 1;
    for (idim=0; idim < WORLD_NDIMS; idim++) {
       index = input_volume_def.axes[idim];
       size = input_volume_def.nelements[idim];
       total_size *= size;
       in_vol->volume->size[index] = size;
+      in_vol->volume->origin[index] = 0;
+   }
+   if (args.flags.max_buffer_size_in_kb <= 0) {
+      in_vol->volume->data = realloc(in_vol->volume->data, (size_t) total_size
+                                     * nctypelen(in_vol->volume->datatype));
    }
-   in_vol->volume->data = malloc((size_t) total_size * 
-                                 nctypelen(in_vol->volume->datatype));
 
    /* Get space for slice scale and offset */
-   in_vol->volume->scale = 
-      malloc(sizeof(double) * in_vol->volume->size[SLC_AXIS]);
-   in_vol->volume->offset = 
-      malloc(sizeof(double) * in_vol->volume->size[SLC_AXIS]);
+   in_vol->volume->scale = realloc(in_vol->volume->scale,
+                     sizeof(double) * in_vol->volume->size[SLC_AXIS]);
+   in_vol->volume->offset = realloc(in_vol->volume->offset,
+                     sizeof(double) * in_vol->volume->size[SLC_AXIS]);
 
    /* Save the program flags */
    *program_flags = args.flags;
+   program_flags->transform_checksum = 0;
+   if (args.flags.coord_cache_file != NULL) {
+      program_flags->transform_checksum = 
+         get_transform_checksum(job->transform_info);
+   }
+
+   /* Labels are written with the type and range of the input */
+   if (args.flags.labels &&
+       (((args.datatype != MI_ORIGINAL_TYPE) && 
+         (args.datatype != in_vol->file->datatype)) ||
+        ((args.is_signed != INT_MIN) && 
+         (args.is_signed != in_vol->file->is_signed)) ||
+        ((args.vrange[0] != -DBL_MAX) &&
+         ((args.vrange[0] != in_vol->file->vrange[0]) ||
+          (args.vrange[1] != in_vol->file->vrange[1]))))) {
+      (void) fprintf(stderr, 
+                     "-labels keeps the input type, sign and range.\n");
+      exit(EXIT_FAILURE);
+   }
 
    /* Set the default output file datatype */
    if (args.datatype == MI_ORIGINAL_TYPE)
       args.datatype = in_vol->file->datatype;
 
-   /* Explicitly force output files to have regular spacing */
-   for (idim=0; idim < WORLD_NDIMS; idim++) {
-      if (args.volume_def.coords[idim] != NULL) {
-         free(args.volume_def.coords[idim]);
-         args.volume_def.coords[idim] = NULL;
-      }
-   }
-
    /* Check to see if sign and range have been explicitly set. If not set
       them now */
    if (args.is_signed == INT_MIN) {
@@ -734,7 +1058,9 @@ static void get_arginfo(int argc, char *argv[],
    }
 
    /* Set up the file description for the output file */
-   out_vol->file = malloc(sizeof(File_Info));
+   if (out_vol->file == NULL) {
+      out_vol->file = malloc(sizeof(File_Info));
+   }
    out_vol->file->ndims = in_vol->file->ndims;
    out_vol->file->datatype = args.datatype;
    out_vol->file->is_signed = args.is_signed;
@@ -746,9 +1072,16 @@ static void get_arginfo(int argc, char *argv[],
    }
    out_vol->file->keep_real_range = args.keep_real_range;
 
-   /* Get space for output slice */
+   /* Get space for output slices, one per thread */
    out_vol->volume = NULL;
-   out_vol->slice = malloc(sizeof(Slice_Data));
+   nthreads = args.flags.nthreads;
+   if (out_vol->slice == NULL) {
+      out_vol->slice = malloc(sizeof(Slice_Data) * nthreads);
+      for (ithread=0; ithread < nthreads; ithread++) {
+         out_vol->slice[ithread].data = NULL;
+         out_vol->slice[ithread].raw_data = NULL;
+      }
+   }
 
    /* Loop through list of axes, getting size of volume and slice */
    total_size = 1;
@@ -771,7 +1104,20 @@ static void get_arginfo(int argc, char *argv[],
          total_size *= size;
       }
    }
-   out_vol->slice->data = malloc((size_t) total_size * sizeof(double));
+   for (ithread=0; ithread < nthreads; ithread++) {
+      out_vol->slice[ithread].size[SLICE_ROW] = 
+         out_vol->slice[0].size[SLICE_ROW];
+      out_vol->slice[ithread].size[SLICE_COL] = 
+         out_vol->slice[0].size[SLICE_COL];
+      out_vol->slice[ithread].data = 
+         realloc(out_vol->slice[ithread].data,
+                 (size_t) total_size * sizeof(double));
+      if (args.flags.labels) {
+         out_vol->slice[ithread].raw_data = 
+            realloc(out_vol->slice[ithread].raw_data,
+                    (size_t) total_size * nctypelen(args.datatype));
+      }
+   }
 
    /* Create the output file */
    if (args.clobber) {
@@ -785,20 +1131,32 @@ static void get_arginfo(int argc, char *argv[],
        cflags |= MI2_CREATE_V2;
    }
 #endif /* MINC2 */
-   create_output_file(outfile, cflags, &args.volume_def, 
+   create_output_file(job->outfile, cflags, &args.volume_def, 
                       in_vol->file, out_vol->file,
-                      tm_stamp, &args.transform_info);
+                      args.tm_stamp, &args.transform_info);
+
+   /* For labels, get an icv that writes voxel values unchanged */
+   out_vol->file->raw_icvid = MI_ERROR;
+   if (args.flags.labels) {
+      fp = out_vol->file;
+      fp->raw_icvid = miicv_create();
+      (void) miicv_setint(fp->raw_icvid, MI_ICV_TYPE, fp->datatype);
+      (void) miicv_setstr(fp->raw_icvid, MI_ICV_SIGN, 
+                          (fp->is_signed ? MI_SIGNED : MI_UNSIGNED));
+      (void) miicv_setint(fp->raw_icvid, MI_ICV_DO_NORM, FALSE);
+      (void) miicv_setint(fp->raw_icvid, MI_ICV_DO_RANGE, FALSE);
+      (void) miicv_attach(fp->raw_icvid, fp->mincid, fp->imgid);
+   }
    
    /* Save the voxel_to_world transformation information */
-   out_vol->voxel_to_world = malloc(sizeof(VIO_General_transform));
-   out_vol->world_to_voxel = malloc(sizeof(VIO_General_transform));
+   if (out_vol->voxel_to_world == NULL) {
+      out_vol->voxel_to_world = malloc(sizeof(VIO_General_transform));
+      out_vol->world_to_voxel = malloc(sizeof(VIO_General_transform));
+   }
    get_voxel_to_world_transf(&args.volume_def, out_vol->voxel_to_world);
    create_inverse_general_transform(out_vol->voxel_to_world,
                                     out_vol->world_to_voxel);
 
-   /* Free the time stamp */
-   free(tm_stamp);
-
 }
 
 /* ----------------------------- MNI Header -----------------------------------
@@ -1882,6 +2240,9 @@ static void finish_up(VVolume *in_vol, VVolume *out_vol)
    if (out_file->using_icv) {
       (void) miicv_free(out_file->icvid);
    }
+   if (out_file->raw_icvid != MI_ERROR) {
+      (void) miicv_free(out_file->raw_icvid);
+   }
    (void) miclose(out_file->mincid);
 
    /* Close the input file */
@@ -1890,9 +2251,123 @@ static void finish_up(VVolume *in_vol, VVolume *out_vol)
    }
    (void) miclose(in_file->mincid);
 
+   /* Free the voxel to world transformations so that the structures
+      can be used for another job */
+   delete_general_transform(in_vol->voxel_to_world);
+   delete_general_transform(in_vol->world_to_voxel);
+   delete_general_transform(out_vol->voxel_to_world);
+   delete_general_transform(out_vol->world_to_voxel);
+
    return;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_transform_checksum
+@INPUT      : transform_info - world transformation of a job
+@OUTPUT     : (nothing) 
+@RETURNS    : Checksum of the transformation
+@DESCRIPTION: Routine to identify a transformation in a coordinate cache
+              file, from the contents of its file (empty for the identity),
+              the contents of the grid files that it refers to and whether
+              it is inverted.
+@METHOD     : 32-bit FNV-1a hash.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static unsigned long get_transform_checksum(Transform_Info *transform_info)
+{
+   unsigned long checksum;
+   char *ptr;
+
+   checksum = 2166136261UL;
+   if (transform_info->file_contents != NULL) {
+      for (ptr = transform_info->file_contents; *ptr != '\0'; ptr++) {
+         checksum = ((checksum ^ (unsigned char) *ptr) * 16777619UL) &
+            0xffffffffUL;
+      }
+      checksum = add_grid_files_to_checksum(transform_info, checksum);
+   }
+   checksum = ((checksum ^ (transform_info->invert_transform ? 1UL : 0UL))
+               * 16777619UL) & 0xffffffffUL;
+
+   return checksum;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : add_grid_files_to_checksum
+@INPUT      : transform_info - world transformation of a job
+              checksum - checksum so far
+@OUTPUT     : (nothing) 
+@RETURNS    : Checksum including the grid files
+@DESCRIPTION: Routine to add the contents of each displacement volume 
+              named in a transformation file to its checksum, so that a
+              coordinate cache file is not reused after a grid file has
+              changed. A grid file that cannot be read adds nothing, 
+              leaving only its name in the checksum.
+@METHOD     : Relative names are taken from the directory of the
+              transformation file, as volume_io does.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static unsigned long add_grid_files_to_checksum(Transform_Info *transform_info,
+                                                unsigned long checksum)
+{
+   static char key[] = "Displacement_Volume";
+   char *ptr, *end, *slash, *grid_file;
+   long dir_length, name_length;
+   FILE *fp;
+   int ch;
+
+   ptr = transform_info->file_contents;
+   while ((ptr = strstr(ptr, key)) != NULL) {
+
+      /* Get the name after "=" */
+      ptr += strlen(key);
+      while (isspace((unsigned char) *ptr)) ptr++;
+      if (*ptr != '=') continue;
+      ptr++;
+      while (isspace((unsigned char) *ptr)) ptr++;
+      for (end = ptr; (*end != '\0') && (*end != ';') && 
+              !isspace((unsigned char) *end); end++) {}
+      name_length = end - ptr;
+      if (name_length <= 0) continue;
+
+      /* Put the directory of the transformation file in front of it */
+      dir_length = 0;
+      slash = NULL;
+      if ((*ptr != '/') && (transform_info->file_name != NULL)) {
+         slash = strrchr(transform_info->file_name, '/');
+      }
+      if (slash != NULL) {
+         dir_length = slash - transform_info->file_name + 1;
+      }
+      grid_file = malloc(dir_length + name_length + 1);
+      if (dir_length > 0) {
+         (void) strncpy(grid_file, transform_info->file_name, dir_length);
+      }
+      (void) strncpy(&grid_file[dir_length], ptr, name_length);
+      grid_file[dir_length + name_length] = '\0';
+
+      /* Add its contents */
+      fp = fopen(grid_file, "rb");
+      if (fp != NULL) {
+         while ((ch = getc(fp)) != EOF) {
+            checksum = ((checksum ^ (unsigned char) ch) * 16777619UL) &
+               0xffffffffUL;
+         }
+         (void) fclose(fp);
+      }
+      free(grid_file);
+      ptr = end;
+   }
+
+   return checksum;
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : get_transformation
 @INPUT      : dst - Pointer to client data from argument table
@@ -1915,6 +2390,7 @@ static int get_transformation(char *dst, char *key, char *nextArg)
    VIO_General_transform *transformation;
    FILE *fp;
    int ch, index;
+   Profile_Timer timer;
 
    /* Check for following argument */
    if (nextArg == NULL) {
@@ -1930,6 +2406,7 @@ static int get_transformation(char *dst, char *key, char *nextArg)
    /* Save file name */
    transform_info->file_name = nextArg;
    transformation = transform_info->transformation;
+   profile_start(&timer);
 
    /* Open the file */
    if (strcmp(nextArg, "-") == 0) {
@@ -1979,6 +2456,7 @@ static int get_transformation(char *dst, char *key, char *nextArg)
       exit(EXIT_FAILURE);
    }
    (void) close_file(fp);
+   profile_stop(&timer, PROFILE_TRANSFORM_LOAD, (double) index);
 
 #ifdef TRANSFORM_CHANGE_KLUDGE
    Specified_transform = TRUE;
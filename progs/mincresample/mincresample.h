@@ -147,6 +147,13 @@
 #define SMALL_VALUE (100.0*FLT_MIN)   /* A small floating-point value */
 #define VOXEL_COORD_EPS (100.0*FLT_EPSILON)  /* Epsilon for voxel coords */
 #define TRANSFORM_BUFFER_INCREMENT 256
+#define BATCH_LINE_LENGTH 4096
+#define BATCH_JOB_INCREMENT 64
+#define BATCH_SEPARATORS " \t\r\n"
+#define COORD_MAP_NPROBES 27      /* 3 x 3 x 3 points checked when
+                                     reading a coordinate cache file */
+#define COORD_MAP_TOLERANCE 1.0e-6
+#define COORD_MAP_MAGIC "MNCCOOR2"
 #define PROCESSING_VAR "processing"
 #define TEMP_IMAGE_VAR "mincresample-temporary-image"
 #ifndef TRUE
@@ -178,6 +185,8 @@ typedef struct {
                                 order (value=0,1,2; 0=slowest varying) */
    int using_icv;            /* True if we are using an icv to read data */
    int icvid;                /* Id of icv (if used) */
+   int raw_icvid;            /* Id of icv writing voxel values unchanged,
+                                for label resampling (MI_ERROR if none) */
    long slices_per_image;    /* Number of volume slices (row, column) per
                                 minc file image */
    long images_per_file;     /* Number of minc file images in the file */
@@ -192,30 +201,48 @@ typedef struct {
 typedef struct {
    long size[SLICE_NDIMS];   /* Size of each dimension */
    double *data;             /* Pointer to slice data */
+   void *raw_data;           /* Slice in the input voxel type, for label
+                                resampling (NULL if not used) */
 } Slice_Data;
 
 typedef struct Volume_Data_Struct Volume_Data;
 typedef int (*Interpolating_Function) 
      (Volume_Data *volume, Coord_Vector coord, double *result);
+typedef void (*Row_Interpolating_Function) 
+     (Volume_Data *volume, long npoints, Coord_Vector coords[], 
+      double result[], int inside[]);
 struct Volume_Data_Struct {
    nc_type datatype;         /* Type of data in volume */
    int is_signed;            /* Sign of data (TRUE if signed) */
    int use_fill;             /* TRUE if fill values should be used in
                                 calculation of output image max/min */
    double fillvalue;         /* Value to return when out of bounds */
+   double voxel_fillvalue;   /* Fill value as a voxel value, for label 
+                                resampling */
    double vrange[2];         /* [0]=min, [1]=max */
    double real_range[2];     /* Real min and max for current volume */
    int size[VOL_NDIMS];      /* Size of each dimension */
+   long origin[VOL_NDIMS];   /* Index in the file volume of the first
+                                voxel in data (non-zero when only part
+                                of the volume is loaded) */
+   int support;              /* Number of voxels on either side of a 
+                                point used by the interpolant */
+   double gain;              /* Largest sum of absolute interpolation 
+                                weights along one axis (1 if the 
+                                interpolant never overshoots) */
    void *data;               /* Pointer to volume data */
    double *scale;            /* Pointer to array of scales for slices */
    double *offset;           /* Pointer to array of offsets for slices */
    Interpolating_Function interpolant; /* Function Pointer */
+   Row_Interpolating_Function row_interpolant; /* Function for a whole row
+                                                  of points (NULL if none) */
 };
 
 typedef struct {
    File_Info *file;           /* Information about associated file */
    Volume_Data *volume;      /* Volume data for (input volume) */
-   Slice_Data *slice;        /* Slice data for (output volume) */
+   Slice_Data *slice;        /* Slice data for (output volume), one
+                                per thread */
    VIO_General_transform *voxel_to_world;
    VIO_General_transform *world_to_voxel;
 } VVolume;
@@ -234,8 +261,42 @@ typedef struct {
 
 typedef struct {
    int verbose;
+   int nthreads;             /* Number of threads used to compute slices */
+   int transform_lattice;    /* Spacing (in output voxels) of the points 
+                                at which non-linear transformations are
+                                evaluated exactly (1 = every voxel) */
+   long max_buffer_size_in_kb; /* Largest part of the input volume to 
+                                  hold in memory (0 = whole volume) */
+   int analytic_range;       /* Take the output range from the input range
+                                and the interpolant, so that slices are 
+                                only written once */
+   int coord_cache;          /* Keep the input coordinates of every output
+                                voxel for non-linear transformations */
+   char *coord_cache_file;   /* File in which to save them (or NULL) */
+   unsigned long transform_checksum; /* Checksum of the transformation
+                                        file and direction, identifying
+                                        it in a coordinate cache file */
+   int labels;               /* Copy voxel values of a label volume 
+                                without conversion to real values */
+   int profile;              /* Print stage timings as JSON at exit */
 } Program_Flags;
 
+/* Stages of a run that are timed for -profile */
+typedef enum {
+   PROFILE_TRANSFORM_LOAD,   /* Reading transformation files */
+   PROFILE_LOAD_VOLUME,      /* Reading input voxels */
+   PROFILE_TRANSFORM_SLICE,  /* Getting input coordinates of output voxels */
+   PROFILE_INTERPOLATE,      /* Interpolating input values */
+   PROFILE_WRITE,            /* Writing output slices */
+   PROFILE_RENORMALIZE,      /* Rescaling output slices */
+   PROFILE_NSTAGES
+} Profile_Stage;
+
+typedef struct {
+   double wall;              /* Wall clock time at start (seconds) */
+   double cpu;               /* Process cpu time at start (seconds) */
+} Profile_Timer;
+
 typedef struct {
    int invert_transform;
    char *file_name;
@@ -257,8 +318,18 @@ typedef struct {
    Transform_Info transform_info;
    Volume_Definition volume_def;
    int v2format;                /* If non-zero, create a MINC 2.0 output */
+   char *batch_file;            /* File listing jobs (NULL if none) */
+   int transform_input_sampling; /* Transform input sampling for output */
+   char *tm_stamp;              /* Time stamp for history */
 } Arg_Data;
 
+typedef struct {
+   char *infile;
+   char *outfile;
+   Transform_Info *transform_info; /* World transformation, shared by all
+                                      jobs that use the same file */
+} Resample_Job;
+
 typedef struct {
    long last_index[VOL_NDIMS];
    long nelements[VOL_NDIMS];
@@ -321,6 +392,20 @@ typedef struct {
 #define INTERPOLATE(volume, coord, result) \
    (*volume->interpolant) (volume, coord, result)
 
+#define INTERPOLATE_ROW(volume, npoints, coords, result, inside) \
+   (*volume->row_interpolant) (volume, npoints, coords, result, inside)
+
+/* Cubic interpolation (code from Dave MacDonald). Gives v1 and v2 at 
+   u = 0 and 1 and gives continuity of intensity and first derivative. */
+#define CUBIC_INTERPOLATE(v0, v1, v2, v3, u) \
+     ( (v1) + (u) * ( \
+       0.5 * ((v2)-(v0)) + (u) * ( \
+       (v0) - 2.5 * (v1) + 2.0 * (v2) - 0.5 * (v3) + (u) * ( \
+       -0.5 * (v0) + 1.5 * (v1) - 1.5 * (v2) + 0.5 * (v3)  ) \
+                                 ) \
+                    ) \
+     )
+
 #define VOLUME_VALUE(volume, slcind, rowind, colind, value) \
 { \
    long offset; \
@@ -368,9 +453,36 @@ extern int nearest_neighbour_interpolant(Volume_Data *volume,
                                          Coord_Vector coord, double *result);
 extern int windowed_sinc_interpolant(Volume_Data *volume,
                                      Coord_Vector coord, double *result);
+extern void trilinear_interpolant_row(Volume_Data *volume, long npoints,
+                                      Coord_Vector coords[], 
+                                      double result[], int inside[]);
+extern void tricubic_interpolant_row(Volume_Data *volume, long npoints,
+                                     Coord_Vector coords[], 
+                                     double result[], int inside[]);
+extern void windowed_sinc_interpolant_row(Volume_Data *volume, long npoints,
+                                          Coord_Vector coords[], 
+                                          double result[], int inside[]);
+extern void nearest_neighbour_label_row(Volume_Data *volume, long npoints,
+                                        Coord_Vector coords[], 
+                                        void *result, int inside[]);
+extern void init_sinc_table(void);
+extern double get_interpolant_gain(enum Interpolant_type type);
+extern void profile_enable(void);
+extern void profile_disable(void);
+extern double profile_wall_time(void);
+extern double profile_cpu_time(void);
+extern void profile_start(Profile_Timer *timer);
+extern void profile_stop(Profile_Timer *timer, Profile_Stage stage,
+                         double nbytes);
+extern void profile_add(Profile_Stage stage, long calls, double wall,
+                        double cpu, double thread_time, double nbytes);
+extern void profile_write(FILE *fp, Profile_Timer *run_timer,
+                          int nthreads, int njobs);
 
 #define SINC_HALF_WIDTH_MAX 10
 #define SINC_HALF_WIDTH_MIN 1
+#define SINC_TABLE_BINS 1024     /* Fractional offsets per voxel in the 
+                                    sinc weight table */
 
 enum sinc_interpolant_window_t {
     SINC_WINDOW_NONE,
@@ -380,3 +492,4 @@ enum sinc_interpolant_window_t {
 
 extern enum sinc_interpolant_window_t sinc_window_type;
 extern int sinc_half_width;
+extern int sinc_use_table;
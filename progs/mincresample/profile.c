@@ -0,0 +1,277 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile.c
+@DESCRIPTION: Routines to time the stages of a mincresample run and to
+              print the totals as JSON (-profile). Nothing is timed 
+              unless profile_enable has been called, so that runs 
+              without -profile make no clock calls once the arguments 
+              are parsed.
+@METHOD     : Each stage keeps the number of times it was run, the wall
+              clock and process cpu time spent in it, the time summed
+              over the threads that ran it and the number of bytes of
+              voxel data (or transformation file) it handled. Only the
+              main thread updates the totals.
+@GLOBALS    : profile_enabled, profile_stages
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1993 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#include <minc.h>
+#include <volume_io.h>
+#include "mincresample.h"
+
+#ifndef PACKAGE_VERSION
+#define PACKAGE_VERSION "unknown"
+#endif
+
+/* TRUE once timing has been asked for */
+static int profile_enabled = FALSE;
+
+/* Totals for each stage */
+static struct {
+   char *name;
+   long calls;
+   double wall;
+   double cpu;
+   double thread_time;
+   double nbytes;
+} profile_stages[PROFILE_NSTAGES] = {
+   {"transform_load"},
+   {"load_volume"},
+   {"transform_slice"},
+   {"interpolate"},
+   {"write"},
+   {"renormalize"}
+};
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_enable
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Turns on the timing of stages by profile_start, profile_stop
+              and profile_add, which otherwise do nothing.
+@METHOD     :
+@GLOBALS    : profile_enabled
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void profile_enable(void)
+{
+   profile_enabled = TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_disable
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Turns off the timing of stages and clears the totals.
+@METHOD     :
+@GLOBALS    : profile_enabled, profile_stages
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void profile_disable(void)
+{
+   int istage;
+
+   profile_enabled = FALSE;
+   for (istage=0; istage < PROFILE_NSTAGES; istage++) {
+      profile_stages[istage].calls = 0;
+      profile_stages[istage].wall = 0.0;
+      profile_stages[istage].cpu = 0.0;
+      profile_stages[istage].thread_time = 0.0;
+      profile_stages[istage].nbytes = 0.0;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_wall_time
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : Wall clock time in seconds (from an arbitrary origin)
+@DESCRIPTION: Gets the wall clock time, to the microsecond if possible.
+              Safe to call from any thread.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+double profile_wall_time(void)
+{
+#ifdef HAVE_SYS_TIME_H
+   struct timeval tv;
+
+   (void) gettimeofday(&tv, NULL);
+   return (double) tv.tv_sec + 1.0e-6 * (double) tv.tv_usec;
+#else
+   return (double) time(NULL);
+#endif
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_cpu_time
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : Cpu time used by the process (all threads) in seconds
+@DESCRIPTION: Gets the processor time used so far.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+double profile_cpu_time(void)
+{
+   return (double) clock() / (double) CLOCKS_PER_SEC;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_start
+@INPUT      : (none)
+@OUTPUT     : timer - set to the current times
+@RETURNS    : (none)
+@DESCRIPTION: Starts timing a stage (if timing is enabled).
+@METHOD     :
+@GLOBALS    : profile_enabled
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void profile_start(Profile_Timer *timer)
+{
+   if (!profile_enabled) return;
+
+   timer->wall = profile_wall_time();
+   timer->cpu = profile_cpu_time();
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_stop
+@INPUT      : timer - times at start of stage
+              stage - stage being timed
+              nbytes - number of bytes handled by the stage
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Adds the time since profile_start to the totals for a
+              stage run by the main thread (if timing is enabled).
+@METHOD     :
+@GLOBALS    : profile_enabled, profile_stages
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void profile_stop(Profile_Timer *timer, Profile_Stage stage, double nbytes)
+{
+   double wall;
+
+   if (!profile_enabled) return;
+
+   wall = profile_wall_time() - timer->wall;
+   profile_add(stage, 1, wall, profile_cpu_time() - timer->cpu,
+               wall, nbytes);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_add
+@INPUT      : stage - stage that was run
+              calls - number of times it was run
+              wall - wall clock time spent
+              cpu - process cpu time spent
+              thread_time - time summed over the threads that ran it
+              nbytes - number of bytes handled
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Adds to the totals for a stage (if timing is enabled). 
+              Must be called from the main thread only.
+@METHOD     :
+@GLOBALS    : profile_enabled, profile_stages
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void profile_add(Profile_Stage stage, long calls, double wall,
+                 double cpu, double thread_time, double nbytes)
+{
+   if (!profile_enabled) return;
+
+   profile_stages[stage].calls += calls;
+   profile_stages[stage].wall += wall;
+   profile_stages[stage].cpu += cpu;
+   profile_stages[stage].thread_time += thread_time;
+   profile_stages[stage].nbytes += nbytes;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_write
+@INPUT      : fp - file to write to
+              run_timer - times at start of program
+              nthreads - number of threads requested
+              njobs - number of files resampled
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Writes the stage totals as a JSON object.
+@METHOD     :
+@GLOBALS    : profile_stages
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void profile_write(FILE *fp, Profile_Timer *run_timer,
+                   int nthreads, int njobs)
+{
+   int istage;
+   double rate;
+
+   (void) fprintf(fp, "{\n");
+   (void) fprintf(fp, "  \"program\": \"mincresample\",\n");
+   (void) fprintf(fp, "  \"version\": \"%s\",\n", PACKAGE_VERSION);
+   (void) fprintf(fp, "  \"threads\": %d,\n", nthreads);
+   (void) fprintf(fp, "  \"jobs\": %d,\n", njobs);
+   (void) fprintf(fp, "  \"total\": {\"wall_seconds\": %.6f, "
+                  "\"cpu_seconds\": %.6f},\n",
+                  profile_wall_time() - run_timer->wall,
+                  profile_cpu_time() - run_timer->cpu);
+   (void) fprintf(fp, "  \"stages\": [\n");
+   for (istage=0; istage < PROFILE_NSTAGES; istage++) {
+      rate = (profile_stages[istage].wall > 0.0) ?
+         profile_stages[istage].nbytes / profile_stages[istage].wall : 0.0;
+      (void) fprintf(fp, "    {\"name\": \"%s\", \"calls\": %ld, "
+                     "\"wall_seconds\": %.6f, \"cpu_seconds\": %.6f, "
+                     "\"thread_seconds\": %.6f, \"bytes\": %.0f, "
+                     "\"bytes_per_second\": %.0f}%s\n",
+                     profile_stages[istage].name,
+                     profile_stages[istage].calls,
+                     profile_stages[istage].wall,
+                     profile_stages[istage].cpu,
+                     profile_stages[istage].thread_time,
+                     profile_stages[istage].nbytes, rate,
+                     (istage < PROFILE_NSTAGES-1) ? "," : "");
+   }
+   (void) fprintf(fp, "  ]\n");
+   (void) fprintf(fp, "}\n");
+   (void) fflush(fp);
+}
@@ -126,13 +126,128 @@
 #include <math.h>
 #include <minc.h>
 #include <volume_io.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include "mincresample.h"
 
+/* Description of the work needed to compute one output slice. Each
+   job has its own slice buffer and its own copy of the voxel to voxel
+   transformation so that jobs can run concurrently. */
+typedef struct {
+   long slice_num;           /* Output slice to compute */
+   Volume_Data *volume;      /* Input volume (shared, read-only) */
+   Slice_Data *slice;        /* Slice buffer for this job */
+   VIO_General_transform *transformation; /* Output voxel to input voxel */
+   VIO_Real *separations;    /* Input volume step sizes (shared) */
+   int lattice_step;         /* Spacing of exactly transformed points */
+   float *coords;            /* Cached input coordinates of the slice 
+                                (NULL if not caching) */
+   int have_coords;          /* TRUE if coords are already filled in */
+   int raw_labels;           /* TRUE to copy label voxels into the raw 
+                                slice rather than interpolate */
+   int profile;              /* TRUE to time the stages of the slice */
+   double transform_time;    /* Time spent getting coordinates (on return,
+                                if profiling) */
+   double interpolate_time;  /* Time spent interpolating (ditto) */
+   double minimum;           /* Slice minimum (on return) */
+   double maximum;           /* Slice maximum (on return) */
+} Slice_Job;
+
+/* Threads that compute slices. They are started once for the whole
+   resampling and then wait for each group of jobs: worker i does job i
+   of a group, while the calling thread does job 0 and the jobs of any
+   workers that could not be started. */
+struct Slice_Pool;
+
+typedef struct {
+   struct Slice_Pool *pool;
+   int ijob;                 /* Job of each group done by this worker */
+} Slice_Worker;
+
+typedef struct Slice_Pool {
+   Slice_Job *jobs;          /* Jobs of the current group */
+   int nworkers;             /* Number of workers started */
+#ifdef HAVE_PTHREAD
+   pthread_t *threads;
+   Slice_Worker *workers;
+   pthread_mutex_t mutex;
+   pthread_cond_t cond;
+   int njobs;                /* Number of jobs in the current group */
+   long group;               /* Number of groups given to the workers */
+   int jobs_done;            /* Jobs of the group done by the workers */
+   int quit;                 /* TRUE once the workers should exit */
+#endif
+} Slice_Pool;
+
+/* Input voxel coordinates of every output voxel, kept for non-linear
+   transformations so that they are computed only once for all of the 
+   volumes of a file (and, with a cache file, for later runs) */
+typedef struct {
+   long size[VOL_NDIMS];     /* Size of output volume */
+   int lattice_step;         /* Spacing of exactly transformed points */
+   unsigned long transform_checksum; /* Identity of the transformation */
+   float *coords;            /* Coordinates (3 per voxel) */
+   int *valid;               /* TRUE for each slice that is filled in */
+   Coord_Vector sampling[COORD_MAP_NPROBES]; /* World coordinates of the
+                                                sample points of the 
+                                                output volume */
+   Coord_Vector probe[COORD_MAP_NPROBES]; /* Transformed sample points 
+                                             of the output volume */
+   int saved;                /* TRUE if the cache file holds the
+                                coordinates */
+} Coord_Map;
+
 static void load_volume(File_Info *file, long start[], long count[],
                         Volume_Data *volume);
-static void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol,
-                      VIO_General_transform *transformation,
+static void get_volume_scaling(File_Info *file, long start[], long count[],
+                               Volume_Data *volume);
+static long load_input_slab(File_Info *file, long volume_start[],
+                            Volume_Data *volume, 
+                            VIO_General_transform *total_transf,
+                            VIO_Real separations[], Slice_Data *slice,
+                            long first_slice, long nslice, 
+                            long max_buffer_size, long *nslab);
+static int get_input_bounding_box(File_Info *file, Volume_Data *volume,
+                                  VIO_General_transform *total_transf,
+                                  VIO_Real separations[], Slice_Data *slice,
+                                  long first_slice, long nslab,
+                                  long box_start[], long box_count[]);
+static void get_voxel_to_voxel_transf(VVolume *in_vol, VVolume *out_vol,
+                                      VIO_General_transform *transformation,
+                                      VIO_General_transform *total_transf);
+static void get_input_separations(File_Info *file, VIO_Real separations[]);
+static void start_slice_pool(Slice_Pool *pool, Slice_Job jobs[],
+                             int nthreads);
+static void stop_slice_pool(Slice_Pool *pool);
+static void compute_slices(Slice_Pool *pool, int njobs);
+static void profile_slices(Profile_Timer *timer, Slice_Job jobs[], int njobs,
+                           long slice_size);
+static void *slice_worker(void *job_ptr);
+#ifdef HAVE_PTHREAD
+static void *pool_worker(void *worker_ptr);
+#endif
+static void get_slice(long slice_num, Volume_Data *volume, Slice_Data *slice,
+                      VIO_General_transform *total_transf,
+                      VIO_Real separations[], int lattice_step,
+                      float coords[], int have_coords, int raw_labels,
+                      double *transform_time, double *interpolate_time,
                       double *minimum, double *maximum);
+static int setup_raw_labels(File_Info *file, Volume_Data *volume);
+static Coord_Map *create_coord_map(Program_Flags *program_flags,
+                                   long nslice, Slice_Data *slice,
+                                   VIO_General_transform *voxel_to_world,
+                                   VIO_General_transform *total_transf,
+                                   VIO_Real separations[]);
+static int read_coord_map(char *filename, Coord_Map *map);
+static void write_coord_map(char *filename, Coord_Map *map);
+static void delete_coord_map(Coord_Map *map);
+static void transform_lattice(long slice_num, Slice_Data *slice,
+                              VIO_General_transform *total_transf,
+                              VIO_Real separations[], int lattice_step,
+                              long nlattice[], Coord_Vector lattice[]);
+static void get_analytic_range(Volume_Data *volume, double real_range[],
+                               double range[]);
 static void renormalize_slices(Program_Flags *program_flags, VVolume *out_vol,
                                double slice_min[], double slice_max[]);
 static int do_Ncubic_interpolation(Volume_Data *volume, 
@@ -164,18 +279,40 @@ void resample_volumes(Program_Flags *program_flags,
    long in_start[MAX_VAR_DIMS], in_count[MAX_VAR_DIMS], in_end[MAX_VAR_DIMS];
    long out_start[MAX_VAR_DIMS], out_count[MAX_VAR_DIMS];
    long mm_start[MAX_VAR_DIMS];   /* VIO_Vector for min/max variables */
-   long nslice, islice, slice_count;
+   long nslice, islice, slice_count, slab_end, nslab, nvolumes, slice_size;
+   long nbytes;
    int idim, index, slice_index;
-   double maximum, minimum, valid_range[2];
+   int nthreads, ithread, njobs, ijob;
+   int use_analytic_range, do_renormalization, raw_labels, read_in_slabs;
+   double maximum, minimum, valid_range[2], real_range[2], analytic_range[2];
    double *slice_max, *slice_min;
    File_Info *ifp,*ofp;
+   VIO_Real separations[WORLD_NDIMS];
+   VIO_General_transform *thread_transf;
+   Slice_Job *jobs;
+   Slice_Pool pool;
+   Coord_Map *coord_map;
+   Profile_Timer timer;
 
    /* Set pointers to file information */
    ifp = in_vol->file;
    ofp = out_vol->file;
 
+   /* If every slice of an image gets the same max and min, then the 
+      slices never need to be renormalized. This is the case when keeping
+      the real range, or when the output range can be derived from the 
+      input range, which is only known for integer input */
+   use_analytic_range = 
+      program_flags->analytic_range && ofp->do_slice_renormalization &&
+      !ofp->keep_real_range &&
+      (ifp->using_icv ||
+       ((ifp->maxid != MI_ERROR) && (ifp->minid != MI_ERROR) &&
+        (ifp->datatype != NC_FLOAT) && (ifp->datatype != NC_DOUBLE)));
+   do_renormalization = ofp->do_slice_renormalization &&
+      !ofp->keep_real_range && !use_analytic_range;
+
    /* Allocate slice min/max arrays if needed */
-   if (ofp->do_slice_renormalization) {
+   if (do_renormalization) {
       slice_min = malloc(ofp->images_per_file * ofp->slices_per_image *
                          sizeof(double));
       slice_max = malloc(ofp->images_per_file * ofp->slices_per_image *
@@ -208,6 +345,84 @@ void resample_volumes(Program_Flags *program_flags,
       }
    }
 
+   /* Work out how many slices to compute at a time */
+   nthreads = program_flags->nthreads;
+#ifndef HAVE_PTHREAD
+   nthreads = 1;
+#endif
+   if (nthreads > nslice) nthreads = nslice;
+   if (nthreads < 1) nthreads = 1;
+
+   /* Set up the per-thread jobs. Each thread uses its own output slice
+      buffer and its own copy of the voxel to voxel transformation. The
+      input step sizes are read here once since the netcdf calls are not
+      thread-safe. */
+   thread_transf = malloc(sizeof(VIO_General_transform) * nthreads);
+   jobs = malloc(sizeof(Slice_Job) * nthreads);
+   get_voxel_to_voxel_transf(in_vol, out_vol, transformation, 
+                             &thread_transf[0]);
+   get_input_separations(ifp, separations);
+   for (ithread=0; ithread < nthreads; ithread++) {
+      if (ithread != 0) {
+         copy_general_transform(&thread_transf[0], &thread_transf[ithread]);
+      }
+      jobs[ithread].volume = in_vol->volume;
+      jobs[ithread].slice = &out_vol->slice[ithread];
+      jobs[ithread].transformation = &thread_transf[ithread];
+      jobs[ithread].separations = separations;
+      jobs[ithread].lattice_step = program_flags->transform_lattice;
+      jobs[ithread].coords = NULL;
+      jobs[ithread].have_coords = FALSE;
+      jobs[ithread].raw_labels = FALSE;
+      jobs[ithread].profile = program_flags->profile;
+   }
+   start_slice_pool(&pool, jobs, nthreads);
+
+   /* Keep the transformed coordinates if a non-linear transformation 
+      would otherwise be applied again to each volume (or if they are to
+      be saved for another run). Linear transformations are applied 
+      incrementally, which costs less than reading back the coordinates. */
+   nvolumes = 1;
+   for (idim=0; idim < ifp->ndims; idim++) {
+      nvolumes *= in_end[idim] / in_count[idim];
+   }
+   slice_size = out_vol->slice->size[SLICE_ROW] * 
+      out_vol->slice->size[SLICE_COL];
+   coord_map = NULL;
+   if (program_flags->coord_cache &&
+       ((nvolumes > 1) || (program_flags->coord_cache_file != NULL)) &&
+       (get_transform_type(&thread_transf[0]) != LINEAR)) {
+      coord_map = create_coord_map(program_flags, nslice, out_vol->slice,
+                                   out_vol->voxel_to_world,
+                                   &thread_transf[0], separations);
+   }
+
+   /* Read the input in slabs only for linear transformations: the
+      block of input that a non-linear transformation maps a slab to
+      cannot be bounded from a sample of its points (the transformation
+      may fold between them), so whole volumes are read instead */
+   read_in_slabs = (program_flags->max_buffer_size_in_kb > 0);
+   if (read_in_slabs && (get_transform_type(&thread_transf[0]) != LINEAR)) {
+      read_in_slabs = FALSE;
+      if (program_flags->verbose) {
+         (void) fprintf(stderr, "Non-linear transformation: "
+                        "reading whole input volumes.\n");
+      }
+      nbytes = nctypelen(in_vol->volume->datatype);
+      for (idim=0; idim < VOL_NDIMS; idim++) {
+         in_vol->volume->size[idim] = ifp->nelements[ifp->indices[idim]];
+         in_vol->volume->origin[idim] = 0;
+         nbytes *= in_vol->volume->size[idim];
+      }
+      in_vol->volume->data = realloc(in_vol->volume->data, nbytes);
+      if (in_vol->volume->data == NULL) {
+         (void) fprintf(stderr, 
+                        "Unable to allocate %ld bytes of input buffer\n",
+                        nbytes);
+         exit(EXIT_FAILURE);
+      }
+   }
+
    /* Initialize global max and min */
    valid_range[0] =  DBL_MAX;
    valid_range[1] = -DBL_MAX;
@@ -229,59 +444,141 @@ void resample_volumes(Program_Flags *program_flags,
       for (idim=0; idim < ifp->ndims; idim++)
          out_start[idim] = in_start[idim];
 
-      /* Read in the volume */
-      load_volume(ifp, in_start, in_count, in_vol->volume);
+      /* Read in the volume, or, if we are reading the input in parts,
+         just get the real range of the whole volume */
+      if (!read_in_slabs) {
+         load_volume(ifp, in_start, in_count, in_vol->volume);
+         slab_end = nslice;
+      }
+      else {
+         for (idim=0; idim < VOL_NDIMS; idim++) {
+            in_vol->volume->size[idim] = ifp->nelements[ifp->indices[idim]];
+         }
+         get_volume_scaling(ifp, in_start, in_count, in_vol->volume);
+         slab_end = 0;
+         nslab = nslice;
+      }
+      real_range[0] = in_vol->volume->real_range[0];
+      real_range[1] = in_vol->volume->real_range[1];
+      if (use_analytic_range) {
+         get_analytic_range(in_vol->volume, real_range, analytic_range);
+      }
 
-      /* Loop over slices */
-      for (islice=0; islice < nslice; islice++) {
+      /* Check whether label voxels can be copied unchanged */
+      raw_labels = program_flags->labels && 
+         setup_raw_labels(ifp, in_vol->volume);
+      if (program_flags->labels && !raw_labels && program_flags->verbose) {
+         (void) fprintf(stderr, "Input scale varies by slice: "
+                        "resampling labels as real values.\n");
+      }
 
-         /* Print log message */
-         if (program_flags->verbose) {
-            (void) fprintf(stderr, ".");
-            (void) fflush(stderr);
+      /* Loop over groups of slices, one slice per thread */
+      for (islice=0; islice < nslice; islice += njobs) {
+
+         /* Read the part of the input needed for the next slab of 
+            output slices */
+         if (islice >= slab_end) {
+            slab_end = load_input_slab(ifp, in_start, in_vol->volume,
+                                       &thread_transf[0], separations,
+                                       out_vol->slice, islice, nslice, 
+                                       program_flags->max_buffer_size_in_kb 
+                                          * 1024,
+                                       &nslab);
          }
 
-         /* Set slice number in out_start */
-         out_start[slice_index] = islice;
+         /* Get the slices */
+         njobs = MIN(nthreads, slab_end - islice);
+         for (ijob=0; ijob < njobs; ijob++) {
+            jobs[ijob].slice_num = islice + ijob;
+            jobs[ijob].raw_labels = raw_labels;
+            if (coord_map != NULL) {
+               jobs[ijob].coords = coord_map->coords + 
+                  (islice + ijob) * slice_size * WORLD_NDIMS;
+               jobs[ijob].have_coords = coord_map->valid[islice + ijob];
+            }
+         }
+         profile_start(&timer);
+         compute_slices(&pool, njobs);
+         if (program_flags->profile) {
+            profile_slices(&timer, jobs, njobs, slice_size);
+         }
+         if (coord_map != NULL) {
+            for (ijob=0; ijob < njobs; ijob++)
+               coord_map->valid[islice + ijob] = TRUE;
+         }
 
-         /* Get the slice */
-         get_slice(islice, in_vol, out_vol, transformation, 
-                   &minimum, &maximum);
+         /* Write out the slices in order */
+         for (ijob=0; ijob < njobs; ijob++) {
 
-         /* Check whether we are keep the input range */
-         if (ofp->keep_real_range) {
-            minimum = in_vol->volume->real_range[0];
-            maximum = in_vol->volume->real_range[1];
-         }
+            /* Print log message */
+            if (program_flags->verbose) {
+               (void) fprintf(stderr, ".");
+               (void) fflush(stderr);
+            }
 
-         /* Update global max and min */
-         if (maximum > valid_range[1]) valid_range[1] = maximum;
-         if (minimum < valid_range[0]) valid_range[0] = minimum;
-
-         /* Write the max, min and slice */
-         (void) mivarput1(ofp->mincid, ofp->maxid, 
-                          mitranslate_coords(ofp->mincid, 
-                                             ofp->imgid, out_start,
-                                             ofp->maxid, mm_start),
-                          NC_DOUBLE, NULL, &maximum);
-         (void) mivarput1(ofp->mincid, ofp->minid, 
-                          mitranslate_coords(ofp->mincid, 
-                                             ofp->imgid, out_start,
-                                             ofp->minid, mm_start),
-                          NC_DOUBLE, NULL, &minimum);
-         (void) miicv_put(ofp->icvid, out_start, out_count,
-                          out_vol->slice->data);
-
-         /* Save the max, min if needed */
-         if (ofp->do_slice_renormalization) {
-            slice_max[slice_count] = maximum;
-            slice_min[slice_count] = minimum;
-         }
+            /* Set slice number in out_start */
+            out_start[slice_index] = jobs[ijob].slice_num;
 
-         /* Increment slice count */
-         slice_count++;
+            /* Get the slice max and min */
+            minimum = jobs[ijob].minimum;
+            maximum = jobs[ijob].maximum;
 
-      }    /* End loop over slices */
+            /* Check whether we are keep the input range */
+            if (ofp->keep_real_range) {
+               minimum = real_range[0];
+               maximum = real_range[1];
+            }
+            else if (use_analytic_range) {
+               minimum = analytic_range[0];
+               maximum = analytic_range[1];
+            }
+
+            /* Update global max and min */
+            if (maximum > valid_range[1]) valid_range[1] = maximum;
+            if (minimum < valid_range[0]) valid_range[0] = minimum;
+
+            /* Write the max, min and slice */
+            profile_start(&timer);
+            (void) mivarput1(ofp->mincid, ofp->maxid, 
+                             mitranslate_coords(ofp->mincid, 
+                                                ofp->imgid, out_start,
+                                                ofp->maxid, mm_start),
+                             NC_DOUBLE, NULL, &maximum);
+            (void) mivarput1(ofp->mincid, ofp->minid, 
+                             mitranslate_coords(ofp->mincid, 
+                                                ofp->imgid, out_start,
+                                                ofp->minid, mm_start),
+                             NC_DOUBLE, NULL, &minimum);
+            if (raw_labels) {
+               (void) miicv_put(ofp->raw_icvid, out_start, out_count,
+                                jobs[ijob].slice->raw_data);
+            }
+            else {
+               (void) miicv_put(ofp->icvid, out_start, out_count,
+                                jobs[ijob].slice->data);
+            }
+            profile_stop(&timer, PROFILE_WRITE, 
+                         (double) slice_size * nctypelen(ofp->datatype));
+
+            /* Save the max, min if needed */
+            if (do_renormalization) {
+               slice_max[slice_count] = maximum;
+               slice_min[slice_count] = minimum;
+            }
+
+            /* Increment slice count */
+            slice_count++;
+
+         }    /* End loop over slices in group */
+
+      }    /* End loop over groups of slices */
+
+      /* Save the coordinates once they have all been computed */
+      if ((coord_map != NULL) && !coord_map->saved &&
+          (program_flags->coord_cache_file != NULL)) {
+         write_coord_map(program_flags->coord_cache_file, coord_map);
+         coord_map->saved = TRUE;
+      }
 
       /* Increment in_start counter */
       idim = ofp->ndims-1;
@@ -300,14 +597,29 @@ void resample_volumes(Program_Flags *program_flags,
       (void) fflush(stderr);
    }
 
+   /* Free the threads, the coordinate cache and the per-thread
+      transformations */
+   stop_slice_pool(&pool);
+   if (coord_map != NULL) {
+      delete_coord_map(coord_map);
+   }
+   for (ithread=0; ithread < nthreads; ithread++) {
+      delete_general_transform(&thread_transf[ithread]);
+   }
+   free(thread_transf);
+   free(jobs);
+
    /* If output volume is floating point, write out global max and min */
    if ((ofp->datatype == NC_FLOAT) || (ofp->datatype == NC_DOUBLE)) {
       (void) miset_valid_range(ofp->mincid, ofp->imgid, valid_range);
    }
 
    /* Recompute slices and free vectors, if needed */
-   if (ofp->do_slice_renormalization) {
+   if (do_renormalization) {
+      profile_start(&timer);
       renormalize_slices(program_flags, out_vol, slice_min, slice_max);
+      profile_stop(&timer, PROFILE_RENORMALIZE, 2.0 * slice_count *
+                   slice_size * nctypelen(ofp->datatype));
       free(slice_min);
       free(slice_max);
    }
@@ -332,11 +644,12 @@ void resample_volumes(Program_Flags *program_flags,
 void load_volume(File_Info *file, long start[], long count[], 
                  Volume_Data *volume)
 {
-   long nread, islice, mm_start[MAX_VAR_DIMS], mm_count[MAX_VAR_DIMS];
-   int varid, ivar, idim, ndims;
-   double *values, maximum, minimum, denom;
+   Profile_Timer timer;
+   double nbytes;
+   int idim;
 
    /* Load the file */
+   profile_start(&timer);
    if (file->using_icv) {
       (void) miicv_get(file->icvid, start, count, volume->data);
    }
@@ -344,6 +657,38 @@ void load_volume(File_Info *file, long start[], long count[],
       (void) ncvarget(file->mincid, file->imgid, 
                       start, count, volume->data);
    }
+   nbytes = nctypelen(volume->datatype);
+   for (idim=0; idim < file->ndims; idim++) {
+      nbytes *= count[idim];
+   }
+   profile_stop(&timer, PROFILE_LOAD_VOLUME, nbytes);
+
+   /* Get the scales and offsets */
+   get_volume_scaling(file, start, count, volume);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_volume_scaling
+@INPUT      : file - description of input file
+              start - index of start of volume in minc file
+              count - vector size of volume in minc file
+              volume - description of volume data
+@OUTPUT     : volume - contains scales, offsets and real range
+@RETURNS    : (none)
+@DESCRIPTION: Gets the slice scales and offsets and the real range for a
+              volume of a minc file, without reading the voxel data.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : February 10, 1993 (Peter Neelin)
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_volume_scaling(File_Info *file, long start[], long count[],
+                               Volume_Data *volume)
+{
+   long nread, islice, mm_start[MAX_VAR_DIMS], mm_count[MAX_VAR_DIMS];
+   int varid, ivar, idim, ndims;
+   double *values, maximum, minimum, denom;
 
    /* Read the max and min from the file into the scale and offset variables 
       (maxima into scale and minima into offset) if datatype is not
@@ -448,39 +793,788 @@ void load_volume(File_Info *file, long start[], long count[],
 }
 
 /* ----------------------------- MNI Header -----------------------------------
-@NAME       : get_slice
+@NAME       : load_input_slab
+@INPUT      : file - description of input file
+              volume_start - index of start of current volume in minc file
+              volume - description of volume data
+              total_transf - output voxel to input voxel transformation
+              separations - step sizes of input volume
+              slice - output slice (for its size)
+              first_slice - first output slice of the slab
+              nslice - number of output slices
+              max_buffer_size - largest block of input to read (in bytes)
+              nslab - suggested number of slices in slab
+@OUTPUT     : volume - contains the input block needed for the slab, with 
+                 origin set to its position in the file volume
+              nslab - number of slices in slab
+@RETURNS    : Index of the output slice after the end of the slab.
+@DESCRIPTION: Reads the block of the input volume needed to compute a 
+              slab of output slices starting at first_slice. The slab
+              is made as thick as possible (up to twice the suggested
+              thickness) such that the block fits in max_buffer_size
+              bytes, and is at least one slice.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static long load_input_slab(File_Info *file, long volume_start[],
+                            Volume_Data *volume, 
+                            VIO_General_transform *total_transf,
+                            VIO_Real separations[], Slice_Data *slice,
+                            long first_slice, long nslice, 
+                            long max_buffer_size, long *nslab)
+{
+   long start[MAX_VAR_DIMS], count[MAX_VAR_DIMS];
+   long box_start[VOL_NDIMS], box_count[VOL_NDIMS];
+   long nbytes;
+   int idim, index, nonempty;
+
+   /* Find the thickest slab whose input block fits */
+   *nslab = MIN(2 * (*nslab), nslice - first_slice);
+   while (TRUE) {
+      nonempty = get_input_bounding_box(file, volume, total_transf, 
+                                        separations, slice, first_slice, 
+                                        *nslab, box_start, box_count);
+      nbytes = box_count[0] * box_count[1] * box_count[2] * 
+         nctypelen(volume->datatype);
+      if (!nonempty || (nbytes <= max_buffer_size) || (*nslab <= 1)) break;
+      *nslab = (*nslab + 1) / 2;
+   }
+
+   /* Read the block */
+   for (idim=0; idim < file->ndims; idim++) {
+      start[idim] = volume_start[idim];
+      count[idim] = 1;
+   }
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      index = file->indices[idim];
+      start[index] = box_start[idim];
+      count[index] = box_count[idim];
+      volume->size[idim] = box_count[idim];
+      volume->origin[idim] = box_start[idim];
+   }
+   volume->data = realloc(volume->data, nbytes);
+   if (volume->data == NULL) {
+      (void) fprintf(stderr, "Unable to allocate %ld bytes of input buffer\n",
+                     nbytes);
+      exit(EXIT_FAILURE);
+   }
+   load_volume(file, start, count, volume);
+
+   return first_slice + *nslab;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_input_bounding_box
+@INPUT      : file - description of input file
+              volume - description of volume data (for its support)
+              total_transf - output voxel to input voxel transformation
+                 (must be linear)
+              separations - step sizes of input volume
+              slice - output slice (for its size)
+              first_slice - first output slice of the slab
+              nslab - number of slices in slab
+@OUTPUT     : box_start - first input voxel of block
+              box_count - size of block
+@RETURNS    : TRUE if the slab maps into the input volume, FALSE if it 
+              lies completely outside (box is then a single voxel).
+@DESCRIPTION: Finds the block of input voxels needed to interpolate all
+              the points of a slab of output slices.
+@METHOD     : The corners of the slab are transformed, which bounds the
+              whole slab since the transformation is linear.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int get_input_bounding_box(File_Info *file, Volume_Data *volume,
+                                  VIO_General_transform *total_transf,
+                                  VIO_Real separations[], Slice_Data *slice,
+                                  long first_slice, long nslab,
+                                  long box_start[], long box_count[])
+{
+   long last[VOL_NDIMS], step[VOL_NDIMS], index[VOL_NDIMS];
+   long lo, hi, full_size;
+   int idim, margin;
+   double minimum[VOL_NDIMS], maximum[VOL_NDIMS];
+   Coord_Vector coord, transf_coord;
+
+   /* Set up the points to transform */
+   last[SLICE] = first_slice + nslab - 1;
+   last[ROW] = slice->size[SLICE_ROW] - 1;
+   last[COLUMN] = slice->size[SLICE_COL] - 1;
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      minimum[idim] =  DBL_MAX;
+      maximum[idim] = -DBL_MAX;
+   }
+   margin = volume->support + 1;
+   step[SLICE] = MAX(last[SLICE] - first_slice, 1);
+   step[ROW] = MAX(last[ROW], 1);
+   step[COLUMN] = MAX(last[COLUMN], 1);
+
+   /* Transform the corners */
+   for (index[SLICE]=first_slice; ; index[SLICE] += step[SLICE]) {
+      coord[SLICE] = MIN(index[SLICE], last[SLICE]);
+      for (index[ROW]=0; ; index[ROW] += step[ROW]) {
+         coord[ROW] = MIN(index[ROW], last[ROW]);
+         for (index[COLUMN]=0; ; index[COLUMN] += step[COLUMN]) {
+            coord[COLUMN] = MIN(index[COLUMN], last[COLUMN]);
+            DO_TRANSFORM_WITH_INPUT_STEPS(transf_coord, total_transf, 
+                                          coord, separations);
+            for (idim=0; idim < VOL_NDIMS; idim++) {
+               if (transf_coord[idim] < minimum[idim])
+                  minimum[idim] = transf_coord[idim];
+               if (transf_coord[idim] > maximum[idim])
+                  maximum[idim] = transf_coord[idim];
+            }
+            if (index[COLUMN] >= last[COLUMN]) break;
+         }
+         if (index[ROW] >= last[ROW]) break;
+      }
+      if (index[SLICE] >= last[SLICE]) break;
+   }
+
+   /* Get the block, with a margin for the interpolant, clipped to the 
+      volume */
+   for (idim=0; idim < VOL_NDIMS; idim++) {
+      full_size = file->nelements[file->indices[idim]];
+      lo = (long) floor(minimum[idim]) - margin;
+      hi = (long) ceil(maximum[idim]) + margin;
+      if (lo < 0) lo = 0;
+      if (hi > full_size - 1) hi = full_size - 1;
+      if (hi < lo) {
+         for (idim=0; idim < VOL_NDIMS; idim++) {
+            box_start[idim] = 0;
+            box_count[idim] = 1;
+         }
+         return FALSE;
+      }
+      box_start[idim] = lo;
+      box_count[idim] = hi - lo + 1;
+   }
+
+   return TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : setup_raw_labels
+@INPUT      : file - description of input file
+              volume - description of volume data, with scales and 
+                 offsets set
+@OUTPUT     : volume - voxel_fillvalue is set
+@RETURNS    : TRUE if the voxel values of the volume can be copied to the
+              output without conversion, FALSE otherwise.
+@DESCRIPTION: Checks that a label volume is read in its own type (not 
+              through an icv) with the same scale for every slice, so 
+              that the output, which gets the real range of the input,
+              gives each voxel the same real value. Works out the fill 
+              value in voxel units.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int setup_raw_labels(File_Info *file, Volume_Data *volume)
+{
+   long islice;
+   double value;
+
+   if (file->using_icv) return FALSE;
+   for (islice=1; islice < volume->size[SLC_AXIS]; islice++) {
+      if ((volume->scale[islice] != volume->scale[0]) ||
+          (volume->offset[islice] != volume->offset[0]))
+         return FALSE;
+   }
+
+   /* Convert the fill value to a voxel value */
+   value = volume->fillvalue;
+   if (volume->scale[0] != 0.0) {
+      value = (value - volume->offset[0]) / volume->scale[0];
+   }
+   if ((volume->datatype != NC_FLOAT) && (volume->datatype != NC_DOUBLE)) {
+      value = floor(value + 0.5);
+   }
+   if (value < volume->vrange[0]) value = volume->vrange[0];
+   if (value > volume->vrange[1]) value = volume->vrange[1];
+   volume->voxel_fillvalue = value;
+
+   return TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_coord_map
+@INPUT      : program_flags - data for program execution
+              nslice - number of output slices
+              slice - output slice (for its size)
+              voxel_to_world - output voxel to world transformation
+              total_transf - output voxel to input voxel transformation
+              separations - step sizes of input volume
+@OUTPUT     : (none)
+@RETURNS    : Pointer to coordinate map (NULL if there is not enough 
+              memory for one)
+@DESCRIPTION: Sets up storage for the input coordinates of every output
+              voxel. If there is a cache file for the same output sampling
+              and transformation, the coordinates are read from it and 
+              marked as valid; otherwise they are filled in as the first
+              volume is resampled.
+@METHOD     : A cache file is accepted if it has the same output size,
+              the same lattice step, the same transformation file (by 
+              checksum) and, at a 3 x 3 x 3 set of sample points spanning
+              the output volume, the same world coordinates (the output
+              sampling) and the same transformed coordinates.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static Coord_Map *create_coord_map(Program_Flags *program_flags,
+                                   long nslice, Slice_Data *slice,
+                                   VIO_General_transform *voxel_to_world,
+                                   VIO_General_transform *total_transf,
+                                   VIO_Real separations[])
+{
+   Coord_Map *map;
+   Coord_Vector point;
+   long islice, nvalues;
+   int iprobe, idim, index;
+
+   /* Get space for the coordinates */
+   map = malloc(sizeof(Coord_Map));
+   map->size[SLICE] = nslice;
+   map->size[ROW] = slice->size[SLICE_ROW];
+   map->size[COLUMN] = slice->size[SLICE_COL];
+   map->lattice_step = program_flags->transform_lattice;
+   map->transform_checksum = program_flags->transform_checksum;
+   nvalues = map->size[SLICE] * map->size[ROW] * map->size[COLUMN] * 
+      WORLD_NDIMS;
+   map->coords = malloc(sizeof(float) * nvalues);
+   map->valid = malloc(sizeof(int) * nslice);
+   if ((map->coords == NULL) || (map->valid == NULL)) {
+      (void) fprintf(stderr, 
+                     "Not enough memory to cache coordinates - ignoring.\n");
+      delete_coord_map(map);
+      return NULL;
+   }
+
+   /* Transform the sample points: first, middle and last along each 
+      axis */
+   for (iprobe=0; iprobe < COORD_MAP_NPROBES; iprobe++) {
+      for (index=iprobe, idim=0; idim < VOL_NDIMS; idim++, index /= 3) {
+         point[idim] = (double) ((index % 3) * (map->size[idim] - 1) / 2);
+      }
+      DO_TRANSFORM(map->sampling[iprobe], voxel_to_world, point);
+      DO_TRANSFORM_WITH_INPUT_STEPS(map->probe[iprobe], total_transf, 
+                                    point, separations);
+   }
+
+   /* Look for a cache file */
+   map->saved = FALSE;
+   if (program_flags->coord_cache_file != NULL) {
+      map->saved = read_coord_map(program_flags->coord_cache_file, map);
+      if (map->saved && program_flags->verbose) {
+         (void) fprintf(stderr, "Using transformed coordinates from %s\n",
+                        program_flags->coord_cache_file);
+      }
+   }
+   for (islice=0; islice < nslice; islice++) {
+      map->valid[islice] = map->saved;
+   }
+
+   return map;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : read_coord_map
+@INPUT      : filename - name of cache file
+              map - coordinate map with size and sample points set
+@OUTPUT     : map - coordinates read from file
+@RETURNS    : TRUE if the file exists and matches the map, FALSE otherwise.
+@DESCRIPTION: Reads the coordinates of a coordinate map from a cache file
+              written by write_coord_map, checking first that the file
+              was written for the same output size and sampling, lattice
+              step and transformation.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static int read_coord_map(char *filename, Coord_Map *map)
+{
+   FILE *fp;
+   char magic[sizeof(COORD_MAP_MAGIC)];
+   long size[VOL_NDIMS], nvalues;
+   int lattice_step;
+   unsigned long transform_checksum;
+   Coord_Vector sampling[COORD_MAP_NPROBES], probe[COORD_MAP_NPROBES];
+   int ok, idim, iprobe;
+
+   if ((fp = fopen(filename, "rb")) == NULL) return FALSE;
+
+   /* Read and check the header */
+   ok = ((fread(magic, sizeof(magic), 1, fp) == 1) &&
+         (memcmp(magic, COORD_MAP_MAGIC, sizeof(magic)) == 0) &&
+         (fread(size, sizeof(size), 1, fp) == 1) &&
+         (fread(&lattice_step, sizeof(lattice_step), 1, fp) == 1) &&
+         (fread(&transform_checksum, sizeof(transform_checksum), 
+                1, fp) == 1) &&
+         (fread(sampling, sizeof(sampling), 1, fp) == 1) &&
+         (fread(probe, sizeof(probe), 1, fp) == 1));
+   for (idim=0; ok && (idim < VOL_NDIMS); idim++) {
+      ok = (size[idim] == map->size[idim]);
+   }
+   ok = ok && (lattice_step == map->lattice_step) &&
+      (transform_checksum == map->transform_checksum);
+   for (iprobe=0; ok && (iprobe < COORD_MAP_NPROBES); iprobe++) {
+      for (idim=0; ok && (idim < WORLD_NDIMS); idim++) {
+         ok = (fabs(sampling[iprobe][idim] - map->sampling[iprobe][idim]) <=
+               COORD_MAP_TOLERANCE) &&
+            (fabs(probe[iprobe][idim] - map->probe[iprobe][idim]) <= 
+             COORD_MAP_TOLERANCE);
+      }
+   }
+
+   /* Read the coordinates */
+   if (ok) {
+      nvalues = size[SLICE] * size[ROW] * size[COLUMN] * WORLD_NDIMS;
+      ok = (fread(map->coords, sizeof(float), nvalues, fp) == nvalues);
+   }
+
+   (void) fclose(fp);
+
+   return ok;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : write_coord_map
+@INPUT      : filename - name of cache file
+              map - complete coordinate map
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Writes a coordinate map to a cache file. The file is in 
+              the native byte order and is only meant to be read back on
+              the same kind of machine. Failure to write is not fatal.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void write_coord_map(char *filename, Coord_Map *map)
+{
+   FILE *fp;
+   long nvalues;
+   int ok;
+
+   nvalues = map->size[SLICE] * map->size[ROW] * map->size[COLUMN] * 
+      WORLD_NDIMS;
+   ok = ((fp = fopen(filename, "wb")) != NULL);
+   if (ok) {
+      ok = ((fwrite(COORD_MAP_MAGIC, sizeof(COORD_MAP_MAGIC), 1, fp) == 1) &&
+            (fwrite(map->size, sizeof(map->size), 1, fp) == 1) &&
+            (fwrite(&map->lattice_step, sizeof(map->lattice_step),
+                    1, fp) == 1) &&
+            (fwrite(&map->transform_checksum, 
+                    sizeof(map->transform_checksum), 1, fp) == 1) &&
+            (fwrite(map->sampling, sizeof(map->sampling), 1, fp) == 1) &&
+            (fwrite(map->probe, sizeof(map->probe), 1, fp) == 1) &&
+            (fwrite(map->coords, sizeof(float), nvalues, fp) == nvalues));
+      ok = (fclose(fp) == 0) && ok;
+   }
+   if (!ok) {
+      (void) fprintf(stderr, "Error writing coordinate cache file %s.\n",
+                     filename);
+      (void) remove(filename);
+   }
+}
+
+/* Free a coordinate map */
+static void delete_coord_map(Coord_Map *map)
+{
+   if (map->coords != NULL) free(map->coords);
+   if (map->valid != NULL) free(map->valid);
+   free(map);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_voxel_to_voxel_transf
 @INPUT      : in_vol - description of input volume
               out_vol - description of output volume
               transformation - description of world transformation
-@OUTPUT     : out_vol - slice field contains new slice
+@OUTPUT     : total_transf - transformation from output voxel coordinates
+                 to input voxel coordinates
+@RETURNS    : (none)
+@DESCRIPTION: Concatenates the output voxel to world, world to world and
+              world to input voxel transformations. The result must be
+              freed with delete_general_transform.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : February 8, 1993 (Peter Neelin)
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_voxel_to_voxel_transf(VVolume *in_vol, VVolume *out_vol,
+                                      VIO_General_transform *transformation,
+                                      VIO_General_transform *total_transf)
+{
+   VIO_General_transform temp_transf;
+
+   concat_general_transforms(out_vol->voxel_to_world, 
+                             transformation, &temp_transf);
+   concat_general_transforms(&temp_transf, in_vol->world_to_voxel,
+                             total_transf);
+   delete_general_transform(&temp_transf);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_input_separations
+@INPUT      : file - description of input file
+@OUTPUT     : separations - step sizes of the input volume, subscripted
+                 by world axis
+@RETURNS    : (none)
+@DESCRIPTION: Gets the step sizes (separations) of the input volume in
+              order to get an appropriate error margin (ftol) for the
+              function grid_inverse_transform_point.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : February 8, 1993 (Peter Neelin)
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_input_separations(File_Info *file, VIO_Real separations[])
+{
+   int  idim, idim_in, axis;
+   char dimname[MAX_NC_NAME];
+   int  dim[MAX_VAR_DIMS], dimid;
+   int  imgid;
+   int  ndims;
+   long dimlength;
+
+   for (idim=0; idim < WORLD_NDIMS; idim++)
+      separations[idim] = 1.0;
+
+   imgid = ncvarid(file->mincid, MIimage);
+   ncvarinq(file->mincid, imgid, NULL, NULL, &ndims, dim, NULL);
+
+   for (idim_in=0; idim_in < file->ndims; idim_in++) {
+
+      /* Only spatial dimensions matter */
+      axis = file->world_axes[idim_in];
+      if (axis == NO_AXIS) continue;
+           
+      /* Get name of dimension */
+      (void) ncdiminq(file->mincid, dim[idim_in], dimname, &dimlength);
+
+      /* Check for existence of variable */
+      dimid = ncvarid(file->mincid, dimname);
+      if (dimid == MI_ERROR) continue;
+
+      /* Get attributes from variable */
+      (void) miattget1(file->mincid, dimid, MIstep, 
+                       NC_DOUBLE, &separations[axis]);
+
+      if (separations[axis] == 0.0)
+          separations[axis] = 1.0;
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_slice_pool
+@INPUT      : jobs - list of jobs, one per thread
+              nthreads - number of threads to compute slices with
+@OUTPUT     : pool - threads waiting for groups of jobs
+@RETURNS    : (none)
+@DESCRIPTION: Starts the threads that compute slices, so that they are
+              created only once for all of the slices of a resampling.
+              If threads are not available (or cannot be created), the
+              calling thread does all of the jobs.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void start_slice_pool(Slice_Pool *pool, Slice_Job jobs[],
+                             int nthreads)
+{
+#ifdef HAVE_PTHREAD
+   int ithread;
+#endif
+
+   pool->jobs = jobs;
+   pool->nworkers = 0;
+
+#ifdef HAVE_PTHREAD
+   pool->threads = NULL;
+   if (nthreads <= 1) return;
+
+   (void) pthread_mutex_init(&pool->mutex, NULL);
+   (void) pthread_cond_init(&pool->cond, NULL);
+   pool->njobs = 0;
+   pool->group = 0;
+   pool->jobs_done = 0;
+   pool->quit = FALSE;
+   pool->threads = malloc(sizeof(pthread_t) * nthreads);
+   pool->workers = malloc(sizeof(Slice_Worker) * nthreads);
+   for (ithread=1; ithread < nthreads; ithread++) {
+      pool->workers[ithread].pool = pool;
+      pool->workers[ithread].ijob = ithread;
+      if (pthread_create(&pool->threads[ithread], NULL, pool_worker,
+                         &pool->workers[ithread]) != 0) break;
+      pool->nworkers++;
+   }
+#endif /* HAVE_PTHREAD */
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : stop_slice_pool
+@INPUT      : pool - threads started by start_slice_pool
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Tells the threads that compute slices to exit, waits for 
+              them and frees the pool.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void stop_slice_pool(Slice_Pool *pool)
+{
+#ifdef HAVE_PTHREAD
+   int ithread;
+
+   if (pool->threads != NULL) {
+      (void) pthread_mutex_lock(&pool->mutex);
+      pool->quit = TRUE;
+      (void) pthread_cond_broadcast(&pool->cond);
+      (void) pthread_mutex_unlock(&pool->mutex);
+      for (ithread=1; ithread <= pool->nworkers; ithread++) {
+         (void) pthread_join(pool->threads[ithread], NULL);
+      }
+      (void) pthread_cond_destroy(&pool->cond);
+      (void) pthread_mutex_destroy(&pool->mutex);
+      free(pool->threads);
+      free(pool->workers);
+      pool->threads = NULL;
+   }
+#endif /* HAVE_PTHREAD */
+
+   pool->jobs = NULL;
+   pool->nworkers = 0;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : compute_slices
+@INPUT      : pool - threads started by start_slice_pool
+              njobs - number of jobs at the start of its list to do
+@OUTPUT     : (none) - slice buffers, minima and maxima of the jobs are
+                 filled in
+@RETURNS    : (none)
+@DESCRIPTION: Computes a group of output slices, one per thread. The 
+              calling thread does the first job itself, along with those
+              of any threads that could not be started.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void compute_slices(Slice_Pool *pool, int njobs)
+{
+   int ijob, nworker_jobs;
+
+   nworker_jobs = MIN(njobs - 1, pool->nworkers);
+   if (nworker_jobs < 0) nworker_jobs = 0;
+
+#ifdef HAVE_PTHREAD
+   if (nworker_jobs > 0) {
+      (void) pthread_mutex_lock(&pool->mutex);
+      pool->njobs = njobs;
+      pool->jobs_done = 0;
+      pool->group++;
+      (void) pthread_cond_broadcast(&pool->cond);
+      (void) pthread_mutex_unlock(&pool->mutex);
+   }
+#endif /* HAVE_PTHREAD */
+
+   if (njobs > 0) {
+      (void) slice_worker(&pool->jobs[0]);
+   }
+   for (ijob=nworker_jobs+1; ijob < njobs; ijob++) {
+      (void) slice_worker(&pool->jobs[ijob]);
+   }
+
+#ifdef HAVE_PTHREAD
+   if (nworker_jobs > 0) {
+      (void) pthread_mutex_lock(&pool->mutex);
+      while (pool->jobs_done < nworker_jobs)
+         (void) pthread_cond_wait(&pool->cond, &pool->mutex);
+      (void) pthread_mutex_unlock(&pool->mutex);
+   }
+#endif /* HAVE_PTHREAD */
+}
+
+#ifdef HAVE_PTHREAD
+
+/* Thread entry point: do this worker's job of each group of slices until
+   the pool is stopped */
+static void *pool_worker(void *worker_ptr)
+{
+   Slice_Worker *worker = (Slice_Worker *) worker_ptr;
+   Slice_Pool *pool = worker->pool;
+   long group;
+
+   group = 0;
+   (void) pthread_mutex_lock(&pool->mutex);
+   for (;;) {
+      while ((pool->group == group) && !pool->quit)
+         (void) pthread_cond_wait(&pool->cond, &pool->mutex);
+      if (pool->quit) break;
+      group = pool->group;
+      if (worker->ijob < pool->njobs) {
+         (void) pthread_mutex_unlock(&pool->mutex);
+         (void) slice_worker(&pool->jobs[worker->ijob]);
+         (void) pthread_mutex_lock(&pool->mutex);
+         pool->jobs_done++;
+         (void) pthread_cond_broadcast(&pool->cond);
+      }
+   }
+   (void) pthread_mutex_unlock(&pool->mutex);
+
+   return NULL;
+}
+
+#endif /* HAVE_PTHREAD */
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : profile_slices
+@INPUT      : timer - times at start of compute_slices
+              jobs - list of jobs just computed, with their times
+              njobs - number of jobs in list
+              slice_size - number of voxels in a slice
+@OUTPUT     : (none)
+@RETURNS    : (none)
+@DESCRIPTION: Adds the time spent computing a group of slices to the 
+              coordinate transformation and interpolation stages. 
+@METHOD     : The threads time each stage row by row. The wall clock and
+              cpu time of the whole group are split between the stages in
+              proportion to the time summed over the threads.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void profile_slices(Profile_Timer *timer, Slice_Job jobs[], int njobs,
+                           long slice_size)
+{
+   double wall, cpu, transform_time, interpolate_time, fraction;
+   int ijob;
+
+   wall = profile_wall_time() - timer->wall;
+   cpu = profile_cpu_time() - timer->cpu;
+   transform_time = 0.0;
+   interpolate_time = 0.0;
+   for (ijob=0; ijob < njobs; ijob++) {
+      transform_time += jobs[ijob].transform_time;
+      interpolate_time += jobs[ijob].interpolate_time;
+   }
+   fraction = (transform_time + interpolate_time > 0.0) ?
+      transform_time / (transform_time + interpolate_time) : 0.5;
+
+   profile_add(PROFILE_TRANSFORM_SLICE, njobs, fraction * wall, 
+               fraction * cpu, transform_time, 
+               (double) njobs * slice_size * sizeof(Coord_Vector));
+   profile_add(PROFILE_INTERPOLATE, njobs, (1.0 - fraction) * wall, 
+               (1.0 - fraction) * cpu, interpolate_time,
+               (double) njobs * slice_size * 
+                  (jobs[0].raw_labels ? 
+                   nctypelen(jobs[0].volume->datatype) : sizeof(double)));
+}
+
+/* Thread entry point: compute the slice described by a Slice_Job */
+static void *slice_worker(void *job_ptr)
+{
+   Slice_Job *job = (Slice_Job *) job_ptr;
+
+   job->transform_time = 0.0;
+   job->interpolate_time = 0.0;
+   get_slice(job->slice_num, job->volume, job->slice, job->transformation,
+             job->separations, job->lattice_step, 
+             job->coords, job->have_coords, job->raw_labels,
+             (job->profile ? &job->transform_time : NULL),
+             (job->profile ? &job->interpolate_time : NULL),
+             &job->minimum, &job->maximum);
+
+   return NULL;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_slice
+@INPUT      : slice_num - number of output slice to compute
+              volume - current input volume
+              slice - buffer for output slice
+              total_transf - output voxel to input voxel transformation
+              separations - step sizes of input volume
+              lattice_step - spacing of points at which a non-linear
+                 transformation is evaluated exactly
+              coords - input coordinates of the slice voxels (NULL if
+                 they are not cached)
+              have_coords - TRUE if coords are filled in, FALSE if they
+                 should be computed and saved in coords
+              raw_labels - TRUE if label voxels should be copied into
+                 slice->raw_data (minimum and maximum are not computed)
+              transform_time, interpolate_time - NULL unless the stages
+                 should be timed
+@OUTPUT     : slice - contains new slice
+              coords - filled in, if given and not already set
+              transform_time - time spent getting input coordinates
+              interpolate_time - time spent interpolating
               minimum - slice minimum (excluding data from outside volume)
               maximum - slice maximum (excluding data from outside volume)
 @RETURNS    : (none)
-@DESCRIPTION: Resamples current volume of in_vol into slice in out_vol 
-              using given world transformation.
-@METHOD     : 
+@DESCRIPTION: Resamples current input volume into slice using the given
+              voxel to voxel transformation. Only touches data passed in,
+              so that different slices can be computed concurrently.
+@METHOD     : Linear transformations are applied by stepping the 
+              coordinate incrementally along rows and columns. Non-linear
+              transformations are evaluated at every voxel, or, if
+              lattice_step > 1, on a coarse lattice of the slice with the
+              transformed coordinates interpolated bilinearly in between.
+              Cached coordinates, when present, replace both.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : February 8, 1993 (Peter Neelin)
 @MODIFIED   : 
 ---------------------------------------------------------------------------- */
-void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol, 
-               VIO_General_transform *transformation, 
-               double *minimum, double *maximum)
+static void get_slice(long slice_num, Volume_Data *volume, Slice_Data *slice,
+                      VIO_General_transform *total_transf,
+                      VIO_Real separations[], int lattice_step,
+                      float coords[], int have_coords, int raw_labels,
+                      double *transform_time, double *interpolate_time,
+                      double *minimum, double *maximum)
 {
-   Slice_Data *slice;
-   Volume_Data *volume;
    double *dptr;
+   float *cptr;
    long irow, icol;
    int all_linear;
    int idim;
+   double weight, time_start, time_coords;
+
+   /* Lattice of exactly transformed points for non-linear transforms */
+   Coord_Vector *lattice, *row_lattice, lattice_incr;
+   long nlattice[SLICE_NDIMS], ilat, jlat, lpos, lnext;
+
+   /* Transformed coordinates of a row, interpolated all at once */
+   Coord_Vector *row_coords;
+   int *row_inside;
+
+   /* Position of the data in memory within the input volume */
+   Coord_Vector origin;
    
-   VIO_Real separations[WORLD_NDIMS];
-   int  idim_in;
-   char dimname[MAX_NC_NAME];
-   int  dim[MAX_VAR_DIMS], dimid;
-   int  imgid;
-   int  ndims;
    /* Coordinate vectors for stepping through slice */
    Coord_Vector zero = {0, 0, 0};
    Coord_Vector column = {0, 0, 1};
@@ -488,98 +1582,186 @@ void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol,
    Coord_Vector start = {0, 0, 0};    /* start[SLICE] set later to slice_num */
    Coord_Vector coord, transf_coord;
 
-   /* Transformation stuff */
-   VIO_General_transform total_transf, temp_transf;
-
-   /* Get slice and volume pointers */
-   volume = in_vol->volume;
-   slice = out_vol->slice;
-
-   /* Concatenate transforms */
-   concat_general_transforms(out_vol->voxel_to_world, 
-                             transformation, &temp_transf);
-   concat_general_transforms(&temp_transf, in_vol->world_to_voxel,
-                             &total_transf);
-   delete_general_transform(&temp_transf);
-
    /* Check for complete linear transformation */
-   all_linear = (get_transform_type(&total_transf) == LINEAR);
+   all_linear = (get_transform_type(total_transf) == LINEAR);
+   time_start = (transform_time != NULL) ? profile_wall_time() : 0.0;
+   time_coords = time_start;
 
    /* VIO_Transform vectors for linear transformation */
    start[SLICE] = slice_num;
    if (all_linear) {
-      DO_TRANSFORM(zero, &total_transf, zero);
-      DO_TRANSFORM(column, &total_transf, column);
-      DO_TRANSFORM(row, &total_transf, row);
-      DO_TRANSFORM(start, &total_transf, start);
+      DO_TRANSFORM(zero, total_transf, zero);
+      DO_TRANSFORM(column, total_transf, column);
+      DO_TRANSFORM(row, total_transf, row);
+      DO_TRANSFORM(start, total_transf, start);
    }
 
    /* Make sure that row and column are vectors and not points */
    VECTOR_DIFF(row, row, zero);
    VECTOR_DIFF(column, column, zero);
 
+   /* For a non-linear transformation, transform the lattice points of
+      the slice once, up front */
+   lattice = NULL;
+   row_lattice = NULL;
+   if (!all_linear && (lattice_step > 1) && !have_coords) {
+      for (idim=0; idim < SLICE_NDIMS; idim++) {
+         nlattice[idim] = (slice->size[idim] + lattice_step - 2) / 
+            lattice_step + 1;
+      }
+      lattice = malloc(sizeof(Coord_Vector) * 
+                       nlattice[SLICE_ROW] * nlattice[SLICE_COL]);
+      row_lattice = malloc(sizeof(Coord_Vector) * nlattice[SLICE_COL]);
+      transform_lattice(slice_num, slice, total_transf, separations,
+                        lattice_step, nlattice, lattice);
+   }
+
+   /* Get the position of the part of the volume that is in memory */
+   for (idim=0; idim < VOL_NDIMS; idim++)
+      origin[idim] = volume->origin[idim];
+
+   /* Get space for one row of coordinates */
+   row_coords = malloc(sizeof(Coord_Vector) * slice->size[SLICE_COL]);
+   row_inside = malloc(sizeof(int) * slice->size[SLICE_COL]);
+
    /* Initialize maximum and minimum */
    *maximum = -DBL_MAX;
    *minimum =  DBL_MAX;
    
-   imgid = ncvarid(in_vol->file->mincid, MIimage);
-   ncvarinq(in_vol->file->mincid, imgid, NULL, NULL, &ndims, dim, NULL);
-
-   /* Get the steps sizes (separations) of the input volume in order
-      to get an appropriate error margin (ftol) for the function
-      grid_inverse_transform_point */
-   for (idim_in=0; idim_in < in_vol->file->ndims; idim_in++) {
-           
-      /* Get size of dimension */
-      (void) ncdiminq(in_vol->file->mincid, dim[idim_in], dimname, 
-                      &in_vol->file->nelements[idim]);
-
-      /* Check for existence of variable */
-      dimid = ncvarid(in_vol->file->mincid, dimname);
-      if (dimid == MI_ERROR) continue;
-
-      /* Get attributes from variget_file_infoable */
-      (void) miattget1(in_vol->file->mincid, dimid, MIstep, 
-                       NC_DOUBLE, &separations[in_vol->file->world_axes[idim_in]]);
-
-      if (separations[in_vol->file->world_axes[idim_in]] == 0.0)
-          separations[in_vol->file->world_axes[idim_in]] = 1.0;
-   }
-
    /* Loop over rows of slice */
 
    for (irow=0; irow < slice->size[SLICE_ROW]; irow++) {
 
+      /* Restart the clock (the lattice counts as transformation) */
+      if ((transform_time != NULL) && (irow > 0)) 
+         time_start = profile_wall_time();
+
       /* Set starting coordinate of row */
       VECTOR_SCALAR_MULT(coord, row, irow);
       VECTOR_ADD(coord, coord, start);
 
-      /* Loop over columns */
+      /* Interpolate the transformed coordinates of this row at the
+         lattice columns from the lattice rows on either side */
+      if (lattice != NULL) {
+         ilat = MIN(irow / lattice_step, nlattice[SLICE_ROW] - 2);
+         if (ilat < 0) ilat = 0;
+         lpos = MIN(ilat * lattice_step, slice->size[SLICE_ROW] - 1);
+         lnext = MIN(lpos + lattice_step, slice->size[SLICE_ROW] - 1);
+         weight = (lnext > lpos) ? 
+            (double) (irow - lpos) / (double) (lnext - lpos) : 0.0;
+         for (jlat=0; jlat < nlattice[SLICE_COL]; jlat++) {
+            for (idim=0; idim < WORLD_NDIMS; idim++) {
+               row_lattice[jlat][idim] = 
+                  (1.0 - weight) * 
+                     lattice[ilat * nlattice[SLICE_COL] + jlat][idim];
+               if (lnext > lpos) {
+                  row_lattice[jlat][idim] += weight *
+                     lattice[(ilat+1) * nlattice[SLICE_COL] + jlat][idim];
+               }
+            }
+         }
+         jlat = 0;
+      }
 
-      dptr = slice->data + irow*slice->size[SLICE_COL];
+      /* Loop over columns, getting the coordinates of the row */
+
+      cptr = (coords == NULL) ? NULL : 
+         coords + irow * slice->size[SLICE_COL] * WORLD_NDIMS;
       for (icol=0; icol < slice->size[SLICE_COL]; icol++) {
 
+         /* If we have a lattice, copy the transformed coordinate at 
+            lattice points and step linearly towards the next one in 
+            between (cached coordinates are used as they are, below) */
+         if ((lattice != NULL) && !have_coords) {
+            lpos = MIN(jlat * lattice_step, slice->size[SLICE_COL] - 1);
+            if (icol == lpos) {
+               VECTOR_COPY(transf_coord, row_lattice[jlat]);
+               if (jlat < nlattice[SLICE_COL] - 1) {
+                  lnext = MIN(lpos + lattice_step, slice->size[SLICE_COL] - 1);
+                  VECTOR_DIFF(lattice_incr, row_lattice[jlat+1], 
+                              row_lattice[jlat]);
+                  VECTOR_SCALAR_MULT(lattice_incr, lattice_incr, 
+                                     1.0 / (double) (lnext - lpos));
+                  jlat++;
+               }
+            }
+            else {
+               VECTOR_ADD(transf_coord, transf_coord, lattice_incr);
+            }
+         }
+
          /* If transformation is not completely linear, then transform 
             voxel to world, world to world and world to voxel, as needed */
-         for (idim=0; idim<WORLD_NDIMS; idim++) 
-            transf_coord[idim]=coord[idim];
-         if (!all_linear) {
-            DO_TRANSFORM_WITH_INPUT_STEPS(transf_coord, &total_transf, transf_coord, separations);
+         else if (!have_coords) {
+            for (idim=0; idim<WORLD_NDIMS; idim++) 
+               transf_coord[idim]=coord[idim];
+            if (!all_linear) {
+               DO_TRANSFORM_WITH_INPUT_STEPS(transf_coord, total_transf, transf_coord, separations);
+            }
          }
 
-         /* Do interpolation */
-         if (INTERPOLATE(volume, transf_coord, dptr) || volume->use_fill) {
-            if (*dptr > *maximum) *maximum = *dptr;
-            if (*dptr < *minimum) *minimum = *dptr;
+         /* Save the coordinate in the cache and use the saved value, so 
+            that every volume is sampled at the same points */
+         if (cptr != NULL) {
+            if (!have_coords) {
+               for (idim=0; idim<WORLD_NDIMS; idim++) 
+                  cptr[idim] = (float) transf_coord[idim];
+            }
+            for (idim=0; idim<WORLD_NDIMS; idim++) 
+               row_coords[icol][idim] = cptr[idim] - origin[idim];
+            cptr += WORLD_NDIMS;
+         }
+         else {
+            VECTOR_DIFF(row_coords[icol], transf_coord, origin);
          }
 
          /* Increment coordinate */
          VECTOR_ADD(coord, coord, column);
 
-         /* Increment slice pointer */
-         dptr++;
-
       }     /* Loop over columns */
+
+      if (transform_time != NULL) {
+         time_coords = profile_wall_time();
+         *transform_time += time_coords - time_start;
+      }
+
+      /* Copy labels without any conversion */
+      if (raw_labels) {
+         nearest_neighbour_label_row(volume, slice->size[SLICE_COL], 
+                                     row_coords, 
+                                     (char *) slice->raw_data + 
+                                     irow * slice->size[SLICE_COL] *
+                                     nctypelen(volume->datatype),
+                                     row_inside);
+         if (interpolate_time != NULL) 
+            *interpolate_time += profile_wall_time() - time_coords;
+         continue;
+      }
+
+      /* Do interpolation */
+      dptr = slice->data + irow*slice->size[SLICE_COL];
+      if (volume->row_interpolant != NULL) {
+         INTERPOLATE_ROW(volume, slice->size[SLICE_COL], row_coords,
+                         dptr, row_inside);
+      }
+      else {
+         for (icol=0; icol < slice->size[SLICE_COL]; icol++) {
+            row_inside[icol] = INTERPOLATE(volume, row_coords[icol], 
+                                           &dptr[icol]);
+         }
+      }
+
+      /* Update maximum and minimum */
+      for (icol=0; icol < slice->size[SLICE_COL]; icol++) {
+         if (row_inside[icol] || volume->use_fill) {
+            if (dptr[icol] > *maximum) *maximum = dptr[icol];
+            if (dptr[icol] < *minimum) *minimum = dptr[icol];
+         }
+      }
+
+      if (interpolate_time != NULL) 
+         *interpolate_time += profile_wall_time() - time_coords;
+
    }        /* Loop over rows */
 
    if ((*maximum == -DBL_MAX) && (*minimum ==  DBL_MAX)) {
@@ -595,11 +1777,55 @@ void get_slice(long slice_num, VVolume *in_vol, VVolume *out_vol,
          *maximum = 2.0 * (*minimum);
    }
 
-   /* Delete the transformation */
-   delete_general_transform(&total_transf);
+   /* Free the row and the lattice */
+   free(row_coords);
+   free(row_inside);
+   if (lattice != NULL) {
+      free(lattice);
+      free(row_lattice);
+   }
 
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : transform_lattice
+@INPUT      : slice_num - number of output slice
+              slice - output slice (for its size)
+              total_transf - output voxel to input voxel transformation
+              separations - step sizes of input volume
+              lattice_step - spacing of lattice points (in output voxels)
+              nlattice - number of lattice points along rows and columns
+@OUTPUT     : lattice - transformed coordinates of lattice points (row
+                 major, nlattice[SLICE_ROW] * nlattice[SLICE_COL] points)
+@RETURNS    : (none)
+@DESCRIPTION: Transforms every lattice_step'th row and column of a slice
+              exactly. The last row and column of the slice are always 
+              included, so that interpolation never extrapolates.
+@METHOD     : 
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void transform_lattice(long slice_num, Slice_Data *slice,
+                              VIO_General_transform *total_transf,
+                              VIO_Real separations[], int lattice_step,
+                              long nlattice[], Coord_Vector lattice[])
+{
+   long ilat, jlat;
+   Coord_Vector coord;
+
+   coord[SLICE] = slice_num;
+   for (ilat=0; ilat < nlattice[SLICE_ROW]; ilat++) {
+      coord[ROW] = MIN(ilat * lattice_step, slice->size[SLICE_ROW] - 1);
+      for (jlat=0; jlat < nlattice[SLICE_COL]; jlat++) {
+         coord[COLUMN] = MIN(jlat * lattice_step, slice->size[SLICE_COL] - 1);
+         DO_TRANSFORM_WITH_INPUT_STEPS(lattice[ilat*nlattice[SLICE_COL]+jlat],
+                                       total_transf, coord, separations);
+      }
+   }
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : trilinear_interpolant
 @INPUT      : volume - pointer to volume data
@@ -620,8 +1846,8 @@ int trilinear_interpolant(Volume_Data *volume,
 {
    long slcind, rowind, colind, slcmax, rowmax, colmax;
    long slcnext, rownext, colnext;
-   static double f0, f1, f2, r0, r1, r2, r1r2, r1f2, f1r2, f1f2;
-   static double v000, v001, v010, v011, v100, v101, v110, v111;
+   double f0, f1, f2, r0, r1, r2, r1r2, r1f2, f1r2, f1f2;
+   double v000, v001, v010, v011, v100, v101, v110, v111;
 
    /* Check that the coordinate is inside the volume */
    slcmax = volume->size[SLC_AXIS] - 1;
@@ -707,11 +1933,11 @@ int trilinear_interpolant(Volume_Data *volume,
              f1r2 * v010 +
              f1f2 * v011) + volume->offset[slcind]);
    *result +=
-      f0 * (volume->scale[slcind+1] *
+      f0 * (volume->scale[slcnext] *
             (r1r2 * v100 +
              r1f2 * v101 +
              f1r2 * v110 +
-             f1f2 * v111) + volume->offset[slcind+1]);
+             f1f2 * v111) + volume->offset[slcnext]);
    
    return TRUE;
 
@@ -896,17 +2122,8 @@ int do_Ncubic_interpolation(Volume_Data *volume,
    /* Get fraction */
    u = frac[cur_dim];
 
-   /* Do tricubic interpolation (code from Dave MacDonald).
-      Gives v1 and v2 at u = 0 and 1 and gives continuity of intensity
-      and first derivative. */
-   *result =
-     ( (v1) + (u) * (
-       0.5 * ((v2)-(v0)) + (u) * (
-       (v0) - 2.5 * (v1) + 2.0 * (v2) - 0.5 * (v3) + (u) * (
-       -0.5 * (v0) + 1.5 * (v1) - 1.5 * (v2) + 0.5 * (v3)  )
-                                 )
-                    )
-     );
+   /* Do tricubic interpolation */
+   *result = CUBIC_INTERPOLATE(v0, v1, v2, v3, u);
 
    return TRUE;
 }
@@ -928,6 +2145,13 @@ int sinc_half_width = SINC_HALF_WIDTH_MAX / 2;
 
 enum sinc_interpolant_window_t sinc_window_type = SINC_WINDOW_HANNING;
 
+int sinc_use_table = FALSE;
+
+/* Table of weights, (2 * sinc_half_width + 1) for each of the
+   SINC_TABLE_BINS + 1 fractional offsets from 0 to 1 (set up by 
+   init_sinc_table) */
+static double *sinc_table = NULL;
+
 /* basic windowed sinc function */
 
 static double 
@@ -968,6 +2192,77 @@ windowed_sinc(double delta)
     return (sinc * window);
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : init_sinc_table
+@INPUT      : (none)
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Precomputes the windowed sinc weights for SINC_TABLE_BINS+1
+              evenly spaced fractional offsets, for the current window
+              type and half-width. Once this is called, get_sinc_weights
+              interpolates the weights from the table instead of
+              evaluating windowed_sinc.
+@METHOD     : 
+@GLOBALS    : sinc_half_width, sinc_window_type, sinc_table
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void init_sinc_table(void)
+{
+    int nweights, ibin, i;
+    double frac;
+
+    nweights = 2 * sinc_half_width + 1;
+    if (sinc_table != NULL) {
+        free(sinc_table);
+    }
+    sinc_table = malloc(sizeof(double) * nweights * (SINC_TABLE_BINS + 1));
+
+    for (ibin = 0; ibin <= SINC_TABLE_BINS; ibin++) {
+        frac = (double) ibin / (double) SINC_TABLE_BINS;
+        for (i = -sinc_half_width; i <= sinc_half_width; i++) {
+            sinc_table[ibin * nweights + i + sinc_half_width] = 
+                windowed_sinc(frac - i);
+        }
+    }
+}
+
+/* Get the 2 * sinc_half_width + 1 weights for a fractional offset 
+   (0 <= frac < 1) and their total, either directly or from the table */
+static void
+get_sinc_weights(double frac, double weights[], double *total)
+{
+    int nweights, i;
+    long ibin;
+    double position, alpha;
+    double *lower, *upper;
+
+    *total = 0.0;
+
+    if (sinc_table == NULL) {
+        for (i = -sinc_half_width; i <= sinc_half_width; i++) {
+            weights[i + sinc_half_width] = windowed_sinc(frac - i);
+            *total += weights[i + sinc_half_width];
+        }
+        return;
+    }
+
+    /* Interpolate linearly between the two nearest table entries */
+    nweights = 2 * sinc_half_width + 1;
+    position = frac * SINC_TABLE_BINS;
+    ibin = (long) position;
+    if (ibin < 0) ibin = 0;
+    if (ibin > SINC_TABLE_BINS - 1) ibin = SINC_TABLE_BINS - 1;
+    alpha = position - ibin;
+    lower = &sinc_table[ibin * nweights];
+    upper = lower + nweights;
+    for (i = 0; i < nweights; i++) {
+        weights[i] = lower[i] + alpha * (upper[i] - lower[i]);
+        *total += weights[i];
+    }
+}
+
 /* Floating-point (unscaled) multiply/accumulate operations */
 #define SINC_FRND result += *pix_ptr++ * *win_ptr++
 
@@ -1172,7 +2467,7 @@ windowed_sinc_interpolant(Volume_Data *volume, Coord_Vector coord,
     int zi, yi, xi;
     int i, j;
     double new;
-    double tmp;
+    double tmp = 0.0;
     long slcmax, rowmax, colmax;
     double zw[SINC_HALF_WIDTH_MAX * 2 + 1];
     double yw[SINC_HALF_WIDTH_MAX * 2 + 1];
@@ -1206,27 +2501,11 @@ windowed_sinc_interpolant(Volume_Data *volume, Coord_Vector coord,
     yf = coord[ROW] - yi;
     xf = coord[COLUMN] - xi;
     
-    /* Initialize the totals.
+    /* Generate the three windowed sinc functions and their totals.
      */
-    zt = 0.0;
-    yt = 0.0;
-    xt = 0.0;
-
-    /* Generate the three windowed sinc functions.
-     */
-    for (i = -sinc_half_width; i <= sinc_half_width; i++) {
-        tmp = windowed_sinc(zf - i);
-        zw[i + sinc_half_width] = tmp;
-        zt += tmp;
-        
-        tmp = windowed_sinc(yf - i);
-        yw[i + sinc_half_width] = tmp;
-        yt += tmp;
-        
-        tmp = windowed_sinc(xf - i);
-        xw[i + sinc_half_width] = tmp;
-        xt += tmp;
-    }
+    get_sinc_weights(zf, zw, &zt);
+    get_sinc_weights(yf, yw, &yt);
+    get_sinc_weights(xf, xw, &xt);
 
     /* Now calculate the new value.
      */
@@ -1308,6 +2587,242 @@ windowed_sinc_interpolant(Volume_Data *volume, Coord_Vector coord,
     return TRUE;
 }
 
+/* Add weight times the (scaled) values of n voxels of an input line
+   along axis, starting at voxel index, to line. Along slices the scale
+   changes from voxel to voxel. */
+#define SINC_LINE_FMAC(type) \
+    { \
+        type *pix_ptr = (type *) volume->data + offset; \
+        for (ix = 0; ix < n; ix++) \
+            line[ix] += weight * pix_ptr[ix * stride]; \
+    }
+#define SINC_LINE_IMAC(type) \
+    { \
+        type *pix_ptr = (type *) volume->data + offset; \
+        if (axis != SLICE) { \
+            for (ix = 0; ix < n; ix++) \
+                line[ix] += weight * \
+                    ((slope * pix_ptr[ix * stride]) + intercept); \
+        } \
+        else { \
+            for (ix = 0; ix < n; ix++) \
+                line[ix] += weight * \
+                    ((volume->scale[z + ix] * pix_ptr[ix * stride]) + \
+                     volume->offset[z + ix]); \
+        } \
+    }
+
+static void
+sinc_accumulate_line(Volume_Data *volume, int index[], int axis, long n,
+                     double weight, double line[])
+{
+    int z = index[SLICE];
+    double slope = volume->scale[z];
+    double intercept = volume->offset[z];
+    long offset, stride, ix;
+
+    offset = ((long) z * volume->size[ROW_AXIS] + index[ROW]) * 
+        volume->size[COL_AXIS] + index[COLUMN];
+    switch (axis) {
+    case SLICE:
+        stride = volume->size[ROW_AXIS] * volume->size[COL_AXIS];
+        break;
+    case ROW:
+        stride = volume->size[COL_AXIS];
+        break;
+    default:
+        stride = 1;
+        break;
+    }
+
+    switch (volume->datatype) {
+    case NC_BYTE:
+        if (volume->is_signed)
+            SINC_LINE_IMAC(signed char)
+        else
+            SINC_LINE_IMAC(unsigned char)
+        break;
+    case NC_SHORT:
+        if (volume->is_signed)
+            SINC_LINE_IMAC(short)
+        else
+            SINC_LINE_IMAC(unsigned short)
+        break;
+    case NC_INT:
+        if (volume->is_signed)
+            SINC_LINE_IMAC(int)
+        else
+            SINC_LINE_IMAC(unsigned int)
+        break;
+    case NC_FLOAT:
+        SINC_LINE_FMAC(float)
+        break;
+    case NC_DOUBLE:
+        SINC_LINE_FMAC(double)
+        break;
+    default:
+        fprintf(stderr, "UNHANDLED TYPE!!!\n");
+        break;
+    }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : windowed_sinc_interpolant_row
+@INPUT      : volume - pointer to volume data
+              npoints - number of points to interpolate
+              coords - points at which volume should be interpolated in
+                 voxel units (with 0 being first point of the volume).
+@OUTPUT     : result - interpolated values.
+              inside - TRUE for each point within the volume, FALSE 
+                 otherwise.
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to interpolate a volume at a row of points with 
+              windowed sinc interpolation. Gives the same results as 
+              windowed_sinc_interpolant for each point, up to rounding.
+@METHOD     : If all points of the row share the same coordinate along 
+              two of the input axes (the output row runs along the 
+              input columns, rows or slices, as for a change of 
+              orientation or a zoom), the kernel is separable: the 
+              weights for those two axes are applied once to collapse 
+              the (2w+1)^2 input lines around the output row onto a 
+              single line, and each point then only needs a 1-d pass of
+              2w+1 taps along that line. Rows that cross the input axes 
+              (rotations and non-linear transformations) are done point
+              by point; separating those would need the resampling to be
+              decomposed into shears.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+void
+windowed_sinc_interpolant_row(Volume_Data *volume, long npoints,
+                              Coord_Vector coords[], 
+                              double result[], int inside[])
+{
+    long ipoint, lo, hi, il;
+    long vmax[VOL_NDIMS];
+    int axis, fixed[2], centre[2], index[VOL_NDIMS];
+    int idim, ifixed, ci, i, j;
+    double total[2], wt;
+    double frac, new;
+    double *coord, *line;
+    double weights[2][SINC_HALF_WIDTH_MAX * 2 + 1];
+    double w[SINC_HALF_WIDTH_MAX * 2 + 1];
+
+    for (idim = 0; idim < VOL_NDIMS; idim++) {
+        vmax[idim] = volume->size[idim] - 1;
+    }
+
+    /* Look for an input axis along which the row runs, with the other
+       two coordinates the same for every point */
+    axis = -1;
+    for (idim = VOL_NDIMS - 1; (idim >= 0) && (axis < 0) && (npoints > 1);
+         idim--) {
+        axis = idim;
+        for (ipoint = 1; (ipoint < npoints) && (axis >= 0); ipoint++) {
+            for (ifixed = 0; ifixed < VOL_NDIMS; ifixed++) {
+                if ((ifixed != idim) && 
+                    (coords[ipoint][ifixed] != coords[0][ifixed])) {
+                    axis = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    /* The fixed coordinates must be away from the edges of the volume */
+    if (axis >= 0) {
+        ifixed = 0;
+        for (idim = 0; idim < VOL_NDIMS; idim++) {
+            if (idim != axis) fixed[ifixed++] = idim;
+        }
+        for (ifixed = 0; (ifixed < 2) && (axis >= 0); ifixed++) {
+            idim = fixed[ifixed];
+            centre[ifixed] = (int) coords[0][idim];
+            if ((coords[0][idim] < 0) || (coords[0][idim] > vmax[idim]) ||
+                (centre[ifixed] < sinc_half_width) ||
+                (centre[ifixed] > vmax[idim] - sinc_half_width)) {
+                axis = -1;
+            }
+        }
+    }
+
+    /* Find the span of the input line needed */
+    lo = (axis >= 0) ? vmax[axis] + 1 : 0;
+    hi = -1;
+    for (ipoint = 0; (ipoint < npoints) && (axis >= 0); ipoint++) {
+        coord = coords[ipoint];
+        if ((coord[axis] < 0) || (coord[axis] > vmax[axis])) continue;
+        ci = (int) coord[axis];
+        if ((ci < sinc_half_width) || (ci > vmax[axis] - sinc_half_width)) 
+            continue;
+        if (ci - sinc_half_width < lo) lo = ci - sinc_half_width;
+        if (ci + sinc_half_width > hi) hi = ci + sinc_half_width;
+    }
+
+    /* Otherwise do it point by point */
+    if ((axis < 0) || (hi < lo)) {
+        for (ipoint = 0; ipoint < npoints; ipoint++) {
+            inside[ipoint] = windowed_sinc_interpolant(volume, 
+                                                       coords[ipoint],
+                                                       &result[ipoint]);
+        }
+        return;
+    }
+
+    /* Apply the weights of the two fixed axes, collapsing the input 
+       lines onto a line from lo to hi along axis */
+    for (ifixed = 0; ifixed < 2; ifixed++) {
+        frac = coords[0][fixed[ifixed]] - centre[ifixed];
+        get_sinc_weights(frac, weights[ifixed], &total[ifixed]);
+    }
+    line = malloc(sizeof(double) * (hi - lo + 1));
+    for (il = 0; il <= hi - lo; il++) {
+        line[il] = 0.0;
+    }
+    index[axis] = lo;
+    for (i = -sinc_half_width; i <= sinc_half_width; i++) {
+        index[fixed[0]] = centre[0] + i;
+        for (j = -sinc_half_width; j <= sinc_half_width; j++) {
+            index[fixed[1]] = centre[1] + j;
+            sinc_accumulate_line(volume, index, axis, hi - lo + 1,
+                                 weights[0][i + sinc_half_width] * 
+                                 weights[1][j + sinc_half_width],
+                                 line);
+        }
+    }
+
+    /* Now apply the weights along the line for each point */
+    for (ipoint = 0; ipoint < npoints; ipoint++) {
+        coord = coords[ipoint];
+        if ((coord[axis] < 0) || (coord[axis] > vmax[axis])) {
+            result[ipoint] = volume->fillvalue;
+            inside[ipoint] = FALSE;
+            continue;
+        }
+        ci = (int) coord[axis];
+
+        /* Check for edges - do linear interpolation at edges */
+        if ((ci < sinc_half_width) || (ci > vmax[axis] - sinc_half_width)) {
+            inside[ipoint] = trilinear_interpolant(volume, coord, 
+                                                   &result[ipoint]);
+            continue;
+        }
+
+        frac = coord[axis] - ci;
+        get_sinc_weights(frac, w, &wt);
+        new = 0.0;
+        for (i = 0; i < 2 * sinc_half_width + 1; i++) {
+            new += w[i] * line[ci - sinc_half_width - lo + i];
+        }
+        result[ipoint] = (new / (total[0] * total[1] * wt));
+        inside[ipoint] = TRUE;
+    }
+
+    free(line);
+}
+
 
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : nearest_neighbour_interpolant
@@ -1359,6 +2874,110 @@ int nearest_neighbour_interpolant(Volume_Data *volume,
 
 }
 
+/* Number of fractional offsets at which the largest interpolation gain 
+   is sought */
+#define GAIN_SAMPLES 1024
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_interpolant_gain
+@INPUT      : type - type of interpolation
+@OUTPUT     : (none)
+@RETURNS    : Largest sum of absolute values of the (normalized) weights 
+              applied to the voxels along one axis.
+@DESCRIPTION: Finds how far an interpolant can overshoot the range of the
+              voxels it combines. Nearest neighbour and trilinear 
+              interpolation never overshoot and have a gain of one; the
+              cubic and sinc kernels have negative lobes and a gain 
+              greater than one.
+@METHOD     : The weights are evaluated at GAIN_SAMPLES+1 evenly spaced
+              fractional offsets. The sinc weights are those for the 
+              current window type and half-width.
+@GLOBALS    : sinc_half_width
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+double get_interpolant_gain(enum Interpolant_type type)
+{
+   double weights[2 * SINC_HALF_WIDTH_MAX + 1];
+   double frac, total, sum, gain;
+   int isample, i, nweights;
+
+   gain = 1.0;
+   for (isample=0; isample <= GAIN_SAMPLES; isample++) {
+      frac = (double) isample / (double) GAIN_SAMPLES;
+      switch (type) {
+      case TRICUBIC:
+         nweights = 4;
+         weights[0] = CUBIC_INTERPOLATE(1.0, 0.0, 0.0, 0.0, frac);
+         weights[1] = CUBIC_INTERPOLATE(0.0, 1.0, 0.0, 0.0, frac);
+         weights[2] = CUBIC_INTERPOLATE(0.0, 0.0, 1.0, 0.0, frac);
+         weights[3] = CUBIC_INTERPOLATE(0.0, 0.0, 0.0, 1.0, frac);
+         total = 1.0;
+         break;
+      case WINDOWED_SINC:
+         nweights = 2 * sinc_half_width + 1;
+         get_sinc_weights(frac, weights, &total);
+         break;
+      default:
+         return 1.0;
+      }
+      if (total == 0.0) continue;
+      for (sum=0.0, i=0; i < nweights; i++)
+         sum += fabs(weights[i]);
+      sum /= fabs(total);
+      if (sum > gain) gain = sum;
+   }
+
+   return gain;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_analytic_range
+@INPUT      : volume - description of input volume (for its interpolant 
+                 gain and fill value)
+              real_range - real range of the input volume
+@OUTPUT     : range - range that contains every interpolated value
+@RETURNS    : (nothing)
+@DESCRIPTION: Works out the output real range of a volume without 
+              resampling it, so that every slice can be written once with
+              its final scaling.
+@METHOD     : Interpolated values are weighted sums of input values with 
+              weights adding up to one. With a gain of g along each axis, 
+              the negative weights add up to at most (g^3 - 1)/2, which 
+              bounds how far the result can fall outside the input range.
+              The fill value is included when it counts towards the 
+              output max and min.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_analytic_range(Volume_Data *volume, double real_range[],
+                               double range[])
+{
+   double overshoot;
+
+   overshoot = (volume->gain * volume->gain * volume->gain - 1.0) / 2.0 *
+      (real_range[1] - real_range[0]);
+   range[0] = real_range[0] - overshoot;
+   range[1] = real_range[1] + overshoot;
+   if (volume->use_fill) {
+      if (volume->fillvalue < range[0]) range[0] = volume->fillvalue;
+      if (volume->fillvalue > range[1]) range[1] = volume->fillvalue;
+   }
+
+   /* Make sure that the range is not empty (as in get_slice) */
+   if (range[1] <= range[0]) {
+      if (range[0] == 0.0) 
+         range[1] = SMALL_VALUE;
+      else if (range[0] < 0.0)
+         range[1] = 0.0;
+      else
+         range[1] = 2.0 * range[0];
+   }
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : renormalize_slices
 @INPUT      : ofp - output file pointer
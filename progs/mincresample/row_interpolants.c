@@ -0,0 +1,535 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : row_interpolants.c
+@DESCRIPTION: Routines to interpolate a whole row of points at a time
+              for mincresample. These give the same results as the
+              single-point interpolants in resample_volumes.c, but
+              the switch on the volume data type is done once per row
+              and the inner loops work directly on the native type of
+              the volume data, so that there is no function call, type
+              switch or scale lookup per voxel and the loop constants
+              stay in registers. The loops are not vectorized: each
+              point has its own voxel addresses and branches on the
+              volume edges and on invalid voxels, and a branch-free form
+              (clamped indices and masked results) would need gathers of
+              8 and 16-bit voxels, which the target instruction sets do
+              not provide.
+@METHOD     : Each row interpolant has one loop per volume data type,
+              generated from a macro. The arithmetic is written in
+              exactly the same order as in the single-point routines,
+              so results are bit-for-bit identical unless the compiler
+              is allowed to contract multiplies and adds into fused
+              multiply-adds (-ffp-contract=fast with FMA instructions
+              enabled), in which case they can differ by a few units in
+              the last place (relative difference < 1e-12). The
+              bench_interpolants program checks this. Data types without
+              a specialized loop, and points for which the single-point
+              routine falls back to another method (volume edges for
+              tricubic, 2-d images), use the single-point routines.
+              nearest_neighbour_label_row is the exception: it copies
+              label voxels in their own type and has no double result.
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1993 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#include <math.h>
+#include <minc.h>
+#include <volume_io.h>
+#include "mincresample.h"
+
+/* Check whether a value read from the volume is outside the valid range
+   (ie. is a fill value) */
+#define IS_FILL(value) \
+   (((value) < vmin) || ((value) > vmax))
+
+/* Trilinear interpolation of a row of points for volume data of a given
+   type. See trilinear_interpolant for the details. Offsets to the next
+   voxel along a dimension of length one are zero. */
+#define TRILINEAR_ROW(type) \
+{ \
+   type *data = (type *) volume->data; \
+   long slcmax = volume->size[SLC_AXIS] - 1; \
+   long rowmax = volume->size[ROW_AXIS] - 1; \
+   long colmax = volume->size[COL_AXIS] - 1; \
+   long slcsize = volume->size[ROW_AXIS] * volume->size[COL_AXIS]; \
+   long rowsize = volume->size[COL_AXIS]; \
+   long dslc = (slcmax == 0) ? 0 : slcsize; \
+   long drow = (rowmax == 0) ? 0 : rowsize; \
+   long dcol = (colmax == 0) ? 0 : 1; \
+   double vmin = volume->vrange[0]; \
+   double vmax = volume->vrange[1]; \
+   double fillvalue = volume->fillvalue; \
+   long ipoint, slcind, rowind, colind, slcnext; \
+   type *p; \
+   double *coord; \
+   double f0, f1, f2, r0, r1, r2, r1r2, r1f2, f1r2, f1f2; \
+   double v000, v001, v010, v011, v100, v101, v110, v111; \
+ \
+   for (ipoint=0; ipoint < npoints; ipoint++) { \
+      coord = coords[ipoint]; \
+ \
+      /* Check that the coordinate is inside the volume */ \
+      if ((coord[SLICE]  < -VOXEL_COORD_EPS) ||  \
+          (coord[SLICE]  > slcmax+VOXEL_COORD_EPS) || \
+          (coord[ROW]    < -VOXEL_COORD_EPS) ||  \
+          (coord[ROW]    > rowmax+VOXEL_COORD_EPS) || \
+          (coord[COLUMN] < -VOXEL_COORD_EPS) ||  \
+          (coord[COLUMN] > colmax+VOXEL_COORD_EPS)) { \
+         result[ipoint] = fillvalue; \
+         inside[ipoint] = FALSE; \
+         continue; \
+      } \
+ \
+      /* Get the whole part of the coordinate */ \
+      slcind = (long) coord[SLICE]; \
+      rowind = (long) coord[ROW]; \
+      colind = (long) coord[COLUMN]; \
+      if (slcind >= slcmax-1) slcind = slcmax-1; \
+      if (rowind >= rowmax-1) rowind = rowmax-1; \
+      if (colind >= colmax-1) colind = colmax-1; \
+      if (slcmax == 0) slcind = 0; \
+      if (rowmax == 0) rowind = 0; \
+      if (colmax == 0) colind = 0; \
+      slcnext = (slcmax == 0) ? slcind : slcind+1; \
+ \
+      /* Get the relevant voxels */ \
+      p = data + slcind*slcsize + rowind*rowsize + colind; \
+      v000 = p[0]; \
+      v001 = p[dcol]; \
+      v010 = p[drow]; \
+      v011 = p[drow+dcol]; \
+      v100 = p[dslc]; \
+      v101 = p[dslc+dcol]; \
+      v110 = p[dslc+drow]; \
+      v111 = p[dslc+drow+dcol]; \
+ \
+      /* Check that the values are not fill values */ \
+      if (IS_FILL(v000) || IS_FILL(v001) || IS_FILL(v010) || \
+          IS_FILL(v011) || IS_FILL(v100) || IS_FILL(v101) || \
+          IS_FILL(v110) || IS_FILL(v111)) { \
+         result[ipoint] = fillvalue; \
+         inside[ipoint] = FALSE; \
+         continue; \
+      } \
+ \
+      /* Do the interpolation */ \
+      f0 = coord[SLICE]  - slcind; \
+      f1 = coord[ROW]    - rowind; \
+      f2 = coord[COLUMN] - colind; \
+      r0 = 1.0 - f0; \
+      r1 = 1.0 - f1; \
+      r2 = 1.0 - f2; \
+      r1r2 = r1 * r2; \
+      r1f2 = r1 * f2; \
+      f1r2 = f1 * r2; \
+      f1f2 = f1 * f2; \
+      result[ipoint] = \
+         r0 * (volume->scale[slcind] * \
+               (r1r2 * v000 + \
+                r1f2 * v001 + \
+                f1r2 * v010 + \
+                f1f2 * v011) + volume->offset[slcind]); \
+      result[ipoint] += \
+         f0 * (volume->scale[slcnext] * \
+               (r1r2 * v100 + \
+                r1f2 * v101 + \
+                f1r2 * v110 + \
+                f1f2 * v111) + volume->offset[slcnext]); \
+      inside[ipoint] = TRUE; \
+   } \
+}
+
+/* Tricubic interpolation of a row of points for volume data of a given
+   type. See tricubic_interpolant and do_Ncubic_interpolation for the
+   details: the 4x4x4 neighbourhood is interpolated along columns, then
+   rows, then (after scaling) slices. */
+#define TRICUBIC_ROW(type) \
+{ \
+   type *data = (type *) volume->data; \
+   long slcmax = volume->size[SLC_AXIS] - 1; \
+   long rowmax = volume->size[ROW_AXIS] - 1; \
+   long colmax = volume->size[COL_AXIS] - 1; \
+   long slcsize = volume->size[ROW_AXIS] * volume->size[COL_AXIS]; \
+   long rowsize = volume->size[COL_AXIS]; \
+   double vmin = volume->vrange[0]; \
+   double vmax = volume->vrange[1]; \
+   double fillvalue = volume->fillvalue; \
+   long ipoint, slcind, rowind, colind; \
+   int islc, irow, found_fillvalue; \
+   type *p; \
+   double *coord; \
+   double frac[VOL_NDIMS], v0, v1, v2, v3; \
+   double line[4], plane[4]; \
+ \
+   for (ipoint=0; ipoint < npoints; ipoint++) { \
+      coord = coords[ipoint]; \
+ \
+      /* 2-d images are left to the single-point routine */ \
+      if (slcmax == 0) { \
+         inside[ipoint] = \
+            tricubic_interpolant(volume, coord, &result[ipoint]); \
+         continue; \
+      } \
+ \
+      /* Check that the coordinate is inside the volume */ \
+      if ((coord[SLICE]  < 0) || (coord[SLICE]  > slcmax) || \
+          (coord[ROW]    < 0) || (coord[ROW]    > rowmax) || \
+          (coord[COLUMN] < 0) || (coord[COLUMN] > colmax)) { \
+         result[ipoint] = fillvalue; \
+         inside[ipoint] = FALSE; \
+         continue; \
+      } \
+ \
+      /* Get the whole and fractional part of the coordinate */ \
+      slcind = (long) coord[SLICE]; \
+      rowind = (long) coord[ROW]; \
+      colind = (long) coord[COLUMN]; \
+      frac[0] = coord[SLICE]  - slcind; \
+      frac[1] = coord[ROW]    - rowind; \
+      frac[2] = coord[COLUMN] - colind; \
+      slcind--; \
+      rowind--; \
+      colind--; \
+ \
+      /* Do linear interpolation at edges */ \
+      if ((slcind > slcmax-3) || (slcind < 0) || \
+          (rowind > rowmax-3) || (rowind < 0) || \
+          (colind > colmax-3) || (colind < 0)) { \
+         inside[ipoint] = \
+            trilinear_interpolant(volume, coord, &result[ipoint]); \
+         continue; \
+      } \
+ \
+      /* Interpolate along columns and rows for each slice */ \
+      found_fillvalue = FALSE; \
+      for (islc=0; islc < 4; islc++) { \
+         for (irow=0; irow < 4; irow++) { \
+            p = data + (slcind+islc)*slcsize + (rowind+irow)*rowsize + \
+               colind; \
+            v0 = p[0]; \
+            v1 = p[1]; \
+            v2 = p[2]; \
+            v3 = p[3]; \
+            if (IS_FILL(v0) || IS_FILL(v1) || IS_FILL(v2) || IS_FILL(v3)) \
+               found_fillvalue = TRUE; \
+            line[irow] = CUBIC_INTERPOLATE(v0, v1, v2, v3, frac[2]); \
+         } \
+         plane[islc] = CUBIC_INTERPOLATE(line[0], line[1], line[2], \
+                                         line[3], frac[1]); \
+      } \
+      if (found_fillvalue) { \
+         result[ipoint] = fillvalue; \
+         inside[ipoint] = FALSE; \
+         continue; \
+      } \
+ \
+      /* Scale values for slices and interpolate between them */ \
+      for (islc=0; islc < 4; islc++) { \
+         plane[islc] = plane[islc] * volume->scale[slcind+islc] + \
+            volume->offset[slcind+islc]; \
+      } \
+      result[ipoint] = CUBIC_INTERPOLATE(plane[0], plane[1], plane[2], \
+                                         plane[3], frac[0]); \
+      inside[ipoint] = TRUE; \
+   } \
+}
+
+/* Nearest neighbour lookup of a row of points in a label volume of a 
+   given type, copying voxel values without conversion. See
+   nearest_neighbour_interpolant for the details. */
+#define NEAREST_LABEL_ROW(type) \
+{ \
+   type *data = (type *) volume->data; \
+   type *values = (type *) result; \
+   type fill = (type) volume->voxel_fillvalue; \
+   long slcmax = volume->size[SLC_AXIS] - 1; \
+   long rowmax = volume->size[ROW_AXIS] - 1; \
+   long colmax = volume->size[COL_AXIS] - 1; \
+   long slcsize = volume->size[ROW_AXIS] * volume->size[COL_AXIS]; \
+   long rowsize = volume->size[COL_AXIS]; \
+   double vmin = volume->vrange[0]; \
+   double vmax = volume->vrange[1]; \
+   long ipoint, slcind, rowind, colind; \
+   type value; \
+ \
+   for (ipoint=0; ipoint < npoints; ipoint++) { \
+      slcind = VIO_ROUND(coords[ipoint][SLICE]); \
+      rowind = VIO_ROUND(coords[ipoint][ROW]); \
+      colind = VIO_ROUND(coords[ipoint][COLUMN]); \
+      if ((slcind < 0) || (slcind > slcmax) || \
+          (rowind < 0) || (rowind > rowmax) || \
+          (colind < 0) || (colind > colmax)) { \
+         values[ipoint] = fill; \
+         inside[ipoint] = FALSE; \
+         continue; \
+      } \
+      value = data[slcind * slcsize + rowind * rowsize + colind]; \
+      if (IS_FILL(value)) { \
+         values[ipoint] = fill; \
+         inside[ipoint] = FALSE; \
+      } \
+      else { \
+         values[ipoint] = value; \
+         inside[ipoint] = TRUE; \
+      } \
+   } \
+}
+
+/* Type-specialized row loops */
+
+static void trilinear_row_uc(Volume_Data *volume, long npoints,
+                             Coord_Vector coords[], double result[],
+                             int inside[])
+TRILINEAR_ROW(unsigned char)
+
+static void trilinear_row_ss(Volume_Data *volume, long npoints,
+                             Coord_Vector coords[], double result[],
+                             int inside[])
+TRILINEAR_ROW(short)
+
+static void trilinear_row_us(Volume_Data *volume, long npoints,
+                             Coord_Vector coords[], double result[],
+                             int inside[])
+TRILINEAR_ROW(unsigned short)
+
+static void trilinear_row_f(Volume_Data *volume, long npoints,
+                            Coord_Vector coords[], double result[],
+                            int inside[])
+TRILINEAR_ROW(float)
+
+static void tricubic_row_uc(Volume_Data *volume, long npoints,
+                            Coord_Vector coords[], double result[],
+                            int inside[])
+TRICUBIC_ROW(unsigned char)
+
+static void tricubic_row_ss(Volume_Data *volume, long npoints,
+                            Coord_Vector coords[], double result[],
+                            int inside[])
+TRICUBIC_ROW(short)
+
+static void tricubic_row_us(Volume_Data *volume, long npoints,
+                            Coord_Vector coords[], double result[],
+                            int inside[])
+TRICUBIC_ROW(unsigned short)
+
+static void tricubic_row_f(Volume_Data *volume, long npoints,
+                           Coord_Vector coords[], double result[],
+                           int inside[])
+TRICUBIC_ROW(float)
+
+static void nearest_label_row_sc(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[], void *result,
+                                 int inside[])
+NEAREST_LABEL_ROW(signed char)
+
+static void nearest_label_row_uc(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[], void *result,
+                                 int inside[])
+NEAREST_LABEL_ROW(unsigned char)
+
+static void nearest_label_row_ss(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[], void *result,
+                                 int inside[])
+NEAREST_LABEL_ROW(short)
+
+static void nearest_label_row_us(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[], void *result,
+                                 int inside[])
+NEAREST_LABEL_ROW(unsigned short)
+
+static void nearest_label_row_si(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[], void *result,
+                                 int inside[])
+NEAREST_LABEL_ROW(int)
+
+static void nearest_label_row_ui(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[], void *result,
+                                 int inside[])
+NEAREST_LABEL_ROW(unsigned int)
+
+static void nearest_label_row_f(Volume_Data *volume, long npoints,
+                                Coord_Vector coords[], void *result,
+                                int inside[])
+NEAREST_LABEL_ROW(float)
+
+static void nearest_label_row_d(Volume_Data *volume, long npoints,
+                                Coord_Vector coords[], void *result,
+                                int inside[])
+NEAREST_LABEL_ROW(double)
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : trilinear_interpolant_row
+@INPUT      : volume - pointer to volume data
+              npoints - number of points to interpolate
+              coords - points at which volume should be interpolated in
+                 voxel units (with 0 being first point of the volume).
+@OUTPUT     : result - interpolated values.
+              inside - TRUE for each point within the volume, FALSE
+                 otherwise.
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to interpolate a volume at a row of points with
+              tri-linear interpolation. Gives the same results as calling
+              trilinear_interpolant for each point.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void trilinear_interpolant_row(Volume_Data *volume, long npoints,
+                               Coord_Vector coords[],
+                               double result[], int inside[])
+{
+   long ipoint;
+
+   switch (volume->datatype) {
+   case NC_BYTE:
+      if (!volume->is_signed) {
+         trilinear_row_uc(volume, npoints, coords, result, inside);
+         return;
+      }
+      break;
+   case NC_SHORT:
+      if (volume->is_signed)
+         trilinear_row_ss(volume, npoints, coords, result, inside);
+      else
+         trilinear_row_us(volume, npoints, coords, result, inside);
+      return;
+   case NC_FLOAT:
+      trilinear_row_f(volume, npoints, coords, result, inside);
+      return;
+   default:
+      break;
+   }
+
+   /* Other types go through the single-point routine */
+   for (ipoint=0; ipoint < npoints; ipoint++) {
+      inside[ipoint] =
+         trilinear_interpolant(volume, coords[ipoint], &result[ipoint]);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : tricubic_interpolant_row
+@INPUT      : volume - pointer to volume data
+              npoints - number of points to interpolate
+              coords - points at which volume should be interpolated in
+                 voxel units (with 0 being first point of the volume).
+@OUTPUT     : result - interpolated values.
+              inside - TRUE for each point within the volume, FALSE
+                 otherwise.
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to interpolate a volume at a row of points with
+              tri-cubic interpolation. Gives the same results as calling
+              tricubic_interpolant for each point.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void tricubic_interpolant_row(Volume_Data *volume, long npoints,
+                              Coord_Vector coords[],
+                              double result[], int inside[])
+{
+   long ipoint;
+
+   switch (volume->datatype) {
+   case NC_BYTE:
+      if (!volume->is_signed) {
+         tricubic_row_uc(volume, npoints, coords, result, inside);
+         return;
+      }
+      break;
+   case NC_SHORT:
+      if (volume->is_signed)
+         tricubic_row_ss(volume, npoints, coords, result, inside);
+      else
+         tricubic_row_us(volume, npoints, coords, result, inside);
+      return;
+   case NC_FLOAT:
+      tricubic_row_f(volume, npoints, coords, result, inside);
+      return;
+   default:
+      break;
+   }
+
+   /* Other types go through the single-point routine */
+   for (ipoint=0; ipoint < npoints; ipoint++) {
+      inside[ipoint] =
+         tricubic_interpolant(volume, coords[ipoint], &result[ipoint]);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : nearest_neighbour_label_row
+@INPUT      : volume - pointer to volume data
+              npoints - number of points to look up
+              coords - points at which volume should be sampled in
+                 voxel units (with 0 being first point of the volume).
+@OUTPUT     : result - voxel values, in the type of the volume data.
+              inside - TRUE for each point within the volume, FALSE
+                 otherwise.
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to sample a label volume at a row of points with
+              nearest neighbour interpolation. Voxel values are copied
+              as they are, without scaling to real values, so labels
+              can never be changed by rounding. Points outside the volume
+              or on an invalid voxel get volume->voxel_fillvalue.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void nearest_neighbour_label_row(Volume_Data *volume, long npoints,
+                                 Coord_Vector coords[],
+                                 void *result, int inside[])
+{
+   switch (volume->datatype) {
+   case NC_BYTE:
+      if (volume->is_signed)
+         nearest_label_row_sc(volume, npoints, coords, result, inside);
+      else
+         nearest_label_row_uc(volume, npoints, coords, result, inside);
+      break;
+   case NC_SHORT:
+      if (volume->is_signed)
+         nearest_label_row_ss(volume, npoints, coords, result, inside);
+      else
+         nearest_label_row_us(volume, npoints, coords, result, inside);
+      break;
+   case NC_INT:
+      if (volume->is_signed)
+         nearest_label_row_si(volume, npoints, coords, result, inside);
+      else
+         nearest_label_row_ui(volume, npoints, coords, result, inside);
+      break;
+   case NC_FLOAT:
+      nearest_label_row_f(volume, npoints, coords, result, inside);
+      break;
+   case NC_DOUBLE:
+      nearest_label_row_d(volume, npoints, coords, result, inside);
+      break;
+   default:
+      (void) fprintf(stderr, "Unknown type for label volume\n");
+      exit(EXIT_FAILURE);
+   }
+}
@@ -0,0 +1,211 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : bench_reorder.c
+@DESCRIPTION: Benchmark for the dimension reordering of mincreshape. Moves
+              a synthetic 4-d short volume with time as the last (fastest)
+              dimension to a netcdf file with time as the first dimension,
+              one slice of the input at a time, in two ways: with an imap
+              vector in ncvarputg (the old mincreshape path) and with
+              reorder_data followed by a contiguous ncvarput. Reports the
+              time of each, the time of reorder_data alone, and checks
+              that the two files hold the same values. Exits with a
+              failure status if they differ.
+@METHOD     : Usage: bench_reorder [<size> [<nframes> [<directory>]]]
+              The volume is <size> cubed by <nframes> (default 128 x 50);
+              "bench_reorder 256 200" gives the 256^3 x 200 case, which
+              needs about 13 Gb of disk in <directory> (default /tmp).
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1994 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#include <string.h>
+#include <time.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#include <minc.h>
+#include "mincreshape.h"
+
+#define DEFAULT_SIZE    128
+#define DEFAULT_NFRAMES 50
+#define DEFAULT_DIR     "/tmp"
+
+/* Output dimensions */
+#define NDIMS 4
+static char *dimnames[NDIMS] = {"time", "zspace", "yspace", "xspace"};
+
+static double wall_time(void)
+{
+#ifdef HAVE_SYS_TIME_H
+   struct timeval tv;
+
+   (void) gettimeofday(&tv, NULL);
+   return (double) tv.tv_sec + 1.0e-6 * (double) tv.tv_usec;
+#else
+   return (double) time(NULL);
+#endif
+}
+
+/* Create an output file with time first */
+static int create_file(char *filename, long size, long nframes)
+{
+   int mincid, dim[NDIMS], idim;
+
+   mincid = nccreate(filename, NC_CLOBBER);
+   for (idim=0; idim < NDIMS; idim++) {
+      dim[idim] = ncdimdef(mincid, dimnames[idim],
+                           (idim == 0) ? nframes : size);
+   }
+   (void) ncvardef(mincid, "image", NC_SHORT, NDIMS, dim);
+   (void) ncendef(mincid);
+   return mincid;
+}
+
+/* Fill an input slice (y, x, time) with a pattern that depends on
+   every index */
+static void make_slice(short *slice, long islice, long size, long nframes)
+{
+   long iy, ix, it, ivox;
+
+   ivox = 0;
+   for (iy=0; iy < size; iy++)
+      for (ix=0; ix < size; ix++)
+         for (it=0; it < nframes; it++)
+            slice[ivox++] = (short) (islice * 7 + iy * 5 + ix * 3 + it);
+}
+
+int main(int argc, char *argv[])
+{
+   long size, nframes, islice, slice_size;
+   long start[NDIMS], count[NDIMS], imap[NDIMS], step[NDIMS];
+   char imap_file[1024], reorder_file[1024], *dir;
+   short *slice, *reordered, *check1, *check2;
+   double imap_time, reorder_time, kernel_time, t0, t1;
+   int mincid, mincid2, idim, ok;
+
+   size = (argc > 1) ? atol(argv[1]) : DEFAULT_SIZE;
+   nframes = (argc > 2) ? atol(argv[2]) : DEFAULT_NFRAMES;
+   dir = (argc > 3) ? argv[3] : DEFAULT_DIR;
+   if ((size < 1) || (nframes < 1)) {
+      (void) fprintf(stderr,
+                     "Usage: %s [<size> [<nframes> [<directory>]]]\n",
+                     argv[0]);
+      exit(EXIT_FAILURE);
+   }
+   (void) sprintf(imap_file, "%s/bench_reorder_imap.nc", dir);
+   (void) sprintf(reorder_file, "%s/bench_reorder_tiled.nc", dir);
+
+   slice_size = size * size * nframes;
+   slice = malloc(sizeof(short) * slice_size);
+   reordered = malloc(sizeof(short) * slice_size);
+
+   /* Output hyperslab for one input slice, and the steps (in bytes)
+      through the input slice for the output dimensions */
+   start[0] = 0;        count[0] = nframes;
+   start[2] = 0;        count[2] = size;
+   start[3] = 0;        count[3] = size;
+   count[1] = 1;
+   imap[0] = sizeof(short);
+   imap[1] = sizeof(short) * slice_size;
+   imap[2] = sizeof(short) * size * nframes;
+   imap[3] = sizeof(short) * nframes;
+   step[NDIMS-1] = sizeof(short);
+   for (idim=NDIMS-2; idim >= 0; idim--)
+      step[idim] = step[idim+1] * count[idim+1];
+
+   /* Old path: let netcdf scatter the values */
+   mincid = create_file(imap_file, size, nframes);
+   imap_time = 0.0;
+   for (islice=0; islice < size; islice++) {
+      make_slice(slice, islice, size, nframes);
+      start[1] = islice;
+      t0 = wall_time();
+      (void) ncvarputg(mincid, ncvarid(mincid, "image"), start, count,
+                       NULL, imap, slice);
+      imap_time += wall_time() - t0;
+   }
+   t0 = wall_time();
+   (void) ncclose(mincid);
+   imap_time += wall_time() - t0;
+
+   /* New path: reorder in memory and write contiguously */
+   mincid = create_file(reorder_file, size, nframes);
+   reorder_time = 0.0;
+   kernel_time = 0.0;
+   for (islice=0; islice < size; islice++) {
+      make_slice(slice, islice, size, nframes);
+      start[1] = islice;
+      t0 = wall_time();
+      reorder_data(NDIMS, count, imap, step, slice, reordered,
+                   sizeof(short));
+      t1 = wall_time();
+      (void) ncvarput(mincid, ncvarid(mincid, "image"), start, count,
+                      reordered);
+      kernel_time += t1 - t0;
+      reorder_time += wall_time() - t0;
+   }
+   t0 = wall_time();
+   (void) ncclose(mincid);
+   reorder_time += wall_time() - t0;
+
+   /* Compare the files one time point at a time */
+   check1 = malloc(sizeof(short) * size * size * size);
+   check2 = malloc(sizeof(short) * size * size * size);
+   ok = TRUE;
+   for (idim=0; idim < NDIMS; idim++) {
+      start[idim] = 0;
+      count[idim] = size;
+   }
+   count[0] = 1;
+   mincid = ncopen(imap_file, NC_NOWRITE);
+   mincid2 = ncopen(reorder_file, NC_NOWRITE);
+   for (start[0]=0; start[0] < nframes; start[0]++) {
+      (void) ncvarget(mincid, ncvarid(mincid, "image"),
+                      start, count, check1);
+      (void) ncvarget(mincid2, ncvarid(mincid2, "image"),
+                      start, count, check2);
+      if (memcmp(check1, check2, sizeof(short) * size * size * size)) {
+         ok = FALSE;
+      }
+   }
+   (void) ncclose(mincid);
+   (void) ncclose(mincid2);
+   (void) remove(imap_file);
+   (void) remove(reorder_file);
+
+   (void) printf("%ld^3 x %ld shorts, time last to time first\n",
+                 size, nframes);
+   (void) printf("imap ncvarputg          %8.3f s\n", imap_time);
+   (void) printf("reorder_data + ncvarput %8.3f s   (reorder_data %.3f s)"
+                 "   speedup %5.2f\n", reorder_time, kernel_time,
+                 (reorder_time > 0.0) ? imap_time / reorder_time : 0.0);
+
+   free(slice);
+   free(reordered);
+   free(check1);
+   free(check2);
+
+   if (!ok) {
+      (void) fprintf(stderr, "Reordered files differ\n");
+      exit(EXIT_FAILURE);
+   }
+
+   exit(EXIT_SUCCESS);
+}
@@ -94,24 +94,132 @@
 #include <math.h>
 #include <minc.h>
 #include <nd_loop.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #include "mincreshape.h"
 
 #define VIO_ROUND( x ) ((long) ((x) + ( ((x) >= 0) ? 0.5 : (-0.5) ) ))
 
+/* Description of how to copy one chunk of the output volume */
+typedef struct {
+   long chunk_start[MAX_VAR_DIMS];   /* Output hyperslab of chunk */
+   long chunk_count[MAX_VAR_DIMS];
+   long input_start[MAX_VAR_DIMS];   /* Input hyperslab with chunk data */
+   long input_count[MAX_VAR_DIMS];
+   long output_start[MAX_VAR_DIMS];  /* Output hyperslab of that data */
+   long output_count[MAX_VAR_DIMS];
+   long output_imap[MAX_VAR_DIMS];   /* Step (in bytes) through the input
+                                        data for each output dimension */
+   long origin_offset;               /* Offset (in bytes) of output data
+                                        [0,0,...] in the input data */
+   long total_size;                  /* Number of values in chunk */
+   int zero_data;                    /* TRUE if chunk needs filling */
+   int really_copy_the_data;         /* TRUE if chunk has input data */
+   int in_order;                     /* TRUE if the input data is already
+                                        laid out as the output chunk */
+   double fillvalue;                 /* Pixel fill value for chunk */
+} Chunk_Info;
+
+#ifdef HAVE_PTHREAD
+
+/* A chunk being copied by the pipeline. The input data is read by the
+   main thread and then reordered into output order in output_data by
+   a worker thread. */
+typedef struct {
+   Reshape_info *reshape_info;
+   Chunk_Info chunk;
+   void *input_data;
+   void *output_data;
+} Chunk_Job;
+
+/* Pipeline for copying chunks with several threads. Jobs come in two
+   sets of nthreads: while the threads reorder one set, the main thread 
+   writes the previous contents of the other set and then reads the next
+   chunks into it. All netcdf calls stay on the main thread. */
+typedef struct {
+   Reshape_info *reshape_info;
+   int nthreads;
+   Chunk_Job *jobs[2];               /* The two sets of jobs */
+   int njobs[2];                     /* Number of chunks in each set */
+   int current;                      /* Set being read into */
+   int running;                      /* TRUE if threads are reordering
+                                        the other set */
+   pthread_t *threads;
+   int *started;
+} Chunk_Pipeline;
+
+/* Part of a buffer of real values scanned for its range by one thread */
+typedef struct {
+   double *values;
+   long nvalues;
+   double minimum, maximum;
+} Scan_Job;
+
+/* Threads that scan buffers for their range. They are started once for
+   the whole scan and then wait for each buffer: worker i scans part i,
+   while the calling thread scans part 0 and the parts of any workers 
+   that could not be started. */
+typedef struct {
+   struct Scan_Pool *pool;
+   int ijob;                 /* Part of each buffer scanned by this 
+                                worker */
+} Scan_Worker;
+
+struct Scan_Pool {
+   int njobs;                /* Number of parts of each buffer */
+   Scan_Job *jobs;           /* Parts of the current buffer */
+   int nworkers;             /* Number of workers started */
+   pthread_t *threads;
+   Scan_Worker *workers;
+   pthread_mutex_t mutex;
+   pthread_cond_t cond;
+   long group;               /* Number of buffers given to the workers */
+   int jobs_done;            /* Parts of the buffer done by the workers */
+   int quit;                 /* TRUE once the workers should exit */
+};
+
+#endif /* HAVE_PTHREAD */
+
+/* All of the values of image-min or image-max of the input file, so that
+   block ranges can be worked out without going back to the file */
+typedef struct {
+   int ndims;
+   long size[MAX_VAR_DIMS];
+   double *values;                   /* NULL if the variable is missing */
+} Minmax_Index;
+
 static void get_num_minmax_values(Reshape_info *reshape_info,
                                   long *block_start, long *block_count,
                                   long *num_min_values, long *num_max_values);
+static void load_minmax_index(Reshape_info *reshape_info,
+                              Minmax_Index minmax_index[2]);
+static double get_index_extreme(Minmax_Index *index,
+                                long start[], long count[], double sign);
 static void handle_normalization(Reshape_info *reshape_info,
                                  long *block_start,
                                  long *block_count,
-                                 double *minmax_buffer,
+                                 Minmax_Index minmax_index[2],
                                  double *fillvalue);
 static void get_block_min_and_max(Reshape_info *reshape_info,
                                   long *block_start,
                                   long *block_count,
-                                  double *minmax_buffer,
+                                  Minmax_Index minmax_index[2],
                                   double *minimum,
                                   double *maximum);
+static int create_scan_icv(Reshape_info *reshape_info);
+static int scan_block_range(Reshape_info *reshape_info,
+                            long input_start[], long input_count[],
+                            double *minimum, double *maximum);
+static void scan_values(double *values, long nvalues,
+                        double *minimum, double *maximum);
+#ifdef HAVE_PTHREAD
+static Scan_Pool *start_scan_pool(int nthreads);
+static void stop_scan_pool(Scan_Pool *pool);
+static void scan_buffer(Scan_Pool *pool, double *values, long nvalues,
+                        double *minimum, double *maximum);
+static void *scan_pool_worker(void *worker_ptr);
+#endif
 static void truncate_input_vectors(Reshape_info *reshape_info,
                                    long *input_start,
 				   long *input_count);
@@ -125,11 +233,35 @@ static void translate_input_to_output(Reshape_info *reshape_info,
                                       long *input_count,
                                       long *output_start,
                                       long *output_count);
+static void setup_chunk(Reshape_info *reshape_info,
+                        long chunk_start[],
+                        long chunk_count[],
+                        double fillvalue,
+                        Chunk_Info *chunk);
+static void fill_chunk(Reshape_info *reshape_info, Chunk_Info *chunk,
+                       void *chunk_data);
+static void reorder_chunk_data(Reshape_info *reshape_info, Chunk_Info *chunk,
+                               void *input_data, void *chunk_data);
 static void copy_the_chunk(Reshape_info *reshape_info,
                            long chunk_start[],
                            long chunk_count[],
+                           void *input_data,
                            void *chunk_data,
                            double fillvalue);
+#ifdef HAVE_PTHREAD
+static Chunk_Pipeline *create_chunk_pipeline(Reshape_info *reshape_info,
+                                             long total_size);
+static void queue_chunk(Chunk_Pipeline *pipeline,
+                        long chunk_start[],
+                        long chunk_count[],
+                        double fillvalue);
+static void start_reordering(Chunk_Pipeline *pipeline, int set);
+static void finish_reordering(Chunk_Pipeline *pipeline, int set);
+static void write_chunks(Chunk_Pipeline *pipeline, int set);
+static void flush_chunk_pipeline(Chunk_Pipeline *pipeline);
+static void delete_chunk_pipeline(Chunk_Pipeline *pipeline);
+static void *reorder_chunk(void *job_ptr);
+#endif /* HAVE_PTHREAD */
 static void convert_value_from_double(double dvalue,
                                       nc_type datatype, int is_signed,
                                       void *ptr);
@@ -151,7 +283,7 @@ static void convert_value_from_double(double dvalue,
 ---------------------------------------------------------------------------- */
 void copy_data(Reshape_info *reshape_info)
 {
-   int idim, odim, out_ndims;
+   int idim, odim, out_ndims, iloop;
    long block_begin[MAX_VAR_DIMS], block_end[MAX_VAR_DIMS];
    long block_count[MAX_VAR_DIMS];
    long block_cur_start[MAX_VAR_DIMS], block_cur_count[MAX_VAR_DIMS];
@@ -159,9 +291,12 @@ void copy_data(Reshape_info *reshape_info)
    long chunk_count[MAX_VAR_DIMS];
    long chunk_cur_start[MAX_VAR_DIMS], chunk_cur_count[MAX_VAR_DIMS];
    long total_size;
-   long num_min_values, num_max_values, num_values;
-   double fillvalue, *minmax_buffer;
-   void *chunk_data;
+   double fillvalue;
+   Minmax_Index minmax_index[2];
+   void *chunk_data, *input_data;
+#ifdef HAVE_PTHREAD
+   Chunk_Pipeline *pipeline;
+#endif
 
    /* Get number of dimensions */
    out_ndims = reshape_info->output_ndims;
@@ -183,16 +318,32 @@ void copy_data(Reshape_info *reshape_info)
       total_size *= reshape_info->chunk_count[odim];
    }
    chunk_data = malloc(total_size);
+   input_data = malloc(total_size);
 
-   /* Get enough space for image-min and max values for a block */
-   get_num_minmax_values(reshape_info, NULL, block_count, 
-                         &num_min_values, &num_max_values);
-   num_values = ((num_min_values > num_max_values) ?
-                 num_min_values : num_max_values);
-   if (num_values > 0)
-      minmax_buffer = malloc(num_values * sizeof(double));
-   else
-      minmax_buffer = NULL;
+   /* Use a pipeline of chunks if we have more than one thread */
+#ifdef HAVE_PTHREAD
+   pipeline = NULL;
+   if ((reshape_info->nthreads > 1) && (out_ndims > 0)) {
+      pipeline = create_chunk_pipeline(reshape_info, total_size);
+   }
+#endif
+
+   /* Read in all of the image-min and max values, and get ready to scan
+      the data where there are none */
+   load_minmax_index(reshape_info, minmax_index);
+   reshape_info->scan_icvid = MI_ERROR;
+   if (reshape_info->scan_range && !reshape_info->do_icv_normalization &&
+       ((minmax_index[0].values == NULL) || 
+        (minmax_index[1].values == NULL))) {
+      reshape_info->scan_icvid = create_scan_icv(reshape_info);
+   }
+   reshape_info->scan_pool = NULL;
+#ifdef HAVE_PTHREAD
+   if ((reshape_info->scan_icvid != MI_ERROR) && 
+       (reshape_info->nthreads > 1)) {
+      reshape_info->scan_pool = start_scan_pool(reshape_info->nthreads);
+   }
+#endif
 
    /* Print log message */
    if (reshape_info->verbose) {
@@ -219,7 +370,7 @@ void copy_data(Reshape_info *reshape_info)
       /* Set up icv for normalization, set output image-max/min and 
          calculate pixel fill value to use for current block */
       handle_normalization(reshape_info, block_cur_start, block_cur_count,
-                           minmax_buffer, &fillvalue);
+                           minmax_index, &fillvalue);
 
       /* Loop through chunks */
 
@@ -237,9 +388,16 @@ void copy_data(Reshape_info *reshape_info)
          }
 
          /* Copy the chunk */
-         copy_the_chunk(reshape_info, 
-                        chunk_cur_start, chunk_cur_count, chunk_data,
+#ifdef HAVE_PTHREAD
+         if (pipeline != NULL) {
+            queue_chunk(pipeline, chunk_cur_start, chunk_cur_count,
                         fillvalue);
+         }
+         else
+#endif
+         copy_the_chunk(reshape_info, 
+                        chunk_cur_start, chunk_cur_count, 
+                        input_data, chunk_data, fillvalue);
 
          /* Increment chunk loop count */
          nd_increment_loop(chunk_cur_start, chunk_begin, chunk_count,
@@ -253,13 +411,32 @@ void copy_data(Reshape_info *reshape_info)
 
    }
 
+   /* Write out the chunks still in the pipeline */
+#ifdef HAVE_PTHREAD
+   if (pipeline != NULL) {
+      flush_chunk_pipeline(pipeline);
+      delete_chunk_pipeline(pipeline);
+   }
+#endif
+
    /* Free the chunk space */
    free(chunk_data);
+   free(input_data);
 
-   /* Free minmax buffer */
-   if (minmax_buffer != NULL) {
-      free(minmax_buffer);
+   /* Free the image-min and max values and the scanning icv */
+   for (iloop=0; iloop < 2; iloop++) {
+      if (minmax_index[iloop].values != NULL)
+         free(minmax_index[iloop].values);
+   }
+   if (reshape_info->scan_icvid != MI_ERROR) {
+      (void) miicv_free(reshape_info->scan_icvid);
+   }
+#ifdef HAVE_PTHREAD
+   if (reshape_info->scan_pool != NULL) {
+      stop_scan_pool(reshape_info->scan_pool);
+      reshape_info->scan_pool = NULL;
    }
+#endif
 
    /* Print ending log message */
    if (reshape_info->verbose) {
@@ -360,8 +537,7 @@ static void get_num_minmax_values(Reshape_info *reshape_info,
 @INPUT      : reshape_info - information for reshaping volume
               block_start - start of current block
               block_count - count for current block
-              minmax_buffer - buffer space for getting min and max
-                 values
+              minmax_index - all image-min and max values of input
 @OUTPUT     : fillvalue - pixel fill value to use for this block
 @RETURNS    : (none)
 @DESCRIPTION: Sets up icv for normalization to ensure that block is
@@ -377,7 +553,7 @@ static void get_num_minmax_values(Reshape_info *reshape_info,
 static void handle_normalization(Reshape_info *reshape_info,
                                  long *block_start,
                                  long *block_count,
-                                 double *minmax_buffer,
+                                 Minmax_Index minmax_index[2],
                                  double *fillvalue)
 {
    int iloop;
@@ -393,7 +569,7 @@ static void handle_normalization(Reshape_info *reshape_info,
 
    /* Get input min and max for block */
    get_block_min_and_max(reshape_info, block_start, block_count,
-                         minmax_buffer, &minimum, &maximum);
+                         minmax_index, &minimum, &maximum);
 
    /* Modify the icv if necessary */
    if (reshape_info->do_block_normalization) {
@@ -459,28 +635,30 @@ static void handle_normalization(Reshape_info *reshape_info,
 @INPUT      : reshape_info - information for reshaping volume
               block_start - start of current block
               block_count - count for current block
-              minmax_buffer - buffer space for getting min and max
-                 values
+              minmax_index - all image-min and max values of input
 @OUTPUT     : minimum - input minimum for block
               maximum - input maximum for block
 @RETURNS    : (none)
 @DESCRIPTION: Gets the min and max for the input file for a given output
               block.
-@METHOD     :
+@METHOD     : The range comes from the image-min and max values read in
+              by load_minmax_index, without touching the image. If there
+              are none and -scan_range was given, the block is read to
+              find its range.
 @GLOBALS    :
 @CALLS      :
 @CREATED    : October 25, 1994 (Peter Neelin)
-@MODIFIED   :
+@MODIFIED   : October 16, 2026 - use values read in once, scan if missing
 ---------------------------------------------------------------------------- */
 static void get_block_min_and_max(Reshape_info *reshape_info,
                                   long *block_start,
                                   long *block_count,
-                                  double *minmax_buffer,
+                                  Minmax_Index minmax_index[2],
                                   double *minimum,
                                   double *maximum)
 {
    int iloop;
-   long num_min_values, num_max_values, ivalue;
+   long num_min_values, num_max_values;
    int inmincid, inimgid, varid, icvid;
    long minmax_start[MAX_VAR_DIMS], minmax_count[MAX_VAR_DIMS];
    long input_block_start[MAX_VAR_DIMS], input_block_count[MAX_VAR_DIMS];
@@ -488,6 +666,8 @@ static void get_block_min_and_max(Reshape_info *reshape_info,
    long num_values;
    char *varname;
    double sign, default_extreme;
+   double scan_extreme[2];
+   int scanned;
 
    /* Get input minc id, image id and icv id*/
    inmincid = reshape_info->inmincid;
@@ -510,6 +690,15 @@ static void get_block_min_and_max(Reshape_info *reshape_info,
    get_num_minmax_values(reshape_info, block_start, block_count, 
                          &num_min_values, &num_max_values);
 
+   /* Scan the block if the range is not known */
+   scanned = FALSE;
+   if ((reshape_info->scan_icvid != MI_ERROR) &&
+       ((num_min_values <= 0) || (num_max_values <= 0))) {
+      scanned = scan_block_range(reshape_info, 
+                                 input_block_start, input_block_count,
+                                 &scan_extreme[0], &scan_extreme[1]);
+   }
+
    /* Loop over image-min and image-max getting block min and max */
 
    for (iloop=0; iloop < 2; iloop++) {
@@ -532,8 +721,8 @@ static void get_block_min_and_max(Reshape_info *reshape_info,
          break;
       }
 
-      /* Get values from file */
-      if (num_values > 0) {
+      /* Get values from the index, or from the scan */
+      if ((num_values > 0) && (minmax_index[iloop].values != NULL)) {
          varid = ncvarid(inmincid, varname);
          (void) mitranslate_coords(inmincid,
                                    inimgid, input_block_start,
@@ -541,14 +730,11 @@ static void get_block_min_and_max(Reshape_info *reshape_info,
          (void) mitranslate_coords(inmincid,
                                    inimgid, input_block_count,
                                    varid, minmax_count);
-         (void) mivarget(reshape_info->inmincid, varid, 
-                         minmax_start, minmax_count, 
-                         NC_DOUBLE, NULL, minmax_buffer);
-         *extreme = minmax_buffer[0];
-         for (ivalue=1; ivalue < num_values; ivalue++) {
-            if ((minmax_buffer[ivalue] * sign) > (*extreme * sign))
-               *extreme = minmax_buffer[ivalue];
-         }
+         *extreme = get_index_extreme(&minmax_index[iloop], 
+                                      minmax_start, minmax_count, sign);
+      }
+      else if (scanned) {
+         *extreme = scan_extreme[iloop];
       }
       else {
          *extreme = default_extreme;
@@ -561,6 +747,443 @@ static void get_block_min_and_max(Reshape_info *reshape_info,
    }
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : load_minmax_index
+@INPUT      : reshape_info - information for reshaping volume
+@OUTPUT     : minmax_index - all values of image-min ([0]) and image-max
+                 ([1]) of the input file
+@RETURNS    : (nothing)
+@DESCRIPTION: Reads in the whole of the input image-min and image-max
+              variables, so that the range of each block can be found
+              without reading from the file again. The values are NULL
+              for a missing variable, or if the icv is doing the 
+              normalization.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void load_minmax_index(Reshape_info *reshape_info,
+                              Minmax_Index minmax_index[2])
+{
+   int iloop, idim, varid;
+   int dim[MAX_VAR_DIMS];
+   long start[MAX_VAR_DIMS], nvalues;
+   Minmax_Index *index;
+
+   for (iloop=0; iloop < 2; iloop++) {
+      index = &minmax_index[iloop];
+      index->ndims = 0;
+      index->values = NULL;
+      if (reshape_info->do_icv_normalization) continue;
+
+      /* Look for the variable */
+      ncopts = 0;
+      varid = ncvarid(reshape_info->inmincid, 
+                      (iloop == 0) ? MIimagemin : MIimagemax);
+      ncopts = NCOPTS_DEFAULT;
+      if (varid == MI_ERROR) continue;
+
+      /* Get its size and read it */
+      (void) ncvarinq(reshape_info->inmincid, varid, NULL, NULL, 
+                      &index->ndims, dim, NULL);
+      nvalues = 1;
+      for (idim=0; idim < index->ndims; idim++) {
+         (void) ncdiminq(reshape_info->inmincid, dim[idim], NULL, 
+                         &index->size[idim]);
+         start[idim] = 0;
+         nvalues *= index->size[idim];
+      }
+      index->values = malloc(MAX(nvalues, 1) * sizeof(double));
+      (void) mivarget(reshape_info->inmincid, varid, start, index->size,
+                      NC_DOUBLE, NULL, index->values);
+   }
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_index_extreme
+@INPUT      : index - all values of image-min or image-max
+              start - start of hyperslab of the variable
+              count - count for hyperslab of the variable
+              sign - -1 to get the minimum, +1 to get the maximum
+@OUTPUT     : (nothing)
+@RETURNS    : Smallest or largest value in the hyperslab
+@DESCRIPTION: Finds the extreme of a hyperslab of image-min or image-max
+              values held in memory.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static double get_index_extreme(Minmax_Index *index,
+                                long start[], long count[], double sign)
+{
+   int idim, first;
+   long end[MAX_VAR_DIMS], cur[MAX_VAR_DIMS], step[MAX_VAR_DIMS];
+   long offset;
+   double extreme, value;
+
+   /* Check for a scalar */
+   if (index->ndims <= 0) return index->values[0];
+
+   /* Loop through the hyperslab one value at a time */
+   for (idim=0; idim < index->ndims; idim++) {
+      end[idim] = start[idim] + count[idim];
+      step[idim] = 1;
+   }
+   extreme = 0.0;
+   first = TRUE;
+   nd_begin_looping(start, cur, index->ndims);
+   while (!nd_end_of_loop(cur, end, index->ndims)) {
+      offset = 0;
+      for (idim=0; idim < index->ndims; idim++) {
+         offset = offset * index->size[idim] + cur[idim];
+      }
+      value = index->values[offset];
+      if (first || ((value * sign) > (extreme * sign))) {
+         extreme = value;
+         first = FALSE;
+      }
+      nd_increment_loop(cur, start, step, end, index->ndims);
+   }
+
+   return extreme;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_scan_icv
+@INPUT      : reshape_info - information for reshaping volume
+@OUTPUT     : (nothing)
+@RETURNS    : Id of icv for reading real values
+@DESCRIPTION: Creates an icv that gives real values of the input image as
+              doubles, with the same dimension conversion as the icv used
+              for copying, so that the same hyperslabs can be read.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static int create_scan_icv(Reshape_info *reshape_info)
+{
+   static int dim_props[] = {
+      MI_ICV_DO_DIM_CONV, MI_ICV_DO_SCALAR, MI_ICV_XDIM_DIR,
+      MI_ICV_YDIM_DIR, MI_ICV_ZDIM_DIR, MI_ICV_KEEP_ASPECT,
+      MI_ICV_NUM_IMGDIMS
+   };
+   int icvid, iprop, value;
+
+   icvid = miicv_create();
+   (void) miicv_setint(icvid, MI_ICV_TYPE, NC_DOUBLE);
+   (void) miicv_setint(icvid, MI_ICV_DO_NORM, FALSE);
+   for (iprop=0; iprop < sizeof(dim_props)/sizeof(dim_props[0]); iprop++) {
+      (void) miicv_inqint(reshape_info->icvid, dim_props[iprop], &value);
+      (void) miicv_setint(icvid, dim_props[iprop], value);
+   }
+   for (iprop=0; iprop < MI_MAX_IMGDIMS; iprop++) {
+      (void) miicv_inqint(reshape_info->icvid, MI_ICV_DIM_SIZE+iprop, &value);
+      (void) miicv_setint(icvid, MI_ICV_DIM_SIZE+iprop, value);
+   }
+   (void) miicv_attach(icvid, reshape_info->inmincid,
+                       ncvarid(reshape_info->inmincid, MIimage));
+
+   return icvid;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : scan_block_range
+@INPUT      : reshape_info - information for reshaping volume
+              input_start - start of input hyperslab (legal for the file)
+              input_count - count for input hyperslab
+@OUTPUT     : minimum - smallest real value in hyperslab
+              maximum - largest real value in hyperslab
+@RETURNS    : TRUE if any values were read
+@DESCRIPTION: Reads a block of the input through the scanning icv to find
+              its real range. This is the fallback for files without
+              image-min and max.
+@METHOD     : The hyperslab is read in pieces no bigger than a copy chunk.
+              With more than one thread, each piece is split between the
+              threads of the scan pool; the reading stays on the main
+              thread.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static int scan_block_range(Reshape_info *reshape_info,
+                            long input_start[], long input_count[],
+                            double *minimum, double *maximum)
+{
+   int idim, odim, ndims, found;
+   long end[MAX_VAR_DIMS], slab_count[MAX_VAR_DIMS];
+   long cur_start[MAX_VAR_DIMS], cur_count[MAX_VAR_DIMS];
+   long max_values, nvalues;
+   double *buffer;
+
+   /* Check for an empty hyperslab */
+   ndims = reshape_info->input_ndims;
+   for (idim=0; idim < ndims; idim++) {
+      if (input_count[idim] <= 0) return FALSE;
+   }
+
+   /* Read pieces of up to the size of a copy chunk */
+   max_values = 1;
+   for (odim=0; odim < reshape_info->output_ndims; odim++) {
+      max_values *= reshape_info->chunk_count[odim];
+   }
+   nvalues = 1;
+   for (idim=ndims-1; idim >= 0; idim--) {
+      slab_count[idim] = MAX(max_values / nvalues, 1);
+      if (slab_count[idim] > input_count[idim]) 
+         slab_count[idim] = input_count[idim];
+      nvalues *= slab_count[idim];
+      end[idim] = input_start[idim] + input_count[idim];
+   }
+   buffer = malloc(nvalues * sizeof(double));
+   if (buffer == NULL) {
+      (void) fprintf(stderr, "Unable to allocate buffer for scanning\n");
+      exit(EXIT_FAILURE);
+   }
+
+   found = FALSE;
+   nd_begin_looping(input_start, cur_start, ndims);
+   while (!nd_end_of_loop(cur_start, end, ndims)) {
+      nd_update_current_count(cur_start, slab_count, end, cur_count, ndims);
+
+      /* Read the piece */
+      (void) miicv_get(reshape_info->scan_icvid, cur_start, cur_count, 
+                       buffer);
+      nvalues = 1;
+      for (idim=0; idim < ndims; idim++) nvalues *= cur_count[idim];
+      if (!found) {
+         *minimum = *maximum = buffer[0];
+         found = TRUE;
+      }
+
+      /* Scan it */
+#ifdef HAVE_PTHREAD
+      if (reshape_info->scan_pool != NULL)
+         scan_buffer(reshape_info->scan_pool, buffer, nvalues, 
+                     minimum, maximum);
+      else
+#endif
+      scan_values(buffer, nvalues, minimum, maximum);
+
+      nd_increment_loop(cur_start, input_start, slab_count, end, ndims);
+   }
+
+   free(buffer);
+
+   return found;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : scan_values
+@INPUT      : values - values to scan
+              nvalues - number of values
+              minimum - range so far
+              maximum
+@OUTPUT     : minimum - range including the values
+              maximum
+@RETURNS    : (nothing)
+@DESCRIPTION: Widens a range to include a buffer of values.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void scan_values(double *values, long nvalues,
+                        double *minimum, double *maximum)
+{
+   long ivalue;
+   double vmin, vmax;
+
+   vmin = *minimum;
+   vmax = *maximum;
+   for (ivalue=0; ivalue < nvalues; ivalue++) {
+      if (values[ivalue] < vmin) vmin = values[ivalue];
+      if (values[ivalue] > vmax) vmax = values[ivalue];
+   }
+   *minimum = vmin;
+   *maximum = vmax;
+}
+
+#ifdef HAVE_PTHREAD
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_scan_pool
+@INPUT      : nthreads - number of threads to scan with
+@OUTPUT     : (nothing)
+@RETURNS    : Threads waiting for buffers to scan
+@DESCRIPTION: Starts the threads that scan buffers for their range, so 
+              that they are created only once for all of the blocks.
+              If a thread cannot be created, the calling thread scans its
+              part of each buffer.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static Scan_Pool *start_scan_pool(int nthreads)
+{
+   Scan_Pool *pool;
+   int ithread;
+
+   pool = malloc(sizeof(*pool));
+   pool->njobs = nthreads;
+   pool->jobs = malloc(sizeof(Scan_Job) * nthreads);
+   pool->threads = malloc(sizeof(pthread_t) * nthreads);
+   pool->workers = malloc(sizeof(Scan_Worker) * nthreads);
+   pool->nworkers = 0;
+   pool->group = 0;
+   pool->jobs_done = 0;
+   pool->quit = FALSE;
+   (void) pthread_mutex_init(&pool->mutex, NULL);
+   (void) pthread_cond_init(&pool->cond, NULL);
+   for (ithread=1; ithread < nthreads; ithread++) {
+      pool->workers[ithread].pool = pool;
+      pool->workers[ithread].ijob = ithread;
+      if (pthread_create(&pool->threads[ithread], NULL, scan_pool_worker,
+                         &pool->workers[ithread]) != 0) break;
+      pool->nworkers++;
+   }
+
+   return pool;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : stop_scan_pool
+@INPUT      : pool - threads started by start_scan_pool
+@OUTPUT     : (nothing)
+@RETURNS    : (nothing)
+@DESCRIPTION: Tells the scanning threads to exit, waits for them and 
+              frees the pool.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void stop_scan_pool(Scan_Pool *pool)
+{
+   int ithread;
+
+   (void) pthread_mutex_lock(&pool->mutex);
+   pool->quit = TRUE;
+   (void) pthread_cond_broadcast(&pool->cond);
+   (void) pthread_mutex_unlock(&pool->mutex);
+   for (ithread=1; ithread <= pool->nworkers; ithread++) {
+      (void) pthread_join(pool->threads[ithread], NULL);
+   }
+   (void) pthread_cond_destroy(&pool->cond);
+   (void) pthread_mutex_destroy(&pool->mutex);
+   free(pool->jobs);
+   free(pool->threads);
+   free(pool->workers);
+   free(pool);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : scan_buffer
+@INPUT      : pool - threads started by start_scan_pool
+              values - values to scan
+              nvalues - number of values
+              minimum - range so far
+              maximum
+@OUTPUT     : minimum - range including the values
+              maximum
+@RETURNS    : (nothing)
+@DESCRIPTION: Widens a range to include a buffer of values, split 
+              between the threads of the pool. The calling thread scans
+              the first part, along with those of any threads that could
+              not be started.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void scan_buffer(Scan_Pool *pool, double *values, long nvalues,
+                        double *minimum, double *maximum)
+{
+   int ijob;
+   long nper, ivalue;
+   Scan_Job *job;
+
+   /* Split the buffer */
+   nper = (nvalues + pool->njobs - 1) / pool->njobs;
+   for (ijob=0; ijob < pool->njobs; ijob++) {
+      job = &pool->jobs[ijob];
+      ivalue = MIN(ijob * nper, nvalues);
+      job->values = values + ivalue;
+      job->nvalues = MIN(nper, nvalues - ivalue);
+      job->minimum = *minimum;
+      job->maximum = *maximum;
+   }
+
+   /* Hand it to the workers and scan the rest here */
+   if (pool->nworkers > 0) {
+      (void) pthread_mutex_lock(&pool->mutex);
+      pool->jobs_done = 0;
+      pool->group++;
+      (void) pthread_cond_broadcast(&pool->cond);
+      (void) pthread_mutex_unlock(&pool->mutex);
+   }
+   job = &pool->jobs[0];
+   scan_values(job->values, job->nvalues, &job->minimum, &job->maximum);
+   for (ijob=pool->nworkers+1; ijob < pool->njobs; ijob++) {
+      job = &pool->jobs[ijob];
+      scan_values(job->values, job->nvalues, &job->minimum, &job->maximum);
+   }
+   if (pool->nworkers > 0) {
+      (void) pthread_mutex_lock(&pool->mutex);
+      while (pool->jobs_done < pool->nworkers)
+         (void) pthread_cond_wait(&pool->cond, &pool->mutex);
+      (void) pthread_mutex_unlock(&pool->mutex);
+   }
+
+   /* Combine the parts */
+   for (ijob=0; ijob < pool->njobs; ijob++) {
+      if (pool->jobs[ijob].minimum < *minimum) 
+         *minimum = pool->jobs[ijob].minimum;
+      if (pool->jobs[ijob].maximum > *maximum) 
+         *maximum = pool->jobs[ijob].maximum;
+   }
+}
+
+/* Thread entry point: scan this worker's part of each buffer until the
+   pool is stopped */
+static void *scan_pool_worker(void *worker_ptr)
+{
+   Scan_Worker *worker = (Scan_Worker *) worker_ptr;
+   Scan_Pool *pool = worker->pool;
+   Scan_Job *job;
+   long group;
+
+   group = 0;
+   (void) pthread_mutex_lock(&pool->mutex);
+   for (;;) {
+      while ((pool->group == group) && !pool->quit)
+         (void) pthread_cond_wait(&pool->cond, &pool->mutex);
+      if (pool->quit) break;
+      group = pool->group;
+      job = &pool->jobs[worker->ijob];
+      (void) pthread_mutex_unlock(&pool->mutex);
+      scan_values(job->values, job->nvalues, &job->minimum, &job->maximum);
+      (void) pthread_mutex_lock(&pool->mutex);
+      pool->jobs_done++;
+      (void) pthread_cond_broadcast(&pool->cond);
+   }
+   (void) pthread_mutex_unlock(&pool->mutex);
+
+   return NULL;
+}
+#endif /* HAVE_PTHREAD */
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : truncate_input_vectors
 @INPUT      : reshape_info - information for reshaping volume
@@ -698,38 +1321,32 @@ static void translate_input_to_output(Reshape_info *reshape_info,
 }
 
 /* ----------------------------- MNI Header -----------------------------------
-@NAME       : copy_the_chunk
+@NAME       : setup_chunk
 @INPUT      : reshape_info - information for reshaping volume
-              chunk_start - start of current block
-              chunk_count - count for current block
-              chunk_data - pointer to enough space for chunk
+              chunk_start - start of current chunk
+              chunk_count - count for current chunk
               fillvalue - pixel value to zero volume, if necessary.
-@OUTPUT     : (none)
+@OUTPUT     : chunk - description of how to copy the chunk
 @RETURNS    : (nothing)
-@DESCRIPTION: Copies the chunk from the input file to the output file.
+@DESCRIPTION: Works out the input hyperslab that holds the data for a 
+              chunk, where it goes in the output and whether the chunk
+              needs to be filled.
 @METHOD     :
 @GLOBALS    :
 @CALLS      :
 @CREATED    : October 25, 1994 (Peter Neelin)
-@MODIFIED   :
+@MODIFIED   : October 16, 2026 - split out of copy_the_chunk
 ---------------------------------------------------------------------------- */
-static void copy_the_chunk(Reshape_info *reshape_info,
-                           long chunk_start[],
-                           long chunk_count[],
-                           void *chunk_data,
-                           double fillvalue)
+static void setup_chunk(Reshape_info *reshape_info,
+                        long chunk_start[],
+                        long chunk_count[],
+                        double fillvalue,
+                        Chunk_Info *chunk)
 {
    int idim, odim, in_ndims, out_ndims;
-   long input_start[MAX_VAR_DIMS], input_count[MAX_VAR_DIMS];
-   long output_start[MAX_VAR_DIMS], output_count[MAX_VAR_DIMS];
-   long input_imap[MAX_VAR_DIMS], output_imap[MAX_VAR_DIMS];
-   void *output_origin;
+   long input_imap[MAX_VAR_DIMS];
    int datatype_size;
-   long total_size, ipix, first, last;
-   int zero_data, really_copy_the_data;
-   union {
-      char c; short s; long l; float f; double d;
-   } value_buffer;
+   long first, last;
 
    /* Get number of dimensions */
    out_ndims = reshape_info->output_ndims;
@@ -738,85 +1355,488 @@ static void copy_the_chunk(Reshape_info *reshape_info,
    /* Get size of output datatype */
    datatype_size = nctypelen(reshape_info->output_datatype);
 
+   /* Save the chunk position */
+   for (odim=0; odim < out_ndims; odim++) {
+      chunk->chunk_start[odim] = chunk_start[odim];
+      chunk->chunk_count[odim] = chunk_count[odim];
+   }
+   chunk->fillvalue = fillvalue;
+
    /* Create input start and count */
    translate_output_to_input(reshape_info, chunk_start, chunk_count,
-                             input_start, input_count);
+                             chunk->input_start, chunk->input_count);
 
    /* Find out if we need to zero the volume and if we need to copy any
       data */
-   zero_data = FALSE;
-   really_copy_the_data = TRUE;
-   total_size = 1;
+   chunk->zero_data = FALSE;
+   chunk->really_copy_the_data = TRUE;
+   chunk->total_size = 1;
    for (idim=0; idim < in_ndims; idim++) {
-      first = input_start[idim];
-      last = input_start[idim] + input_count[idim] - 1;
+      first = chunk->input_start[idim];
+      last = chunk->input_start[idim] + chunk->input_count[idim] - 1;
       if ((first < 0) || (last >= reshape_info->input_size[idim]))
-         zero_data = TRUE;
+         chunk->zero_data = TRUE;
       if ((last < 0) || (first >= reshape_info->input_size[idim]))
-         really_copy_the_data = FALSE;
-      total_size *= input_count[idim];
+         chunk->really_copy_the_data = FALSE;
+      chunk->total_size *= chunk->input_count[idim];
    }
 
    /* Make sure that input vectors are legal and translate them back 
       to output */
-   truncate_input_vectors(reshape_info, input_start, input_count);
-   translate_input_to_output(reshape_info, input_start, input_count,
-                             output_start, output_count);
-
-   /* Write out zero data if needed */
-   if (zero_data) {
-      convert_value_from_double(fillvalue, 
-                                reshape_info->output_datatype,
-                                reshape_info->output_is_signed,
-                                &value_buffer);
-      for (ipix=0; ipix < total_size; ipix++) {
-         (void) memcpy((char *)chunk_data + ipix*datatype_size,
-                       &value_buffer, datatype_size);
-      }
-      (void) ncvarput(reshape_info->outmincid, reshape_info->outimgid,
-                      chunk_start, chunk_count, chunk_data);
-   }
+   truncate_input_vectors(reshape_info, 
+                          chunk->input_start, chunk->input_count);
+   translate_input_to_output(reshape_info, 
+                             chunk->input_start, chunk->input_count,
+                             chunk->output_start, chunk->output_count);
 
    /* Set up hypothetical imap variable for input */
    for (idim=in_ndims-1; idim >= 0; idim--) {
       input_imap[idim] = ((idim == in_ndims-1) ? 
                           datatype_size :
-                          input_imap[idim+1] * input_count[idim+1]);
+                          input_imap[idim+1] * chunk->input_count[idim+1]);
    }
 
    /* Create output imap variable from input one (re-ordering dimensions and
-      flipping). Also work out the chunk origin (point to byte for output
+      flipping). Also work out the chunk origin (offset of byte for output
       [0,0,0...]). */
-   output_origin = chunk_data;
+   chunk->origin_offset = 0;
    for (odim=0; odim < out_ndims; odim++) {
       idim = reshape_info->map_out_to_in[odim];
       if (reshape_info->input_count[idim] > 0) {
-         output_imap[odim] = input_imap[idim];
+         chunk->output_imap[odim] = input_imap[idim];
       }
       else {
-         output_imap[odim] = -input_imap[idim];
-         output_origin = 
-            (void *) ((char *)output_origin - 
-                      (output_count[odim] - 1) * output_imap[odim]);
+         chunk->output_imap[odim] = -input_imap[idim];
+         chunk->origin_offset -= 
+            (chunk->output_count[odim] - 1) * chunk->output_imap[odim];
       }
    }
 
-   /* Should we really copy the data? */
-   if (really_copy_the_data) {
+   /* The data can be written as it is read if the whole chunk comes from
+      the input with no flipping and with dimensions in the same order */
+   chunk->in_order = !chunk->zero_data;
+   last = datatype_size;
+   for (odim=out_ndims-1; odim >= 0; odim--) {
+      if (chunk->output_count[odim] == 1) continue;
+      if (chunk->output_imap[odim] != last) chunk->in_order = FALSE;
+      last *= chunk->output_count[odim];
+   }
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : fill_chunk
+@INPUT      : reshape_info - information for reshaping volume
+              chunk - description of chunk
+              chunk_data - pointer to enough space for chunk
+@OUTPUT     : chunk_data - filled with the chunk fill value
+@RETURNS    : (nothing)
+@DESCRIPTION: Sets every value of a chunk to its fill value.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void fill_chunk(Reshape_info *reshape_info, Chunk_Info *chunk,
+                       void *chunk_data)
+{
+   int datatype_size;
+   long ipix;
+   union {
+      char c; short s; long l; float f; double d;
+   } value_buffer;
+
+   datatype_size = nctypelen(reshape_info->output_datatype);
+   convert_value_from_double(chunk->fillvalue, 
+                             reshape_info->output_datatype,
+                             reshape_info->output_is_signed,
+                             &value_buffer);
+   for (ipix=0; ipix < chunk->total_size; ipix++) {
+      (void) memcpy((char *)chunk_data + ipix*datatype_size,
+                    &value_buffer, datatype_size);
+   }
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reorder_chunk_data
+@INPUT      : reshape_info - information for reshaping volume
+              chunk - description of chunk
+              input_data - data read for chunk from input hyperslab
+@OUTPUT     : chunk_data - data put in place in the output chunk
+@RETURNS    : (nothing)
+@DESCRIPTION: Copies the input data of a chunk into the output chunk,
+              reordering and flipping dimensions as needed, so that the
+              chunk can be written with a contiguous ncvarput.
+@METHOD     :
+@GLOBALS    :
+@CALLS      : reorder_data
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void reorder_chunk_data(Reshape_info *reshape_info, Chunk_Info *chunk,
+                               void *input_data, void *chunk_data)
+{
+   int odim, out_ndims, datatype_size;
+   long chunk_step[MAX_VAR_DIMS], out_offset;
+
+   out_ndims = reshape_info->output_ndims;
+   datatype_size = nctypelen(reshape_info->output_datatype);
+
+   /* Get the step (in bytes) through the output chunk for each dimension
+      and the offset of the data in it */
+   out_offset = 0;
+   for (odim=out_ndims-1; odim >= 0; odim--) {
+      chunk_step[odim] = ((odim == out_ndims-1) ? 
+                          datatype_size :
+                          chunk_step[odim+1] * chunk->chunk_count[odim+1]);
+      out_offset += (chunk->output_start[odim] - chunk->chunk_start[odim]) *
+         chunk_step[odim];
+   }
+
+   reorder_data(out_ndims, chunk->output_count, 
+                chunk->output_imap, chunk_step,
+                (char *) input_data + chunk->origin_offset,
+                (char *) chunk_data + out_offset, datatype_size);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : copy_the_chunk
+@INPUT      : reshape_info - information for reshaping volume
+              chunk_start - start of current block
+              chunk_count - count for current block
+              input_data - pointer to enough space for chunk
+              chunk_data - pointer to enough space for chunk
+              fillvalue - pixel value to zero volume, if necessary.
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Copies the chunk from the input file to the output file.
+@METHOD     : The input data is reordered into output order in memory
+              (with the fill value around it if the chunk is not all
+              inside the input), so that the chunk is written in one
+              contiguous piece.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 25, 1994 (Peter Neelin)
+@MODIFIED   : October 16, 2026 - reorder in memory rather than with imap
+---------------------------------------------------------------------------- */
+static void copy_the_chunk(Reshape_info *reshape_info,
+                           long chunk_start[],
+                           long chunk_count[],
+                           void *input_data,
+                           void *chunk_data,
+                           double fillvalue)
+{
+   Chunk_Info chunk;
+
+   /* Work out what to copy */
+   setup_chunk(reshape_info, chunk_start, chunk_count, fillvalue, &chunk);
+
+   /* Fill the chunk if needed */
+   if (chunk.zero_data) {
+      fill_chunk(reshape_info, &chunk, chunk_data);
+   }
 
-      /* Read in the data */
-      (void) miicv_get(reshape_info->icvid, input_start, input_count, 
+   /* Read in the data and put it in place */
+   if (chunk.in_order) {
+      (void) miicv_get(reshape_info->icvid, 
+                       chunk.input_start, chunk.input_count, 
                        chunk_data);
-   
-      /* Write it out */
-      (void) ncvarputg(reshape_info->outmincid, reshape_info->outimgid,
-                       output_start, output_count, NULL, output_imap, 
-                       output_origin);
+   }
+   else if (chunk.really_copy_the_data) {
+      (void) miicv_get(reshape_info->icvid, 
+                       chunk.input_start, chunk.input_count, 
+                       input_data);
+      reorder_chunk_data(reshape_info, &chunk, input_data, chunk_data);
+   }
 
+   /* Write it out */
+   (void) ncvarput(reshape_info->outmincid, reshape_info->outimgid,
+                   chunk.chunk_start, chunk.chunk_count, chunk_data);
+
+}
+
+#ifdef HAVE_PTHREAD
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : create_chunk_pipeline
+@INPUT      : reshape_info - information for reshaping volume
+              total_size - size of a chunk in bytes
+@OUTPUT     : (none)
+@RETURNS    : New pipeline
+@DESCRIPTION: Allocates a pipeline for copying chunks with 
+              reshape_info->nthreads threads, with input and output
+              buffers for two sets of nthreads chunks.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static Chunk_Pipeline *create_chunk_pipeline(Reshape_info *reshape_info,
+                                             long total_size)
+{
+   Chunk_Pipeline *pipeline;
+   int iset, ijob;
+
+   pipeline = malloc(sizeof(*pipeline));
+   pipeline->reshape_info = reshape_info;
+   pipeline->nthreads = reshape_info->nthreads;
+   for (iset=0; iset < 2; iset++) {
+      pipeline->jobs[iset] = malloc(sizeof(Chunk_Job) * pipeline->nthreads);
+      pipeline->njobs[iset] = 0;
+      for (ijob=0; ijob < pipeline->nthreads; ijob++) {
+         pipeline->jobs[iset][ijob].reshape_info = reshape_info;
+         pipeline->jobs[iset][ijob].input_data = malloc(total_size);
+         pipeline->jobs[iset][ijob].output_data = malloc(total_size);
+         if ((pipeline->jobs[iset][ijob].input_data == NULL) ||
+             (pipeline->jobs[iset][ijob].output_data == NULL)) {
+            (void) fprintf(stderr, 
+                           "Unable to allocate chunk buffers for %d threads\n",
+                           pipeline->nthreads);
+            exit(EXIT_FAILURE);
+         }
+      }
    }
+   pipeline->current = 0;
+   pipeline->running = FALSE;
+   pipeline->threads = malloc(sizeof(pthread_t) * pipeline->nthreads);
+   pipeline->started = malloc(sizeof(int) * pipeline->nthreads);
 
+   return pipeline;
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : queue_chunk
+@INPUT      : pipeline - chunk pipeline
+              chunk_start - start of chunk
+              chunk_count - count for chunk
+              fillvalue - pixel value to zero volume, if necessary.
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Reads the input data for a chunk into the current set of
+              jobs. When the set is full, the threads are started on it
+              and the other set, reordered in the meantime, is written 
+              out, so that reading, reordering and writing overlap. 
+              Chunks must be queued in the order in which the icv is set
+              up for them (handle_normalization), since they are read
+              immediately.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void queue_chunk(Chunk_Pipeline *pipeline,
+                        long chunk_start[],
+                        long chunk_count[],
+                        double fillvalue)
+{
+   Reshape_info *reshape_info;
+   Chunk_Job *job;
+   int set;
+
+   reshape_info = pipeline->reshape_info;
+   set = pipeline->current;
+
+   /* Read the chunk */
+   job = &pipeline->jobs[set][pipeline->njobs[set]];
+   setup_chunk(reshape_info, chunk_start, chunk_count, fillvalue,
+               &job->chunk);
+   if (job->chunk.really_copy_the_data) {
+      (void) miicv_get(reshape_info->icvid, 
+                       job->chunk.input_start, job->chunk.input_count, 
+                       (job->chunk.in_order ? 
+                        job->output_data : job->input_data));
+   }
+   pipeline->njobs[set]++;
+   if (pipeline->njobs[set] < pipeline->nthreads) return;
+
+   /* The set is full: wait for the other set, reorder this one and 
+      write out the other one while this one is being reordered */
+   if (pipeline->running) {
+      finish_reordering(pipeline, !set);
+   }
+   start_reordering(pipeline, set);
+   write_chunks(pipeline, !set);
+
+   /* Read into the other set from now on */
+   pipeline->current = !set;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : start_reordering
+@INPUT      : pipeline - chunk pipeline
+              set - set of jobs to reorder
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Starts one thread per chunk of a set to reorder the chunks
+              into output order. A chunk whose thread cannot be created
+              is reordered by finish_reordering.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void start_reordering(Chunk_Pipeline *pipeline, int set)
+{
+   int ijob;
+
+   for (ijob=0; ijob < pipeline->njobs[set]; ijob++) {
+      pipeline->started[ijob] = 
+         (pthread_create(&pipeline->threads[ijob], NULL, reorder_chunk,
+                         &pipeline->jobs[set][ijob]) == 0);
+   }
+   pipeline->running = TRUE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : finish_reordering
+@INPUT      : pipeline - chunk pipeline
+              set - set of jobs being reordered
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Waits for the threads started by start_reordering.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void finish_reordering(Chunk_Pipeline *pipeline, int set)
+{
+   int ijob;
+
+   for (ijob=0; ijob < pipeline->njobs[set]; ijob++) {
+      if (pipeline->started[ijob])
+         (void) pthread_join(pipeline->threads[ijob], NULL);
+      else
+         (void) reorder_chunk(&pipeline->jobs[set][ijob]);
+   }
+   pipeline->running = FALSE;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : write_chunks
+@INPUT      : pipeline - chunk pipeline
+              set - set of reordered jobs
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Writes out the chunks of a set in order and empties the 
+              set.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void write_chunks(Chunk_Pipeline *pipeline, int set)
+{
+   Reshape_info *reshape_info;
+   Chunk_Job *job;
+   int ijob;
+
+   reshape_info = pipeline->reshape_info;
+   for (ijob=0; ijob < pipeline->njobs[set]; ijob++) {
+      job = &pipeline->jobs[set][ijob];
+      (void) ncvarput(reshape_info->outmincid, reshape_info->outimgid,
+                      job->chunk.chunk_start, job->chunk.chunk_count, 
+                      job->output_data);
+   }
+   pipeline->njobs[set] = 0;
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : flush_chunk_pipeline
+@INPUT      : pipeline - chunk pipeline
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Reorders and writes out all of the chunks left in the 
+              pipeline.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void flush_chunk_pipeline(Chunk_Pipeline *pipeline)
+{
+   int set;
+
+   set = pipeline->current;
+   if (pipeline->running) {
+      finish_reordering(pipeline, !set);
+   }
+   if (pipeline->njobs[set] > 0) {
+      start_reordering(pipeline, set);
+   }
+   write_chunks(pipeline, !set);
+   if (pipeline->running) {
+      finish_reordering(pipeline, set);
+   }
+   write_chunks(pipeline, set);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : delete_chunk_pipeline
+@INPUT      : pipeline - chunk pipeline
+@OUTPUT     : (none)
+@RETURNS    : (nothing)
+@DESCRIPTION: Frees a chunk pipeline.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void delete_chunk_pipeline(Chunk_Pipeline *pipeline)
+{
+   int iset, ijob;
+
+   for (iset=0; iset < 2; iset++) {
+      for (ijob=0; ijob < pipeline->nthreads; ijob++) {
+         free(pipeline->jobs[iset][ijob].input_data);
+         free(pipeline->jobs[iset][ijob].output_data);
+      }
+      free(pipeline->jobs[iset]);
+   }
+   free(pipeline->threads);
+   free(pipeline->started);
+   free(pipeline);
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reorder_chunk
+@INPUT      : job_ptr - pointer to Chunk_Job with input data read
+@OUTPUT     : (none)
+@RETURNS    : NULL
+@DESCRIPTION: Thread entry point: fills the output buffer of a chunk, if
+              needed, and puts the input data in place in it. Touches 
+              only the job, so that chunks can be reordered concurrently.
+@METHOD     :
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+static void *reorder_chunk(void *job_ptr)
+{
+   Chunk_Job *job = (Chunk_Job *) job_ptr;
+
+   if (job->chunk.zero_data) {
+      fill_chunk(job->reshape_info, &job->chunk, job->output_data);
+   }
+   if (job->chunk.really_copy_the_data && !job->chunk.in_order) {
+      reorder_chunk_data(job->reshape_info, &job->chunk, 
+                         job->input_data, job->output_data);
+   }
+
+   return NULL;
+}
+
+#endif /* HAVE_PTHREAD */
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : convert_value_from_double
 @INPUT      : dvalue - double value to convert
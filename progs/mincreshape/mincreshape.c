@@ -123,6 +123,9 @@
 #include <ctype.h>
 #include <math.h>
 #include <minc.h>
+#if MINC2
+#include <minc2.h>
+#endif /* MINC2 */
 #include <ParseArgv.h>
 #include <time_stamp.h>
 #include "mincreshape.h"
@@ -144,7 +147,12 @@ static void setup_reshaping_info(int icvid, int mincid,
                                  long hs_start[], long hs_count[],
                                  int max_chunk_size_in_kb,
                                  Reshape_info *reshape_info);
-static void setup_output_file(int mincid, char *history,
+static void get_storage_chunking(char *filename, long edges[]);
+static void align_chunks_to_storage(int mincid, int max_chunk_size_in_kb,
+                                    long input_edges[], long output_edges[],
+                                    Reshape_info *reshape_info);
+static void setup_output_file(int mincid, char *filename, char *history,
+                              int max_chunk_size_in_kb, long input_edges[],
                               Reshape_info *reshape_info);
 static void create_dim_var(int outmincid, int outdimid,
                            int inicvid, int cur_image_dim, int inmincid,
@@ -219,6 +227,8 @@ static void get_arginfo(int argc, char *argv[],
    static long hs_count[MAX_VAR_DIMS] = {LONG_MIN};
    static double fillvalue = NOFILL;
    static int max_chunk_size_in_kb = DEFAULT_MAX_CHUNK_SIZE_IN_KB;
+   static int nthreads = 1;
+   static int scan_range = FALSE;
 #if MINC2
    static int minc2_format = 0;
 #endif /* MINC2 */
@@ -239,6 +249,10 @@ static void get_arginfo(int argc, char *argv[],
       {"-max_chunk_size_in_kb", ARGV_INT, (char *) 0, 
           (char *) &max_chunk_size_in_kb,
           "Specify the maximum size of the copy buffer (in kbytes)."},
+#ifdef HAVE_PTHREAD
+      {"-threads", ARGV_INT, (char *) 1, (char *) &nthreads,
+          "Number of threads used to reorder chunks (default 1)."},
+#endif /* HAVE_PTHREAD */
 #if MINC2
       {"-2", ARGV_CONSTANT, (char *) TRUE, (char *)&minc2_format,
        "Produce a MINC 2.0 format output file."},
@@ -273,6 +287,8 @@ static void get_arginfo(int argc, char *argv[],
           "Normalize images to file minimum and maximum."},
       {"-nonormalize", ARGV_CONSTANT, (char *) FALSE, (char *) &do_norm,
           "Do not normalize images (default)."},
+      {"-scan_range", ARGV_CONSTANT, (char *) TRUE, (char *) &scan_range,
+          "Read the data to get the range if there is no image-max/min."},
       {"-nopixfill", ARGV_FUNC, (char *) get_fillvalue, 
           (char *) &pixfillvalue,
           "Do not convert out-of-range values in input file."},
@@ -383,6 +399,7 @@ static void get_arginfo(int argc, char *argv[],
    char *infile, *outfile;
    char *history, *pname;
    int icvid;
+   long input_edges[MAX_VAR_DIMS];
 
    /* Get the history information and program name */
    history = time_stamp(argc, argv);
@@ -409,6 +426,15 @@ static void get_arginfo(int argc, char *argv[],
       exit(EXIT_FAILURE);
    }
 
+   /* Check number of threads */
+   if (nthreads < 1) {
+      (void) fprintf(stderr, "Illegal number of threads (%d)\n", nthreads);
+      exit(EXIT_FAILURE);
+   }
+   reshape_info->nthreads = nthreads;
+   reshape_info->scan_range = scan_range;
+   reshape_info->scan_icvid = MI_ERROR;
+
    /* Check the x, y and z directions */
    if (xdirection == INT_MIN) xdirection = direction;
    if (ydirection == INT_MIN) ydirection = direction;
@@ -497,7 +523,12 @@ static void get_arginfo(int argc, char *argv[],
    }
 #endif /* MINC2 */
    reshape_info->outmincid = micreate(outfile, cflags);
-   setup_output_file(reshape_info->outmincid, history, reshape_info);
+
+   /* Set up the output file, lining the copy chunks up with the storage
+      chunking of the input image and of the new output image */
+   get_storage_chunking(infile, input_edges);
+   setup_output_file(reshape_info->outmincid, outfile, history,
+                     max_chunk_size_in_kb, input_edges, reshape_info);
 
    return;
 }
@@ -1320,6 +1351,13 @@ static void setup_reshaping_info(int icvid, int mincid,
       minid = ncvarid(mincid, MIimagemin);
       maxid = ncvarid(mincid, MIimagemax);
       ncopts = NCOPTS_DEFAULT;
+
+      /* Without image-min/max, a scanned range is applied to each block */
+      if (reshape_info->scan_range && 
+          ((minid == MI_ERROR) || (maxid == MI_ERROR))) {
+         reshape_info->do_block_normalization = TRUE;
+      }
+
       if ((minid != MI_ERROR) && (maxid != MI_ERROR)) {
          (void) ncvarinq(mincid, minid, NULL, NULL, &min_ndims, min_dim, NULL);
          (void) ncvarinq(mincid, maxid, NULL, NULL, &max_ndims, max_dim, NULL);
@@ -1345,21 +1383,197 @@ static void setup_reshaping_info(int icvid, int mincid,
 
 }
 
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : get_storage_chunking
+@INPUT      : filename - name of minc file
+@OUTPUT     : edges - edge lengths of the storage chunks of the image
+                 variable, in file dimension order (0 if not chunked)
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to get the HDF5 chunking of a MINC 2.0 image. Netcdf
+              (MINC 1) files are not chunked.
+@METHOD     : The file is checked for the HDF5 signature before it is
+              opened through the MINC 2.0 interface, so that netcdf files
+              do not produce HDF5 error messages.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void get_storage_chunking(char *filename, long edges[])
+{
+   int idim;
+#if MINC2
+   static char signature[] = "\211HDF\r\n\032\n";
+   char buffer[sizeof(signature)-1];
+   FILE *fp;
+   mihandle_t volume;
+   mivolumeprops_t props;
+   int edge_count, edge_lengths[MAX_VAR_DIMS];
+#endif /* MINC2 */
+
+   for (idim=0; idim < MAX_VAR_DIMS; idim++) {
+      edges[idim] = 0;
+   }
+
+#if MINC2
+   /* Check for an HDF5 file */
+   if ((fp = fopen(filename, "rb")) == NULL) return;
+   if ((fread(buffer, 1, sizeof(buffer), fp) != sizeof(buffer)) ||
+       (memcmp(buffer, signature, sizeof(buffer)) != 0)) {
+      (void) fclose(fp);
+      return;
+   }
+   (void) fclose(fp);
+
+   /* Get the chunking of the image */
+   if (miopen_volume(filename, MI2_OPEN_READ, &volume) != MI_NOERROR)
+      return;
+   if (miget_volume_props(volume, &props) == MI_NOERROR) {
+      if (miget_props_blocking(props, &edge_count, edge_lengths,
+                               MAX_VAR_DIMS) == MI_NOERROR) {
+         for (idim=0; (idim < edge_count) && (idim < MAX_VAR_DIMS); idim++) {
+            if (edge_lengths[idim] > 0) edges[idim] = edge_lengths[idim];
+         }
+      }
+      (void) mifree_volume_props(props);
+   }
+   (void) miclose_volume(volume);
+#endif /* MINC2 */
+
+}
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : align_chunks_to_storage
+@INPUT      : mincid - id of input minc file
+              max_chunk_size_in_kb - maximum size of copy buffer in kbytes.
+              input_edges - storage chunk edge lengths of input image
+                 (0 where not chunked)
+              output_edges - storage chunk edge lengths of output image
+                 (0 where not chunked)
+              reshape_info - information describing the reshaping
+@OUTPUT     : reshape_info - chunk_count and dim_used_in_block modified
+@RETURNS    : (nothing)
+@DESCRIPTION: Routine to choose chunk counts that are whole multiples of
+              the storage chunks of both the input and the output image, so
+              that each compressed chunk is read and written in one piece
+              rather than being decompressed once for every copy chunk that
+              touches it.
+@METHOD     : Going from the fastest varying output dimension to the
+              slowest, the chunk count is set to the largest multiple of
+              the storage chunk edges (the least common multiple of the
+              input and output edges) that fits in the copy buffer, or to
+              the whole dimension. A dimension that is not already in the
+              block is only added to it if image-min/max do not vary
+              along it, so that the normalization is unchanged. Counts
+              that cannot hold a whole storage chunk are left alone.
+              Chunks only line up with the storage exactly when the
+              hyperslab starts on a storage chunk boundary.
+@GLOBALS    : 
+@CALLS      : 
+@CREATED    : October 16, 2026
+@MODIFIED   : 
+---------------------------------------------------------------------------- */
+static void align_chunks_to_storage(int mincid, int max_chunk_size_in_kb,
+                                    long input_edges[], long output_edges[],
+                                    Reshape_info *reshape_info)
+{
+   int input_ndims, input_dim[MAX_VAR_DIMS];
+   int min_ndims, max_ndims, min_dim[MAX_VAR_DIMS], max_dim[MAX_VAR_DIMS];
+   int minid, maxid, idim, odim, jdim, varies;
+   long edge, in_edge, out_edge, size, count, other_size, max_size;
+   long total_size, a, b, t;
+   nc_type datatype;
+
+   /* Get the dimensions of the image and of image-min/max */
+   (void) ncvarinq(mincid, ncvarid(mincid, MIimage), NULL, NULL,
+                   &input_ndims, input_dim, NULL);
+   min_ndims = max_ndims = 0;
+   ncopts = 0;
+   minid = ncvarid(mincid, MIimagemin);
+   maxid = ncvarid(mincid, MIimagemax);
+   ncopts = NCOPTS_DEFAULT;
+   if (minid != MI_ERROR)
+      (void) ncvarinq(mincid, minid, NULL, NULL, &min_ndims, min_dim, NULL);
+   if (maxid != MI_ERROR)
+      (void) ncvarinq(mincid, maxid, NULL, NULL, &max_ndims, max_dim, NULL);
+
+   /* Get the size of the copy buffer in values */
+   (void) miicv_inqint(reshape_info->icvid, MI_ICV_TYPE, (int *) &datatype);
+   max_size = (long) max_chunk_size_in_kb * 1024 / nctypelen(datatype);
+   total_size = 1;
+   for (odim=0; odim < reshape_info->output_ndims; odim++) {
+      total_size *= reshape_info->chunk_count[odim];
+   }
+
+   /* Loop over output dimensions from fastest to slowest */
+   for (odim=reshape_info->output_ndims-1; odim >= 0; odim--) {
+      idim = reshape_info->map_out_to_in[odim];
+      size = ABS(reshape_info->input_count[idim]);
+      count = reshape_info->chunk_count[odim];
+
+      /* Get the least common multiple of the storage chunk edges */
+      in_edge = input_edges[idim];
+      out_edge = MIN(output_edges[odim], size);
+      if (in_edge < 1) in_edge = 1;
+      if (out_edge < 1) out_edge = 1;
+      a = in_edge;
+      b = out_edge;
+      while (b != 0) {
+         t = a % b;
+         a = b;
+         b = t;
+      }
+      edge = in_edge / a * out_edge;
+      if ((edge <= 1) || (count >= size)) continue;
+
+      /* Dimensions outside the block can only be added if image-min/max
+         do not vary along them */
+      if (!reshape_info->dim_used_in_block[odim]) {
+         varies = FALSE;
+         for (jdim=0; jdim < min_ndims; jdim++) {
+            if (min_dim[jdim] == input_dim[idim]) varies = TRUE;
+         }
+         for (jdim=0; jdim < max_ndims; jdim++) {
+            if (max_dim[jdim] == input_dim[idim]) varies = TRUE;
+         }
+         if (varies) continue;
+      }
+
+      /* Take as many whole storage chunks as will fit */
+      other_size = total_size / count;
+      count = (max_size / other_size / edge) * edge;
+      if (count > size) count = size;
+      if (count < MIN(edge, size)) continue;
+      reshape_info->chunk_count[odim] = count;
+      reshape_info->dim_used_in_block[odim] = TRUE;
+      total_size = other_size * count;
+   }
+
+}
+
 /* ----------------------------- MNI Header -----------------------------------
 @NAME       : setup_output_file
 @INPUT      : mincid - id of output minc file
+              filename - name of output minc file
               history - string to be added to history list
+              max_chunk_size_in_kb - maximum size of copy buffer in kbytes.
+              input_edges - storage chunk edge lengths of input image
+                 (0 where not chunked)
               reshape_info - information describing the reshaping
-@OUTPUT     : (none)
+@OUTPUT     : reshape_info - chunk_count and dim_used_in_block modified
 @RETURNS    : (nothing)
 @DESCRIPTION: Routine to set up the output file
-@METHOD     : 
+@METHOD     : The image variable is created before image-min/max so that
+              its storage chunking can be read back from the file and the
+              copy chunks lined up with it before the dimensions of
+              image-min/max are chosen from the block dimensions.
 @GLOBALS    : 
 @CALLS      : 
 @CREATED    : June 16, 1994 (Peter Neelin)
-@MODIFIED   : 
+@MODIFIED   : October 16, 2026 - align chunks to storage chunking
 ---------------------------------------------------------------------------- */
-static void setup_output_file(int mincid, char *history, 
+static void setup_output_file(int mincid, char *filename, char *history,
+                              int max_chunk_size_in_kb, long input_edges[],
                               Reshape_info *reshape_info)
 {
    int output_ndims, output_dim[MAX_VAR_DIMS];
@@ -1378,6 +1592,7 @@ static void setup_output_file(int mincid, char *history,
    int att_length;
    int has_vector_dimension;
    int fastest_img_dim;
+   long output_edges[MAX_VAR_DIMS];
 
    /* Get useful info */
    output_ndims = reshape_info->output_ndims;
@@ -1448,6 +1663,17 @@ static void setup_output_file(int mincid, char *history,
       if (0.0 > valid_range[1]) valid_range[1] = 0.0;
    }
 
+   /* Create the image variable */
+   imgid = micreate_std_variable(mincid, MIimage, datatype,
+                                 output_ndims, output_dim);
+   reshape_info->outimgid = imgid;
+
+   /* Line the copy chunks up with the storage chunking of the input and
+      of the new image variable */
+   get_storage_chunking(filename, output_edges);
+   align_chunks_to_storage(reshape_info->inmincid, max_chunk_size_in_kb,
+                           input_edges, output_edges, reshape_info);
+
    /* Create the imagemax/min variables */
    minmax_ndims = 0;
    for (odim=0; odim < output_ndims; odim++) {
@@ -1470,10 +1696,7 @@ static void setup_output_file(int mincid, char *history,
                                 varid2, mincid, varid);
    }
 
-   /* Create the image variable */
-   imgid = micreate_std_variable(mincid, MIimage, datatype,
-                                 output_ndims, output_dim);
-   reshape_info->outimgid = imgid;
+   /* Copy the image variable attributes */
    (void) micopy_all_atts(reshape_info->inmincid, 
                           ncvarid(reshape_info->inmincid, MIimage),
                           mincid, imgid);
@@ -73,9 +73,18 @@
 
 /* Types used in program */
 
+/* Threads for scanning block ranges (defined in copy_data.c) */
+typedef struct Scan_Pool Scan_Pool;
+
 typedef struct {
    int verbose;
+   int nthreads;                     /* Number of threads used to reorder
+                                        chunks */
    int icvid, inmincid, outmincid, outimgid;
+   int scan_range;                   /* Read the data for block ranges
+                                        that image-max/min do not give */
+   int scan_icvid;                   /* Icv for scanning (or MI_ERROR) */
+   Scan_Pool *scan_pool;             /* Threads for scanning (or NULL) */
    nc_type output_datatype;
    int output_is_signed;
    int input_ndims;                  /* Number of input dimensions */
@@ -122,3 +131,7 @@ typedef struct {
 
 /* Function prototypes */
 extern void copy_data(Reshape_info *reshape_info);
+extern void reorder_data(int ndims, long count[], 
+                         long in_step[], long out_step[],
+                         void *in_origin, void *out_origin, 
+                         int datatype_size);
@@ -0,0 +1,199 @@
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reorder_data.c
+@DESCRIPTION: Routine to copy a hyperslab of data from one layout in
+              memory to another, reordering and flipping dimensions, so
+              that mincreshape can write contiguous chunks instead of
+              handing netcdf an imap to scatter the data.
+@METHOD     : The copy is done as a series of two-dimensional transposes
+              between the fastest-varying dimension of the output and that
+              of the input, in square tiles small enough for both the
+              rows read and the rows written to stay in cache. There is a
+              specialized loop for each size of data type.
+@GLOBALS    :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+@COPYRIGHT  :
+              Copyright 1994 Peter Neelin, McConnell Brain Imaging Centre,
+              Montreal Neurological Institute, McGill University.
+              Permission to use, copy, modify, and distribute this
+              software and its documentation for any purpose and without
+              fee is hereby granted, provided that the above copyright
+              notice appear in all copies.  The author and McGill University
+              make no representations about the suitability of this
+              software for any purpose.  It is provided "as is" without
+              express or implied warranty.
+---------------------------------------------------------------------------- */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <float.h>
+#include <string.h>
+#include <minc.h>
+#include "mincreshape.h"
+
+/* Size of the square tiles of the transpose (in values). 32 x 32 values
+   of 8 bytes fill 8 kbytes for each of input and output. */
+#define REORDER_TILE 32
+
+/* Tiled transpose of an ni x no block for one data type. Steps are in
+   values. Output rows (along o) are written contiguously when out_so is
+   1 and input rows (along i) are read contiguously when in_si is 1. */
+#define REORDER_BLOCK(name, type) \
+static void name(long ni, long no, long in_si, long in_so, \
+                 long out_si, long out_so, void *in_ptr, void *out_ptr) \
+{ \
+   type *in, *out; \
+   long i, o, i0, o0, iend, oend; \
+ \
+   for (i0=0; i0 < ni; i0 += REORDER_TILE) { \
+      iend = MIN(i0 + REORDER_TILE, ni); \
+      for (o0=0; o0 < no; o0 += REORDER_TILE) { \
+         oend = MIN(o0 + REORDER_TILE, no); \
+         for (i=i0; i < iend; i++) { \
+            in = (type *) in_ptr + i * in_si; \
+            out = (type *) out_ptr + i * out_si; \
+            for (o=o0; o < oend; o++) { \
+               out[o * out_so] = in[o * in_so]; \
+            } \
+         } \
+      } \
+   } \
+}
+
+REORDER_BLOCK(reorder_block_1, unsigned char)
+REORDER_BLOCK(reorder_block_2, unsigned short)
+REORDER_BLOCK(reorder_block_4, unsigned int)
+REORDER_BLOCK(reorder_block_8, double)
+
+/* ----------------------------- MNI Header -----------------------------------
+@NAME       : reorder_data
+@INPUT      : ndims - number of dimensions of hyperslab
+              count - size of hyperslab
+              in_step - step (in bytes) through input for each dimension
+                 (may be negative)
+              out_step - step (in bytes) through output for each dimension
+                 (may be negative)
+              in_origin - pointer to input value [0,0,...]
+              datatype_size - size of a value in bytes
+@OUTPUT     : out_origin - pointer to output value [0,0,...]
+@RETURNS    : (nothing)
+@DESCRIPTION: Copies a hyperslab of values such that the value at index
+              [i0,i1,...] goes from in_origin + sum(ik*in_step[k]) to
+              out_origin + sum(ik*out_step[k]) - the same mapping as an
+              imap vector in ncvarputg. Steps must be multiples of
+              datatype_size. Only touches data passed in, so several
+              hyperslabs can be reordered concurrently.
+@METHOD     : The output dimension with the smallest output step and the
+              one with the smallest input step are copied together as a
+              tiled transpose; the other dimensions are looped over. If
+              they are the same dimension, rows are copied one at a time.
+@GLOBALS    :
+@CALLS      :
+@CREATED    : October 16, 2026
+@MODIFIED   :
+---------------------------------------------------------------------------- */
+void reorder_data(int ndims, long count[], long in_step[], long out_step[],
+                  void *in_origin, void *out_origin, int datatype_size)
+{
+   int idim, odim, dim;
+   long index[MAX_VAR_DIMS];
+   long ni, no, in_si, in_so, out_si, out_so;
+   char *in_ptr, *out_ptr;
+
+   /* Check for empty hyperslab and a single value */
+   for (dim=0; dim < ndims; dim++) {
+      if (count[dim] <= 0) return;
+   }
+   if (ndims < 1) {
+      (void) memcpy(out_origin, in_origin, datatype_size);
+      return;
+   }
+
+   /* Find the fastest varying dimensions of the output and the input */
+   odim = 0;
+   idim = -1;
+   for (dim=0; dim < ndims; dim++) {
+      if (ABS(out_step[dim]) < ABS(out_step[odim])) odim = dim;
+   }
+   for (dim=0; dim < ndims; dim++) {
+      if ((dim != odim) && (count[dim] > 1) &&
+          ((idim < 0) || (ABS(in_step[dim]) < ABS(in_step[idim]))))
+         idim = dim;
+   }
+   if ((idim >= 0) && (ABS(in_step[odim]) <= ABS(in_step[idim])))
+      idim = -1;
+
+   /* Get the block sizes and steps (in values) */
+   no = count[odim];
+   in_so = in_step[odim] / datatype_size;
+   out_so = out_step[odim] / datatype_size;
+   if (idim >= 0) {
+      ni = count[idim];
+      in_si = in_step[idim] / datatype_size;
+      out_si = out_step[idim] / datatype_size;
+   }
+   else {
+      ni = 1;
+      in_si = 0;
+      out_si = 0;
+   }
+
+   /* Loop over the other dimensions */
+   for (dim=0; dim < ndims; dim++) index[dim] = 0;
+   while (TRUE) {
+
+      /* Get the start of the block */
+      in_ptr = (char *) in_origin;
+      out_ptr = (char *) out_origin;
+      for (dim=0; dim < ndims; dim++) {
+         in_ptr += index[dim] * in_step[dim];
+         out_ptr += index[dim] * out_step[dim];
+      }
+
+      /* Copy it */
+      if ((ni == 1) && (in_so == 1) && (out_so == 1)) {
+         (void) memcpy(out_ptr, in_ptr, no * datatype_size);
+      }
+      else {
+         switch (datatype_size) {
+         case 1:
+            reorder_block_1(ni, no, in_si, in_so, out_si, out_so,
+                            in_ptr, out_ptr);
+            break;
+         case 2:
+            reorder_block_2(ni, no, in_si, in_so, out_si, out_so,
+                            in_ptr, out_ptr);
+            break;
+         case 4:
+            reorder_block_4(ni, no, in_si, in_so, out_si, out_so,
+                            in_ptr, out_ptr);
+            break;
+         case 8:
+            reorder_block_8(ni, no, in_si, in_so, out_si, out_so,
+                            in_ptr, out_ptr);
+            break;
+         default:
+            (void) fprintf(stderr, "Cannot reorder values of %d bytes\n",
+                           datatype_size);
+            exit(EXIT_FAILURE);
+         }
+      }
+
+      /* Increment the index of the other dimensions */
+      dim = ndims-1;
+      while (dim >= 0) {
+         if ((dim != odim) && (dim != idim)) {
+            index[dim]++;
+            if (index[dim] < count[dim]) break;
+            index[dim] = 0;
+         }
+         dim--;
+      }
+      if (dim < 0) break;
+   }
+
+}